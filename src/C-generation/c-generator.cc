@@ -0,0 +1,449 @@
+#include "c-generator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <set>
+#include <unordered_map>
+
+#include "IR/ir_visitor.h"
+#include "IR/code-gen-constants.h"
+#include "IR/program-units.h"
+#include "exceptions/exceptions.h"
+#include "utillities/overload.h"
+
+namespace {
+
+// Declarations shared by every file: the function table, the memory and its accessors, and the runtime
+const char *RUNTIME_HEADER = R"(#ifndef JOOS_H
+#define JOOS_H
+
+#include <stdint.h>
+#include <string.h>
+
+typedef void (*joos_function)(void);
+
+extern const joos_function joos_functions[];
+extern unsigned char *joos_memory;
+
+int32_t joos_malloc(int32_t size);
+int32_t joos_exception(void);
+int32_t joos_debexit(int32_t code);
+int32_t joos_native_write(int32_t c);
+
+static inline int32_t joos_load(int32_t address) {
+    int32_t value;
+    memcpy(&value, joos_memory + (uint32_t) address, sizeof value);
+    return value;
+}
+
+static inline void joos_store(int32_t address, int32_t value) {
+    memcpy(joos_memory + (uint32_t) address, &value, sizeof value);
+}
+
+static inline int32_t joos_add(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a + (uint32_t) b); }
+static inline int32_t joos_sub(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a - (uint32_t) b); }
+static inline int32_t joos_mul(int32_t a, int32_t b) { return (int32_t) ((uint32_t) a * (uint32_t) b); }
+
+static inline int32_t joos_div(int32_t a, int32_t b) {
+    if (b == 0) joos_exception();
+    return b == -1 ? joos_sub(0, a) : a / b;
+}
+
+static inline int32_t joos_mod(int32_t a, int32_t b) {
+    if (b == 0) joos_exception();
+    return b == -1 ? 0 : a % b;
+}
+
+#endif
+)";
+
+// The runtime, as tests/stdlib/runtime.s implements it; memory starts past address 0, which is null
+const char *RUNTIME = R"(
+unsigned char *joos_memory;
+static uint32_t joos_memory_size;
+static uint32_t joos_memory_used = 8;
+
+int32_t joos_malloc(int32_t size) {
+    uint32_t address = joos_memory_used;
+    uint32_t end = address + (uint32_t) size;
+    if (size < 0 || end < address || end > 0x7fffffffu) exit(22);
+
+    if (end > joos_memory_size) {
+        uint32_t new_size = joos_memory_size ? joos_memory_size : 1u << 20;
+        while (new_size < end) new_size *= 2;
+        unsigned char *memory = realloc(joos_memory, new_size);
+        if (!memory) exit(22);
+        memset(memory + joos_memory_size, 0, new_size - joos_memory_size);
+        joos_memory = memory;
+        joos_memory_size = new_size;
+    }
+
+    joos_memory_used = end;
+    return (int32_t) address;
+}
+
+int32_t joos_exception(void) {
+    exit(13);
+}
+
+int32_t joos_debexit(int32_t code) {
+    exit(code);
+}
+
+int32_t joos_native_write(int32_t c) {
+    putchar((unsigned char) c);
+    return 0;
+}
+)";
+
+// Library functions the IR calls, implemented by the runtime
+const std::map<std::string, std::string> LIBRARY_FUNCTIONS = {
+    {"__malloc", "joos_malloc"},
+    {"__exception", "joos_exception"},
+    {"__debexit", "joos_debexit"},
+    {"NATIVEjava.io.OutputStream.nativeWrite", "joos_native_write"}
+};
+
+// Escape a label into identifier characters, keeping distinct labels distinct: _ becomes __, and every other
+// character that is not a letter or digit becomes _ followed by its hex code
+std::string escape(const std::string &label) {
+    static const char *HEX = "0123456789abcdef";
+    std::string result;
+    result.reserve(label.size());
+    for (unsigned char c : label) {
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+            result += c;
+        } else if (c == '_') {
+            result += "__";
+        } else {
+            result += '_';
+            result += HEX[c >> 4];
+            result += HEX[c & 0xf];
+        }
+    }
+    return result;
+}
+
+// The constant holding a function's address, i.e. its index in the function table
+std::string addressIdentifier(const std::string &label) {
+    return "h_" + escape(label);
+}
+
+// The type of a function taking the number of arguments
+std::string functionType(size_t num_args) {
+    if (num_args == 0) return "int32_t (*)(void)";
+    std::string type = "int32_t (*)(int32_t";
+    for (size_t i = 1; i < num_args; ++i) type += ", int32_t";
+    return type + ")";
+}
+
+std::string prototype(const std::string &label, size_t num_params) {
+    std::string result = "int32_t " + CSourceGenerator::identifier(label) + "(";
+    if (num_params == 0) return result + "void);\n";
+    for (size_t i = 0; i < num_params; ++i) {
+        result += i == 0 ? "int32_t" : ", int32_t";
+    }
+    return result + ");\n";
+}
+
+std::string constant(int32_t value) {
+    // -2147483648 is not a literal in C, but the negation of one that does not fit in an int
+    if (value == INT32_MIN) return "(-2147483647 - 1)";
+    return std::to_string(value);
+}
+
+// Temporaries a function uses as locals
+class LocalTempCollector : public IRSkipVisitor {
+  public:
+    std::set<TempId> temps;
+
+    using IRSkipVisitor::operator();
+
+    void operator()(TempIR &node) override {
+        if (!node.isGlobal) temps.insert(node.getId());
+    }
+};
+
+// Renders the functions of a compilation unit as C, recording what they use from other files
+class FunctionWriter {
+    CompUnitIR &cu;
+    bool annotate;
+    std::optional<TempId> ret_temp;
+    std::unordered_map<std::string, FuncDeclIR*> own_functions;
+
+    std::string code;
+    std::set<TempId> locals;
+
+    bool isArgument(TempId temp) {
+        static const util::Symbol arg_prefix {CGConstants::ABSTRACT_ARG_PREFIX};
+        return cu.temps.prefix(temp) == arg_prefix && cu.temps.number(temp) != IRNameTable::NO_NUMBER;
+    }
+
+    std::string temp(TempIR &node) {
+        if (node.isGlobal) {
+            std::string name = cu.temps.name(node.getId());
+            static_fields.insert(name);
+            return CSourceGenerator::identifier(name);
+        }
+        if (isArgument(node.getId())) {
+            return "a" + std::to_string(cu.temps.number(node.getId()));
+        }
+        return "t" + std::to_string(node.getId());
+    }
+
+    std::string expression(ExpressionIR &ir) {
+        return std::visit(util::overload {
+            [&](BinOpIR &node) -> std::string {
+                std::string left = expression(node.getLeft());
+                std::string right = expression(node.getRight());
+                switch (node.op) {
+                    case BinOpIR::ADD: return "joos_add(" + left + ", " + right + ")";
+                    case BinOpIR::SUB: return "joos_sub(" + left + ", " + right + ")";
+                    case BinOpIR::MUL: return "joos_mul(" + left + ", " + right + ")";
+                    case BinOpIR::DIV: return "joos_div(" + left + ", " + right + ")";
+                    case BinOpIR::MOD: return "joos_mod(" + left + ", " + right + ")";
+                    case BinOpIR::AND: return "(" + left + " & " + right + ")";
+                    case BinOpIR::OR: return "(" + left + " | " + right + ")";
+                    case BinOpIR::EQ: return "(" + left + " == " + right + ")";
+                    case BinOpIR::NEQ: return "(" + left + " != " + right + ")";
+                    case BinOpIR::LT: return "(" + left + " < " + right + ")";
+                    case BinOpIR::GT: return "(" + left + " > " + right + ")";
+                    case BinOpIR::LEQ: return "(" + left + " <= " + right + ")";
+                    case BinOpIR::GEQ: return "(" + left + " >= " + right + ")";
+                }
+                THROW_CompilerError("Unknown BinOpIR operator");
+            },
+            [&](ConstIR &node) -> std::string { return constant(node.getValue()); },
+            [&](MemIR &node) -> std::string { return "joos_load(" + expression(node.getAddress()) + ")"; },
+            [&](NameIR &node) -> std::string {
+                function_addresses.insert(node.getName());
+                return addressIdentifier(node.getName());
+            },
+            [&](TempIR &node) -> std::string { return temp(node); },
+            [&](ESeqIR &) -> std::string { THROW_CompilerError("ESeqIR should not exist after canonicalization"); },
+            [&](CallIR &) -> std::string { THROW_CompilerError("CallIR should not be considered an expression after canonicalization"); }
+        }, ir);
+    }
+
+    std::string call(CallIR &node) {
+        std::string arguments;
+        for (auto &arg : node.getArgs()) {
+            if (!arguments.empty()) arguments += ", ";
+            arguments += expression(*arg);
+        }
+
+        // Call a function by name directly, and any other address through the function table
+        if (auto name = std::get_if<NameIR>(&node.getTarget())) {
+            if (!own_functions.count(name->getName()) && !LIBRARY_FUNCTIONS.count(name->getName())) {
+                called_functions[name->getName()] = node.getNumArgs();
+            }
+            return CSourceGenerator::identifier(name->getName()) + "(" + arguments + ")";
+        }
+        std::string address = expression(node.getTarget());
+        return "((" + functionType(node.getNumArgs()) + ") joos_functions[" + address + "])(" + arguments + ")";
+    }
+
+    void line(const std::string &text) {
+        code += "    ";
+        code += text;
+        code += '\n';
+    }
+
+    void statement(StatementIR &ir) {
+        std::visit(util::overload {
+            [&](CJumpIR &node) {
+                line("if (" + expression(node.getCondition()) + ") goto l" + std::to_string(node.trueLabel()) + ";");
+                if (node.falseLabel() != NO_LABEL) {
+                    line("goto l" + std::to_string(node.falseLabel()) + ";");
+                }
+            },
+            [&](JumpIR &node) { line("goto l" + std::to_string(node.getTarget()) + ";"); },
+            [&](LabelIR &node) {
+                code += "l" + std::to_string(node.getId()) + ":;";
+                if (annotate) code += " /* " + cu.labels.name(node.getId()) + " */";
+                code += '\n';
+            },
+            [&](MoveIR &node) {
+                std::string source = expression(node.getSource());
+                std::visit(util::overload {
+                    [&](TempIR &target) { line(temp(target) + " = " + source + ";"); },
+                    [&](MemIR &target) { line("joos_store(" + expression(target.getAddress()) + ", " + source + ");"); },
+                    [&](auto &) { THROW_CompilerError("Invalid MoveIR target"); }
+                }, node.getTarget());
+            },
+            [&](ReturnIR &node) { line("return " + (node.getRet() ? expression(*node.getRet()) : "0") + ";"); },
+            [&](SeqIR &node) {
+                for (auto &stmt : node.getStmts()) statement(*stmt);
+            },
+            [&](CallIR &node) {
+                // The result is only kept if the function reads it
+                if (ret_temp && locals.count(*ret_temp)) {
+                    line("t" + std::to_string(*ret_temp) + " = " + call(node) + ";");
+                } else {
+                    line(call(node) + ";");
+                }
+            },
+            [&](ExpIR &node) { line("(void) " + expression(node.getExpr()) + ";"); },
+            [&](CommentIR &node) {
+                if (!annotate) return;
+                std::string text = node.getText();
+                for (size_t i = text.find("*/"); i != std::string::npos; i = text.find("*/", i)) {
+                    text.replace(i, 2, "* /");
+                }
+                line("/* " + text + " */");
+            }
+        }, ir);
+    }
+
+  public:
+    std::map<std::string, size_t> called_functions; // Functions of other units called by name, with their number of arguments
+    std::set<std::string> function_addresses;
+    std::set<std::string> static_fields;
+
+    FunctionWriter(CompUnitIR &cu, bool annotate) : cu{cu}, annotate{annotate}, own_functions{cu.getFunctions()} {
+        ret_temp = cu.temps.find(CGConstants::ABSTRACT_RET);
+    }
+
+    // Write the function, returning its number of parameters
+    size_t write(FuncDeclIR &func) {
+        LocalTempCollector collector;
+        collector(func.getBody());
+
+        // Methods take `this` as their first argument besides their declared parameters, so the arguments
+        // are counted from the ones the body reads
+        size_t num_params = 0;
+        for (auto temp : collector.temps) {
+            if (isArgument(temp)) num_params = std::max<size_t>(num_params, cu.temps.number(temp) + 1);
+        }
+
+        std::string parameters;
+        for (size_t i = 0; i < num_params; ++i) {
+            parameters += (i == 0 ? "int32_t a" : ", int32_t a") + std::to_string(i);
+        }
+        code += "int32_t " + CSourceGenerator::identifier(func.getName()) + "(" + (parameters.empty() ? "void" : parameters) + ") {\n";
+
+        locals.clear();
+        for (auto temp : collector.temps) {
+            if (isArgument(temp)) continue;
+            locals.insert(temp);
+            line("int32_t t" + std::to_string(temp) + " = 0;" + (annotate ? " /* " + cu.temps.name(temp) + " */" : ""));
+        }
+
+        statement(func.getBody());
+        code += "}\n\n";
+        return num_params;
+    }
+
+    std::string take() { return std::move(code); }
+};
+
+} // namespace
+
+std::string CSourceGenerator::identifier(const std::string &label) {
+    auto library_function = LIBRARY_FUNCTIONS.find(label);
+    if (library_function != LIBRARY_FUNCTIONS.end()) {
+        return library_function->second;
+    }
+    return "j_" + escape(label);
+}
+
+std::string CSourceGenerator::generateCompUnitFile(CompUnitIR &cu, std::vector<size_t> &num_params) {
+    FunctionWriter writer {cu, annotate};
+    for (auto &func : cu.getFunctionList()) {
+        num_params.push_back(writer.write(*func));
+    }
+    std::string functions = writer.take();
+
+    // Declare what the unit uses from other files, sorted so the file is the same in every compile
+    std::string result = "#include \"joos.h\"\n\n";
+    for (auto &field : writer.static_fields) {
+        result += "extern int32_t " + identifier(field) + ";\n";
+    }
+    for (auto &label : writer.function_addresses) {
+        result += "extern const int32_t " + addressIdentifier(label) + ";\n";
+    }
+    for (auto &[label, num_args] : writer.called_functions) {
+        result += prototype(label, num_args);
+    }
+    for (size_t i = 0; i < cu.getFunctionList().size(); ++i) {
+        result += prototype(cu.getFunctionList()[i]->getName(), num_params[i]);
+    }
+    result += '\n';
+
+    return result + functions;
+}
+
+void CSourceGenerator::generateCode(std::vector<IR> &ir_trees, const std::string &entrypoint_method) {
+    // Reset output directory
+    std::filesystem::create_directories(output_directory);
+    for (auto &path : std::filesystem::directory_iterator(output_directory)) {
+        std::filesystem::remove_all(path);
+    }
+
+    ProgramUnits program = prepareProgramUnits(ir_trees);
+
+    std::ofstream header_file {output_directory / "joos.h", std::ios::binary};
+    header_file << RUNTIME_HEADER;
+
+    std::vector<std::vector<size_t>> num_params(program.comp_units.size());
+    pool.parallelFor(program.comp_units.size(), [&](size_t file_id) {
+        std::string code = generateCompUnitFile(*program.comp_units[file_id], num_params[file_id]);
+        std::ofstream output_file {output_directory / ("cu_" + std::to_string(file_id) + ".c"), std::ios::binary};
+        output_file.write(code.data(), code.size());
+    });
+
+    // Emit a main file with the static fields, the function table, the runtime and the entrypoint
+    std::ofstream main_file {output_directory / "main.c", std::ios::binary};
+    main_file << "#include <stdio.h>\n#include <stdlib.h>\n\n#include \"joos.h\"\n\n";
+
+    for (auto &field : program.static_fields) {
+        main_file << "int32_t " << identifier(field) << " = 0;\n";
+    }
+    main_file << '\n';
+
+    std::vector<FuncDeclIR*> functions;
+    size_t entrypoint_num_params = 0;
+    for (size_t file_id = 0; file_id < program.comp_units.size(); ++file_id) {
+        auto &function_list = program.comp_units[file_id]->getFunctionList();
+        for (size_t i = 0; i < function_list.size(); ++i) {
+            functions.push_back(function_list[i].get());
+            main_file << prototype(function_list[i]->getName(), num_params[file_id][i]);
+            if (function_list[i]->getName() == entrypoint_method) entrypoint_num_params = num_params[file_id][i];
+        }
+    }
+
+    // Native methods are in dispatch vectors too, so the library functions are in the table after the units' functions
+    std::vector<std::string> function_labels;
+    for (auto func : functions) {
+        function_labels.push_back(func->getName());
+    }
+    for (auto &[label, _] : LIBRARY_FUNCTIONS) {
+        function_labels.push_back(label);
+    }
+
+    main_file << "\nconst joos_function joos_functions[] = {\n";
+    for (auto &label : function_labels) {
+        main_file << "    (joos_function) " << identifier(label) << ",\n";
+    }
+    main_file << "};\n\n";
+    for (size_t i = 0; i < function_labels.size(); ++i) {
+        main_file << "const int32_t " << addressIdentifier(function_labels[i]) << " = " << i << ";\n";
+    }
+
+    main_file << RUNTIME << "\nint main(void) {\n";
+    for (auto &initializer : program.static_initializers) {
+        main_file << "    " << identifier(initializer) << "();\n";
+    }
+    for (auto &initializer : program.dispatch_vector_initializers) {
+        main_file << "    " << identifier(initializer) << "();\n";
+    }
+
+    // The entrypoint is static, so its `this` argument is unused
+    std::string arguments;
+    for (size_t i = 0; i < entrypoint_num_params; ++i) {
+        arguments += i == 0 ? "0" : ", 0";
+    }
+    main_file << "    return " << identifier(entrypoint_method) << "(" << arguments << ");\n}\n";
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "IR/ir.h"
+#include "utillities/thread_pool.h"
+
+// Generates portable C99 from the canonical IR, as a backend alongside AssemblyGenerator that gcc can optimize.
+//
+// Each compilation unit becomes cu_N.c: temporaries become locals of their function, labels and jumps become goto,
+// and MemIR becomes loads and stores of the program's memory. main.c holds the static fields, the table of every
+// function, the runtime (__malloc, __exception and nativeWrite) and main, which runs the static initializers,
+// dispatch vector setup and entrypoint as _start does. joos.h declares what the files share.
+//
+// Values and addresses are 32 bit ints, as in the assembly: an address is an offset into one block of memory that
+// __malloc grows, and a function's address is its index in the function table. Arithmetic wraps as on x86.
+class CSourceGenerator {
+    util::ThreadPool &pool;
+    std::filesystem::path output_directory;
+    bool annotate;
+
+    // The file for a compilation unit, adding the number of parameters of each of its functions to num_params
+    std::string generateCompUnitFile(CompUnitIR &cu, std::vector<size_t> &num_params);
+
+  public:
+    // Writes the C files to output_directory. If annotate is set, the IR's comments are kept as C comments.
+    explicit CSourceGenerator(util::ThreadPool &pool, std::filesystem::path output_directory = "output", bool annotate = false)
+        : pool{pool}, output_directory{std::move(output_directory)}, annotate{annotate} {}
+
+    void generateCode(std::vector<IR> &ir_trees, const std::string &entrypoint_method);
+
+    // The C identifier of a function or static field label
+    static std::string identifier(const std::string &label);
+};
@@ -58,7 +58,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(Assignment &expr) {
 
     convert_eseq_ir(dest);
 
-    auto src_temp = TempIR::generateName("assign_src");
+    auto src_temp = temp_names.generate("assign_src");
     seq_vec.push_back(MoveIR::makeStmt(
         TempIR::makeExpr(src_temp),
         std::move(src)
@@ -75,10 +75,10 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(Assignment &expr) {
     return eseq;
 }
 
-std::unique_ptr<ExpressionIR> handleShortCircuit(BinOpIR::OpType op, std::unique_ptr<ExpressionIR> e1, std::unique_ptr<ExpressionIR> e2) {
+std::unique_ptr<ExpressionIR> IRBuilderVisitor::handleShortCircuit(BinOpIR::OpType op, std::unique_ptr<ExpressionIR> e1, std::unique_ptr<ExpressionIR> e2) {
     switch (op) {
         case BinOpIR::AND: {
-            auto temp_name = TempIR::generateName("t_and");
+            auto temp_name = temp_names.generate("t_and");
             vector<unique_ptr<StatementIR>> seq_vec;
             // Move(t_and, e1)
             seq_vec.push_back(
@@ -88,8 +88,8 @@ std::unique_ptr<ExpressionIR> handleShortCircuit(BinOpIR::OpType op, std::unique
                 )
             );
             // CJump(e1 == 0, false, true)
-            auto true_name = LabelIR::generateName("sc_true");
-            auto false_name = LabelIR::generateName("sc_false");
+            auto true_name = label_names.generate("sc_true");
+            auto false_name = label_names.generate("sc_false");
             seq_vec.push_back(
                 CJumpIR::makeStmt(
                     BinOpIR::makeNegate(TempIR::makeExpr(temp_name)),
@@ -120,7 +120,7 @@ std::unique_ptr<ExpressionIR> handleShortCircuit(BinOpIR::OpType op, std::unique
             );
         }
         case BinOpIR::OR: {
-            auto temp_name = TempIR::generateName("t_or");
+            auto temp_name = temp_names.generate("t_or");
             vector<unique_ptr<StatementIR>> seq_vec;
             // Move(t_or, e1)
             seq_vec.push_back(
@@ -130,8 +130,8 @@ std::unique_ptr<ExpressionIR> handleShortCircuit(BinOpIR::OpType op, std::unique
                 )
             );
             // CJump(t_or, false, true)
-            auto true_name = LabelIR::generateName("sc_true");
-            auto false_name = LabelIR::generateName("sc_false");
+            auto true_name = label_names.generate("sc_true");
+            auto false_name = label_names.generate("sc_false");
             seq_vec.push_back(
                 CJumpIR::makeStmt(
                     TempIR::makeExpr(temp_name),
@@ -303,7 +303,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(CastExpression &expr) {
                 return expr;
             } else if ( auto str_ptr = get_if<string>(&lit) ) {
                 // Target non-primitive && source is a string
-                auto source_obj = Util::root_package->getJavaLangString();
+                auto source_obj = context.root_package->getJavaLangString();
                 if ( auto target_obj = expr.type->link.getIfIsClass() ) {
                     if ( source_obj == target_obj ) {
                         // Do nothing
@@ -312,7 +312,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(CastExpression &expr) {
                         // Upcasting
                         vector<unique_ptr<StatementIR>> seq_vec;
 
-                        string cast_result = TempIR::generateName("cast_result");
+                        TempId cast_result = temp_names.generate("cast_result");
                         // Move(cast_result, literal)
                         seq_vec.push_back(
                             MoveIR::makeStmt(
@@ -325,7 +325,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(CastExpression &expr) {
                         seq_vec.push_back(
                             MoveIR::makeStmt(
                                 MemIR::makeExpr(TempIR::makeExpr(cast_result)),
-                                TempIR::makeExpr(CGConstants::uniqueClassLabel(target_obj), true)
+                                TempIR::makeExpr(comp_unit.temps.get(CGConstants::uniqueClassLabel(target_obj)), true)
                             )
                         );
 
@@ -377,15 +377,15 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(Literal &expr) {
         string value = *lit;
 
         // Get the java.lang.String class
-        auto string_class = Util::root_package->getJavaLangString();
+        auto string_class = context.root_package->getJavaLangString();
         vector<unique_ptr<StatementIR>> seq_vec;
 
         // Get the dispatch vector of that class
-        DV string_dv = DVBuilder::getDV(string_class);
+        DV string_dv = context.dispatch_vectors.getDV(string_class);
         int num_fields = string_dv.field_vector.size();
 
         // Create the string reference, -> this will be returned as the result
-        std::string string_ref = TempIR::generateName("string_ref");
+        TempId string_ref = temp_names.generate("string_ref");
 
         // Allocate space for class -> point the string reference to the newly allocated memory
         seq_vec.push_back(
@@ -400,7 +400,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(Literal &expr) {
             MoveIR::makeStmt(
                 MemIR::makeExpr(TempIR::makeExpr(string_ref)),
                 // Location of dispatch vector
-                TempIR::makeExpr(CGConstants::uniqueClassLabel(string_class), true)
+                TempIR::makeExpr(comp_unit.temps.get(CGConstants::uniqueClassLabel(string_class)), true)
             )
         );
 
@@ -430,8 +430,9 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(Literal &expr) {
 
         // Get the zero arg constructor for the string class
         MethodDeclarationObject* string_constructor_no_arguments = nullptr;
+        // method_list also holds inherited constructors, whose order depends on allocation
         for ( auto &method : string_class->method_list ) {
-            if ( method->is_constructor && method->getParameters().size() == 0 ) {
+            if ( method->is_constructor && method->getParameters().size() == 0 && method->containing_type == string_class ) {
                 string_constructor_no_arguments = method;
                 break;
             }
@@ -457,7 +458,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(Literal &expr) {
         int fieldOffset = string_dv.getFieldOffset(field);
 
         // Create a reference to that part of memory
-        std::string chars_ref = TempIR::generateName("chars_ref");
+        TempId chars_ref = temp_names.generate("chars_ref");
         
         // Move nmemory location of chars into chars ref
         seq_vec.push_back(
@@ -490,7 +491,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(Literal &expr) {
         );
 
         // Attach array DV
-        auto array_obj = Util::root_package->getJavaUtilArrays();
+        auto array_obj = context.root_package->getJavaUtilArrays();
         seq_vec.push_back(
             // MEM(arr + 4) = DV for arrays
             MoveIR::makeStmt(
@@ -499,7 +500,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(Literal &expr) {
                     MemIR::makeExpr(TempIR::makeExpr(chars_ref)),
                     ConstIR::makeWords()
                 )),
-                TempIR::makeExpr(CGConstants::uniqueClassLabel(array_obj), true)
+                TempIR::makeExpr(comp_unit.temps.get(CGConstants::uniqueClassLabel(array_obj)), true)
             )
         );
 
@@ -548,11 +549,11 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ClassInstanceCreationExp
     auto constructor_obj = expr.called_constructor;
     std::string class_name = class_obj->full_qualified_name;
 
-    DV class_dv = DVBuilder::getDV(class_obj);
+    DV class_dv = context.dispatch_vectors.getDV(class_obj);
     int num_fields = class_dv.field_vector.size();
 
     vector<unique_ptr<StatementIR>> seq_vec;
-    std::string obj_ref = TempIR::generateName("obj_ref");
+    TempId obj_ref = temp_names.generate("obj_ref");
 
     // Allocate space for class
     seq_vec.push_back(
@@ -567,7 +568,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ClassInstanceCreationExp
         MoveIR::makeStmt(
             MemIR::makeExpr(TempIR::makeExpr(obj_ref)),
             // Location of dispatch vector
-            TempIR::makeExpr(CGConstants::uniqueClassLabel(class_obj), true)
+            TempIR::makeExpr(comp_unit.temps.get(CGConstants::uniqueClassLabel(class_obj)), true)
         )
     );
 
@@ -602,7 +603,8 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ClassInstanceCreationExp
             if ( superclass_obj != class_obj ) {
                 // Is not the same class as obj
                 for ( auto &method : superclass_obj->method_list ) {
-                    if ( method->is_constructor && method->getParameters().size() == 0 ) {
+                    // Skip inherited constructors; they are called for their own class
+                    if ( method->is_constructor && method->getParameters().size() == 0 && method->containing_type == superclass_obj ) {
                         // Call default constructor
                         seq_vec.push_back(
                             ExpIR::makeStmt(
@@ -648,20 +650,20 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ClassInstanceCreationExp
 std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(FieldAccess &expr) {
     assert(expr.expression);
     assert(expr.identifier);
-    auto accessed_obj_type = TypeChecker::getLink(*expr.expression);
+    auto accessed_obj_type = TypeChecker::getLink(*expr.expression, context.root_package);
 
     // Special case: array length field
     if (accessed_obj_type.is_array && expr.identifier->name == "length") {
         // Get array
-        string array_name = TempIR::generateName("array");
+        TempId array_name = temp_names.generate("array");
         auto get_array = MoveIR::makeStmt(
             TempIR::makeExpr(array_name),
             std::move(convert(*expr.expression))
         );
 
         // Non-null check
-        string error_name = LabelIR::generateName("error");
-        string non_null_name = LabelIR::generateName("nonnull");
+        LabelId error_name = label_names.generate("error");
+        LabelId non_null_name = label_names.generate("nonnull");
         auto non_null_check = CJumpIR::makeStmt(
             // NEQ(t_a, 0)
             BinOpIR::makeExpr(
@@ -716,7 +718,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(FieldAccess &expr) {
         auto class_obj = expr.type_accessed_on.getIfIsClass();
         assert(class_obj);
 
-        DV class_dv = DVBuilder::getDV(class_obj);
+        DV class_dv = context.dispatch_vectors.getDV(class_obj);
         int field_offset = class_dv.getFieldOffset(field_obj);
 
         return MemIR::makeExpr(
@@ -749,19 +751,19 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(MethodInvocation &expr)
         );
     } else {
         // Instance method invoked
-        string this_name;
+        TempId this_name;
         unique_ptr<StatementIR> stmt = nullptr;
 
         if ( expr.parent_expr ) {
             // If there is a parent_expr, define a stmt to move into Temp
-            this_name = TempIR::generateName("this");
+            this_name = temp_names.generate("this");
             stmt = MoveIR::makeStmt(
                 TempIR::makeExpr(this_name),
                 convert(*expr.parent_expr)
             );
         } else {
             // Else simply use "this"
-            this_name = "this";
+            this_name = comp_unit.temps.get("this");
         }
 
         // Define return expr based on `this_name`
@@ -777,7 +779,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(MethodInvocation &expr)
                         ),
                         BinOpIR::makeExpr(
                             BinOpIR::MUL,
-                            ConstIR::makeExpr(DVBuilder::getAssignment(expr.called_method)),
+                            ConstIR::makeExpr(context.dispatch_vectors.getAssignment(expr.called_method)),
                             ConstIR::makeWords()
                         )
                     )
@@ -804,15 +806,15 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ArrayAccess &expr) {
     assert(expr.selector);
 
     // Get array in temp
-    string array_name = TempIR::generateName("array");
+    TempId array_name = temp_names.generate("array");
     auto get_array = MoveIR::makeStmt(
         TempIR::makeExpr(array_name),
         std::move(convert(*expr.array))
     );
 
     // Non-null check
-    string error_name = LabelIR::generateName("error");
-    string non_null_name = LabelIR::generateName("nonnull");
+    LabelId error_name = label_names.generate("error");
+    LabelId non_null_name = label_names.generate("nonnull");
     auto non_null_check = CJumpIR::makeStmt(
         // NEQ(t_a, 0)
         BinOpIR::makeExpr(
@@ -830,14 +832,14 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ArrayAccess &expr) {
 
     // Non-null
     auto non_null_label = LabelIR::makeStmt(non_null_name);
-    string selector_name = TempIR::generateName("selector");
+    TempId selector_name = temp_names.generate("selector");
     auto get_selector = MoveIR::makeStmt(
         TempIR::makeExpr(selector_name),
         std::move(convert(*expr.selector))
     );
 
     // Bounds check
-    auto inbound_name = LabelIR::generateName("inbounds");
+    auto inbound_name = label_names.generate("inbounds");
     auto bounds_check = CJumpIR::makeStmt(
         // t_i < 0 || t_i >= mem(t_a - 4)
         BinOpIR::makeExpr(
@@ -907,19 +909,19 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ArrayAccess &expr) {
 }
 
 std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(QualifiedThis &expr) {
-    return TempIR::makeExpr("this");
+    return TempIR::makeExpr(comp_unit.temps.get("this"));
 }
 
 std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ArrayCreationExpression &expr) {
     assert(expr.type);
     assert(expr.expression);
 
-    auto array_obj = Util::root_package->getJavaUtilArrays();
+    auto array_obj = context.root_package->getJavaUtilArrays();
 
     vector<unique_ptr<StatementIR>> seq_vec;
 
     // Get inner expression
-    auto size_name = TempIR::generateName("size");
+    auto size_name = temp_names.generate("size");
     seq_vec.push_back(
         MoveIR::makeStmt(
             TempIR::makeExpr(size_name),
@@ -928,8 +930,8 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ArrayCreationExpression
     );
 
     // Check non-negative
-    auto error_name = LabelIR::generateName("error");
-    auto non_negative_name = LabelIR::generateName("nonneg");
+    auto error_name = label_names.generate("error");
+    auto non_negative_name = label_names.generate("nonneg");
     seq_vec.push_back(
         CJumpIR::makeStmt(
             // t_e >= 0
@@ -950,7 +952,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ArrayCreationExpression
     ));
 
     // Allocate space
-    auto array_name = TempIR::generateName("array");
+    auto array_name = temp_names.generate("array");
     seq_vec.push_back(LabelIR::makeStmt(non_negative_name));
     seq_vec.push_back(
         MoveIR::makeStmt(
@@ -989,15 +991,15 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ArrayCreationExpression
                     ConstIR::makeWords()
                 )
             ),
-            TempIR::makeExpr(CGConstants::uniqueClassLabel(array_obj), true)
+            TempIR::makeExpr(comp_unit.temps.get(CGConstants::uniqueClassLabel(array_obj)), true)
         )
     );
 
     // Zero initialize array (loop)
-    auto iterator_name = TempIR::generateName("iter");
-    auto start_loop = LabelIR::generateName("start_loop");
-    auto exit_loop = LabelIR::generateName("exit_loop");
-    auto dummy_name = LabelIR::generateName("dummy");
+    auto iterator_name = temp_names.generate("iter");
+    auto start_loop = label_names.generate("start_loop");
+    auto exit_loop = label_names.generate("exit_loop");
+    auto dummy_name = label_names.generate("dummy");
 
     seq_vec.push_back(
         // Move(t_i, 0)
@@ -1060,9 +1062,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(ArrayCreationExpression
     );
     seq_vec.push_back(
         // Jump to start_loop
-        JumpIR::makeStmt(
-            NameIR::makeExpr(start_loop)
-        )
+        JumpIR::makeStmt(start_loop)
     );
     seq_vec.push_back(
         // exit_loop:
@@ -1094,15 +1094,15 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(QualifiedIdentifier &exp
         auto qid_before_length = expr.getQualifiedIdentifierWithoutLast();
 
         // Get array
-        string array_name = TempIR::generateName("array");
+        TempId array_name = temp_names.generate("array");
         auto get_array = MoveIR::makeStmt(
             TempIR::makeExpr(array_name),
             std::move(convert(qid_before_length))
         );
 
         // Non-null check
-        string error_name = LabelIR::generateName("error");
-        string non_null_name = LabelIR::generateName("nonnull");
+        LabelId error_name = label_names.generate("error");
+        LabelId non_null_name = label_names.generate("nonnull");
         auto non_null_check = CJumpIR::makeStmt(
             // NEQ(t_a, 0)
             BinOpIR::makeExpr(
@@ -1146,19 +1146,19 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(QualifiedIdentifier &exp
 
     // Local variable access
     if (auto variable = expr.getIfRefersToLocalVariable()) {
-        auto name = CGConstants::uniqueLocalVariableLabel(variable);
+        auto name = local_temps.localVariableTemp(variable);
         return TempIR::makeExpr(name);
     }
 
     // Parameter access
     if (auto parameter = expr.getIfRefersToParameter()) {
-        auto name = CGConstants::uniqueParameterLabel(parameter);
+        auto name = local_temps.parameterTemp(parameter);
         return TempIR::makeExpr(name);
     }
     
     // Static field access
     if (expr.getIfRefersToField() && expr.getIfRefersToField()->ast_reference->hasModifier(Modifier::STATIC)) {
-        auto name = CGConstants::uniqueStaticFieldLabel(expr.getIfRefersToField());
+        auto name = comp_unit.temps.get(CGConstants::uniqueStaticFieldLabel(expr.getIfRefersToField()));
         return TempIR::makeExpr(name, true);
     }
 
@@ -1166,13 +1166,13 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(QualifiedIdentifier &exp
     if (auto field = expr.getIfRefersToField()) {
         if ( expr.isSimple() ) {
             // Get local field
-            DV class_dv = DVBuilder::getDV(current_class);
+            DV class_dv = context.dispatch_vectors.getDV(current_class);
             int field_offset = class_dv.getFieldOffset(field);
 
             return MemIR::makeExpr(
                 BinOpIR::makeExpr(
                     BinOpIR::ADD,
-                    TempIR::makeExpr("this"),
+                    TempIR::makeExpr(comp_unit.temps.get("this")),
                     ConstIR::makeExpr(4*(field_offset + 1))
                 )
             );
@@ -1181,18 +1181,18 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(QualifiedIdentifier &exp
             unique_ptr<ExpressionIR> obj;
             LinkedType type;
             if ( auto prefix = expr.getQualifiedIdentifierWithoutLast().getIfRefersToLocalVariable() ) {
-                obj = TempIR::makeExpr(CGConstants::uniqueLocalVariableLabel(prefix));
+                obj = TempIR::makeExpr(local_temps.localVariableTemp(prefix));
                 type = prefix->type;
             } else if ( auto prefix = expr.getQualifiedIdentifierWithoutLast().getIfRefersToParameter() ) {
-                obj = TempIR::makeExpr(CGConstants::uniqueParameterLabel(prefix));
+                obj = TempIR::makeExpr(local_temps.parameterTemp(prefix));
                 type = prefix->type;
             } else if ( auto prefix = expr.getQualifiedIdentifierWithoutLast().getIfRefersToField() ) {
-                obj = TempIR::makeExpr(CGConstants::uniqueFieldLabel(prefix));
+                obj = TempIR::makeExpr(comp_unit.temps.get(CGConstants::uniqueFieldLabel(prefix)));
                 type = prefix->type;
             }
 
             if ( auto class_obj = type.getIfIsClass() ) {
-                DV class_dv = DVBuilder::getDV(class_obj);
+                DV class_dv = context.dispatch_vectors.getDV(class_obj);
                 int field_offset = class_dv.getFieldOffset(field);
 
                 return MemIR::makeExpr(
@@ -1219,7 +1219,7 @@ std::unique_ptr<ExpressionIR> IRBuilderVisitor::convert(InstanceOfExpression &ex
     if ( !expr.expression ) { return ConstIR::makeZero(); }
 
     if ( auto target_class = expr.type->link.getIfIsClass() ) {
-        auto source_link = TypeChecker::getLink(*expr.expression);
+        auto source_link = TypeChecker::getLink(*expr.expression, context.root_package);
         if ( auto source_class = source_link.getIfNonArrayIsClass() ) {
             if ( source_class->isRelativeTo(target_class) ) {
                 return BinOpIR::makeExpr(
@@ -1255,8 +1255,8 @@ std::unique_ptr<StatementIR> IRBuilderVisitor::convert(IfThenStatement &stmt) {
     assert(stmt.if_clause);
     assert(stmt.then_clause);
 
-    auto if_true = LabelIR::generateName("if_true");
-    auto if_exit = LabelIR::generateName("if_exit");
+    auto if_true = label_names.generate("if_true");
+    auto if_exit = label_names.generate("if_exit");
    
     vector<unique_ptr<StatementIR>> seq_vec;
     // CJump(expr == 0, exit, true)
@@ -1293,9 +1293,9 @@ std::unique_ptr<StatementIR> IRBuilderVisitor::convert(IfThenElseStatement &stmt
     assert(stmt.then_clause);
     assert(stmt.else_clause);
 
-    auto if_true = LabelIR::generateName("if_true");
-    auto if_false = LabelIR::generateName("if_false");
-    auto if_exit = LabelIR::generateName("if_exit");
+    auto if_true = label_names.generate("if_true");
+    auto if_false = label_names.generate("if_false");
+    auto if_exit = label_names.generate("if_exit");
    
     vector<unique_ptr<StatementIR>> seq_vec;
     // CJump(expr == 0, false, true)
@@ -1321,7 +1321,7 @@ std::unique_ptr<StatementIR> IRBuilderVisitor::convert(IfThenElseStatement &stmt
 
     // jump to exit
     seq_vec.push_back(
-        JumpIR::makeStmt(NameIR::makeExpr(if_exit))
+        JumpIR::makeStmt(if_exit)
     );
 
     // if_false:
@@ -1349,9 +1349,9 @@ std::unique_ptr<StatementIR> IRBuilderVisitor::convert(WhileStatement &stmt) {
     assert(stmt.body_statement);
 
     vector<unique_ptr<StatementIR>> seq_vec;
-    auto while_start = LabelIR::generateName("while_start");
-    auto while_true = LabelIR::generateName("while_true");
-    auto while_exit = LabelIR::generateName("while_exit");
+    auto while_start = label_names.generate("while_start");
+    auto while_true = label_names.generate("while_true");
+    auto while_exit = label_names.generate("while_exit");
 
     // while_start:
     seq_vec.push_back(
@@ -1381,7 +1381,7 @@ std::unique_ptr<StatementIR> IRBuilderVisitor::convert(WhileStatement &stmt) {
 
     // Jump to while_start
     seq_vec.push_back(
-        JumpIR::makeStmt(NameIR::makeExpr(while_start))
+        JumpIR::makeStmt(while_start)
     );
 
     // while_exit:
@@ -1397,9 +1397,9 @@ std::unique_ptr<StatementIR> IRBuilderVisitor::convert(ForStatement &stmt) {
     assert(stmt.body_statement);
 
     vector<unique_ptr<StatementIR>> seq_vec;
-    auto for_start = LabelIR::generateName("for_start");
-    auto for_true = LabelIR::generateName("for_true");
-    auto for_exit = LabelIR::generateName("for_exit");
+    auto for_start = label_names.generate("for_start");
+    auto for_true = label_names.generate("for_true");
+    auto for_exit = label_names.generate("for_exit");
 
     // Init statement
     if (stmt.init_statement) {
@@ -1443,7 +1443,7 @@ std::unique_ptr<StatementIR> IRBuilderVisitor::convert(ForStatement &stmt) {
 
     // Jump to start
     seq_vec.push_back(
-        JumpIR::makeStmt(NameIR::makeExpr(for_start))
+        JumpIR::makeStmt(for_start)
     );
 
     // for_exit:
@@ -1498,7 +1498,7 @@ std::unique_ptr<StatementIR> IRBuilderVisitor::convert(LocalVariableDeclaration
 
     vector<unique_ptr<StatementIR>> seq_vec;
     //auto var_name = stmt.variable_declarator->variable_name->name;
-    auto var_name = CGConstants::uniqueLocalVariableLabel(stmt.environment);
+    auto var_name = local_temps.localVariableTemp(stmt.environment);
 
     // Move(var, rhs)
     #warning This will overwrite a previous LVD (should have some kind of stack)
@@ -1517,7 +1517,9 @@ void IRBuilderVisitor::operator()(ClassDeclaration &node) {
     comp_unit = {node.environment->identifier};
 
     auto class_obj = node.environment;
-    auto class_dv = DVBuilder::getDV(class_obj);
+    comp_unit.static_init_label = CGConstants::uniqueStaticInitLabel(class_obj);
+    comp_unit.dispatch_vector_init_label = CGConstants::uniqueDispatchVectorInitLabel(class_obj);
+    auto class_dv = context.dispatch_vectors.getDV(class_obj);
     
     // Malloc memory for dispatch vector
     comp_unit.appendField(
@@ -1536,10 +1538,10 @@ void IRBuilderVisitor::operator()(ClassDeclaration &node) {
                     MemIR::makeExpr(
                         BinOpIR::makeExpr(
                             BinOpIR::ADD,
-                            TempIR::makeExpr(CGConstants::uniqueClassLabel(class_obj), true),
+                            TempIR::makeExpr(comp_unit.temps.get(CGConstants::uniqueClassLabel(class_obj)), true),
                             BinOpIR::makeExpr(
                                 BinOpIR::MUL,
-                                ConstIR::makeExpr(DVBuilder::getAssignment(method)),
+                                ConstIR::makeExpr(context.dispatch_vectors.getAssignment(method)),
                                 ConstIR::makeWords()
                             )
                         )
@@ -1590,19 +1592,19 @@ void IRBuilderVisitor::operator()(MethodDeclaration &node) {
     int arg_num = 0;
 
     // Load `this` arg
-    auto abstract_arg_name = CGConstants::ABSTRACT_ARG_PREFIX + to_string(arg_num++);
+    auto abstract_arg_name = comp_unit.temps.get(CGConstants::ABSTRACT_ARG_PREFIX, arg_num++);
 
     load_args.push_back(
         MoveIR::makeStmt(
-            TempIR::makeExpr("this"),
+            TempIR::makeExpr(comp_unit.temps.get("this")),
             TempIR::makeExpr(abstract_arg_name)
         )
     );
 
     // Move each value in abstract argument register from caller into parameter temp
     for ( auto &param : node.parameters ) {
-        auto param_name = CGConstants::uniqueParameterLabel(param.environment);
-        auto abstract_arg_name = CGConstants::ABSTRACT_ARG_PREFIX + to_string(arg_num++);
+        auto param_name = local_temps.parameterTemp(param.environment);
+        auto abstract_arg_name = comp_unit.temps.get(CGConstants::ABSTRACT_ARG_PREFIX, arg_num++);
 
         load_args.push_back(
             MoveIR::makeStmt(
@@ -1,14 +1,28 @@
 #pragma once
 
 #include "IR/comp-unit/comp-unit.h"
+#include "IR/ir.h"
+#include "IR/code-gen-constants.h"
+#include "IR/name-generator.h"
+#include "compiler/compilation-context.h"
 #include "environment-builder/symboltableentry.h"
 #include "variant-ast/astnode.h"
 #include "variant-ast/astvisitor/defaultskipvisitor.h"
 
+// Builds the IR of one compilation unit; use a new visitor for each unit
 class IRBuilderVisitor : public DefaultSkipVisitor<CompUnitIR> {
+    CompilationContext &context;
     CompUnitIR comp_unit;
     ClassDeclarationObject* current_class;
 
+    // Temporaries, labels and locals are numbered per compilation unit, so the IR of a unit
+    // does not depend on which units were built before it
+    NameGenerator temp_names {comp_unit.temps, "temp"};
+    NameGenerator label_names {comp_unit.labels, "label"};
+    LocalTemps local_temps {comp_unit.temps};
+
+    std::unique_ptr<ExpressionIR> handleShortCircuit(BinOpIR::OpType op, std::unique_ptr<ExpressionIR> e1, std::unique_ptr<ExpressionIR> e2);
+
     // Statement converters
     std::unique_ptr<StatementIR> convert(Statement &stmt);
     std::unique_ptr<StatementIR> convert(IfThenStatement &stmt);
@@ -47,7 +61,7 @@ public:
     // void operator()(InterfaceDeclaration &node) override;
     void operator()(FieldDeclaration &node) override;
 
-    IRBuilderVisitor() : comp_unit{""} {}
+    explicit IRBuilderVisitor(CompilationContext &context) : context{context}, comp_unit{""} {}
 
     CompUnitIR visit(AstNodeVariant &ast) override {
         std::visit(*this, ast);
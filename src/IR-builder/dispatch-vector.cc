@@ -29,18 +29,37 @@ void DVBuilder::addMethodsToGraph(std::set<MethodDeclarationObject*> &method_lis
     }
 }
 
+// Key that orders methods the same way on every run, unlike their addresses
+static std::string signatureKey(MethodDeclarationObject* method) {
+    std::string key = method->full_qualified_name + "(";
+    for ( auto parameter : method->getParameters() ) {
+        auto &type = parameter->type;
+        if ( auto cls = type.getIfNonArrayIsClass() ) {
+            key += cls->full_qualified_name + (type.is_array ? "[]," : ",");
+        } else if ( auto ifc = type.getIfNonArrayIsInterface() ) {
+            key += ifc->full_qualified_name + (type.is_array ? "[]," : ",");
+        } else {
+            key += type.toSimpleString() + ",";
+        }
+    }
+    return key + ")";
+}
+
 void DVBuilder::assignColours() {
-    auto firstVertex = graph.neighbours.begin()->first;
-    graph.colour[firstVertex] = 1;
+    // Colour in signature order, so the dispatch vectors do not depend on allocation order
+    // (ASTs are allocated on several threads)
+    std::vector<std::pair<std::string, MethodDeclarationObject*>> vertices;
+    for ( auto& vertex : graph.neighbours ) {
+        vertices.push_back({signatureKey(vertex.first), vertex.first});
+    }
+    std::sort(vertices.begin(), vertices.end());
 
     std::unordered_set<int> availableColors;
 
-    for (auto& vertex : graph.neighbours) {
-        if (vertex.first == firstVertex) continue; 
-
+    for (auto& [key, vertex] : vertices) {
         availableColors.clear();
 
-        for (auto& adjacent : graph.neighbours[vertex.first]) {
+        for (auto& adjacent : graph.neighbours[vertex]) {
             if (graph.colour[adjacent] != 0) {
                 availableColors.insert(graph.colour[adjacent]);
             }
@@ -51,7 +70,7 @@ void DVBuilder::assignColours() {
             currentColor++;
         }
 
-        graph.colour[vertex.first] = currentColor;
+        graph.colour[vertex] = currentColor;
     }
 }
 
@@ -85,11 +104,11 @@ void DVBuilder::operator()(InterfaceDeclaration &node) {
     addMethodsToGraph(node.environment->method_list);
 }
 
-DV::DV(ClassDeclarationObject* class_obj) {
+DV::DV(DVBuilder &builder, ClassDeclarationObject* class_obj) {
     auto parent_class = class_obj->extended;
     if ( parent_class ) {
         // parent classes
-        auto parent_dv = DVBuilder::getDV(class_obj->extended);
+        auto parent_dv = builder.getDV(class_obj->extended);
         field_vector = parent_dv.field_vector;
     } else {
         // java.lang.Object
@@ -105,14 +124,14 @@ DV::DV(ClassDeclarationObject* class_obj) {
     int max_colour = 0;
     for ( auto method : class_obj->method_list ) {
         if ( method->is_constructor ) { continue; }
-        int colour = DVBuilder::getAssignment(method);
+        int colour = builder.getAssignment(method);
         max_colour = std::max(colour, max_colour);
     }
 
     dispatch_vector.resize(max_colour + 1, nullptr);
     for ( auto method : class_obj->method_list ) {
         if ( method->is_constructor ) { continue; }
-        int colour = DVBuilder::getAssignment(method);
+        int colour = builder.getAssignment(method);
         dispatch_vector[colour] = method;
     }
 }
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "environment-builder/symboltableentry.h"
 #include "exceptions/exceptions.h"
 #include "utillities/util.h"
@@ -7,46 +9,52 @@
 #include <unordered_map>
 #include <variant>
 
+class DVBuilder;
+
 class DV {
     DV() = default; // deletes default constructor
 public:
     std::vector<MethodDeclarationObject*> dispatch_vector;
     std::vector<FieldDeclarationObject*> field_vector;
     int getFieldOffset(FieldDeclarationObject * field);
-    DV(ClassDeclarationObject* class_obj);
+    DV(DVBuilder &builder, ClassDeclarationObject* class_obj);
 };
 
+// Builds the dispatch vectors of one program: visit every AST with the same builder, then assign colours
 class DVBuilder : DefaultSkipVisitor<void>{
     // Graph
-    static inline struct Graph {
+    struct Graph {
         // Neighbours
         size_t min_colours;
         std::set<MethodDeclarationObject*> methods;
         std::unordered_map<MethodDeclarationObject*, std::set<MethodDeclarationObject*>> neighbours;
         std::unordered_map<MethodDeclarationObject*, int> colour;
-    } graph;
+    } graph {};
 
     void addMethodsToGraph(std::set<MethodDeclarationObject*> &method_list);
-    static inline std::unordered_map<ClassDeclarationObject*, std::unique_ptr<DV>> class_dvs;
+    std::unordered_map<ClassDeclarationObject*, std::unique_ptr<DV>> class_dvs;
 public:
     using DefaultSkipVisitor<void>::operator();
 
+    // Start from the methods already added to another builder, e.g. those of an analysed library
+    void copyGraph(const DVBuilder &other) { graph = other.graph; }
+
     // Colouring functions
-    static void assignColours();
-    static void resetColours();
-    static void assertColoured();
+    void assignColours();
+    void resetColours();
+    void assertColoured();
 
     // Method assignment getter (returns colour)
-    static int getAssignment(MethodDeclarationObject* method) {
+    int getAssignment(MethodDeclarationObject* method) {
         assert(graph.methods.find(method) != graph.methods.end()); // Assert method exists in graph
         int colour = graph.colour[method];
         assert(colour > 0); // Assert assigned colour
         return colour;
     }
 
-    static DV getDV(ClassDeclarationObject* class_obj) {
+    DV getDV(ClassDeclarationObject* class_obj) {
         if ( class_dvs.find(class_obj) == class_dvs.end() ) {
-            class_dvs.insert({class_obj, std::make_unique<DV>(class_obj)});
+            class_dvs.insert({class_obj, std::make_unique<DV>(*this, class_obj)});
         }
         return *class_dvs.at(class_obj);
     }
@@ -61,11 +69,14 @@ public:
 };
 
 class PrintDVS : public DefaultSkipVisitor<void> {
+    DVBuilder &dispatch_vectors;
 public:
     using DefaultSkipVisitor<void>::operator();
 
+    explicit PrintDVS(DVBuilder &dispatch_vectors) : dispatch_vectors{dispatch_vectors} {}
+
     void operator()(ClassDeclaration &node) override {
-        auto dv = DVBuilder::getDV(node.environment);
+        auto dv = dispatch_vectors.getDV(node.environment);
         std::cout << "==== " << node.environment->identifier << " ====" << std::endl;
         int i = 0;
         for ( auto method : dv.dispatch_vector ) {
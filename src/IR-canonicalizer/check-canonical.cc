@@ -94,7 +94,7 @@ void CanonicalChecker::check(StatementIR &ir) {
             } else {
                 auto& next_stmt = current_body->at(current_statement+1);
                 if (auto next_stmt_as_label = std::get_if<LabelIR>(next_stmt.get())) {
-                    if (next_stmt_as_label->getName() != cJumpFalseLabel)
+                    if (next_stmt_as_label->getId() != cJumpFalseLabel)
                         notCanonicalBecause("Statement after CJumpIR is not false label");
                 } else {
                     notCanonicalBecause("Statement after CJumpIR is not a label");
@@ -106,9 +106,7 @@ void CanonicalChecker::check(StatementIR &ir) {
             notCanonicalBecause("ExpIR should not exist in canonical form");
         },
 
-        [&](JumpIR &node) {
-            check(node.getTarget());
-        },
+        [&](JumpIR &node) {},
 
         [&](LabelIR &node) {},
 
@@ -23,6 +23,9 @@ IRCanonicalizer::LoweredStatement IRCanonicalizer::operator()(StatementIR &ir) {
 void IRCanonicalizer::convert(IR &ir) {
     std::visit(util::overload {
         [&](CompUnitIR &node) {
+            temps = &node.temps;
+            temp_names.emplace(node.temps, "temp");
+
             for (auto& func : node.getFunctionList()) {
                 func->getBody() = SeqIR(convert(func->getBody()).statements);
             }
@@ -37,7 +40,7 @@ void IRCanonicalizer::convert(IR &ir) {
 
                 std::vector<StatementIR> initializer_statements = concatenate(
                     lowered.statements,
-                    MoveIR(std::make_unique<ExpressionIR>(TempIR(static_field_name, true)), std::move(lowered.expression))
+                    MoveIR(std::make_unique<ExpressionIR>(TempIR(temps->get(static_field_name), true)), std::move(lowered.expression))
                 );
 
                 child_canonical_static_fields.emplace_back(
@@ -58,7 +61,7 @@ IRCanonicalizer::LoweredExpression IRCanonicalizer::convert(ExpressionIR &ir) {
             LoweredExpression lowered1 = convert(node.getLeft());
             LoweredExpression lowered2 = convert(node.getRight());
             
-            std::string temp_name = TempIR::generateName();
+            TempId temp_name = temp_names->generate();
 
             auto statements = concatenate(
                 lowered1.statements,
@@ -77,7 +80,7 @@ IRCanonicalizer::LoweredExpression IRCanonicalizer::convert(ExpressionIR &ir) {
             std::vector<std::unique_ptr<ExpressionIR>> arg_temporaries;
 
             for (auto& arg : node.getArgs()) {
-                auto temporary = TempIR(TempIR::generateName(ARG_TEMPORARY_PREFIX));
+                auto temporary = TempIR(temp_names->generate(ARG_TEMPORARY_PREFIX));
                 arg_temporaries.push_back(std::make_unique<ExpressionIR>(temporary));
 
                 auto lowered = convert(*arg);
@@ -103,7 +106,7 @@ IRCanonicalizer::LoweredExpression IRCanonicalizer::convert(ExpressionIR &ir) {
                 );
             }
             
-            result.expression = std::make_unique<ExpressionIR>(TempIR(CGConstants::ABSTRACT_RET));
+            result.expression = std::make_unique<ExpressionIR>(TempIR(temps->get(CGConstants::ABSTRACT_RET)));
 
             return result;
         },
@@ -168,12 +171,8 @@ IRCanonicalizer::LoweredStatement IRCanonicalizer::convert(StatementIR &ir) {
         },
 
         [&](JumpIR &node) {
-            LoweredExpression lowered_target = convert(node.getTarget());
-
-            return LoweredStatement(concatenate(
-                lowered_target.statements,
-                JumpIR(std::move(lowered_target.expression))
-            ));
+            // Leave alone
+            return LoweredStatement(std::move(node));
         },
 
         [&](LabelIR &node) {
@@ -198,7 +197,7 @@ IRCanonicalizer::LoweredStatement IRCanonicalizer::convert(StatementIR &ir) {
                 // LoweredExpression lowered1 = convert(node.getTarget());
                 LoweredExpression lowered2 = convert(node.getSource());
             
-                std::string temp_name = TempIR::generateName();
+                TempId temp_name = temp_names->generate();
 
                 auto mem = MemIR(std::make_unique<ExpressionIR>(TempIR(temp_name)));
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "IR/ir.h"
+#include "IR/name-generator.h"
+#include <optional>
 #include <vector>
 #include <memory>
 #include <string>
@@ -36,6 +38,11 @@ class IRCanonicalizer {
 
     static inline std::string ARG_TEMPORARY_PREFIX = "CANON_ARG";
 
+    // Use one canonicalizer per compilation unit; the prefixes used here never clash with the IR builder's.
+    // Set when the compilation unit is reached, since its temporaries are generated in its name table
+    IRNameTable *temps = nullptr;
+    std::optional<NameGenerator> temp_names;
+
   public:
     void operator()(IR&);
     void convert(IR&);
@@ -9,7 +9,12 @@ void IRJavaConverter::appendToResult(std::string s) {
     result += getNewlineAndTabString() + s;
 }
 
+std::string IRJavaConverter::labelName(LabelId label) {
+    return label == NO_LABEL ? "" : comp_unit->labels.name(label);
+}
+
 void IRJavaConverter::operator()(CompUnitIR &node) {
+    comp_unit = &node;
     result += "package joosc.ir.interpret;\nimport joosc.ir.ast.*;\nimport joosc.ir.visit.CheckCanonicalIRVisitor;\n\n";
     result += "public class " + class_name + " {";
     num_tabs += 1;
@@ -117,7 +122,7 @@ void IRJavaConverter::operator()(NameIR &node) {
 
 void IRJavaConverter::operator()(TempIR &node) {
     num_tabs += 1;
-    appendToResult("new Temp(\"" + node.getName() + "\")");
+    appendToResult("new Temp(\"" + comp_unit->temps.name(node.getId()) + "\")");
     num_tabs -= 1;
 }
 
@@ -125,7 +130,7 @@ void IRJavaConverter::operator()(CJumpIR &node) {
     num_tabs += 1;
     appendToResult("new CJump(");
     visit_children(node.getCondition());
-    result += ", \"" + node.trueLabel() + "\", \"" + node.falseLabel() + "\")";
+    result += ", \"" + labelName(node.trueLabel()) + "\", \"" + labelName(node.falseLabel()) + "\")";
     num_tabs -= 1;
 }
 
@@ -140,14 +145,16 @@ void IRJavaConverter::operator()(ExpIR &node) {
 void IRJavaConverter::operator()(JumpIR &node) {
     num_tabs += 1;
     appendToResult("new Jump(");
-    visit_children(node.getTarget());
+    num_tabs += 1;
+    appendToResult("new Name(\"" + labelName(node.getTarget()) + "\")");
+    num_tabs -= 1;
     appendToResult(")");
     num_tabs -= 1;
 }
 
 void IRJavaConverter::operator()(LabelIR &node) {
     num_tabs += 1;
-    appendToResult("new Label(\"" + node.getName() + "\")");
+    appendToResult("new Label(\"" + labelName(node.getId()) + "\")");
     num_tabs -=1;
 }
 
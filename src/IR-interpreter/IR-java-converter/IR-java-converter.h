@@ -23,6 +23,12 @@ class IRJavaConverter : public IRSkipVisitor {
     // Number of tabs to produce on current line when outputted to result
     int num_tabs;
 
+    // The compilation unit being converted, which names its temporaries and labels
+    CompUnitIR *comp_unit = nullptr;
+
+    // Name of the label, or an empty name for an absent label
+    std::string labelName(LabelId label);
+
     // Get a string of num_tabs concatenated
     std::string getTabString();
 
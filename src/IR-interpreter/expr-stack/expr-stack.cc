@@ -25,7 +25,7 @@ void ExprStack::pushAddr(int value, int addr) {
     stack.push(StackItem(value, addr));
 }
 
-void ExprStack::pushTemp(int value, std::string temp) {
+void ExprStack::pushTemp(int value, TempId temp) {
     if(debugLevel > 1) {
         std::cout << "Pushing TEMP " << value << " (" << temp << ")" << std::endl;
     }
@@ -4,38 +4,43 @@
 #include <string>
 #include <variant>
 #include <cstdint> 
+#include <algorithm>
 #include "exceptions/exceptions.h"
-#include "utillities/overload.h"
 
 #include "IR/code-gen-constants.h"
 
 int WORD_SIZE = 4;
 
 
-Simulator::ExecutionFrame::ExecutionFrame(int ip, Simulator& parent) : ip(ip), parent(parent) {
+Simulator::ExecutionFrame::ExecutionFrame(const FlatIR *body, int ip, Simulator& parent) : ip(ip), parent(parent), body(body) {
     ret = rand();
 }
 
-int Simulator::ExecutionFrame::get(std::string tempName) {
-    if (regs.find(tempName) == regs.end()) {
-        put(tempName, rand());
+int Simulator::ExecutionFrame::get(TempId temp) {
+    if (temp >= assigned.size() || !assigned[temp]) {
+        put(temp, rand());
     }
 
-    return regs[tempName];
+    return regs[temp];
 }
 
-void Simulator::ExecutionFrame::put(std::string tempName, int value) {
-    regs[tempName] = value;
+void Simulator::ExecutionFrame::put(TempId temp, int value) {
+    if (temp >= regs.size()) {
+        regs.resize(std::max<size_t>(temp + 1, parent.compUnit->temps.size()));
+        assigned.resize(regs.size());
+    }
+    regs[temp] = value;
+    assigned[temp] = true;
 }
 
 bool Simulator::ExecutionFrame::advance() {
     if (parent.debugLevel > 1) {
-        std::cout << "\033[1;31mEvaluating " << parent.getNodeType(getCurrentNode()) << " with ip: " << ip << "\033[0m" << std::endl;
+        std::cout << "\033[1;31mEvaluating " << parent.getNodeType(getBody(), getCurrentNode()) << " with ip: " << ip << "\033[0m" << std::endl;
     }
 
     int backupIp = ip;
 
-    if (ip >= parent.indexToNode.size()) return false;
+    if (ip >= getBody().size()) return false;
 
     parent.leave(this); 
 
@@ -53,17 +58,25 @@ void Simulator::ExecutionFrame::setIP(int ip) {
         if (ip == -1) {
             std::cout << "Returning" << std::endl;
         } else {
-            std::cout << "Jumping to " << parent.getNodeType(getCurrentNode()) << " with ip: " << ip << std::endl; 
+            std::cout << "Jumping to " << parent.getNodeType(getBody(), getCurrentNode()) << " with ip: " << ip << std::endl; 
         }
     }
 }
 
-IR_PTR Simulator::ExecutionFrame::getCurrentNode() {
-    if (parent.indexToNode.find(ip) == parent.indexToNode.end()) {
+IRNodeId Simulator::ExecutionFrame::getCurrentNode() {
+    if (ip < 0 || ip >= getBody().size()) {
         THROW_SimulatorError("Looking for ip and could not find it.");
     }
 
-    return parent.indexToNode[ip];
+    return ip;
+}
+
+const FlatIR &Simulator::ExecutionFrame::getBody() {
+    if (!body) {
+        THROW_SimulatorError("Looking for the body of a frame that is not executing a function.");
+    }
+
+    return *body;
 }
 
 Simulator::Simulator(IR *compUnit, int heapSizeMax) : heapSizeMax(heapSizeMax) {
@@ -80,10 +93,32 @@ Simulator::Simulator(IR *compUnit, int heapSizeMax) : heapSizeMax(heapSizeMax) {
     libraryFunctions.insert("__exception");
     libraryFunctions.insert("NATIVEjava.io.OutputStream.nativeWrite");
 
-    MapsBuilder mapBuilder;
-    mapBuilder.visit(*compUnit);
-    indexToNode = mapBuilder.getIndexToNode();
-    nameToIndex = mapBuilder.getNameToIndex();
+    // Bodies are only read, so they are flattened once for all the calls to their functions
+    for (auto &func : this->compUnit->getFunctionList()) {
+        if (nameToIndex.find(func->getName()) != nameToIndex.end()) {
+            THROW_SimulatorError("Error - encountered duplicate name " + func->getName() + " in the IR tree -- go fix the generator.");
+        }
+        nameToIndex[func->getName()] = functionBodies.size();
+        functionBodies.emplace_back(func->getBody());
+    }
+
+    for (auto &body : functionBodies) {
+        for (IRNodeId id = 0; id < body.size(); id++) {
+            if (body[id].kind != FlatIR::Kind::LABEL) continue;
+
+            LabelId label = body[id].id;
+            if (label >= labelToIndex.size()) {
+                labelToIndex.resize(label + 1, -1);
+            }
+            if (labelToIndex[label] != -1) {
+                THROW_SimulatorError("Error - encountered duplicate label " + std::to_string(label) + " in the IR tree -- go fix the generator.");
+            }
+            labelToIndex[label] = id;
+        }
+    }
+
+    argPrefix = CGConstants::ABSTRACT_ARG_PREFIX;
+    retTemp = this->compUnit->temps.find(CGConstants::ABSTRACT_RET);
 };
 
 
@@ -134,13 +169,20 @@ int Simulator::findLabel(std::string label) {
     return nameToIndex[label];
 }
 
-std::string Simulator::getNodeType(IR_PTR node) {
-    return std::visit([&](auto *x) { return x->label(); }, node);
+int Simulator::findLabel(LabelId label) {
+    if (label >= labelToIndex.size() || labelToIndex[label] == -1) {
+        THROW_SimulatorError("Could not find label '" + compUnit->labels.name(label) + "'!");
+    }
+    return labelToIndex[label];
+}
+
+std::string Simulator::getNodeType(const FlatIR &body, IRNodeId node) {
+    return body.label(node);
 }
 
 int Simulator::call(std::string name, std::vector<int> args) {
     try {
-        auto frame = ExecutionFrame(-1, *this);
+        auto frame = ExecutionFrame(nullptr, -1, *this);
         return call(frame, name, args);
     } catch (ExitSysCall &e) {
         return e.rc;
@@ -164,14 +206,16 @@ int Simulator::call(ExecutionFrame& parent, std::string name, std::vector<int> a
             THROW_SimulatorError("Function " + name + " not found");
         }
 
-        int ip = findLabel(name);
-        auto frame = std::make_unique<ExecutionFrame>(ip, *this);
+        auto frame = std::make_unique<ExecutionFrame>(&functionBodies[findLabel(name)], 0, *this);
 
         for (int i = 0; i < args.size(); i++) {
             if (debugLevel > 1) {
                 std::cout << "Adding " << CGConstants::ABSTRACT_ARG_PREFIX + std::to_string(i) << " = " << args[i] << " to args" << std::endl;
             }
-            frame->put(CGConstants::ABSTRACT_ARG_PREFIX + std::to_string(i), args[i]);
+            // Arguments the IR never reads are not in the temporaries table
+            if (auto arg_temp = compUnit->temps.find(argPrefix, i)) {
+                frame->put(*arg_temp, args[i]);
+            }
         }
 
         while (frame->advance());
@@ -182,7 +226,7 @@ int Simulator::call(ExecutionFrame& parent, std::string name, std::vector<int> a
             std::cout << "Frame return value is " << return_value << std::endl;
     }
 
-    parent.put(CGConstants::ABSTRACT_RET, return_value);
+    if (retTemp) parent.put(*retTemp, return_value);
     if (debugLevel > 1)
         std::cout << "Calling " << name << " returned " << return_value << std::endl;
  
@@ -225,22 +269,25 @@ int Simulator::libraryCall(std::string name, std::vector<int> args) {
 }
 
 void Simulator::leave(ExecutionFrame *frame) {
-    IR_PTR node = frame->getCurrentNode();
-
-    std::visit(util::overload{
-        [&](ConstIR *cons) {
-            Simulator::exprStack.pushValue(cons->getValue());
-        },
-        [&](TempIR *temp) {
-            std::string tempName = temp->getName();
-            Simulator::exprStack.pushTemp(frame->get(tempName), tempName);
-        },
-        [&](BinOpIR *binop) {
+    const FlatIR &body = frame->getBody();
+    IRNodeId id = frame->getCurrentNode();
+    const FlatIR::Node &node = body[id];
+
+    switch (node.kind) {
+        case FlatIR::Kind::CONST: {
+            Simulator::exprStack.pushValue(node.value);
+            break;
+        }
+        case FlatIR::Kind::TEMP: {
+            Simulator::exprStack.pushTemp(frame->get(node.id), node.id);
+            break;
+        }
+        case FlatIR::Kind::BIN_OP: {
             int r = Simulator::exprStack.popValue();
             int l = Simulator::exprStack.popValue();
 
             int result;
-            switch (binop->op) {
+            switch (node.op) {
                 case BinOpIR::OpType::ADD:
                     result = l + r;
                     break;
@@ -289,13 +336,15 @@ void Simulator::leave(ExecutionFrame *frame) {
             }
 
             Simulator::exprStack.pushValue(result);
-        },
-        [&](MemIR *mem){
+            break;
+        }
+        case FlatIR::Kind::MEM: {
             int addr = Simulator::exprStack.popValue();
             Simulator::exprStack.pushAddr(read(addr), addr);
-        },
-        [&](CallIR *call){
-            int argCount = call->getArgs().size();
+            break;
+        }
+        case FlatIR::Kind::CALL: {
+            int argCount = node.list_size;
             std::vector<int> args;
 
             for (int i = 0; i < argCount; i++) {
@@ -310,25 +359,20 @@ void Simulator::leave(ExecutionFrame *frame) {
             auto target = Simulator::exprStack.pop();
             std::string targetName;
 
+            // Only calls to a named function are simulated
             if (target.type == StackItem::Kind::NAME) {
                 targetName = target.name;
-            } else if (Simulator::indexToNode.find(target.value) == Simulator::indexToNode.end()) {
-                auto ir_ptr = Simulator::indexToNode[target.value];
-                if (std::holds_alternative<FuncDeclIR*>(ir_ptr)) {
-                    targetName = std::get<FuncDeclIR*>(ir_ptr)->getName();
-                } else {
-                    THROW_SimulatorError("Call to a non-function instruction");
-                }
             } else {
-                std::string message = "Invalid function call " + call->label() + " (target " + std::to_string(target.value) + " is unknown)!";
+                std::string message = "Invalid function call " + body.label(id) + " (target " + std::to_string(target.value) + " is not a function name)!";
                 THROW_SimulatorError(message);
             }
             
             int return_value = Simulator::call(*frame, targetName, args);
             Simulator::exprStack.pushValue(return_value);
-        },
-        [&](NameIR *name) {
-            std::string str = name->getName();
+            break;
+        }
+        case FlatIR::Kind::NAME: {
+            const std::string &str = body.text(node);
 
             if (Simulator::libraryFunctions.find(str) != Simulator::libraryFunctions.end()) {
                 Simulator::exprStack.pushName(-1, str);
@@ -336,8 +380,9 @@ void Simulator::leave(ExecutionFrame *frame) {
                 int label = findLabel(str);
                 Simulator::exprStack.pushName(label, str);
             }
-        },
-        [&](MoveIR *move) {
+            break;
+        }
+        case FlatIR::Kind::MOVE: {
             int r = Simulator::exprStack.popValue();
             auto stackItem = Simulator::exprStack.pop();
 
@@ -350,45 +395,50 @@ void Simulator::leave(ExecutionFrame *frame) {
                     break;
                 case StackItem::Kind::TEMP:
                     if (Simulator::debugLevel > 0) {
-                        std::cout << "temp[" << stackItem.temp << "] = " << r << std::endl;
+                        std::cout << "temp[" << compUnit->temps.name(stackItem.temp) << "] = " << r << std::endl;
                     }
                     frame->put(stackItem.temp, r);
                     break;
                 default:
                     THROW_SimulatorError("Invalid MOVE - " + stackItem.getKindString());
             }
-        },
-        [&](ExpIR *exp) {
+            break;
+        }
+        case FlatIR::Kind::EXP: {
             Simulator::exprStack.pop();
-        },
-        [&](JumpIR *jump) {
-            frame->setIP(Simulator::exprStack.popValue());
-        },
-        [&](CJumpIR *cjump) {
+            break;
+        }
+        case FlatIR::Kind::JUMP: {
+            frame->setIP(findLabel(node.id));
+            break;
+        }
+        case FlatIR::Kind::CJUMP: {
             int top = Simulator::exprStack.popValue();
-            std::string label;
+            LabelId label;
 
             if (top == 0) {
-                label = cjump->falseLabel();
+                label = node.false_label;
             } else if (top == 1) {
-                label = cjump->trueLabel();
+                label = node.id;
             } else {
                 THROW_SimulatorError("Invalid condition for CJump, expected 0/1 and got " + std::to_string(top));
             }
 
-            if (label != "") frame->setIP(findLabel(label));
-        },
-        [&](ReturnIR *ret) {
+            if (label != NO_LABEL) frame->setIP(findLabel(label));
+            break;
+        }
+        case FlatIR::Kind::RETURN: {
             frame->ret = Simulator::exprStack.popValue();
             if (Simulator::debugLevel > 0) 
                 std::cout << "Encountered return, returning " << frame->ret << std::endl;
             frame->setIP(-1);
-        },
-        [&](auto &node) {
+            break;
+        }
+        default: {
             if (Simulator::debugLevel > 0) 
-                std::cout << "Leaving: " << node->label() << std::endl;
+                std::cout << "Leaving: " << body.label(id) << std::endl;
         }
-    }, node);
+    }
 }
 
 void Simulator::setDebugLevel(int level) {
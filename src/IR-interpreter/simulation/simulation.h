@@ -2,12 +2,13 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <optional>
 #include <string>
 #include "IR/ir.h"
+#include "IR/flat-ir.h"
 #include <vector>
 #include <stack>
 #include "IR-interpreter/expr-stack/expr-stack.h"
-#include "IR-interpreter/maps-builder/maps-builder.h"
 
 extern int WORD_SIZE;
 
@@ -28,9 +29,19 @@ class Simulator {
     /** compilation unit to be interpreted */
     CompUnitIR *compUnit;    
 
-    /** map from labeled name to address */
+    /** body of each function, flattened so a frame steps through its nodes in order */
+    std::vector<FlatIR> functionBodies;
+
+    /** map from function name to the index of its body */
     std::unordered_map<std::string, int> nameToIndex;
 
+    /** map from label id to the index of its node in the body of its function, -1 for labels not in a body */
+    std::vector<int> labelToIndex;
+
+    /** temporaries that arguments are passed in and values are returned in, if the IR uses them */
+    util::Symbol argPrefix;
+    std::optional<TempId> retTemp;
+
     /** heap */
     std::vector<int> memory = {0, 0, 0, 0}; // malloc should not return 0 on success
     
@@ -42,17 +53,11 @@ class Simulator {
 
     /**
      *
-     * @param name name of the label
-     * @return the IR node at the named label
+     * @param name name of the function, or id of the label
+     * @return the index of the function's body, or of the label's node in its function's body
      */
     int findLabel(std::string label);
-
-    /**
-     * Get the IR node at the given address
-     * @param ptr the I
-     * @return the IR node at the given address
-     */
-    IR* getIRFromPtr(IR_PTR ptr);
+    int findLabel(LabelId label);
 
     /**
      * Holds the instruction pointer and temporary registers
@@ -61,8 +66,11 @@ class Simulator {
     class ExecutionFrame {
         /** parent object */
         Simulator& parent;
-        /** local registers (register name -> value) */
-        std::unordered_map<std::string, int> regs;
+        /** body of the function executing in this frame, or nullptr for the frame calls start from */
+        const FlatIR *body;
+        /** local registers, indexed by temporary id, and whether each has been assigned */
+        std::vector<int> regs;
+        std::vector<bool> assigned;
     protected:  
         /** instruction pointer */
         int ip;
@@ -70,26 +78,26 @@ class Simulator {
     public:
         /** return value from this frame */
         int ret;
-        ExecutionFrame(int ip, Simulator& parent);
+        ExecutionFrame(const FlatIR *body, int ip, Simulator& parent);
 
          /**
          * Fetch the value at the given register
-         * @param tempName name of the register
+         * @param temp the register
          * @return the value at the given register
          */
-        int get(std::string tempName);
+        int get(TempId temp);
 
 
         /**
          * Store a value into the given register
-         * @param tempName name of the register
+         * @param temp the register
          * @param value value to be stored
          */
-        void put(std::string tempName, int value);
+        void put(TempId temp, int value);
 
         /**
-         * Advance the instruction pointer. Since we're dealing with a tree,
-         * this is postorder traversal, one step at a time, modulo jumps.
+         * Advance the instruction pointer. The body is stored in postorder,
+         * so this is postorder traversal, one step at a time, modulo jumps.
          */
         bool advance();
 
@@ -101,15 +109,17 @@ class Simulator {
 
         /**
          * Get the Current Node object, based on the current ip
-         * @return IR_PTR the pointer of the IR node at the current ip
+         * @return IRNodeId the id of the node at the current ip
          */
-        IR_PTR getCurrentNode();    
+        IRNodeId getCurrentNode();
 
+        /**
+         * @return const FlatIR& the body of the function executing in this frame
+         */
+        const FlatIR &getBody();
 
     };
 protected:
-    /** map from address to instruction */
-    std::unordered_map<int, IR_PTR> indexToNode;
     int debugLevel = 0;
 
     int getMemoryIndex(int addr);
@@ -202,8 +212,9 @@ public:
     /**
      * Return a string representation of the current node type
      * 
+     * @param body the body the node is in
      * @param node 
      * @return std::string a string representation of the current node type 
      */
-    std::string getNodeType(IR_PTR node);
+    std::string getNodeType(const FlatIR &body, IRNodeId node);
 };
@@ -3,14 +3,17 @@
 StackItem::StackItem(int value) : type(COMPUTED), value(value) {}
 StackItem::StackItem(int value, int addr) : type(MEM), value(value), addr(addr) {}
 StackItem::StackItem(Kind type, int value, std::string string) : type(type), value(value) {
-    if (type == TEMP) {
-        temp = string;
-    } else if (type == NAME) {
+    if (type == NAME) {
         name = string;
     } else {
         throw "Unexpected type in StackItem constructor";
     }
 }
+StackItem::StackItem(Kind type, int value, TempId temp) : type(type), value(value), temp(temp) {
+    if (type != TEMP) {
+        throw "Unexpected type in StackItem constructor";
+    }
+}
 
 
 
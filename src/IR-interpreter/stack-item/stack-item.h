@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include "IR/ir-names.h"
 
 class StackItem {
 public:
@@ -12,12 +13,13 @@ public:
     Kind type;
     int value;
     int addr;
-    std::string temp;
+    TempId temp;
     std::string name;
 
     StackItem(int value);
     StackItem(int value, int addr);
     StackItem(Kind type, int value, std::string string);
+    StackItem(Kind type, int value, TempId temp);
     std::string getKindString() {
         switch (type) {
             case Kind::COMPUTED:
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <optional>
 #include <vector>
 #include <list>
 #include <string>
@@ -8,15 +11,26 @@
 
 #include "IR/ir.h"
 #include "IR/ir_visitor.h"
+#include "IR/flat-ir.h"
+#include "IR/program-units.h"
 #include "utillities/overload.h"
 #include "IR-tiling/tiling/ir-tiling.h"
 
 #include "IR-tiling/register-allocation/brainless-allocator.h"
 #include "IR-tiling/register-allocation/noop-allocator.h"
 #include "IR-tiling/register-allocation/linear-scanning-allocator.h"
+#include "IR-tiling/register-allocation/graph-colouring-allocator.h"
 
 #include "IR-tiling/assembly/assembly.h"
+#include "IR-tiling/assembly/assembly-writer.h"
 #include "IR-tiling/assembly/registers.h"
+#include "IR-tiling/assembly/target.h"
+
+#include "IR-tiling/machine-code/elf-object.h"
+#include "IR-tiling/machine-code/x86-encoder.h"
+
+#include "utillities/thread_pool.h"
+#include "build-cache/build-cache.h"
 
 using namespace Assembly;
 
@@ -49,9 +63,9 @@ class DependencyFinder : public IRSkipVisitor {
     }
 
     virtual void operator()(TempIR &node) override {
-        if (!required_static_fields.count(node.getName()) && node.isGlobal) {
-            // Required static field is not already included
-            required_static_fields.insert(node.getName());
+        if (node.isGlobal) {
+            // Required static field, if not already included
+            required_static_fields.insert(cu.temps.name(node.getId()));
         }
         this->visit_children(node); 
     }
@@ -71,179 +85,335 @@ class DependencyFinder : public IRSkipVisitor {
 // Class in charge of generating all the output assembly for each compilation unit.
 //
 // Tiles each compilation unit and creates the files as appropriate.
+//
+// Functions are tiled, allocated and rendered independently on the thread pool, then stitched
+// into their compilation unit's file in source order, so the output does not depend on scheduling.
+//
+// The static field initializers and dispatch vector setup of a unit become functions in its own file,
+// which main.s calls, so each cu_N.s only depends on its unit and can be reused from a BuildCache.
+//
+// The files are either NASM assembly, or ELF object files (cu_N.o and main.o) encoded directly from the instructions.
+// Object files are only encoded for the x86 target.
 class AssemblyGenerator {
-    IRToTilesConverter converter;
-
-    std::string makeFunctionPrologue(int32_t stack_size) {
-        std::string output;
-        output += "\t" + Push(REG32_STACKBASEPTR).toString() + "\n";
-        output += "\t" + Mov(REG32_STACKBASEPTR, REG32_STACKPTR).toString() + "\n";
-        output += "\t" + Sub(REG32_STACKPTR, 4 * stack_size).toString() + "\n";
-        return output;
+    util::ThreadPool &pool;
+    std::filesystem::path output_directory;
+    const BuildCache *cache;
+    bool annotate;
+    bool emit_objects;
+    Assembly::Target target;
+
+    // Allocate registers for the instructions, returning the number of stack slots needed
+    int32_t allocateRegisters(std::list<AssemblyInstruction>& instructions, const std::string& allocatorChoice) {
+        if (allocatorChoice == "linear-scan") {
+            return LinearScanningRegisterAllocator(annotate, target).allocateRegisters(instructions);
+        } else if (allocatorChoice == "graph-colouring") {
+            return GraphColouringRegisterAllocator(annotate, target).allocateRegisters(instructions);
+        } else if (allocatorChoice == "brainless") {
+            return BrainlessRegisterAllocator(annotate, target).allocateRegisters(instructions);
+        } else if (allocatorChoice == "noop") {
+            return NoopRegisterAllocator(annotate, target).allocateRegisters(instructions);
+        }
+        THROW_CompilerError("Unknown allocator choice: " + allocatorChoice);
     }
 
-  public:
-    void generateCode(std::vector<IR>& ir_trees, std::string entrypoint_method, std::string allocatorChoice = "linear-scan") {
-        std::vector<std::pair<std::string, std::list<AssemblyInstruction>>> static_fields;
-        std::vector<std::list<AssemblyInstruction>> start_commands;
+    // Tile and allocate a single function, starting with its label and prologue; safe to run concurrently for different functions
+    std::list<AssemblyInstruction> generateFunction(CompUnitIR& cu, FuncDeclIR& func, const std::string& allocatorChoice) {
+        FlatIR body {func.getBody()};
+        IRToTilesConverter function_converter {cu.temps, cu.labels, target};
+        StatementTile body_tile = function_converter.tileFunctionBody(body);
+        auto instructions = body_tile->getFullInstructions();
+        int32_t stack_size = allocateRegisters(instructions, allocatorChoice);
+
+        // The callee saved registers the function writes are kept in stack slots after the allocator's
+        std::vector<std::pair<Register, int32_t>> callee_saves;
+        for (auto reg : calleeSavedRegisters(target)) {
+            bool written = std::any_of(instructions.begin(), instructions.end(), [&](AssemblyInstruction& instr) {
+                return instr.getWriteRegisters().count(reg);
+            });
+            if (written) callee_saves.emplace_back(reg, -4 * ++stack_size);
+        }
 
-        // For startup dependencies
-        CompUnitIR dummy_cu = CompUnitIR("");
-        DependencyFinder startup_dep_finder = DependencyFinder(dummy_cu);
+        // Restore them in each epilogue, before it resets the stack pointer
+        if (!callee_saves.empty()) {
+            for (auto it = instructions.begin(); it != instructions.end(); ++it) {
+                if (!std::get_if<Mov>(&*it) || !it->getWriteRegisters().count(REG32_STACKPTR)) continue;
+                for (auto [reg, offset] : callee_saves) {
+                    instructions.insert(it, Mov(reg, EffectiveAddress(REG32_STACKBASEPTR, offset)));
+                }
+            }
+        }
 
-        // Reset output directory
-        std::filesystem::create_directory("output");
-        for (auto& path: std::filesystem::directory_iterator("output")) {
-            std::filesystem::remove_all(path);
+        // Stack slots hold 4 bytes, but the stack pointer is kept aligned to a stack word
+        int32_t frame_size = 4 * stack_size;
+        frame_size += -frame_size & (stackWordSize(target) - 1);
+
+        std::list<AssemblyInstruction> prologue = {
+            Label(func.getName()),
+            Push(REG32_STACKBASEPTR),
+            Mov(REG32_STACKBASEPTR, REG32_STACKPTR),
+            Sub(REG32_STACKPTR, frame_size)
+        };
+        for (auto [reg, offset] : callee_saves) {
+            prologue.emplace_back(Mov(EffectiveAddress(REG32_STACKBASEPTR, offset), reg));
         }
 
-        // Emit a file for each compilation unit
-        size_t file_id = 0;
-        for (auto &ir : ir_trees) {
-            std::visit(util::overload {
-                [&](CompUnitIR& cu) {
-                    // Get static fields to dump in .data section of entrypoint file later
-                    for (auto& [field_name, field_initalizer] : cu.getCanonFieldList()) {
-                        assert(field_initalizer);
-
-                        startup_dep_finder(*field_initalizer);
-                        auto tile = converter.tile(*field_initalizer);
-                        auto instructions = tile->getFullInstructions();
-
-                        static_fields.emplace_back(field_name, std::move(instructions));
-                    }
+        instructions.splice(instructions.begin(), prologue);
+        return instructions;
+    }
 
-                    // Get start commands to dump in .text
-                    for (auto& start_stmt : cu.start_statements) {
-                        assert(start_stmt);
+    // Render a function as assembly, with its label unindented
+    std::string renderFunction(std::list<AssemblyInstruction>& instructions) {
+        AssemblyWriter out {annotate, nullptr, target};
+        for (auto it = instructions.begin(); it != instructions.end(); ++it) {
+            out.line(*it, it != instructions.begin());
+        }
+        out << '\n';
+        return out.take();
+    }
 
-                        startup_dep_finder(*start_stmt);
-                        auto tile = converter.tile(*start_stmt);
-                        auto instructions = tile->getFullInstructions();
+    // Render the file for a compilation unit from the code of its functions, in their original order
+    std::string generateCompUnitFile(CompUnitIR& cu, std::vector<std::string>::const_iterator function_code) {
+        AssemblyWriter out {annotate, nullptr, target};
+        out << "section .text\n\n";
 
-                        start_commands.emplace_back(std::move(instructions));
-                    }
+        // Export functions as global
+        for (auto& func : cu.getFunctionList()) {
+            AssemblyInstruction global = GlobalSymbol(func->getName());
+            out.line(global, false);
+        }
+        out << '\n';
+
+        // Import required functions/static fields, sorted so the file is the same in every compile
+        auto dependency_finder = DependencyFinder(cu);
+        auto required_functions = dependency_finder.getRequiredFunctions();
+        auto required_static_fields = dependency_finder.getRequiredStaticFields();
+        std::vector<std::string> externs(required_functions.begin(), required_functions.end());
+        std::sort(externs.begin(), externs.end());
+        std::vector<std::string> static_field_externs(required_static_fields.begin(), required_static_fields.end());
+        std::sort(static_field_externs.begin(), static_field_externs.end());
+        externs.insert(externs.end(), static_field_externs.begin(), static_field_externs.end());
+
+        for (auto& required : externs) {
+            AssemblyInstruction extern_symbol = ExternSymbol(required);
+            out.line(extern_symbol, false);
+        }
+        out << '\n';
 
-                    // Generate the assembly file for the compilation unit
-                    std::ofstream output_file {"output/cu_" + std::to_string(file_id++) + ".s"};
-                    output_file << "section .text\n\n";
+        for (size_t i = 0; i < cu.getFunctionList().size(); ++i) {
+            out << function_code[i];
+        }
+        return out.take();
+    }
 
-                    // Export functions as global
-                    for (auto& func : cu.getFunctionList()) {
-                        output_file << GlobalSymbol(func->getName()).toString() << "\n";
-                    }
-                    output_file << "\n";
+    // Link the machine code of a compilation unit's functions, in their original order, into an object file
+    static std::string generateCompUnitObject(CompUnitIR& cu, std::vector<MachineCode>::const_iterator function_code) {
+        ElfObjectFile object;
 
-                    // Import required functions/static fields
-                    auto dependency_finder = DependencyFinder(cu);
-                    for (auto& req_func : dependency_finder.getRequiredFunctions()) {
-                        output_file << ExternSymbol(req_func).toString() << "\n";
-                    }
-                    for (auto& req_field : dependency_finder.getRequiredStaticFields()) {
-                        output_file << ExternSymbol(req_field).toString() << "\n";
-                    }
-                    output_file << "\n";
-
-                    // Tile each method in the compilation unit
-                    for (auto& func : cu.getFunctionList()) {
-                        // Tile and allocate registers
-                        StatementTile body_tile = converter.tile(func->getBody());
-                        auto body_instructions = body_tile->getFullInstructions();
-                        int32_t stack_size = 0; 
-                        if (allocatorChoice == "linear-scan") {
-                            stack_size = LinearScanningRegisterAllocator().allocateRegisters(body_instructions);
-                        } else if (allocatorChoice == "brainless") {
-                            stack_size = BrainlessRegisterAllocator().allocateRegisters(body_instructions);
-                        } else if (allocatorChoice == "noop") {
-                            stack_size = NoopRegisterAllocator().allocateRegisters(body_instructions);
-                        } else {
-                            THROW_CompilerError("Unknown allocator choice: " + allocatorChoice);
-                        }
-
-                        // Function label
-                        output_file << Label(func->getName()).toString() << "\n";
-
-                        // Function prologue
-                        output_file << makeFunctionPrologue(stack_size);
-
-                        // Function body
-                        for (auto& body_instruction : body_instructions) {
-                            output_file << "\t" << body_instruction.toString() << "\n";
-                        }
-                        output_file << "\n";
-                    }
-                },
-                [&](auto&) { THROW_CompilerError("shouldn't happen"); }
-            }, ir);
+        MachineCode exports;
+        for (auto& func : cu.getFunctionList()) {
+            exports.globals.push_back(func->getName());
         }
+        object.addCode(exports);
 
-        // Combine all static/startup into one list of instructions
-        std::list<AssemblyInstruction> static_init;
-        for (auto& [field_name, initializer_instructions] : static_fields) {
-            for (auto& instr : initializer_instructions) {
-                static_init.push_back(instr);
-            }
+        for (size_t i = 0; i < cu.getFunctionList().size(); ++i) {
+            object.addCode(function_code[i]);
         }
-        static_init.push_back(Comment("Initialize DVs"));
-        for (auto& start_command : start_commands) {
-            for (auto& instr : start_command) {
-                static_init.push_back(instr);
-            }
+        return object.write();
+    }
+
+    // The code of _start: run the static initializers and dispatch vector setup of every unit, then the entrypoint
+    std::list<AssemblyInstruction> startInstructions(
+        const std::string& entrypoint_method,
+        const std::vector<std::string>& static_initializers,
+        const std::vector<std::string>& dispatch_vector_initializers
+    ) {
+        std::list<AssemblyInstruction> instructions;
+        instructions.push_back(Label("_start"));
+        instructions.push_back(Comment("Initialize all the static fields of all the compilation units, in order"));
+        for (auto& initializer : static_initializers) {
+            instructions.push_back(Call(LabelUse(initializer), target));
         }
 
-        // Emit a main file for the entrypoint
-        std::ofstream start_file {"output/main.s"};
-        
-        start_file << "section .data\n\n";
-        for (auto& [field_name, initalizer_tile] : static_fields) {
-            start_file << field_name + ": dd 0" << "\n";
+        instructions.push_back(Comment("Initialize DVs"));
+        for (auto& initializer : dispatch_vector_initializers) {
+            instructions.push_back(Call(LabelUse(initializer), target));
+        }
+        instructions.push_back(LineBreak());
+
+        if (target == Target::X86_64) {
+            instructions.push_back(Comment("Call entrypoint method and execute exit() system call with return value in REG32_DEST"));
+            instructions.push_back(Call(LabelUse(entrypoint_method), target));
+            instructions.push_back(Mov(REG32_DEST, REG32_ACCUM));
+            instructions.push_back(Mov(REG32_ACCUM, 60));
+            instructions.push_back(SysCall64());
+            return instructions;
         }
-        start_file << "\n"
 
-        << "section .text"                              << "\n\n";
+        instructions.push_back(Comment("Call entrypoint method and execute exit() system call with return value in REG32_BASE"));
+        instructions.push_back(Call(LabelUse(entrypoint_method), target));
+        instructions.push_back(Mov(REG32_BASE, REG32_ACCUM));
+        instructions.push_back(Mov(REG32_ACCUM, 1));
+        instructions.push_back(SysCall());
+        return instructions;
+    }
 
-        for (auto& [field_name, initalizer_tile] : static_fields) {
-            start_file << GlobalSymbol(field_name).toString() << "\n";
+  public:
+    // Writes the assembly files to output_directory, reusing and storing them in the cache if one is given.
+    // If annotate is set, the files are an annotated listing, with comments explaining the generated code.
+    // If emit_objects is set, object files are written instead of assembly.
+    explicit AssemblyGenerator(
+        util::ThreadPool &pool,
+        std::filesystem::path output_directory = "output",
+        const BuildCache *cache = nullptr,
+        bool annotate = false,
+        bool emit_objects = false,
+        Assembly::Target target = Assembly::Target::X86
+    ) : pool{pool}, output_directory{std::move(output_directory)}, cache{cache}, annotate{annotate && !emit_objects},
+        emit_objects{emit_objects}, target{target}
+    {
+        if (emit_objects && target != Assembly::Target::X86) {
+            THROW_CompilerError("Object files can only be emitted for the x86 target");
         }
-        start_file 
-        << GlobalSymbol("_start").toString()             << "\n"
-        << ExternSymbol(entrypoint_method).toString()    << "\n";
+    }
 
-        // Add startup dependencies
-        for (auto& required_fun : startup_dep_finder.getRequiredFunctions()) {
-            start_file << ExternSymbol(required_fun).toString() << "\n";
-        }
-        start_file << "\n"
-
-        << Label("_start").toString() << "\n"
-            << "\t" << Comment("Initialize all the static fields of all the compilation units, in order").toString() << "\n";
-
-            // Initialize all, with the same stack frame
-            int32_t stack_size_for_initializer = 0;
-            if (allocatorChoice == "linear-scan") {
-                stack_size_for_initializer = LinearScanningRegisterAllocator().allocateRegisters(static_init);
-            } else if (allocatorChoice == "brainless") {
-                stack_size_for_initializer = BrainlessRegisterAllocator().allocateRegisters(static_init);
-            } else if (allocatorChoice == "noop") {
-                stack_size_for_initializer = NoopRegisterAllocator().allocateRegisters(static_init);
+    // If unit_milliseconds is given, it is filled with the time spent tiling and allocating the functions of each
+    // compilation unit, summed over the threads they ran on; units reused from the cache take no time.
+    void generateCode(
+        std::vector<IR>& ir_trees,
+        std::string entrypoint_method,
+        std::string allocatorChoice = "linear-scan",
+        std::vector<double>* unit_milliseconds = nullptr
+    ) {
+        // Reset output directory
+        std::filesystem::create_directories(output_directory);
+        for (auto& path: std::filesystem::directory_iterator(output_directory)) {
+            std::filesystem::remove_all(path);
+        }
+
+        // Move the static initialization code of every compilation unit into functions of the unit
+        ProgramUnits program = prepareProgramUnits(ir_trees);
+        auto& comp_units = program.comp_units;
+
+        // Reuse the files of unchanged compilation units
+        std::vector<BuildCache::Fingerprint> cache_keys(comp_units.size());
+        std::vector<std::optional<std::string>> comp_unit_code(comp_units.size());
+        if (cache) {
+            pool.parallelFor(comp_units.size(), [&](size_t i) {
+                cache_keys[i] = BuildCache::fingerprint(*comp_units[i], allocatorChoice, annotate, emit_objects, target);
+                comp_unit_code[i] = cache->load(cache_keys[i]);
+            });
+        }
+
+        std::vector<std::pair<CompUnitIR*, FuncDeclIR*>> functions;
+        for (size_t i = 0; i < comp_units.size(); ++i) {
+            if (comp_unit_code[i]) continue;
+            for (auto& func : comp_units[i]->getFunctionList()) {
+                functions.emplace_back(comp_units[i], func.get());
+            }
+        }
+
+        // Tile, allocate and render (or encode) every remaining function in parallel
+        std::vector<std::string> function_code(emit_objects ? 0 : functions.size());
+        std::vector<MachineCode> function_machine_code(emit_objects ? functions.size() : 0);
+        std::vector<double> function_milliseconds(unit_milliseconds ? functions.size() : 0);
+        pool.parallelFor(functions.size(), [&](size_t i) {
+            auto [cu, func] = functions[i];
+            auto start_time = std::chrono::steady_clock::now();
+            auto instructions = generateFunction(*cu, *func, allocatorChoice);
+            if (unit_milliseconds) {
+                function_milliseconds[i]
+                    = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+            }
+            if (emit_objects) {
+                function_machine_code[i] = X86Encoder().encode(instructions);
             } else {
-                THROW_CompilerError("Unknown allocator choice: " + allocatorChoice);
+                function_code[i] = renderFunction(instructions);
+            }
+        });
+
+        // Emit a file for each compilation unit
+        std::string extension = emit_objects ? ".o" : ".s";
+        size_t next_function = 0;
+        if (unit_milliseconds) unit_milliseconds->assign(comp_units.size(), 0);
+        for (size_t file_id = 0; file_id < comp_units.size(); ++file_id) {
+            CompUnitIR& cu = *comp_units[file_id];
+
+            if (!comp_unit_code[file_id]) {
+                if (unit_milliseconds) {
+                    for (size_t i = 0; i < cu.getFunctionList().size(); ++i) {
+                        (*unit_milliseconds)[file_id] += function_milliseconds[next_function + i];
+                    }
+                }
+                if (emit_objects) {
+                    comp_unit_code[file_id] = generateCompUnitObject(cu, function_machine_code.cbegin() + next_function);
+                } else {
+                    comp_unit_code[file_id] = generateCompUnitFile(cu, function_code.cbegin() + next_function);
+                }
+                next_function += cu.getFunctionList().size();
+                if (cache) {
+                    cache->store(cache_keys[file_id], *comp_unit_code[file_id]);
+                }
             }
 
-            start_file << makeFunctionPrologue(stack_size_for_initializer);
-            for (auto &instr : static_init) {
-                start_file << "\t" << instr.toString() << "\n";
+            std::ofstream output_file {output_directory / ("cu_" + std::to_string(file_id) + extension), std::ios::binary};
+            output_file.write(comp_unit_code[file_id]->data(), comp_unit_code[file_id]->size());
+        }
+
+        auto start = startInstructions(entrypoint_method, program.static_initializers, program.dispatch_vector_initializers);
+
+        // Emit a main object file for the entrypoint, with the static fields in its .data section
+        if (emit_objects) {
+            MachineCode fields;
+            for (auto& field_name : program.static_fields) {
+                fields.labels.push_back({field_name, static_cast<uint32_t>(fields.bytes.size())});
+                fields.globals.push_back(field_name);
+                fields.appendLong(0);
             }
+            start.push_front(GlobalSymbol("_start"));
 
-            start_file << "\t" << Mov(REG32_STACKPTR, REG32_STACKBASEPTR).toString() << "\n";
-            start_file << "\t" << Pop(REG32_STACKBASEPTR).toString() << "\n";
-            start_file << "\n"
+            ElfObjectFile object;
+            object.addData(fields);
+            object.addCode(X86Encoder().encode(start));
+            std::string contents = object.write();
 
-            << "\t" << Comment("Call entrypoint method and execute exit() system call with return value in REG32_BASE").toString() << "\n"
-            << "\t" << Call(entrypoint_method).toString()        << "\n"
-            << "\t" << Mov(REG32_BASE, REG32_ACCUM).toString()   << "\n"
-            << "\t" << Mov(REG32_ACCUM, 1).toString()            << "\n"
-            << "\t" << SysCall().toString()                      << "\n"
-        ;
+            std::ofstream start_file {output_directory / "main.o", std::ios::binary};
+            start_file.write(contents.data(), contents.size());
+            return;
+        }
+
+        // Emit a main file for the entrypoint
+        std::ofstream start_file {output_directory / "main.s", std::ios::binary};
+        AssemblyWriter out {annotate, &start_file, target};
+        auto line = [&](AssemblyInstruction instruction, bool indent = true) { out.line(instruction, indent); };
+
+        out << "section .data\n\n";
+        for (auto& field_name : program.static_fields) {
+            out << field_name << ": dd 0\n";
+        }
+        out << "\nsection .text\n\n";
+
+        for (auto& field_name : program.static_fields) {
+            line(GlobalSymbol(field_name), false);
+        }
+        line(GlobalSymbol("_start"), false);
+        line(ExternSymbol(entrypoint_method), false);
+
+        // Add startup dependencies
+        for (auto& initializer : program.static_initializers) {
+            line(ExternSymbol(initializer), false);
+        }
+        for (auto& initializer : program.dispatch_vector_initializers) {
+            line(ExternSymbol(initializer), false);
+        }
+        out << '\n';
+
+        for (auto& instruction : start) {
+            if (std::holds_alternative<LineBreak>(instruction)) {
+                // The blank line before the entrypoint call is kept in unannotated listings too
+                out << '\n';
+            } else {
+                line(instruction, !std::holds_alternative<Label>(instruction));
+            }
+        }
     }
 };
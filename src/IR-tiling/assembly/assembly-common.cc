@@ -1,29 +1,16 @@
 #include "assembly.h"
 #include "assembly-instruction.h"
 #include "assembly-common.h"
+#include "assembly-writer.h"
 
-std::string EffectiveAddress::toString() {
-    if (!(scale == 1 || scale == 2 || scale == 4 || scale == 8)) {
-        THROW_CompilerError("Invalid parameter for scale");
+void AssemblyCommon::write(AssemblyWriter& out) {
+    out << mnemonic;
+    if (stack_word_operand) {
+        out << ' ';
+        out.stackWord(operands[0]);
+        return;
     }
-
-    std::string result = base_register;
-
-    // index * scale
-    if (index_register != EffectiveAddress::EMPTY_REG) {
-        result += " + ";
-        if (scale != 1) {
-            result += "(" + index_register + " * " + std::to_string(scale) + ")";
-        } else {
-            result += index_register;
-        }
+    for (size_t i = 0; i < num_operands; ++i) {
+        out << (i == 0 ? " " : ", ") << operands[i];
     }
-
-    // displacement
-    if (displacement != 0) {
-        result += (displacement < 0 ? " - " : " + ");
-        result += std::to_string(std::abs(displacement));
-    }
-
-    return "[" + result + "]";
 }
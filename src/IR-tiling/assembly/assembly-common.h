@@ -1,59 +1,61 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <variant>
-#include <vector>
 #include <unordered_set>
 
 #include "utillities/overload.h"
 #include "exceptions/exceptions.h"
-#include "IR/code-gen-constants.h"
 #include "registers.h"
 
+// Label use operand, usually for jumps or data
+struct LabelUse {
+    std::string text;
+    LabelUse(std::string text) : text{text} {}
+};
+
 // Available x86 addressing modes
 struct EffectiveAddress {
-    const static inline std::string EMPTY_REG = "";
+    static constexpr inline Assembly::Register EMPTY_REG = Assembly::Register::none();
 
-    std::string base_register = EMPTY_REG;
-    std::string index_register = EMPTY_REG;
+    // Label the address is relative to (e.g. a static field in the .data section), or empty
+    std::string symbol;
+
+    Assembly::Register base_register = EMPTY_REG;
+    Assembly::Register index_register = EMPTY_REG;
     int scale = 1;
     int displacement = 0;
 
-    EffectiveAddress(std::string base) : base_register{base} {}
+    EffectiveAddress(LabelUse symbol) : symbol{symbol.text} {}
+
+    EffectiveAddress(Assembly::Register base) : base_register{base} {}
 
-    EffectiveAddress(std::string base, int dis) : 
+    EffectiveAddress(Assembly::Register base, int dis) : 
         base_register{base}, displacement{dis} 
     {}
 
-    EffectiveAddress(std::string base, std::string index) : 
+    EffectiveAddress(Assembly::Register base, Assembly::Register index) : 
         base_register{base}, index_register{index} 
     {}
 
-    EffectiveAddress(std::string base, std::string index, int scale) : 
+    EffectiveAddress(Assembly::Register base, Assembly::Register index, int scale) : 
         base_register{base}, index_register{index}, scale{scale} 
     {}
 
-    EffectiveAddress(std::string base, std::string index, int scale, int dis) : 
+    EffectiveAddress(Assembly::Register base, Assembly::Register index, int scale, int dis) : 
         base_register{base}, index_register{index}, scale{scale}, displacement{dis}
     {}
-
-    std::string toString();
-};
-
-// Label use operand, usually for jumps or data
-struct LabelUse {
-    std::string text;
-    LabelUse(std::string text) : text{text} {}
 };
 
-using RegisterString = std::string;
-
 // Operand for x86 assembly instructions
 //
 // Register (real or abstract), label use, effective address, or immediate
-struct Operand : public std::variant<EffectiveAddress, LabelUse, RegisterString, int32_t> {
+struct Operand : public std::variant<EffectiveAddress, LabelUse, Assembly::Register, int32_t> {
     using variant::variant;
 
+    Operand() : variant{0} {}
+
     bool is_read = false;
     bool is_write = false;
 
@@ -74,218 +76,159 @@ struct Operand : public std::variant<EffectiveAddress, LabelUse, RegisterString,
         return *this;
     }
 
-    std::string toString() {
-        return std::visit(util::overload {
-            [&](EffectiveAddress &adr) { return adr.toString(); },
-            [&](std::string &reg) { return reg; },
-            [&](int32_t immediate) { return std::to_string(immediate); },
-            [&](LabelUse &label) { return label.text; }
-        }, *this);
-    }
 };
 
+class AssemblyWriter;
+
 class AssemblyCommon {
+    static constexpr size_t MAX_OPERANDS = 2;
+
+    // Instruction name the operands are written after
+    const char *mnemonic = nullptr;
 
     // Used operands
-    std::vector<Operand> operands;
+    std::array<Operand, MAX_OPERANDS> operands;
+    uint8_t num_operands = 0;
+
+    // Whether the operand is pushed to or popped from the stack, so is a stack word wide (e.g. push, call)
+    bool stack_word_operand = false;
 
     // Real registers that the instruction always reads/write (e.g. imul writing to EAX)
-    std::unordered_set<std::string> read_real_registers;
-    std::unordered_set<std::string> written_real_registers;
+    Assembly::RegisterSet read_real_registers;
+    Assembly::RegisterSet written_real_registers;
+
+    // All registers the instruction reads/writes, kept up to date as operands are added and replaced
+    Assembly::RegisterSet read_registers;
+    Assembly::RegisterSet written_registers;
+
+    void addOperandRegisters(Operand& operand) {
+        std::visit(util::overload {
+            [&](EffectiveAddress& adr) {
+                // Registers used in an effective address are always read, even if the operand itself isn't
+                if (adr.index_register != EffectiveAddress::EMPTY_REG) {
+                    read_registers.insert(adr.index_register);
+                }
+                if (adr.base_register != EffectiveAddress::EMPTY_REG) {
+                    read_registers.insert(adr.base_register);
+                }
+            },
+            [&](Assembly::Register reg) {
+                if (operand.is_read) read_registers.insert(reg);
+                if (operand.is_write) written_registers.insert(reg);
+            },
+            [&](auto&) {}
+        }, operand);
+    }
+
+    void collectRegisters() {
+        read_registers = read_real_registers;
+        written_registers = written_real_registers;
+        for (size_t i = 0; i < num_operands; ++i) {
+            addOperandRegisters(operands[i]);
+        }
+    }
+
+    Assembly::RegisterSet onlyAbstract(const Assembly::RegisterSet& set) {
+        Assembly::RegisterSet result;
+        for (auto reg : set) {
+            if (reg.isAbstract()) result.insert(reg);
+        }
+        return result;
+    }
 
   protected:
+    AssemblyCommon() = default;
+    explicit AssemblyCommon(const char *mnemonic) : mnemonic{mnemonic} {}
+
     template<typename... OperandType>
     void useOperands(OperandType&... operands) {
-        (this->operands.push_back(operands), ...);
+        ((this->operands[num_operands++] = operands, addOperandRegisters(operands)), ...);
+    }
+
+    // Use an operand that is a whole stack word, which 64 bit code writes with its 64 bit register
+    void useStackWordOperand(Operand& operand) {
+        stack_word_operand = true;
+        useOperands(operand);
     }
 
-    template<typename... StringType>
-    void readRealRegisters(StringType&... regs) {
+    template<typename... RegisterType>
+    void readRealRegisters(RegisterType... regs) {
         (this->read_real_registers.insert(regs), ...);
+        (this->read_registers.insert(regs), ...);
     }
 
-    template<typename... StringType>
-    void writeRealRegisters(StringType&... regs) {
+    template<typename... RegisterType>
+    void writeRealRegisters(RegisterType... regs) {
         (this->written_real_registers.insert(regs), ...);
+        (this->written_registers.insert(regs), ...);
     }
 
-    // Remove things that arent registers from a set
-    void removeGlobalData(std::unordered_set<std::string>& set) {
-        std::unordered_set<std::string> set_copy = set;
-        for (auto& reg : set_copy) {
-            if (reg.rfind(CGConstants::global_data_prefix, 0) == 0) {
-                set.erase(reg);
-            }
-        }
-    }
+  public:
+    // Write the instruction as the mnemonic followed by the operands
+    void write(AssemblyWriter& out);
 
-    // Add the set of registers that overlap
-    void addOverlapSet(std::unordered_set<std::string>& set) {
-        std::unordered_set<std::string> set_copy = set;
-        for (auto& reg : set_copy) {
-            for (auto& overlap_reg : Assembly::sameRegisterSet(reg)) {
-                set.insert(overlap_reg);
-            }
-        }
-    }
+    size_t getNumOps() const { return num_operands; }
 
-  public:
     // Get the index'th op (indexed starting at 1)
     Operand& getOp(size_t index) {
-        if (index > operands.size()) {
+        if (index > num_operands) {
             THROW_CompilerError("Attempted to get operand out of range");
         }
         return operands[index - 1];
     }
     
-    void replaceRegister(std::string original_register, std::string new_register) {
-        for (auto& operand : operands) {
+    void replaceRegister(Assembly::Register original_register, Assembly::Register new_register) {
+        bool replaced = false;
+        for (size_t i = 0; i < num_operands; ++i) {
             // Replace any register equal to the original register in each operand
             std::visit(util::overload {
                 [&](EffectiveAddress& adr) {
                     if (adr.index_register == original_register) {
                         adr.index_register = new_register;
+                        replaced = true;
                     }
                     if (adr.base_register == original_register) {
                         adr.base_register = new_register;
+                        replaced = true;
                     }
                 },
-                [&](std::string& reg) {
+                [&](Assembly::Register& reg) {
                     if (reg == original_register) {
                         reg = new_register;
+                        replaced = true;
                     }
                 },
                 [&](auto&) {}
-            }, operand);
+            }, operands[i]);
         }
+        if (replaced) collectRegisters();
     }
 
-    std::unordered_set<std::string> getReadRegisters() {
-        std::unordered_set<std::string> result;
+    // Registers are reported as the 32 bit register containing them
+    const Assembly::RegisterSet& getReadRegisters() { return read_registers; }
+    const Assembly::RegisterSet& getWriteRegisters() { return written_registers; }
 
-        for (auto& operand : operands) {
-            std::visit(util::overload {
-                [&](EffectiveAddress& adr) {
-                    // Registers used in an effective address are always read, even if the operand itself isn't
-                    if (adr.index_register != EffectiveAddress::EMPTY_REG) {
-                        result.insert(adr.index_register);
-                    }
-                    if (adr.base_register != EffectiveAddress::EMPTY_REG) {
-                        result.insert(adr.base_register);
-                    }
-                },
-                [&](std::string& reg) {
-                    if (operand.is_read) {
-                        result.insert(reg);
-                    }
-                },
-                [&](auto&) {}
-            }, operand);
-        }
-
-        for (auto& reg : read_real_registers) {
-            result.insert(reg);
-        }
-
-        addOverlapSet(result);
-        removeGlobalData(result);
-        return std::move(result);
-    }
-
-    std::unordered_set<std::string> getWriteRegisters() {
-        std::unordered_set<std::string> result;
-
-        for (auto& operand : operands) {
-            std::visit(util::overload {
-                [&](EffectiveAddress& adr) {},
-                [&](std::string& reg) {
-                    if (operand.is_write) {
-                        result.insert(reg);
-                    }
-                },
-                [&](auto&) {}
-            }, operand);
-        }
-
-        for (auto& reg : written_real_registers) {
-            result.insert(reg);
-        }
-        
-        addOverlapSet(result);
-        removeGlobalData(result);
-        return std::move(result);
-    }
-
-    std::unordered_set<std::string> getUsedRegisters() {
-        std::unordered_set<std::string> result;
-
-        for (auto& operand : operands) {
-            std::visit(util::overload {
-                [&](EffectiveAddress& adr) {
-                    if (adr.index_register != EffectiveAddress::EMPTY_REG) {
-                        result.insert(adr.index_register);
-                    }
-                    if (adr.base_register != EffectiveAddress::EMPTY_REG) {
-                        result.insert(adr.base_register);
-                    }
-                },
-                [&](std::string& reg) {
-                    result.insert(reg);
-                },
-                [&](auto&) {}
-            }, operand);
-        }
-
-        for (auto& reg : read_real_registers) {
-            result.insert(reg);
-        }
-        for (auto& reg : written_real_registers) {
-            result.insert(reg);
-        }
-        
-        addOverlapSet(result);
-        removeGlobalData(result);
-        return std::move(result);
+    Assembly::RegisterSet getUsedRegisters() {
+        Assembly::RegisterSet result = read_registers;
+        result.insertAll(written_registers);
+        return result;
     }
 
     std::unordered_set<std::string> getUsedLabels() {
         std::unordered_set<std::string> result;
 
-        for (auto& operand : operands) {
-            std::visit(util::overload {
-                [&](LabelUse& label) {
-                    result.insert(label.text);
-                },
-                [&](auto&) {}
-            }, operand);
-        }
-
-        return std::move(result);
-    }
-
-    std::unordered_set<std::string> getUsedAbstractRegisters() {
-        std::unordered_set<std::string> result;
-        for (auto &reg : getUsedRegisters()) {
-            if (!Assembly::isRealRegister(reg)) result.insert(reg);
+        for (size_t i = 0; i < num_operands; ++i) {
+            if (auto label = std::get_if<LabelUse>(&operands[i])) {
+                result.insert(label->text);
+            }
         }
-        return result;
-    }
 
-    std::unordered_set<std::string> getReadAbstractRegisters() {
-        std::unordered_set<std::string> result;
-        for (auto &reg : getReadRegisters()) {
-            if (!Assembly::isRealRegister(reg)) result.insert(reg);
-        }
         return result;
     }
 
-    std::unordered_set<std::string> getWriteAbstractRegisters() {
-        std::unordered_set<std::string> result;
-        for (auto &reg : getWriteRegisters()) {
-            if (!Assembly::isRealRegister(reg)) result.insert(reg);
-        }
-        return result;
-    }
+    Assembly::RegisterSet getUsedAbstractRegisters() { return onlyAbstract(getUsedRegisters()); }
+    Assembly::RegisterSet getReadAbstractRegisters() { return onlyAbstract(read_registers); }
+    Assembly::RegisterSet getWriteAbstractRegisters() { return onlyAbstract(written_registers); }
 
     std::string tagged_comment; // A comment this instruction is tagged with, which will be printed with it
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "assembly.h"
+#include "assembly-writer.h"
 #include <variant>
 
 // AssemblyInstruction variant, to treat instructions polymorphically without needing pointers
@@ -25,6 +26,7 @@ using AssemblyInstructionInheritedVariant = std::variant<
     Assembly::Ret,
     Assembly::Call,
     Assembly::SysCall,
+    Assembly::SysCall64,
     Assembly::SetZ,
     Assembly::SetNZ,
     Assembly::SetL,
@@ -35,6 +37,8 @@ using AssemblyInstructionInheritedVariant = std::variant<
     Assembly::IDiv,
     Assembly::Comment,
     Assembly::Label,
+    Assembly::GlobalSymbol,
+    Assembly::ExternSymbol,
     Assembly::LineBreak
 >;
 
@@ -48,57 +52,56 @@ struct AssemblyInstruction : public AssemblyInstructionInheritedVariant {
         }, *this);
     }
 
-    std::unordered_set<std::string> getUsedRegisters() {
+    Assembly::RegisterSet getUsedRegisters() {
         return std::visit(util::overload {
-            [&](auto &x) -> std::unordered_set<std::string> { return x.getUsedRegisters(); }
+            [&](auto &x) -> Assembly::RegisterSet { return x.getUsedRegisters(); }
         }, *this);
     }
 
-    std::unordered_set<std::string> getWriteRegisters() {
+    const Assembly::RegisterSet& getWriteRegisters() {
         return std::visit(util::overload {
-            [&](auto &x) -> std::unordered_set<std::string> { return x.getWriteRegisters(); }
+            [&](auto &x) -> const Assembly::RegisterSet& { return x.getWriteRegisters(); }
         }, *this);
     }
 
-    std::unordered_set<std::string> getReadRegisters() {
+    const Assembly::RegisterSet& getReadRegisters() {
         return std::visit(util::overload {
-            [&](auto &x) -> std::unordered_set<std::string> { return x.getReadRegisters(); }
+            [&](auto &x) -> const Assembly::RegisterSet& { return x.getReadRegisters(); }
         }, *this);
     }
 
-    std::unordered_set<std::string> getUsedAbstractRegisters() {
+    Assembly::RegisterSet getUsedAbstractRegisters() {
         return std::visit(util::overload {
-            [&](auto &x) -> std::unordered_set<std::string> { return x.getUsedAbstractRegisters(); }
+            [&](auto &x) -> Assembly::RegisterSet { return x.getUsedAbstractRegisters(); }
         }, *this);
     }
 
-    std::unordered_set<std::string> getWriteAbstractRegisters() {
+    Assembly::RegisterSet getWriteAbstractRegisters() {
         return std::visit(util::overload {
-            [&](auto &x) -> std::unordered_set<std::string> { return x.getWriteAbstractRegisters(); }
+            [&](auto &x) -> Assembly::RegisterSet { return x.getWriteAbstractRegisters(); }
         }, *this);
     }
 
-    std::unordered_set<std::string> getReadAbstractRegisters() {
+    Assembly::RegisterSet getReadAbstractRegisters() {
         return std::visit(util::overload {
-            [&](auto &x) -> std::unordered_set<std::string> { return x.getReadAbstractRegisters(); }
+            [&](auto &x) -> Assembly::RegisterSet { return x.getReadAbstractRegisters(); }
         }, *this);
     }
 
-    void replaceRegister(std::string original_register, std::string new_register) {
+    void replaceRegister(Assembly::Register original_register, Assembly::Register new_register) {
         return std::visit(util::overload {
             [&](auto &x) { return x.replaceRegister(original_register, new_register); }
         }, *this);
     }
 
+    // The text of the instruction, with its tagged comment
     std::string toString() {
-        return std::visit(util::overload {
-            [&](auto &x) {
-                if (x.tagged_comment != "") {
-                    return x.toString() + " ; " + x.tagged_comment;
-                }
-                return x.toString(); 
-            }
-        }, *this);
+        AssemblyWriter out {true};
+        out.text(*this);
+        if (hasComment()) {
+            out << " ; " << getComment();
+        }
+        return out.take();
     }
 
     void tagWithComment(const std::string& text) {
@@ -110,9 +113,13 @@ struct AssemblyInstruction : public AssemblyInstructionInheritedVariant {
     }
 
     bool hasComment() {
+        return !getComment().empty();
+    }
+
+    const std::string& getComment() {
         return std::visit(util::overload {
-            [&](auto &x) {
-                return x.tagged_comment != "";
+            [&](auto &x) -> const std::string& {
+                return x.tagged_comment;
             }
         }, *this);
     }
@@ -0,0 +1,117 @@
+#include "assembly-writer.h"
+#include "assembly-instruction.h"
+
+#include <charconv>
+#include <cstdlib>
+
+AssemblyWriter::AssemblyWriter(bool annotate, std::ostream *stream, Assembly::Target target)
+    : stream{stream}, annotate{annotate}, target{target}
+{
+    if (stream) {
+        buffer.reserve(FLUSH_SIZE + FLUSH_SIZE / 4);
+    }
+}
+
+AssemblyWriter& AssemblyWriter::operator<<(int32_t value) {
+    char digits[16];
+    auto [end, _] = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, end);
+    return *this;
+}
+
+AssemblyWriter& AssemblyWriter::operator<<(Assembly::Register reg) {
+    if (reg.isReal()) {
+        bool is_stack_register = reg == Assembly::REG32_STACKPTR || reg == Assembly::REG32_STACKBASEPTR;
+        buffer.append(target == Assembly::Target::X86_64 && is_stack_register ? reg.register64().realName() : reg.realName());
+    } else if (reg.isAbstract()) {
+        *this << "%_ABSTRACT_REG" << static_cast<int32_t>(reg.abstractIndex()) << '%';
+    } else {
+        buffer.append(reg.toString());
+    }
+    return *this;
+}
+
+AssemblyWriter& AssemblyWriter::operator<<(const EffectiveAddress& address) {
+    if (!(address.scale == 1 || address.scale == 2 || address.scale == 4 || address.scale == 8)) {
+        THROW_CompilerError("Invalid parameter for scale");
+    }
+
+    *this << '[' << address.symbol;
+
+    // Addresses are computed in the registers of the address size
+    auto address_register = [&](Assembly::Register reg) {
+        return target == Assembly::Target::X86_64 ? reg.register64() : reg;
+    };
+
+    // base
+    if (address.base_register != EffectiveAddress::EMPTY_REG) {
+        if (!address.symbol.empty()) *this << " + ";
+        *this << address_register(address.base_register);
+    }
+
+    // index * scale
+    if (address.index_register != EffectiveAddress::EMPTY_REG) {
+        *this << " + ";
+        if (address.scale != 1) {
+            *this << '(' << address_register(address.index_register) << " * " << address.scale << ')';
+        } else {
+            *this << address_register(address.index_register);
+        }
+    }
+
+    // displacement
+    if (address.displacement != 0) {
+        *this << (address.displacement < 0 ? " - " : " + ") << std::abs(address.displacement);
+    }
+
+    return *this << ']';
+}
+
+AssemblyWriter& AssemblyWriter::operator<<(const Operand& operand) {
+    std::visit([&](auto &value) { *this << value; }, operand);
+    return *this;
+}
+
+AssemblyWriter& AssemblyWriter::stackWord(const Operand& operand) {
+    if (target == Assembly::Target::X86_64) {
+        if (auto reg = std::get_if<Assembly::Register>(&operand)) {
+            return *this << reg->register64();
+        }
+        if (std::holds_alternative<EffectiveAddress>(operand)) {
+            *this << "qword ";
+        }
+    }
+    return *this << operand;
+}
+
+void AssemblyWriter::text(AssemblyInstruction& instruction) {
+    std::visit([&](auto &x) { x.write(*this); }, instruction);
+}
+
+void AssemblyWriter::line(AssemblyInstruction& instruction, bool indent) {
+    if (!annotate && (std::get_if<Assembly::Comment>(&instruction) || std::get_if<Assembly::LineBreak>(&instruction))) {
+        return;
+    }
+
+    if (indent) *this << '\t';
+    text(instruction);
+    if (annotate && instruction.hasComment()) {
+        *this << " ; " << instruction.getComment();
+    }
+    *this << '\n';
+
+    flushIfFull();
+}
+
+void AssemblyWriter::flush() {
+    if (stream && !buffer.empty()) {
+        stream->write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+std::string AssemblyWriter::take() {
+    std::string result = std::move(buffer);
+    buffer.clear();
+    return result;
+}
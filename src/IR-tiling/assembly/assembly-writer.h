@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "assembly-common.h"
+#include "registers.h"
+#include "target.h"
+
+struct AssemblyInstruction;
+
+// Writes NASM assembly text, formatting instructions and their operands straight into one buffer.
+//
+// The buffer is either taken as a string when writing is done, or flushed to a stream in large writes.
+// Comments, and the instructions' tagged comments, are only written in an annotated listing.
+//
+// For x86-64, the stack and frame pointers, the registers in addresses, and stack word operands are written
+// as their 64 bit registers; everything else is the same 32 bit code.
+class AssemblyWriter {
+    static constexpr size_t FLUSH_SIZE = 1 << 20;
+
+    std::string buffer;
+    std::ostream *stream;
+    bool annotate;
+    Assembly::Target target;
+
+    void flushIfFull() {
+        if (stream && buffer.size() >= FLUSH_SIZE) flush();
+    }
+
+  public:
+    explicit AssemblyWriter(bool annotate = false, std::ostream *stream = nullptr, Assembly::Target target = Assembly::Target::X86);
+    ~AssemblyWriter() { flush(); }
+
+    AssemblyWriter(const AssemblyWriter&) = delete;
+    AssemblyWriter& operator=(const AssemblyWriter&) = delete;
+
+    bool annotates() const { return annotate; }
+
+    AssemblyWriter& operator<<(std::string_view text) { buffer.append(text); return *this; }
+    AssemblyWriter& operator<<(const std::string& text) { buffer.append(text); return *this; }
+    AssemblyWriter& operator<<(const char *text) { buffer.append(text); return *this; }
+    AssemblyWriter& operator<<(char c) { buffer.push_back(c); return *this; }
+    AssemblyWriter& operator<<(int32_t value);
+    AssemblyWriter& operator<<(Assembly::Register reg);
+    AssemblyWriter& operator<<(const EffectiveAddress& address);
+    AssemblyWriter& operator<<(const LabelUse& label) { return *this << label.text; }
+    AssemblyWriter& operator<<(const Operand& operand);
+
+    // Write an operand pushed to or popped from the stack, which is a stack word wide
+    AssemblyWriter& stackWord(const Operand& operand);
+
+    // Write the instruction as a line of the listing.
+    // Comments and blank lines are skipped unless the listing is annotated.
+    void line(AssemblyInstruction& instruction, bool indent = true);
+
+    // Write the text of the instruction alone, with no indentation, comment or newline
+    void text(AssemblyInstruction& instruction);
+
+    // Write the buffered text to the stream
+    void flush();
+
+    // Get the written text, if there is no stream, leaving the writer empty for reuse
+    std::string take();
+};
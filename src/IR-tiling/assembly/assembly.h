@@ -2,261 +2,210 @@
 
 #include <string>
 #include "assembly-common.h"
+#include "assembly-writer.h"
 #include "registers.h"
+#include "target.h"
 
 // File that contains the classes for each used x86 assembly instruction.
 //
 // Each added instruction should be added to the variant in assembly-instruction.h.
-// Each added instruction should implement toString(), and define which operands are read/written to (can be both)
+// Each added instruction should pass its mnemonic to AssemblyCommon (or implement write(), if it is not written as
+// the mnemonic followed by its operands), and define which operands are read/written to (can be both)
 
 namespace Assembly {
 
 /* Assorted instructions */
 
 struct Mov : public AssemblyCommon {
-    Mov(Operand dest, Operand src) {
+    Mov(Operand dest, Operand src) : AssemblyCommon{"mov"} {
         useOperands(dest.write(), src.read());
     }
-
-    std::string toString() {
-        return "mov " + getOp(1).toString() + ", " + getOp(2).toString();
-    }
 };
 
 struct Jump : public AssemblyCommon {
-    Jump(Operand target) {
+    Jump(Operand target) : AssemblyCommon{"jmp"} {
         useOperands(target.read());
     }
-
-    std::string toString() {
-        return "jmp " + getOp(1).toString();
-    }
 };
 
 struct Call : public AssemblyCommon {
-    Call(Operand target) {
-        useOperands(target.read());
+    Call(Operand target, Target machine = Target::X86) : AssemblyCommon{"call"} {
+        useStackWordOperand(target.read());
         writeRealRegisters(REG32_ACCUM);
 
         // Special library functions always read from eax
-        if (target.toString() == "__malloc" || target.toString() == "NATIVEjava.io.OutputStream.nativeWrite") {
+        auto label = std::get_if<LabelUse>(&target);
+        if (label && (label->text == "__malloc" || label->text == "NATIVEjava.io.OutputStream.nativeWrite")) {
             readRealRegisters(REG32_ACCUM);
         }
-    }
 
-    std::string toString() {
-        return "call " + getOp(1).toString();
+        // Calls into the runtime also clobber the registers its functions use
+        if (label) {
+            for (auto reg : runtimeClobberedRegisters(machine, label->text)) writeRealRegisters(reg);
+        }
     }
 };
 
 struct Je : public AssemblyCommon {
-    Je(Operand target) {
+    Je(Operand target) : AssemblyCommon{"je"} {
         useOperands(target.read());
     }
-
-    std::string toString() {
-        return "je " + getOp(1).toString();
-    }
 };
 
 struct JumpIfNZ : public AssemblyCommon {
-    JumpIfNZ(Operand target) {
+    JumpIfNZ(Operand target) : AssemblyCommon{"jnz"} {
         useOperands(target.read());
     }
-
-    std::string toString() {
-        return "jnz " + getOp(1).toString();
-    }
 };
 
 struct Lea : public AssemblyCommon {
-    Lea(Operand dest, Operand src) {
+    Lea(Operand dest, Operand src) : AssemblyCommon{"lea"} {
         useOperands(dest.write(), src.read());
 
         if (!std::get_if<EffectiveAddress>(&src)) {
             THROW_CompilerError("Lea source must be effective address!");
         }
     }
-
-    std::string toString() {
-        return "lea " + getOp(1).toString() + ", " + getOp(2).toString();
-    }
 };
 
 struct Add : public AssemblyCommon {
-    Add(Operand arg1, Operand arg2) {
+    Add(Operand arg1, Operand arg2) : AssemblyCommon{"add"} {
         useOperands(arg1.readwrite(), arg2.read());
     }
-
-    std::string toString() {
-        return "add " + getOp(1).toString() + ", " + getOp(2).toString();
-    }
 };
 
 struct Sub : public AssemblyCommon {
-    Sub(Operand arg1, Operand arg2) {
+    Sub(Operand arg1, Operand arg2) : AssemblyCommon{"sub"} {
         useOperands(arg1.readwrite(), arg2.read());
     }
-
-    std::string toString() {
-        return "sub " + getOp(1).toString() + ", " + getOp(2).toString();
-    }
 };
 
 struct Xor : public AssemblyCommon {
-    Xor(Operand arg1, Operand arg2) {
+    Xor(Operand arg1, Operand arg2) : AssemblyCommon{"xor"} {
         useOperands(arg1.readwrite(), arg2.read());
     }
-
-    std::string toString() {
-        return "xor " + getOp(1).toString() + ", " + getOp(2).toString();
-    }
 };
 
 struct And : public AssemblyCommon {
-    And(Operand arg1, Operand arg2) {
+    And(Operand arg1, Operand arg2) : AssemblyCommon{"and"} {
         useOperands(arg1.readwrite(), arg2.read());
     }
-
-    std::string toString() {
-        return "and " + getOp(1).toString() + ", " + getOp(2).toString();
-    }
 };
 
 struct Or : public AssemblyCommon {
-    Or(Operand arg1, Operand arg2) {
+    Or(Operand arg1, Operand arg2) : AssemblyCommon{"or"} {
         useOperands(arg1.readwrite(), arg2.read());
     }
-
-    std::string toString() {
-        return "or " + getOp(1).toString() + ", " + getOp(2).toString();
-    }
 };
 
 struct MovZX : public AssemblyCommon {
-    MovZX(Operand arg1, Operand arg2) {
+    MovZX(Operand arg1, Operand arg2) : AssemblyCommon{"movzx"} {
         useOperands(arg1.write(), arg2.read());
     }
-
-    std::string toString() {
-        return "movzx " + getOp(1).toString() + ", " + getOp(2).toString();
-    }
 };
 
 struct Cmp : public AssemblyCommon {
-    Cmp(Operand arg1, Operand arg2) {
+    Cmp(Operand arg1, Operand arg2) : AssemblyCommon{"cmp"} {
         useOperands(arg1.read(), arg2.read());
     }
-
-    std::string toString() {
-        return "cmp " + getOp(1).toString() + ", " + getOp(2).toString();
-    }
 };
 
 struct Test : public AssemblyCommon {
-    Test(Operand arg1, Operand arg2) {
+    Test(Operand arg1, Operand arg2) : AssemblyCommon{"test"} {
         useOperands(arg1.read(), arg2.read());
     }
-
-    std::string toString() {
-        return "test " + getOp(1).toString() + ", " + getOp(2).toString();
-    }
 };
 
 struct Push : public AssemblyCommon {
-    Push(Operand arg) {
-        useOperands(arg.read());
-    }
-
-    std::string toString() {
-        return "push " + getOp(1).toString();
+    Push(Operand arg) : AssemblyCommon{"push"} {
+        useStackWordOperand(arg.read());
     }
 };
 
 struct Pop : public AssemblyCommon {
-    Pop(Operand arg) {
-        useOperands(arg.write());
-    }
-
-    std::string toString() {
-        return "pop " + getOp(1).toString();
+    Pop(Operand arg) : AssemblyCommon{"pop"} {
+        useStackWordOperand(arg.write());
     }
 };
 
 /* Instructions without operands */
 
-struct NoOperandInstruction : public AssemblyCommon {
-    std::string static_instruction;
-
-    NoOperandInstruction(std::string static_instruction) : static_instruction{static_instruction} {}
-
-    std::string toString() {
-        return static_instruction;
+struct Cdq : public AssemblyCommon {
+    Cdq() : AssemblyCommon{"cdq"} {
+        readRealRegisters(REG32_ACCUM);
+        writeRealRegisters(REG32_DATA);
     }
 };
 
-struct Cdq : public NoOperandInstruction {
-    Cdq() : NoOperandInstruction{"cdq"} {}
-};
+struct Ret : public AssemblyCommon {
+    Ret(unsigned int bytes = 0) : AssemblyCommon{"ret"} {
+        readRealRegisters(REG32_ACCUM); // The return value
 
-struct Ret : public NoOperandInstruction {
-    Ret(unsigned int bytes = 0) 
-        : NoOperandInstruction{bytes > 0 ? "ret " + std::to_string(bytes) : "ret"} 
-    {}
+        if (bytes > 0) {
+            Operand popped_bytes = static_cast<int32_t>(bytes);
+            useOperands(popped_bytes);
+        }
+    }
 };
 
-struct SysCall : public NoOperandInstruction {
-    SysCall() 
-        : NoOperandInstruction{"int 0x80"} 
-    {
+struct SysCall : public AssemblyCommon {
+    SysCall() : AssemblyCommon{"int 0x80"} {
         readRealRegisters(REG32_ACCUM, REG32_BASE);
     }
 };
 
-struct Comment : public NoOperandInstruction {
-    Comment(std::string text) 
-        : NoOperandInstruction{"; " + text} 
-    {}
+// 64 bit system call, with the call number in eax and the first argument in edi; the kernel clobbers rcx and r11
+struct SysCall64 : public AssemblyCommon {
+    SysCall64() : AssemblyCommon{"syscall"} {
+        readRealRegisters(REG32_ACCUM, REG32_DEST);
+        writeRealRegisters(REG32_ACCUM, REG32_COUNTER, REG32_R11);
+    }
 };
 
-struct Label : public NoOperandInstruction {
-    Label(std::string label) 
-        : NoOperandInstruction{label + ":"} 
-    {}
+/* Lines of the listing that are not instructions */
+
+struct Comment : public AssemblyCommon {
+    std::string text;
+
+    Comment(std::string text) : text{std::move(text)} {}
+
+    void write(AssemblyWriter& out) { out << "; " << text; }
 };
 
-struct GlobalSymbol : public NoOperandInstruction {
-    GlobalSymbol(std::string symbol) 
-        : NoOperandInstruction{"global " + symbol} 
-    {}
+struct Label : public AssemblyCommon {
+    std::string label;
+
+    Label(std::string label) : label{std::move(label)} {}
+
+    void write(AssemblyWriter& out) { out << label << ':'; }
 };
 
-struct ExternSymbol : public NoOperandInstruction {
-    ExternSymbol(std::string symbol) 
-        : NoOperandInstruction{"extern " + symbol} 
-    {}
+struct GlobalSymbol : public AssemblyCommon {
+    std::string symbol;
+
+    GlobalSymbol(std::string symbol) : symbol{std::move(symbol)} {}
+
+    void write(AssemblyWriter& out) { out << "global " << symbol; }
+};
+
+struct ExternSymbol : public AssemblyCommon {
+    std::string symbol;
+
+    ExternSymbol(std::string symbol) : symbol{std::move(symbol)} {}
+
+    void write(AssemblyWriter& out) { out << "extern " << symbol; }
 };
 
-struct LineBreak : public NoOperandInstruction {
-    LineBreak() 
-        : NoOperandInstruction{""} 
-    {}
+struct LineBreak : public AssemblyCommon {
+    void write(AssemblyWriter&) {}
 };
 
 /* SetX instructions which set destination to 1 or 0 based on flags from Cmp */
 
 struct BoolSetInstruction : public AssemblyCommon {
-    std::string instruction_name;
-
-    BoolSetInstruction(std::string name, Operand dest) 
-        : instruction_name{name}
-    {
+    BoolSetInstruction(const char *name, Operand dest) : AssemblyCommon{name} {
         useOperands(dest.write());
     }
-
-    std::string toString() {
-        return instruction_name + " " + getOp(1).toString();
-    }
 };
 
 struct SetZ : public BoolSetInstruction {
@@ -286,7 +235,7 @@ struct SetGE : public BoolSetInstruction {
 /* IMul/IDiv */
 
 struct IMul : public AssemblyCommon {
-    IMul(Operand multiplicand) {
+    IMul(Operand multiplicand) : AssemblyCommon{"imul"} {
         useOperands(multiplicand.read());
 
         readRealRegisters(REG32_ACCUM);
@@ -295,14 +244,10 @@ struct IMul : public AssemblyCommon {
         writeRealRegisters(REG32_ACCUM);
         writeRealRegisters(REG32_DATA);
     }
-
-    std::string toString() {
-        return "imul " + getOp(1).toString();
-    }
 };
 
 struct IDiv : public AssemblyCommon {
-    IDiv(Operand divisor) {
+    IDiv(Operand divisor) : AssemblyCommon{"idiv"} {
         useOperands(divisor.read());
         
         readRealRegisters(REG32_ACCUM);
@@ -311,10 +256,6 @@ struct IDiv : public AssemblyCommon {
         writeRealRegisters(REG32_ACCUM);
         writeRealRegisters(REG32_DATA);
     }
-
-    std::string toString() {
-        return "idiv " + getOp(1).toString();
-    }
 };
 
 }; // namespace Assembly
@@ -1,133 +1,248 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+
+#include "exceptions/exceptions.h"
+
 namespace Assembly {
-    // 8 bit general purpose registers
-    static const inline std::string REG8L_ACCUM = "al";
-    static const inline std::string REG8H_ACCUM = "ah";
 
-    static const inline std::string REG8L_BASE = "bl";
-    static const inline std::string REG8H_BASE = "bh";
+// A register operand : a real (physical) x86 register, or an abstract register numbered within its function,
+// which the register allocator later replaces with a real register or a stack slot.
+//
+// Registers are a single integer, so they are compared, hashed and copied without touching strings.
+// Real registers are numbered in x86 encoding order within each size.
+class Register {
+  public:
+    enum class Physical : uint8_t {
+        // 32 bit general purpose registers
+        EAX, ECX, EDX, EBX, ESP, EBP, ESI, EDI,
 
-    static const inline std::string REG8L_COUNTER = "cl";
-    static const inline std::string REG8H_COUNTER = "ch";
+        // 32 bit low parts of the extra registers (only encodable in 64 bit mode)
+        R8D, R9D, R10D, R11D, R12D, R13D, R14D, R15D,
 
-    static const inline std::string REG8L_DATA = "dl";
-    static const inline std::string REG8H_DATA = "dh";
+        // 16 bit general purpose registers
+        AX, CX, DX, BX, SP, BP, SI, DI,
 
-    static const inline std::string REG8L_STACKPTR = "spl";
-    static const inline std::string REG8L_STACKBASEPTR = "bpl";
+        // 8 bit general purpose registers
+        AL, CL, DL, BL, AH, CH, DH, BH,
 
-    static const inline std::string REG8L_SOURCE = "sil";
-    static const inline std::string REG8L_DEST = "dil";
+        // 8 bit low parts of the pointer/index registers (only encodable in 64 bit mode)
+        SPL, BPL, SIL, DIL,
 
-    // 16 bit general purpose registers
-    static const inline std::string REG16_ACCUM = "ax";
-    static const inline std::string REG16_BASE = "bx";
-    static const inline std::string REG16_COUNTER = "cx";
-    static const inline std::string REG16_DATA = "dx";
+        // 64 bit general purpose registers (only encodable in 64 bit mode)
+        RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+        R8, R9, R10, R11, R12, R13, R14, R15,
 
-    static const inline std::string REG16_STACKPTR = "sp";
-    static const inline std::string REG16_STACKBASEPTR = "bp";
+        COUNT
+    };
 
-    static const inline std::string REG16_SOURCE = "si";
-    static const inline std::string REG16_DEST = "di";
+  private:
+    static constexpr uint32_t NUM_PHYSICAL = static_cast<uint32_t>(Physical::COUNT);
+    static constexpr uint32_t PLACEHOLDER_VALUE = NUM_PHYSICAL;
+    static constexpr uint32_t FIRST_ABSTRACT_VALUE = NUM_PHYSICAL + 1;
+    static constexpr uint32_t NONE_VALUE = std::numeric_limits<uint32_t>::max();
 
-    // 32 bit general purpose registers
-    static const inline std::string REG32_ACCUM = "eax";
-    static const inline std::string REG32_BASE = "ebx";
-    static const inline std::string REG32_COUNTER = "ecx";
-    static const inline std::string REG32_DATA = "edx";
+    static constexpr uint32_t FIRST_REG16 = static_cast<uint32_t>(Physical::AX);
+    static constexpr uint32_t FIRST_REG8 = static_cast<uint32_t>(Physical::AL);
+    static constexpr uint32_t FIRST_REG8H = static_cast<uint32_t>(Physical::AH);
+    static constexpr uint32_t FIRST_REG8_EXTENDED = static_cast<uint32_t>(Physical::SPL);
+    static constexpr uint32_t FIRST_REG64 = static_cast<uint32_t>(Physical::RAX);
 
-    static const inline std::string REG32_STACKPTR = "esp";
-    static const inline std::string REG32_STACKBASEPTR = "ebp";
+    uint32_t value;
 
-    static const inline std::string REG32_SOURCE = "esi";
-    static const inline std::string REG32_DEST = "edi";
+    explicit constexpr Register(uint32_t value) : value{value} {}
 
-    // Instruction pointer register (not a gpr)
-    static const inline std::string REG32_IP = "eip";
+  public:
+    constexpr Register() : Register(NONE_VALUE) {}
+    constexpr Register(Physical reg) : value{static_cast<uint32_t>(reg)} {}
 
-    // Return true if reg is a real gpr, and false if it is an abstract register
-    static const inline std::unordered_set<std::string> assembly_ns_real_reg_set = {
-        REG8L_ACCUM,
-        REG8H_ACCUM,
+    // The index'th abstract register of a function
+    static constexpr Register abstract(uint32_t index) { return Register(FIRST_ABSTRACT_VALUE + index); }
 
-        REG8L_BASE,
-        REG8H_BASE,
+    // Stand-in for the register a tile stores its result in, before the tile is used
+    static constexpr Register placeholder() { return Register(PLACEHOLDER_VALUE); }
 
-        REG8L_COUNTER,
-        REG8H_COUNTER,
+    // No register, e.g. the missing index of an effective address
+    static constexpr Register none() { return Register(); }
 
-        REG8L_DATA,
-        REG8H_DATA,
+    constexpr bool isReal() const { return value < NUM_PHYSICAL; }
+    constexpr bool isAbstract() const { return value >= FIRST_ABSTRACT_VALUE && value != NONE_VALUE; }
+    constexpr bool isNone() const { return value == NONE_VALUE; }
 
-        REG8L_STACKPTR,
-        REG8L_STACKBASEPTR,
+    // Index of an abstract register within its function
+    constexpr uint32_t abstractIndex() const { return value - FIRST_ABSTRACT_VALUE; }
 
-        REG8L_SOURCE,
-        REG8L_DEST,
+    // x86 encoding of a real register within its size; 8 and up need a REX prefix
+    constexpr uint8_t encoding() const {
+        if (value >= FIRST_REG64) return value - FIRST_REG64;
+        if (value >= FIRST_REG8_EXTENDED) return value - FIRST_REG8_EXTENDED + 4;
+        if (value >= FIRST_REG8) return value - FIRST_REG8;
+        if (value >= FIRST_REG16) return value - FIRST_REG16;
+        return value;
+    }
 
-        REG16_ACCUM,
-        REG16_BASE,
-        REG16_COUNTER,
-        REG16_DATA,
+    // Whether a real register can only be encoded in 64 bit mode
+    constexpr bool needsLongMode() const {
+        return (value >= static_cast<uint32_t>(Physical::R8D) && value < FIRST_REG16)
+            || (value >= FIRST_REG8_EXTENDED && value < NUM_PHYSICAL);
+    }
+
+    // Size of a real register in bits
+    constexpr int size() const {
+        if (value >= FIRST_REG64) return 64;
+        if (value >= FIRST_REG8) return 8;
+        if (value >= FIRST_REG16) return 16;
+        return 32;
+    }
+
+    // The 32 bit register that contains or extends a real register (i.e. al is the low part of eax, and eax
+    // of rax), or the register itself
+    constexpr Register fullRegister() const {
+        if (!isReal()) return *this;
+        if (value >= FIRST_REG64) return Register(value - FIRST_REG64);
+        if (value >= FIRST_REG8_EXTENDED) return Register(value - FIRST_REG8_EXTENDED + 4);
+        if (value >= FIRST_REG8H) return Register(value - FIRST_REG8H);
+        if (value >= FIRST_REG8) return Register(value - FIRST_REG8);
+        if (value >= FIRST_REG16) return Register(value - FIRST_REG16);
+        return *this;
+    }
 
-        REG16_STACKPTR,
-        REG16_STACKBASEPTR,
+    // The 64 bit register containing a real register, e.g. for addressing memory in 64 bit mode
+    constexpr Register register64() const {
+        if (!isReal()) return *this;
+        return Register(FIRST_REG64 + fullRegister().value);
+    }
 
-        REG16_SOURCE,
-        REG16_DEST,
+    // Assembler name of a real register
+    const char *realName() const {
+        static constexpr std::array<const char*, NUM_PHYSICAL> names = {
+            "eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi",
+            "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d",
+            "ax", "cx", "dx", "bx", "sp", "bp", "si", "di",
+            "al", "cl", "dl", "bl", "ah", "ch", "dh", "bh",
+            "spl", "bpl", "sil", "dil",
+            "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+            "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15"
+        };
+        return names[value];
+    }
 
-        REG32_ACCUM,
-        REG32_BASE,
-        REG32_COUNTER,
-        REG32_DATA,
+    std::string toString() const {
+        if (isReal()) return realName();
+        if (isAbstract()) return "%_ABSTRACT_REG" + std::to_string(abstractIndex()) + "%";
+        if (value == PLACEHOLDER_VALUE) return "%%PLACEHOLDER_ABSTRACT_REG%%";
+        return "";
+    }
 
-        REG32_STACKPTR,
-        REG32_STACKBASEPTR,
+    constexpr bool operator==(Register other) const { return value == other.value; }
+    constexpr bool operator!=(Register other) const { return value != other.value; }
+    constexpr bool operator<(Register other) const { return value < other.value; }
+
+    constexpr size_t hash() const { return value; }
+};
+
+// 8 bit general purpose registers
+constexpr inline Register REG8L_ACCUM = Register::Physical::AL;
+constexpr inline Register REG8H_ACCUM = Register::Physical::AH;
+
+constexpr inline Register REG8L_BASE = Register::Physical::BL;
+constexpr inline Register REG8H_BASE = Register::Physical::BH;
+
+constexpr inline Register REG8L_COUNTER = Register::Physical::CL;
+constexpr inline Register REG8H_COUNTER = Register::Physical::CH;
+
+constexpr inline Register REG8L_DATA = Register::Physical::DL;
+constexpr inline Register REG8H_DATA = Register::Physical::DH;
+
+constexpr inline Register REG8L_STACKPTR = Register::Physical::SPL;
+constexpr inline Register REG8L_STACKBASEPTR = Register::Physical::BPL;
+
+constexpr inline Register REG8L_SOURCE = Register::Physical::SIL;
+constexpr inline Register REG8L_DEST = Register::Physical::DIL;
+
+// 16 bit general purpose registers
+constexpr inline Register REG16_ACCUM = Register::Physical::AX;
+constexpr inline Register REG16_BASE = Register::Physical::BX;
+constexpr inline Register REG16_COUNTER = Register::Physical::CX;
+constexpr inline Register REG16_DATA = Register::Physical::DX;
+
+constexpr inline Register REG16_STACKPTR = Register::Physical::SP;
+constexpr inline Register REG16_STACKBASEPTR = Register::Physical::BP;
+
+constexpr inline Register REG16_SOURCE = Register::Physical::SI;
+constexpr inline Register REG16_DEST = Register::Physical::DI;
+
+// 32 bit general purpose registers
+constexpr inline Register REG32_ACCUM = Register::Physical::EAX;
+constexpr inline Register REG32_BASE = Register::Physical::EBX;
+constexpr inline Register REG32_COUNTER = Register::Physical::ECX;
+constexpr inline Register REG32_DATA = Register::Physical::EDX;
+
+constexpr inline Register REG32_STACKPTR = Register::Physical::ESP;
+constexpr inline Register REG32_STACKBASEPTR = Register::Physical::EBP;
+
+constexpr inline Register REG32_SOURCE = Register::Physical::ESI;
+constexpr inline Register REG32_DEST = Register::Physical::EDI;
+
+// 32 bit low parts of the extra 64 bit mode registers
+constexpr inline Register REG32_R8 = Register::Physical::R8D;
+constexpr inline Register REG32_R9 = Register::Physical::R9D;
+constexpr inline Register REG32_R10 = Register::Physical::R10D;
+constexpr inline Register REG32_R11 = Register::Physical::R11D;
+constexpr inline Register REG32_R12 = Register::Physical::R12D;
+constexpr inline Register REG32_R13 = Register::Physical::R13D;
+constexpr inline Register REG32_R14 = Register::Physical::R14D;
+constexpr inline Register REG32_R15 = Register::Physical::R15D;
+
+// The registers an instruction reads or writes, without duplicates.
+//
+// An x86 instruction uses only a handful of registers, so they are stored inline rather than in a heap allocated set.
+// Real registers are stored as the 32 bit register containing them, since writing al clobbers eax.
+class RegisterSet {
+    static constexpr size_t CAPACITY = 6;
+
+    std::array<Register, CAPACITY> registers;
+    uint8_t length = 0;
+
+  public:
+    void insert(Register reg) {
+        reg = reg.fullRegister();
+        if (count(reg)) return;
+        if (length == CAPACITY) {
+            THROW_CompilerError("Instruction uses more than " + std::to_string(CAPACITY) + " registers");
+        }
+        registers[length++] = reg;
+    }
 
-        REG32_SOURCE,
-        REG32_DEST
-    };
-    bool inline isRealRegister(std::string reg) {
-        return assembly_ns_real_reg_set.count(reg) ? true : false;
+    void insertAll(const RegisterSet& other) {
+        for (auto reg : other) insert(reg);
     }
 
-    // Return all the registers that overlap with reg (i.e. al is the low part of eax, so both are the same register set)
-    static const inline std::unordered_set<std::string> accum_set 
-        = {REG8L_ACCUM, REG8H_ACCUM, REG16_ACCUM, REG32_ACCUM};
-
-    static const inline std::unordered_set<std::string> base_set
-        = {REG8L_BASE, REG8H_BASE, REG16_BASE, REG32_BASE};
-    
-    static const inline std::unordered_set<std::string> counter_set
-        = {REG8L_COUNTER, REG8H_COUNTER, REG16_COUNTER, REG32_COUNTER};
-
-    static const inline std::unordered_set<std::string> data_set
-        = {REG8L_DATA, REG8H_DATA, REG16_DATA, REG32_DATA};
-    
-    static const inline std::unordered_set<std::string> source_set
-        = {REG8L_SOURCE, REG16_SOURCE, REG32_SOURCE};
-
-    static const inline std::unordered_set<std::string> dest_set
-        = {REG8L_DEST, REG16_DEST, REG32_DEST};
-
-    static const inline std::unordered_set<std::string> stack_ptr_set
-        = {REG8L_STACKPTR, REG16_STACKPTR, REG32_STACKPTR};
-
-    static const inline std::unordered_set<std::string> stack_base_ptr_set
-        = {REG8L_STACKBASEPTR, REG16_STACKBASEPTR, REG32_STACKBASEPTR};
-
-    std::unordered_set<std::string> inline sameRegisterSet(std::string reg) {
-        if (accum_set.count(reg)) return accum_set;
-        if (base_set.count(reg)) return base_set;
-        if (counter_set.count(reg)) return counter_set;
-        if (data_set.count(reg)) return data_set;
-        if (source_set.count(reg)) return source_set;
-        if (dest_set.count(reg)) return dest_set;
-        if (stack_ptr_set.count(reg)) return stack_ptr_set;
-        if (stack_base_ptr_set.count(reg)) return stack_base_ptr_set;
-        return {reg};
+    size_t count(Register reg) const {
+        reg = reg.fullRegister();
+        for (size_t i = 0; i < length; ++i) {
+            if (registers[i] == reg) return 1;
+        }
+        return 0;
     }
 
+    void clear() { length = 0; }
+
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    const Register* begin() const { return registers.data(); }
+    const Register* end() const { return registers.data() + length; }
+};
+
 }; // namespace Assembly
+
+template <>
+struct std::hash<Assembly::Register> {
+    size_t operator()(Assembly::Register reg) const { return reg.hash(); }
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "registers.h"
+
+namespace Assembly {
+
+// Machine the assembly is generated for.
+//
+// Joos ints, and every address the program stores (objects, arrays, dispatch vectors, static fields), are 32 bits
+// on both targets, so the same instructions are generated for both. On x86-64 the program runs in 64 bit mode:
+// stack slots pushed by push and call are 64 bits, esp/ebp and the registers used to address memory are written
+// as their 64 bit registers (32 bit writes zero their upper half, so they hold the same address), and r8d-r15d
+// can be allocated too. Statically linked, the program's code, data and heap all lie in the low 4GB.
+enum class Target {
+    X86,
+    X86_64
+};
+
+// Size in bytes of a value pushed on the stack, or of a return address
+constexpr int32_t stackWordSize(Target target) {
+    return target == Target::X86_64 ? 8 : 4;
+}
+
+// Registers the allocators may keep temporaries in, in order of preference: the registers a call may clobber, then
+// the callee saved ones, which a function saves in its prologue if it writes them
+inline std::vector<Register> allocatableRegisters(Target target) {
+    if (target == Target::X86_64) {
+        return {
+            REG32_ACCUM, REG32_COUNTER, REG32_DATA, REG32_R8, REG32_R9, REG32_R10, REG32_R11,
+            REG32_BASE, REG32_SOURCE, REG32_DEST, REG32_R12, REG32_R13, REG32_R14, REG32_R15
+        };
+    }
+    return {REG32_ACCUM, REG32_COUNTER, REG32_DATA, REG32_BASE, REG32_SOURCE, REG32_DEST};
+}
+
+// Registers a function generated by the compiler keeps intact for its caller. The runtime's functions clobber the
+// registers runtimeClobberedRegisters gives instead.
+inline std::vector<Register> calleeSavedRegisters(Target target) {
+    if (target == Target::X86_64) {
+        return {REG32_BASE, REG32_SOURCE, REG32_DEST, REG32_R12, REG32_R13, REG32_R14, REG32_R15};
+    }
+    return {REG32_BASE, REG32_SOURCE, REG32_DEST};
+}
+
+// Whether the function is one of the runtime's, written by hand rather than generated by the compiler
+inline bool isRuntimeFunction(const std::string& name) {
+    return name.rfind("__", 0) == 0 || name.rfind("NATIVE", 0) == 0;
+}
+
+// Registers besides eax that a call to the runtime's function clobbers. __exception and __debexit never return.
+inline std::vector<Register> runtimeClobberedRegisters(Target target, const std::string& name) {
+    if (name != "__malloc" && name != "NATIVEjava.io.OutputStream.nativeWrite") return {};
+
+    if (target == Target::X86_64) {
+        // Both pass system call arguments in edi, esi and edx, and syscall clobbers rcx and r11
+        return {REG32_COUNTER, REG32_DATA, REG32_SOURCE, REG32_DEST, REG32_R11};
+    }
+    if (name == "__malloc") return {REG32_BASE};
+    return {REG32_BASE, REG32_COUNTER, REG32_DATA};
+}
+
+inline std::optional<Target> parseTarget(const std::string& name) {
+    if (name == "x86") return Target::X86;
+    if (name == "x86-64") return Target::X86_64;
+    return std::nullopt;
+}
+
+}; // namespace Assembly
@@ -0,0 +1,221 @@
+#include "elf-object.h"
+
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "exceptions/exceptions.h"
+
+namespace {
+
+// Values from the System V ABI (elf.h), for a 32 bit little endian i386 object file
+constexpr uint16_t ET_REL = 1;
+constexpr uint16_t EM_386 = 3;
+constexpr uint32_t SHT_PROGBITS = 1, SHT_SYMTAB = 2, SHT_STRTAB = 3, SHT_REL = 9;
+constexpr uint32_t SHF_WRITE = 1, SHF_ALLOC = 2, SHF_EXECINSTR = 4;
+constexpr uint8_t STB_LOCAL = 0, STB_GLOBAL = 1;
+constexpr uint8_t STT_NOTYPE = 0, STT_SECTION = 3;
+constexpr uint8_t R_386_32 = 1, R_386_PC32 = 2;
+
+constexpr uint32_t ELF_HEADER_SIZE = 52;
+constexpr uint32_t SECTION_HEADER_SIZE = 40;
+constexpr uint32_t SYMBOL_SIZE = 16;
+constexpr uint32_t RELOCATION_SIZE = 8;
+
+// Sections of every object file, in order
+enum SectionIndex : uint16_t { NO_SECTION, TEXT, DATA, SYMTAB, STRTAB, REL_TEXT, REL_DATA, SHSTRTAB, NUM_SECTIONS };
+
+// Symbols before the first global: the null symbol, then a section symbol for .text and .data
+constexpr uint32_t TEXT_SYMBOL = 1, DATA_SYMBOL = 2, FIRST_GLOBAL_SYMBOL = 3;
+
+struct ByteWriter {
+    std::string bytes;
+
+    void byte(uint8_t value) { bytes.push_back(static_cast<char>(value)); }
+    void half(uint16_t value) { byte(value & 0xff); byte(value >> 8); }
+    void word(uint32_t value) { half(value & 0xffff); half(value >> 16); }
+    void append(const std::vector<uint8_t>& data) { bytes.append(data.begin(), data.end()); }
+    void append(const std::string& data) { bytes.append(data); }
+    void align(uint32_t alignment) { bytes.resize((bytes.size() + alignment - 1) / alignment * alignment, '\0'); }
+    uint32_t size() const { return bytes.size(); }
+};
+
+// A string table, starting with the empty string
+struct StringTable {
+    std::string strings {'\0'};
+
+    uint32_t add(const std::string& string) {
+        uint32_t offset = strings.size();
+        strings.append(string);
+        strings.push_back('\0');
+        return offset;
+    }
+};
+
+struct Definition {
+    SectionIndex section;
+    uint32_t offset;
+};
+
+struct SectionHeader {
+    uint32_t name = 0, type = 0, flags = 0, offset = 0, size = 0, link = 0, info = 0, alignment = 1, entry_size = 0;
+};
+
+} // namespace
+
+std::string ElfObjectFile::write() const {
+    std::unordered_map<std::string, Definition> definitions;
+    auto define = [&](const MachineCode& code, SectionIndex section) {
+        for (auto& label : code.labels) {
+            if (!definitions.emplace(label.label, Definition{section, label.offset}).second) {
+                THROW_CompilerError("Label " + label.label + " is defined more than once");
+            }
+        }
+    };
+    define(text, TEXT);
+    define(data, DATA);
+
+    // Global symbols: the exported labels, then the labels used but not defined here
+    StringTable strings;
+    ByteWriter symbols;
+    std::unordered_map<std::string, uint32_t> symbol_indices;
+    uint32_t num_symbols = 0;
+    auto add_symbol = [&](uint32_t name, uint32_t value, uint8_t binding, uint8_t type, uint16_t section) {
+        symbols.word(name);
+        symbols.word(value);
+        symbols.word(0);
+        symbols.byte(binding << 4 | type);
+        symbols.byte(0);
+        symbols.half(section);
+        return num_symbols++;
+    };
+    add_symbol(0, 0, STB_LOCAL, STT_NOTYPE, NO_SECTION);
+    add_symbol(0, 0, STB_LOCAL, STT_SECTION, TEXT);
+    add_symbol(0, 0, STB_LOCAL, STT_SECTION, DATA);
+
+    for (auto code : {&text, &data}) {
+        for (auto& global : code->globals) {
+            auto definition = definitions.find(global);
+            if (definition == definitions.end()) {
+                THROW_CompilerError("Global label " + global + " is not defined");
+            }
+            if (symbol_indices.count(global)) continue;
+            symbol_indices[global] = add_symbol(
+                strings.add(global), definition->second.offset, STB_GLOBAL, STT_NOTYPE, definition->second.section
+            );
+        }
+    }
+    for (auto code : {&text, &data}) {
+        for (auto& reference : code->references) {
+            if (definitions.count(reference.symbol) || symbol_indices.count(reference.symbol)) continue;
+            symbol_indices[reference.symbol] = add_symbol(strings.add(reference.symbol), 0, STB_GLOBAL, STT_NOTYPE, NO_SECTION);
+        }
+    }
+
+    // Resolve the references of a section, returning its contents and writing its relocations
+    auto resolve = [&](const MachineCode& code, SectionIndex section, ByteWriter& relocations) {
+        MachineCode resolved;
+        resolved.bytes = code.bytes;
+
+        for (auto& reference : code.references) {
+            uint32_t addend = resolved.readLong(reference.offset);
+            uint8_t type = reference.kind == MachineCode::ReferenceKind::ABSOLUTE ? R_386_32 : R_386_PC32;
+
+            auto definition = definitions.find(reference.symbol);
+            if (definition == definitions.end()) {
+                relocations.word(reference.offset);
+                relocations.word(symbol_indices.at(reference.symbol) << 8 | type);
+                continue;
+            }
+
+            auto [defined_section, defined_offset] = definition->second;
+            if (type == R_386_PC32 && defined_section == section) {
+                resolved.patchLong(reference.offset, defined_offset + addend - reference.offset);
+                continue;
+            }
+            resolved.patchLong(reference.offset, defined_offset + addend);
+            relocations.word(reference.offset);
+            relocations.word((defined_section == TEXT ? TEXT_SYMBOL : DATA_SYMBOL) << 8 | type);
+        }
+        return resolved.bytes;
+    };
+    ByteWriter text_relocations, data_relocations;
+    auto text_bytes = resolve(text, TEXT, text_relocations);
+    auto data_bytes = resolve(data, DATA, data_relocations);
+
+    // Lay out the sections after the ELF header, then the section headers
+    ByteWriter out;
+    out.bytes.resize(ELF_HEADER_SIZE);
+
+    StringTable section_names;
+    std::vector<SectionHeader> headers(NUM_SECTIONS);
+    auto add_section = [&](SectionIndex index, const char *name, uint32_t type, uint32_t alignment, auto& contents) {
+        out.align(alignment);
+        auto& header = headers[index];
+        header.name = section_names.add(name);
+        header.type = type;
+        header.offset = out.size();
+        header.size = contents.size();
+        header.alignment = alignment;
+        out.append(contents);
+        return &header;
+    };
+
+    add_section(TEXT, ".text", SHT_PROGBITS, 16, text_bytes)->flags = SHF_ALLOC | SHF_EXECINSTR;
+    add_section(DATA, ".data", SHT_PROGBITS, 4, data_bytes)->flags = SHF_WRITE | SHF_ALLOC;
+
+    auto symtab = add_section(SYMTAB, ".symtab", SHT_SYMTAB, 4, symbols.bytes);
+    symtab->link = STRTAB;
+    symtab->info = FIRST_GLOBAL_SYMBOL;
+    symtab->entry_size = SYMBOL_SIZE;
+
+    add_section(STRTAB, ".strtab", SHT_STRTAB, 1, strings.strings);
+
+    for (auto [index, name, relocated, relocations] : {
+        std::tuple{REL_TEXT, ".rel.text", TEXT, &text_relocations},
+        std::tuple{REL_DATA, ".rel.data", DATA, &data_relocations}
+    }) {
+        auto header = add_section(index, name, SHT_REL, 4, relocations->bytes);
+        header->link = SYMTAB;
+        header->info = relocated;
+        header->entry_size = RELOCATION_SIZE;
+    }
+
+    // Adds its own name before it is written
+    add_section(SHSTRTAB, ".shstrtab", SHT_STRTAB, 1, section_names.strings);
+
+    out.align(4);
+    uint32_t section_headers_offset = out.size();
+    for (auto& header : headers) {
+        for (uint32_t field : {
+            header.name, header.type, header.flags, uint32_t(0), header.offset,
+            header.size, header.link, header.info, header.alignment, header.entry_size
+        }) {
+            out.word(field);
+        }
+    }
+
+    // ELF header
+    ByteWriter header;
+    header.append(std::string{"\x7f" "ELF"});
+    header.byte(1); // 32 bit
+    header.byte(1); // Little endian
+    header.byte(1); // ELF version 1
+    header.align(16);
+    header.half(ET_REL);
+    header.half(EM_386);
+    header.word(1);
+    header.word(0); // Entry point
+    header.word(0); // Program headers
+    header.word(section_headers_offset);
+    header.word(0); // Flags
+    header.half(ELF_HEADER_SIZE);
+    header.half(0); // Program header size
+    header.half(0); // Number of program headers
+    header.half(SECTION_HEADER_SIZE);
+    header.half(NUM_SECTIONS);
+    header.half(SHSTRTAB);
+    out.bytes.replace(0, ELF_HEADER_SIZE, header.bytes);
+
+    return std::move(out.bytes);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+#include "machine-code.h"
+
+// An ELF32 relocatable object file for i386, with the machine code in .text and static data in .data.
+//
+// References to labels defined in the object are resolved when it is written: relative references within a section
+// are patched in place, and others become relocations against the section. References to labels defined elsewhere
+// become relocations against undefined global symbols, which the linker resolves.
+class ElfObjectFile {
+    MachineCode text;
+    MachineCode data;
+
+  public:
+    void addCode(const MachineCode& code) { text.append(code); }
+    void addData(const MachineCode& code) { data.append(code); }
+
+    // The contents of the .o file
+    std::string write() const;
+};
@@ -0,0 +1,13 @@
+#include "machine-code.h"
+
+void MachineCode::append(const MachineCode& other) {
+    uint32_t start = bytes.size();
+    bytes.insert(bytes.end(), other.bytes.begin(), other.bytes.end());
+    for (auto& label : other.labels) {
+        labels.push_back({label.label, label.offset + start});
+    }
+    for (auto& reference : other.references) {
+        references.push_back({reference.offset + start, reference.symbol, reference.kind});
+    }
+    globals.insert(globals.end(), other.globals.begin(), other.globals.end());
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Encoded x86 machine code of a function or a data section, before it is placed in an object file.
+//
+// Offsets are relative to the start of the code; symbols it uses are left as references for the object file
+// to resolve, or to turn into relocations when they are defined in another object file.
+struct MachineCode {
+    enum class ReferenceKind {
+        ABSOLUTE, // 32 bit address of the symbol (R_386_32)
+        RELATIVE  // 32 bit displacement from the end of the field to the symbol (R_386_PC32)
+    };
+
+    // A 4 byte field holding the address of a symbol, plus the value already stored in the field
+    struct Reference {
+        uint32_t offset;
+        std::string symbol;
+        ReferenceKind kind;
+    };
+
+    struct LabelDefinition {
+        std::string label;
+        uint32_t offset;
+    };
+
+    std::vector<uint8_t> bytes;
+    std::vector<LabelDefinition> labels;
+    std::vector<Reference> references;
+    std::vector<std::string> globals; // Labels exported from the object file
+
+    void appendByte(uint8_t byte) { bytes.push_back(byte); }
+
+    void appendWord(uint16_t word) {
+        appendByte(word & 0xff);
+        appendByte(word >> 8);
+    }
+
+    void appendLong(uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            appendByte((value >> shift) & 0xff);
+        }
+    }
+
+    void patchLong(uint32_t offset, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            bytes[offset + i] = (value >> (8 * i)) & 0xff;
+        }
+    }
+
+    uint32_t readLong(uint32_t offset) const {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(bytes[offset + i]) << (8 * i);
+        }
+        return value;
+    }
+
+    // Append a 4 byte field referring to the symbol, holding addend until it is resolved
+    void appendReference(const std::string& symbol, ReferenceKind kind, int32_t addend = 0) {
+        references.push_back({static_cast<uint32_t>(bytes.size()), symbol, kind});
+        appendLong(addend);
+    }
+
+    // Append other code after this code, moving its labels and references along with it
+    void append(const MachineCode& other);
+};
@@ -0,0 +1,458 @@
+#include "x86-encoder.h"
+
+#include <unordered_map>
+
+#include "exceptions/exceptions.h"
+#include "utillities/overload.h"
+
+using namespace Assembly;
+
+namespace {
+
+// Register field of a ModRM byte, or the register added to a one byte opcode
+uint8_t registerCode(Register reg) {
+    if (!reg.isReal()) {
+        THROW_CompilerError("Cannot encode " + reg.toString() + "; registers must be allocated before encoding");
+    }
+    if (reg.needsLongMode()) {
+        THROW_CompilerError(std::string("Cannot encode ") + reg.realName() + " in 32 bit code");
+    }
+    return reg.encoding();
+}
+
+uint8_t register32Code(Register reg) {
+    if (reg.isReal() && reg.size() != 32) {
+        THROW_CompilerError(std::string("Expected a 32 bit register, got ") + reg.realName());
+    }
+    return registerCode(reg);
+}
+
+bool fitsInByte(int32_t value) {
+    return value >= -128 && value <= 127;
+}
+
+// An address with neither a base nor an index register, i.e. a symbol or a constant address
+bool isAbsolute(const EffectiveAddress& address) {
+    return address.base_register.isNone() && address.index_register.isNone();
+}
+
+uint8_t scaleCode(int scale) {
+    switch (scale) {
+        case 1: return 0;
+        case 2: return 1;
+        case 4: return 2;
+        case 8: return 3;
+        default: THROW_CompilerError("Invalid effective address scale " + std::to_string(scale));
+    }
+}
+
+} // namespace
+
+void X86Encoder::appendAbsoluteAddress(const EffectiveAddress& address) {
+    if (!address.symbol.empty()) {
+        code.appendReference(address.symbol, MachineCode::ReferenceKind::ABSOLUTE, address.displacement);
+    } else {
+        code.appendLong(address.displacement);
+    }
+}
+
+void X86Encoder::encodeMemory(uint8_t reg, const EffectiveAddress& address) {
+    bool has_base = !address.base_register.isNone();
+    bool has_index = !address.index_register.isNone();
+
+    // [disp32], or [symbol + disp32]
+    if (!has_base && !has_index) {
+        code.appendByte(0b00'000'101 | reg << 3);
+        appendAbsoluteAddress(address);
+        return;
+    }
+
+    // [index * scale + disp32] needs a SIB byte with no base, which always has a 32 bit displacement
+    if (!has_base) {
+        uint8_t index = register32Code(address.index_register);
+        if (index == registerCode(REG32_STACKPTR)) {
+            THROW_CompilerError("esp cannot be used as an index register");
+        }
+        code.appendByte(0b00'000'100 | reg << 3);
+        code.appendByte(scaleCode(address.scale) << 6 | index << 3 | 0b101);
+        appendAbsoluteAddress(address);
+        return;
+    }
+
+    uint8_t base = register32Code(address.base_register);
+
+    // No displacement byte is needed for a zero displacement, except with ebp, whose encoding means [disp32]
+    uint8_t mod;
+    if (!address.symbol.empty()) {
+        mod = 0b10;
+    } else if (address.displacement == 0 && base != registerCode(REG32_STACKBASEPTR)) {
+        mod = 0b00;
+    } else if (fitsInByte(address.displacement)) {
+        mod = 0b01;
+    } else {
+        mod = 0b10;
+    }
+
+    if (has_index) {
+        uint8_t index = register32Code(address.index_register);
+        if (index == registerCode(REG32_STACKPTR)) {
+            THROW_CompilerError("esp cannot be used as an index register");
+        }
+        code.appendByte(mod << 6 | reg << 3 | 0b100);
+        code.appendByte(scaleCode(address.scale) << 6 | index << 3 | base);
+    } else if (base == registerCode(REG32_STACKPTR)) {
+        // esp can only be a base through a SIB byte, with no index
+        code.appendByte(mod << 6 | reg << 3 | 0b100);
+        code.appendByte(0b00'100'100);
+    } else {
+        code.appendByte(mod << 6 | reg << 3 | base);
+    }
+
+    if (mod == 0b01) {
+        code.appendByte(static_cast<uint8_t>(address.displacement));
+    } else if (mod == 0b10) {
+        appendAbsoluteAddress(address);
+    }
+}
+
+void X86Encoder::encodeModRM(uint8_t reg, const Operand& rm) {
+    std::visit(util::overload {
+        [&](const Register& rm_register) { code.appendByte(0b11'000'000 | reg << 3 | registerCode(rm_register)); },
+        [&](const EffectiveAddress& address) { encodeMemory(reg, address); },
+        [&](const auto&) { THROW_CompilerError("Operand must be a register or memory"); }
+    }, rm);
+}
+
+// add, or, and, sub, xor and cmp share their encodings, distinguished by a 3 bit opcode extension (the digit)
+void X86Encoder::encodeArithmetic(uint8_t digit, AssemblyCommon& instruction) {
+    Operand& dest = instruction.getOp(1);
+    Operand& src = instruction.getOp(2);
+
+    if (auto src_register = std::get_if<Register>(&src)) {
+        code.appendByte(digit << 3 | 0x01);
+        encodeModRM(register32Code(*src_register), dest);
+    } else if (std::get_if<EffectiveAddress>(&src)) {
+        auto dest_register = std::get_if<Register>(&dest);
+        if (!dest_register) THROW_CompilerError("Instruction cannot have two memory operands");
+        code.appendByte(digit << 3 | 0x03);
+        encodeModRM(register32Code(*dest_register), src);
+    } else if (auto immediate = std::get_if<int32_t>(&src)) {
+        auto dest_register = std::get_if<Register>(&dest);
+        if (fitsInByte(*immediate)) {
+            code.appendByte(0x83);
+            encodeModRM(digit, dest);
+            code.appendByte(static_cast<uint8_t>(*immediate));
+        } else if (dest_register && *dest_register == REG32_ACCUM) {
+            code.appendByte(digit << 3 | 0x05);
+            code.appendLong(*immediate);
+        } else {
+            code.appendByte(0x81);
+            encodeModRM(digit, dest);
+            code.appendLong(*immediate);
+        }
+    } else if (auto label = std::get_if<LabelUse>(&src)) {
+        code.appendByte(0x81);
+        encodeModRM(digit, dest);
+        code.appendReference(label->text, MachineCode::ReferenceKind::ABSOLUTE);
+    }
+}
+
+void X86Encoder::encodeMov(AssemblyCommon& instruction) {
+    Operand& dest = instruction.getOp(1);
+    Operand& src = instruction.getOp(2);
+
+    if (auto dest_register = std::get_if<Register>(&dest)) {
+        uint8_t dest_code = register32Code(*dest_register);
+        std::visit(util::overload {
+            [&](const Register& src_register) {
+                code.appendByte(0x89);
+                encodeModRM(register32Code(src_register), dest);
+            },
+            [&](const EffectiveAddress& address) {
+                if (*dest_register == REG32_ACCUM && isAbsolute(address)) {
+                    // mov eax, [moffs32] has no ModRM byte
+                    code.appendByte(0xa1);
+                    appendAbsoluteAddress(address);
+                    return;
+                }
+                code.appendByte(0x8b);
+                encodeModRM(dest_code, src);
+            },
+            [&](int32_t immediate) {
+                code.appendByte(0xb8 + dest_code);
+                code.appendLong(immediate);
+            },
+            [&](const LabelUse& label) {
+                code.appendByte(0xb8 + dest_code);
+                code.appendReference(label.text, MachineCode::ReferenceKind::ABSOLUTE);
+            }
+        }, src);
+    } else if (std::get_if<EffectiveAddress>(&dest)) {
+        std::visit(util::overload {
+            [&](const Register& src_register) {
+                auto& address = std::get<EffectiveAddress>(dest);
+                if (src_register == REG32_ACCUM && isAbsolute(address)) {
+                    // mov [moffs32], eax has no ModRM byte
+                    code.appendByte(0xa3);
+                    appendAbsoluteAddress(address);
+                    return;
+                }
+                code.appendByte(0x89);
+                encodeModRM(register32Code(src_register), dest);
+            },
+            [&](const EffectiveAddress&) { THROW_CompilerError("Instruction cannot have two memory operands"); },
+            [&](int32_t immediate) {
+                code.appendByte(0xc7);
+                encodeModRM(0, dest);
+                code.appendLong(immediate);
+            },
+            [&](const LabelUse& label) {
+                code.appendByte(0xc7);
+                encodeModRM(0, dest);
+                code.appendReference(label.text, MachineCode::ReferenceKind::ABSOLUTE);
+            }
+        }, src);
+    } else {
+        THROW_CompilerError("Mov destination must be a register or memory");
+    }
+}
+
+void X86Encoder::encodeTest(AssemblyCommon& instruction) {
+    Operand& first = instruction.getOp(1);
+    Operand& second = instruction.getOp(2);
+
+    if (auto second_register = std::get_if<Register>(&second)) {
+        code.appendByte(0x85);
+        encodeModRM(register32Code(*second_register), first);
+    } else if (auto first_register = std::get_if<Register>(&first); first_register && std::get_if<EffectiveAddress>(&second)) {
+        code.appendByte(0x85);
+        encodeModRM(register32Code(*first_register), second);
+    } else if (auto immediate = std::get_if<int32_t>(&second)) {
+        if (first_register && *first_register == REG32_ACCUM) {
+            code.appendByte(0xa9);
+        } else {
+            code.appendByte(0xf7);
+            encodeModRM(0, first);
+        }
+        code.appendLong(*immediate);
+    } else {
+        THROW_CompilerError("Unsupported test operands");
+    }
+}
+
+void X86Encoder::encodeJump(Branch::Condition condition, AssemblyCommon& instruction) {
+    Operand& target = instruction.getOp(1);
+
+    if (auto label = std::get_if<LabelUse>(&target)) {
+        branches.push_back({static_cast<uint32_t>(code.bytes.size()), condition, label->text});
+        return;
+    }
+    if (condition != Branch::ALWAYS) {
+        THROW_CompilerError("Conditional jump target must be a label");
+    }
+
+    // jmp r/m32
+    code.appendByte(0xff);
+    encodeModRM(4, target);
+}
+
+void X86Encoder::encode(AssemblyInstruction& instruction) {
+    std::visit(util::overload {
+        [&](Mov& x) { encodeMov(x); },
+        [&](Lea& x) {
+            auto dest = std::get_if<Register>(&x.getOp(1));
+            if (!dest) THROW_CompilerError("Lea destination must be a register");
+            code.appendByte(0x8d);
+            encodeModRM(register32Code(*dest), x.getOp(2));
+        },
+        [&](Add& x) { encodeArithmetic(0, x); },
+        [&](Or& x) { encodeArithmetic(1, x); },
+        [&](And& x) { encodeArithmetic(4, x); },
+        [&](Sub& x) { encodeArithmetic(5, x); },
+        [&](Xor& x) { encodeArithmetic(6, x); },
+        [&](Cmp& x) { encodeArithmetic(7, x); },
+        [&](Test& x) { encodeTest(x); },
+        [&](MovZX& x) {
+            auto dest = std::get_if<Register>(&x.getOp(1));
+            if (!dest) THROW_CompilerError("MovZX destination must be a register");
+            code.appendByte(0x0f);
+            code.appendByte(0xb6);
+            encodeModRM(register32Code(*dest), x.getOp(2));
+        },
+        [&](Push& x) {
+            std::visit(util::overload {
+                [&](const Register& reg) { code.appendByte(0x50 + register32Code(reg)); },
+                [&](const EffectiveAddress&) {
+                    code.appendByte(0xff);
+                    encodeModRM(6, x.getOp(1));
+                },
+                [&](int32_t immediate) {
+                    if (fitsInByte(immediate)) {
+                        code.appendByte(0x6a);
+                        code.appendByte(static_cast<uint8_t>(immediate));
+                    } else {
+                        code.appendByte(0x68);
+                        code.appendLong(immediate);
+                    }
+                },
+                [&](const LabelUse& label) {
+                    code.appendByte(0x68);
+                    code.appendReference(label.text, MachineCode::ReferenceKind::ABSOLUTE);
+                }
+            }, x.getOp(1));
+        },
+        [&](Pop& x) {
+            if (auto reg = std::get_if<Register>(&x.getOp(1))) {
+                code.appendByte(0x58 + register32Code(*reg));
+            } else {
+                code.appendByte(0x8f);
+                encodeModRM(0, x.getOp(1));
+            }
+        },
+        [&](Cdq&) { code.appendByte(0x99); },
+        [&](Ret& x) {
+            if (x.getNumOps() == 0) {
+                code.appendByte(0xc3);
+                return;
+            }
+            code.appendByte(0xc2);
+            code.appendWord(std::get<int32_t>(x.getOp(1)));
+        },
+        [&](Call& x) {
+            if (auto label = std::get_if<LabelUse>(&x.getOp(1))) {
+                code.appendByte(0xe8);
+                code.appendReference(label->text, MachineCode::ReferenceKind::RELATIVE, -4);
+                return;
+            }
+            code.appendByte(0xff);
+            encodeModRM(2, x.getOp(1));
+        },
+        [&](SysCall&) {
+            code.appendByte(0xcd);
+            code.appendByte(0x80);
+        },
+        [&](SysCall64&) { THROW_CompilerError("Cannot encode syscall in 32 bit code"); },
+        [&](Jump& x) { encodeJump(Branch::ALWAYS, x); },
+        [&](Je& x) { encodeJump(Branch::IF_ZERO, x); },
+        [&](JumpIfNZ& x) { encodeJump(Branch::IF_NOT_ZERO, x); },
+        [&](SetZ& x) { code.appendByte(0x0f); code.appendByte(0x94); encodeModRM(0, x.getOp(1)); },
+        [&](SetNZ& x) { code.appendByte(0x0f); code.appendByte(0x95); encodeModRM(0, x.getOp(1)); },
+        [&](SetL& x) { code.appendByte(0x0f); code.appendByte(0x9c); encodeModRM(0, x.getOp(1)); },
+        [&](SetGE& x) { code.appendByte(0x0f); code.appendByte(0x9d); encodeModRM(0, x.getOp(1)); },
+        [&](SetLE& x) { code.appendByte(0x0f); code.appendByte(0x9e); encodeModRM(0, x.getOp(1)); },
+        [&](SetG& x) { code.appendByte(0x0f); code.appendByte(0x9f); encodeModRM(0, x.getOp(1)); },
+        [&](IMul& x) { code.appendByte(0xf7); encodeModRM(5, x.getOp(1)); },
+        [&](IDiv& x) { code.appendByte(0xf7); encodeModRM(7, x.getOp(1)); },
+        [&](Label& x) {
+            labels.push_back({x.label, static_cast<uint32_t>(code.bytes.size()), branches.size()});
+        },
+        [&](GlobalSymbol& x) { code.globals.push_back(x.symbol); },
+        [&](ExternSymbol&) {},
+        [&](Comment&) {},
+        [&](LineBreak&) {}
+    }, instruction);
+}
+
+MachineCode X86Encoder::layout() {
+    std::unordered_map<std::string, size_t> label_indices;
+    for (size_t i = 0; i < labels.size(); ++i) {
+        label_indices[labels[i].label] = i;
+    }
+
+    // Jumps out of the code always use a 32 bit displacement
+    for (auto& branch : branches) {
+        branch.is_long = !label_indices.count(branch.target);
+    }
+
+    // Offsets in the final code, given the current branch sizes
+    std::vector<uint32_t> branch_offsets(branches.size());
+    std::vector<uint32_t> size_before(branches.size() + 1);
+    auto place = [&]() {
+        size_before[0] = 0;
+        for (size_t i = 0; i < branches.size(); ++i) {
+            branch_offsets[i] = branches[i].position + size_before[i];
+            size_before[i + 1] = size_before[i] + branches[i].size();
+        }
+    };
+    auto label_offset = [&](const std::string& label) {
+        auto& pending = labels[label_indices.at(label)];
+        return pending.position + size_before[pending.branches_before];
+    };
+
+    // Widening a branch only moves other code further apart, so this terminates once no branch has to grow
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        place();
+        for (size_t i = 0; i < branches.size(); ++i) {
+            if (branches[i].is_long) continue;
+            int64_t displacement = int64_t(label_offset(branches[i].target)) - (branch_offsets[i] + branches[i].shortSize());
+            if (displacement < -128 || displacement > 127) {
+                branches[i].is_long = true;
+                changed = true;
+            }
+        }
+    }
+
+    MachineCode result;
+    result.bytes.reserve(code.bytes.size() + size_before.back());
+    result.globals = std::move(code.globals);
+
+    size_t next_reference = 0;
+    uint32_t copied = 0;
+    auto copy_bytes = [&](uint32_t position) {
+        uint32_t shift = result.bytes.size() - copied;
+        while (next_reference < code.references.size() && code.references[next_reference].offset < position) {
+            auto reference = std::move(code.references[next_reference++]);
+            reference.offset += shift;
+            result.references.push_back(std::move(reference));
+        }
+        result.bytes.insert(result.bytes.end(), code.bytes.begin() + copied, code.bytes.begin() + position);
+        copied = position;
+    };
+
+    static constexpr uint8_t SHORT_OPCODES[] = {0xeb, 0x74, 0x75};
+    static constexpr uint8_t LONG_CONDITIONAL_OPCODES[] = {0, 0x84, 0x85};
+
+    for (size_t i = 0; i < branches.size(); ++i) {
+        auto& branch = branches[i];
+        copy_bytes(branch.position);
+
+        if (!branch.is_long) {
+            int32_t displacement = label_offset(branch.target) - (branch_offsets[i] + branch.shortSize());
+            result.appendByte(SHORT_OPCODES[branch.condition]);
+            result.appendByte(static_cast<uint8_t>(displacement));
+            continue;
+        }
+
+        if (branch.condition == Branch::ALWAYS) {
+            result.appendByte(0xe9);
+        } else {
+            result.appendByte(0x0f);
+            result.appendByte(LONG_CONDITIONAL_OPCODES[branch.condition]);
+        }
+        if (label_indices.count(branch.target)) {
+            result.appendLong(label_offset(branch.target) - (branch_offsets[i] + branch.longSize()));
+        } else {
+            result.appendReference(branch.target, MachineCode::ReferenceKind::RELATIVE, -4);
+        }
+    }
+    copy_bytes(code.bytes.size());
+
+    for (auto& label : labels) {
+        result.labels.push_back({label.label, label.position + size_before[label.branches_before]});
+    }
+
+    return result;
+}
+
+MachineCode X86Encoder::encode(std::list<AssemblyInstruction>& instructions) {
+    code = MachineCode();
+    branches.clear();
+    labels.clear();
+
+    for (auto& instruction : instructions) {
+        encode(instruction);
+    }
+    return layout();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "IR-tiling/assembly/assembly-instruction.h"
+#include "machine-code.h"
+
+// Encodes allocated x86 instructions (only real registers) into 32 bit machine code.
+//
+// Jumps to labels defined in the same code start out in their short (8 bit displacement) form, and are widened
+// until every displacement fits, as an assembler would. Other label uses become references in the MachineCode.
+class X86Encoder {
+    // A jump to a label whose encoding is decided once all the labels are placed
+    struct Branch {
+        enum Condition : uint8_t { ALWAYS, IF_ZERO, IF_NOT_ZERO };
+
+        uint32_t position; // Offset in the encoded bytes, which do not include the branches
+        Condition condition;
+        std::string target;
+        bool is_long = false;
+
+        uint32_t shortSize() const { return 2; }
+        uint32_t longSize() const { return condition == ALWAYS ? 5 : 6; }
+        uint32_t size() const { return is_long ? longSize() : shortSize(); }
+    };
+
+    MachineCode code;
+    std::vector<Branch> branches;
+
+    // Label definitions in order, with the number of branches encoded before each
+    struct PendingLabel {
+        std::string label;
+        uint32_t position;
+        size_t branches_before;
+    };
+    std::vector<PendingLabel> labels;
+
+    void encode(AssemblyInstruction& instruction);
+
+    // The 32 bit displacement of an address, relative to its symbol if it has one
+    void appendAbsoluteAddress(const EffectiveAddress& address);
+
+    void encodeModRM(uint8_t reg, const Operand& rm);
+    void encodeMemory(uint8_t reg, const EffectiveAddress& address);
+
+    void encodeArithmetic(uint8_t digit, AssemblyCommon& instruction);
+    void encodeMov(AssemblyCommon& instruction);
+    void encodeTest(AssemblyCommon& instruction);
+    void encodeJump(Branch::Condition condition, AssemblyCommon& instruction);
+
+    // Place the labels and branches, choosing the smallest encoding for each branch
+    MachineCode layout();
+
+  public:
+    MachineCode encode(std::list<AssemblyInstruction>& instructions);
+};
@@ -6,15 +6,14 @@
 #include "exceptions/exceptions.h"
 
 #include <iostream>
-#include <regex>
 
 using namespace Assembly;
 
 void BrainlessRegisterAllocator::findOffsets(std::list<AssemblyInstruction>& function_body) {
     for (auto& instr : function_body) {
-        for (auto& reg : instr.getUsedRegisters()) {
+        for (auto reg : instr.getUsedAbstractRegisters()) {
             // Assign an offset to every abstract register used that hasn't been assigned one yet
-            if (!isRealRegister(reg) && !reg_offsets.count(reg)) {
+            if (!reg_offsets.count(reg)) {
                 reg_offsets[reg] = stack_offset;
                 stack_offset += 4;
             }
@@ -14,5 +14,7 @@ class BrainlessRegisterAllocator : public RegisterAllocator {
     void findOffsets(std::list<AssemblyInstruction>& function_body);
 
   public:
+    using RegisterAllocator::RegisterAllocator;
+
     int32_t allocateRegisters(std::list<AssemblyInstruction>& function_body) override;
 };
@@ -0,0 +1,163 @@
+#include "control-flow-graph.h"
+
+#include <cmath>
+#include <string>
+#include <unordered_map>
+
+using namespace Assembly;
+
+ControlFlowGraph::ControlFlowGraph(std::list<AssemblyInstruction>& function_body) {
+    for (auto& instruction : function_body) {
+        instructions.push_back(&instruction);
+    }
+
+    auto isJump = [](AssemblyInstruction& instruction) {
+        return std::get_if<Jump>(&instruction) || std::get_if<Je>(&instruction) || std::get_if<JumpIfNZ>(&instruction);
+    };
+
+    // Split the instructions into blocks
+    std::unordered_map<std::string, size_t> label_blocks;
+    bool ended_block = true;
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        auto& instruction = *instructions[i];
+
+        auto label = std::get_if<Label>(&instruction);
+        if (ended_block || (label && blocks.back().first != i)) {
+            blocks.push_back(Block{i, i, {}, {}});
+        }
+        if (label) label_blocks[label->label] = blocks.size() - 1;
+
+        blocks.back().end = i + 1;
+        instruction_blocks.push_back(blocks.size() - 1);
+        ended_block = isJump(instruction) || std::get_if<Ret>(&instruction);
+    }
+
+    // Connect each block to the blocks it jumps or falls through to
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        auto& last = *instructions[blocks[b].end - 1];
+
+        if (isJump(last)) {
+            for (auto& target : last.getUsedLabels()) {
+                if (label_blocks.count(target)) blocks[b].successors.push_back(label_blocks[target]);
+            }
+        }
+
+        bool falls_through = !std::get_if<Jump>(&last) && !std::get_if<Ret>(&last);
+        if (falls_through && b + 1 < blocks.size()) {
+            blocks[b].successors.push_back(b + 1);
+        }
+
+        for (auto successor : blocks[b].successors) {
+            blocks[successor].predecessors.push_back(b);
+        }
+    }
+    findDominators();
+    findLoops();
+}
+
+void ControlFlowGraph::findDominators() {
+    dominators.assign(blocks.size(), NO_BLOCK);
+    if (blocks.empty()) return;
+
+    // Number the reachable blocks in postorder, by depth first search from the entry
+    std::vector<size_t> postorder;
+    std::vector<size_t> postorder_numbers(blocks.size(), NO_BLOCK);
+    std::vector<bool> visited(blocks.size(), false);
+    std::vector<std::pair<size_t, size_t>> stack = {{0, 0}}; // Block, and the index of its next successor to visit
+    visited[0] = true;
+
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        if (next < blocks[block].successors.size()) {
+            size_t successor = blocks[block].successors[next++];
+            if (!visited[successor]) {
+                visited[successor] = true;
+                stack.emplace_back(successor, 0);
+            }
+        } else {
+            postorder_numbers[block] = postorder.size();
+            postorder.push_back(block);
+            stack.pop_back();
+        }
+    }
+
+    // Iterate each block's dominator to the nearest common dominator of its predecessors, in reverse postorder
+    // (Cooper, Harvey and Kennedy)
+    auto intersect = [&](size_t a, size_t b) {
+        while (a != b) {
+            while (postorder_numbers[a] < postorder_numbers[b]) a = dominators[a];
+            while (postorder_numbers[b] < postorder_numbers[a]) b = dominators[b];
+        }
+        return a;
+    };
+
+    dominators[0] = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = postorder.rbegin(); it != postorder.rend(); ++it) {
+            size_t block = *it;
+            if (block == 0) continue;
+
+            size_t dominator = NO_BLOCK;
+            for (auto predecessor : blocks[block].predecessors) {
+                if (dominators[predecessor] == NO_BLOCK) continue;
+                dominator = dominator == NO_BLOCK ? predecessor : intersect(predecessor, dominator);
+            }
+
+            if (dominators[block] != dominator) {
+                dominators[block] = dominator;
+                changed = true;
+            }
+        }
+    }
+}
+
+bool ControlFlowGraph::dominates(size_t dominator, size_t block) const {
+    if (dominators[block] == NO_BLOCK) return false;
+
+    while (block != dominator && block != 0) block = dominators[block];
+    return block == dominator;
+}
+
+void ControlFlowGraph::findLoops() {
+    // An edge to a block that dominates where it comes from closes a loop, headed by that block
+    std::unordered_map<size_t, std::vector<size_t>> loop_latches;
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        for (auto successor : blocks[b].successors) {
+            if (dominates(successor, b)) loop_latches[successor].push_back(b);
+        }
+    }
+
+    // The loop is its header, and every block reaching a latch without passing through the header
+    for (auto& [header, latches] : loop_latches) {
+        std::vector<bool> in_loop(blocks.size(), false);
+        in_loop[header] = true;
+
+        std::vector<size_t> worklist;
+        for (auto latch : latches) {
+            if (!in_loop[latch]) {
+                in_loop[latch] = true;
+                worklist.push_back(latch);
+            }
+        }
+        while (!worklist.empty()) {
+            size_t block = worklist.back();
+            worklist.pop_back();
+            for (auto predecessor : blocks[block].predecessors) {
+                if (!in_loop[predecessor]) {
+                    in_loop[predecessor] = true;
+                    worklist.push_back(predecessor);
+                }
+            }
+        }
+
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            if (in_loop[b]) ++blocks[b].loop_depth;
+        }
+    }
+}
+
+double ControlFlowGraph::frequency(size_t instruction) const {
+    return std::pow(10.0, blocks[instruction_blocks[instruction]].loop_depth);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <list>
+#include <vector>
+
+#include "IR-tiling/assembly/assembly-instruction.h"
+
+// Control flow graph of a function body, as basic blocks of consecutive instructions.
+//
+// A block starts at a label or after a jump or return, and ends at the next one. Jumps to labels outside the function
+// (e.g. __exception) leave the function, so they have no successor in the graph.
+//
+// Loops are found as natural loops, from the edges to blocks that dominate where they come from.
+class ControlFlowGraph {
+  public:
+    struct Block {
+        size_t first; // Index of the block's first instruction
+        size_t end;   // Index one past the block's last instruction
+
+        std::vector<size_t> successors;
+        std::vector<size_t> predecessors;
+
+        size_t loop_depth = 0; // Number of loops the block is in
+    };
+
+    // The function body's instructions, indexed in order
+    std::vector<AssemblyInstruction*> instructions;
+
+    // The blocks, in the order of their instructions
+    std::vector<Block> blocks;
+
+    // The block of each instruction
+    std::vector<size_t> instruction_blocks;
+
+  private:
+    // Immediate dominator of each block, or NO_BLOCK if it is unreachable; the entry is its own
+    std::vector<size_t> dominators;
+
+    bool dominates(size_t dominator, size_t block) const;
+    void findDominators();
+    void findLoops();
+
+  public:
+    static constexpr size_t NO_BLOCK = -1;
+
+    explicit ControlFlowGraph(std::list<AssemblyInstruction>& function_body);
+
+    // Estimate of the times the instruction runs per call of the function, as 10 per loop it is in
+    double frequency(size_t instruction) const;
+};
@@ -0,0 +1,445 @@
+#include "graph-colouring-allocator.h"
+
+#include "IR-tiling/assembly/assembly.h"
+#include "IR-tiling/assembly/registers.h"
+#include "exceptions/exceptions.h"
+
+#include <algorithm>
+
+using namespace Assembly;
+
+void GraphColouringRegisterAllocator::build(std::list<AssemblyInstruction>& function_body) {
+    ControlFlowGraph cfg {function_body};
+    Liveness liveness {cfg};
+
+    node_registers.clear();
+    register_nodes.clear();
+    states.clear();
+    adjacency_set.clear();
+    moves.clear();
+    move_worklist.clear();
+    call_live_registers.clear();
+
+    // The colours are precoloured nodes, then every temporary is a node
+    for (auto reg : colours) {
+        register_nodes[reg] = node_registers.size();
+        node_registers.push_back(reg);
+        states.push_back(NodeState::PRECOLOURED);
+    }
+    for (auto reg : liveness.getRegisters()) {
+        if (!reg.isAbstract()) continue;
+        register_nodes[reg] = node_registers.size();
+        node_registers.push_back(reg);
+        states.push_back(NodeState::INITIAL);
+    }
+
+    size_t num_nodes = node_registers.size();
+    degrees.assign(num_nodes, 0);
+    adjacency_lists.assign(num_nodes, {});
+    aliases.resize(num_nodes);
+    node_colours.assign(num_nodes, 0);
+    spill_costs.assign(num_nodes, 0);
+    calls_crossed.assign(num_nodes, 0);
+    node_moves.assign(num_nodes, {});
+    for (size_t i = 0; i < numColours(); ++i) node_colours[i] = i;
+
+    // Node of each register liveness tracks, or none for the real registers that are not colours (e.g. ecx)
+    constexpr size_t NO_NODE = -1;
+    std::vector<size_t> bit_nodes;
+    for (auto reg : liveness.getRegisters()) {
+        bit_nodes.push_back(register_nodes.count(reg) ? register_nodes[reg] : NO_NODE);
+    }
+
+    auto moveNodes = [&](AssemblyInstruction& instruction) -> std::pair<size_t, size_t> {
+        auto move = std::get_if<Mov>(&instruction);
+        if (!move) return {NO_NODE, NO_NODE};
+
+        auto dest = std::get_if<Register>(&move->getOp(1));
+        auto source = std::get_if<Register>(&move->getOp(2));
+        if (!dest || !source || *dest != dest->fullRegister() || *source != source->fullRegister()) {
+            return {NO_NODE, NO_NODE};
+        }
+        if (!register_nodes.count(*dest) || !register_nodes.count(*source)) return {NO_NODE, NO_NODE};
+
+        return {register_nodes[*dest], register_nodes[*source]};
+    };
+
+    // Each register written interferes with every register live after the write, except the source of a move
+    for (size_t b = cfg.blocks.size(); b-- > 0;) {
+        RegisterBits live = liveness.getLiveOut(b);
+
+        for (size_t i = cfg.blocks[b].end; i-- > cfg.blocks[b].first;) {
+            auto& reads = liveness.getReads(i);
+            auto& writes = liveness.getWrites(i);
+            double frequency = cfg.frequency(i);
+
+            reads.forEach([&](size_t bit) {
+                if (bit_nodes[bit] != NO_NODE) spill_costs[bit_nodes[bit]] += frequency;
+            });
+            writes.forEach([&](size_t bit) {
+                if (bit_nodes[bit] != NO_NODE) spill_costs[bit_nodes[bit]] += frequency;
+            });
+
+            if (std::get_if<Call>(cfg.instructions[i])) {
+                auto& live_across = call_live_registers[i];
+                live.forEach([&](size_t bit) {
+                    if (bit_nodes[bit] == NO_NODE || isPrecoloured(bit_nodes[bit])) return;
+                    calls_crossed[bit_nodes[bit]] += frequency;
+                    live_across.push_back(node_registers[bit_nodes[bit]]);
+                });
+            }
+
+            auto [dest, source] = moveNodes(*cfg.instructions[i]);
+            if (dest != NO_NODE) {
+                live.subtract(reads);
+
+                size_t move = moves.size();
+                moves.push_back(Move{dest, source});
+                node_moves[dest].push_back(move);
+                node_moves[source].push_back(move);
+                move_worklist.insert(move);
+            }
+
+            live.unite(writes);
+            writes.forEach([&](size_t written) {
+                if (bit_nodes[written] == NO_NODE) return;
+                live.forEach([&](size_t live_bit) {
+                    if (bit_nodes[live_bit] != NO_NODE) addEdge(bit_nodes[live_bit], bit_nodes[written]);
+                });
+            });
+
+            live.subtract(writes);
+            live.unite(reads);
+        }
+    }
+}
+
+void GraphColouringRegisterAllocator::addEdge(size_t u, size_t v) {
+    if (u == v || interferes(u, v)) return;
+
+    adjacency_set.insert(std::min(u, v) * node_registers.size() + std::max(u, v));
+    if (!isPrecoloured(u)) {
+        adjacency_lists[u].push_back(v);
+        ++degrees[u];
+    }
+    if (!isPrecoloured(v)) {
+        adjacency_lists[v].push_back(u);
+        ++degrees[v];
+    }
+}
+
+bool GraphColouringRegisterAllocator::interferes(size_t u, size_t v) const {
+    return adjacency_set.count(std::min(u, v) * node_registers.size() + std::max(u, v));
+}
+
+std::vector<size_t> GraphColouringRegisterAllocator::nodeMoves(size_t node) const {
+    std::vector<size_t> result;
+    for (auto move : node_moves[node]) {
+        if (moves[move].state == MoveState::ACTIVE || moves[move].state == MoveState::WORKLIST) {
+            result.push_back(move);
+        }
+    }
+    return result;
+}
+
+bool GraphColouringRegisterAllocator::moveRelated(size_t node) const {
+    for (auto move : node_moves[node]) {
+        if (moves[move].state == MoveState::ACTIVE || moves[move].state == MoveState::WORKLIST) return true;
+    }
+    return false;
+}
+
+void GraphColouringRegisterAllocator::setState(size_t node, NodeState state) {
+    switch (states[node]) {
+        case NodeState::SIMPLIFY: simplify_worklist.erase(node); break;
+        case NodeState::FREEZE: freeze_worklist.erase(node); break;
+        case NodeState::SPILL: spill_worklist.erase(node); break;
+        default: break;
+    }
+
+    states[node] = state;
+
+    switch (state) {
+        case NodeState::SIMPLIFY: simplify_worklist.insert(node); break;
+        case NodeState::FREEZE: freeze_worklist.insert(node); break;
+        case NodeState::SPILL: spill_worklist.insert(node); break;
+        default: break;
+    }
+}
+
+void GraphColouringRegisterAllocator::makeWorklists() {
+    for (size_t node = numColours(); node < node_registers.size(); ++node) {
+        if (degrees[node] >= numColours()) {
+            setState(node, NodeState::SPILL);
+        } else if (moveRelated(node)) {
+            setState(node, NodeState::FREEZE);
+        } else {
+            setState(node, NodeState::SIMPLIFY);
+        }
+    }
+}
+
+void GraphColouringRegisterAllocator::simplify() {
+    size_t node = *simplify_worklist.begin();
+    setState(node, NodeState::SELECTED);
+    select_stack.push_back(node);
+
+    for (auto neighbour : adjacency_lists[node]) {
+        if (inGraph(neighbour)) decrementDegree(neighbour);
+    }
+}
+
+void GraphColouringRegisterAllocator::decrementDegree(size_t node) {
+    if (isPrecoloured(node)) return;
+
+    size_t degree = degrees[node]--;
+    if (degree != numColours()) return;
+
+    // The node just became colourable, so moves of it and its neighbours may now coalesce
+    enableMoves(node);
+    for (auto neighbour : adjacency_lists[node]) {
+        if (inGraph(neighbour)) enableMoves(neighbour);
+    }
+
+    if (states[node] == NodeState::SPILL) {
+        setState(node, moveRelated(node) ? NodeState::FREEZE : NodeState::SIMPLIFY);
+    }
+}
+
+void GraphColouringRegisterAllocator::enableMoves(size_t node) {
+    for (auto move : nodeMoves(node)) {
+        if (moves[move].state == MoveState::ACTIVE) {
+            moves[move].state = MoveState::WORKLIST;
+            move_worklist.insert(move);
+        }
+    }
+}
+
+void GraphColouringRegisterAllocator::coalesce() {
+    size_t move = *move_worklist.begin();
+    move_worklist.erase(move);
+
+    size_t x = getAlias(moves[move].dest);
+    size_t y = getAlias(moves[move].source);
+    size_t u = isPrecoloured(y) ? y : x;
+    size_t v = isPrecoloured(y) ? x : y;
+
+    if (u == v) {
+        moves[move].state = MoveState::COALESCED;
+        addWorklist(u);
+    } else if (isPrecoloured(v) || interferes(u, v)) {
+        moves[move].state = MoveState::CONSTRAINED;
+        addWorklist(u);
+        addWorklist(v);
+    } else if (isPrecoloured(u) ? georgeTest(v, u) : briggsTest(u, v)) {
+        moves[move].state = MoveState::COALESCED;
+        combine(u, v);
+        addWorklist(u);
+    } else {
+        moves[move].state = MoveState::ACTIVE;
+    }
+}
+
+void GraphColouringRegisterAllocator::addWorklist(size_t node) {
+    if (!isPrecoloured(node) && !moveRelated(node) && degrees[node] < numColours()) {
+        setState(node, NodeState::SIMPLIFY);
+    }
+}
+
+bool GraphColouringRegisterAllocator::georgeTest(size_t node, size_t precoloured) {
+    // Each neighbour of the node is colourable anyway, or already interferes with the precoloured node
+    for (auto neighbour : adjacency_lists[node]) {
+        if (!inGraph(neighbour)) continue;
+        if (degrees[neighbour] >= numColours() && !isPrecoloured(neighbour) && !interferes(neighbour, precoloured)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GraphColouringRegisterAllocator::briggsTest(size_t u, size_t v) {
+    // The combined node has fewer neighbours of significant degree than there are colours
+    size_t significant = 0;
+    auto isSignificant = [&](size_t neighbour) {
+        return isPrecoloured(neighbour) || degrees[neighbour] >= numColours();
+    };
+
+    for (auto neighbour : adjacency_lists[u]) {
+        if (inGraph(neighbour) && isSignificant(neighbour) && ++significant >= numColours()) return false;
+    }
+    for (auto neighbour : adjacency_lists[v]) {
+        if (!inGraph(neighbour) || !isSignificant(neighbour)) continue;
+        if (interferes(neighbour, u)) continue; // Already counted as a neighbour of u
+        if (++significant >= numColours()) return false;
+    }
+    return true;
+}
+
+size_t GraphColouringRegisterAllocator::getAlias(size_t node) {
+    while (states[node] == NodeState::COALESCED) node = aliases[node];
+    return node;
+}
+
+void GraphColouringRegisterAllocator::combine(size_t u, size_t v) {
+    setState(v, NodeState::COALESCED);
+    aliases[v] = u;
+
+    // Keep only the moves that may still coalesce, so lists do not grow along chains of coalesced moves
+    auto u_moves = nodeMoves(u);
+    auto v_moves = nodeMoves(v);
+    u_moves.insert(u_moves.end(), v_moves.begin(), v_moves.end());
+    std::sort(u_moves.begin(), u_moves.end());
+    u_moves.erase(std::unique(u_moves.begin(), u_moves.end()), u_moves.end());
+    node_moves[u] = std::move(u_moves);
+
+    spill_costs[u] += spill_costs[v];
+    calls_crossed[u] += calls_crossed[v];
+    enableMoves(v);
+
+    for (auto neighbour : adjacency_lists[v]) {
+        if (!inGraph(neighbour)) continue;
+        addEdge(neighbour, u);
+        decrementDegree(neighbour);
+    }
+
+    if (degrees[u] >= numColours() && states[u] == NodeState::FREEZE) {
+        setState(u, NodeState::SPILL);
+    }
+}
+
+void GraphColouringRegisterAllocator::freeze() {
+    size_t node = *freeze_worklist.begin();
+    setState(node, NodeState::SIMPLIFY);
+    freezeMoves(node);
+}
+
+void GraphColouringRegisterAllocator::freezeMoves(size_t node) {
+    // Give up coalescing the node's moves
+    for (auto move : nodeMoves(node)) {
+        size_t x = getAlias(moves[move].dest);
+        size_t y = getAlias(moves[move].source);
+        size_t other = y == getAlias(node) ? x : y;
+
+        move_worklist.erase(move);
+        moves[move].state = MoveState::FROZEN;
+
+        if (states[other] == NodeState::FREEZE && !moveRelated(other) && degrees[other] < numColours()) {
+            setState(other, NodeState::SIMPLIFY);
+        }
+    }
+}
+
+void GraphColouringRegisterAllocator::selectSpill() {
+    // Spill the node used least per neighbour
+    size_t spill = *spill_worklist.begin();
+    for (auto node : spill_worklist) {
+        if (spill_costs[node] * degrees[spill] < spill_costs[spill] * degrees[node]) spill = node;
+    }
+
+    setState(spill, NodeState::SIMPLIFY);
+    freezeMoves(spill);
+}
+
+void GraphColouringRegisterAllocator::assignColours() {
+    while (!select_stack.empty()) {
+        size_t node = select_stack.back();
+        select_stack.pop_back();
+
+        std::vector<bool> taken(numColours(), false);
+        for (auto neighbour : adjacency_lists[node]) {
+            size_t alias = getAlias(neighbour);
+            if (states[alias] == NodeState::COLOURED || isPrecoloured(alias)) taken[node_colours[alias]] = true;
+        }
+
+        states[node] = NodeState::SPILLED;
+        for (auto reg : preferredRegisters(colours, calls_crossed[node], spill_costs[node])) {
+            size_t colour = std::find(colours.begin(), colours.end(), reg) - colours.begin();
+            if (taken[colour]) continue;
+
+            states[node] = NodeState::COLOURED;
+            node_colours[node] = colour;
+            break;
+        }
+    }
+}
+
+size_t GraphColouringRegisterAllocator::assignStackOffsets() {
+    std::unordered_map<size_t, size_t> node_offsets;
+    size_t num_offsets = 0;
+
+    for (size_t node = numColours(); node < node_registers.size(); ++node) {
+        if (states[node] != NodeState::SPILLED) continue;
+
+        std::unordered_set<size_t> taken;
+        for (auto neighbour : adjacency_lists[node]) {
+            size_t alias = getAlias(neighbour);
+            if (node_offsets.count(alias)) taken.insert(node_offsets[alias]);
+        }
+
+        size_t offset = 4;
+        while (taken.count(offset)) offset += 4;
+        node_offsets[node] = offset;
+        num_offsets = std::max(num_offsets, offset / 4);
+    }
+
+    for (size_t node = numColours(); node < node_registers.size(); ++node) {
+        size_t alias = getAlias(node);
+        if (states[alias] == NodeState::SPILLED) reg_offsets[node_registers[node]] = node_offsets[alias];
+    }
+
+    return num_offsets;
+}
+
+bool GraphColouringRegisterAllocator::colour(std::list<AssemblyInstruction>& function_body) {
+    build(function_body);
+    makeWorklists();
+
+    while (!simplify_worklist.empty() || !move_worklist.empty() || !freeze_worklist.empty() || !spill_worklist.empty()) {
+        if (!simplify_worklist.empty()) {
+            simplify();
+        } else if (!move_worklist.empty()) {
+            coalesce();
+        } else if (!freeze_worklist.empty()) {
+            freeze();
+        } else {
+            selectSpill();
+        }
+    }
+
+    assignColours();
+    return std::find(states.begin(), states.end(), NodeState::SPILLED) == states.end();
+}
+
+int32_t GraphColouringRegisterAllocator::allocateRegisters(std::list<AssemblyInstruction>& function_body) {
+    checkAllTemporariesInitialized(function_body);
+
+    // Colour with every register, keeping the instruction registers free if any temporary is spilled
+    colours = registerPool(function_body, false);
+    if (!colour(function_body)) {
+        colours = registerPool(function_body, true);
+        colour(function_body);
+    }
+
+    size_t num_offsets = assignStackOffsets();
+
+    // The register each coloured temporary was given
+    std::unordered_map<Register, Register> allocated;
+    for (size_t node = numColours(); node < node_registers.size(); ++node) {
+        size_t alias = getAlias(node);
+        if (states[alias] == NodeState::COLOURED || isPrecoloured(alias)) {
+            allocated[node_registers[node]] = colours[node_colours[alias]];
+        }
+    }
+
+    // Do actual instruction replacement
+    replaceTemporaries(
+        function_body,
+        [&](Register reg) -> std::optional<Register> {
+            if (allocated.count(reg)) return allocated[reg];
+            return std::nullopt;
+        },
+        [&]() { return 4 * ++num_offsets; }
+    );
+
+    return num_offsets;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "register-allocator.h"
+#include "liveness.h"
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Register allocator that colours the interference graph of the temporaries, by iterated register coalescing
+// (George and Appel).
+//
+// Moves between registers that do not interfere are coalesced, when the Briggs or George test shows colouring stays
+// possible, so the copies the tiler emits disappear. Temporaries that cannot be coloured are spilled by lowest cost,
+// the number of instructions using them over their degree, counting 10 for each loop an instruction is in. Spilled
+// temporaries are loaded into the instruction registers, so if any is spilled the graph is coloured once more without
+// them, and no further rebuild is needed; spilled temporaries that do not interfere share stack spaces. Temporaries
+// live across calls prefer callee saved colours, and only the registers holding values live across a call are saved
+// around it.
+//
+// Slower than linear scanning, but gives better code.
+class GraphColouringRegisterAllocator : public RegisterAllocator {
+    using Register = Assembly::Register;
+
+    enum class NodeState {
+        PRECOLOURED,
+        INITIAL,
+        SIMPLIFY,
+        FREEZE,
+        SPILL,
+        SPILLED,
+        COALESCED,
+        COLOURED,
+        SELECTED
+    };
+
+    enum class MoveState {
+        WORKLIST,
+        ACTIVE,
+        COALESCED,
+        CONSTRAINED,
+        FROZEN
+    };
+
+    // A move between the registers of two nodes
+    struct Move {
+        size_t dest;
+        size_t source;
+        MoveState state = MoveState::WORKLIST;
+    };
+
+    // The colours, in order of preference; the first nodes of the graph are precoloured with them
+    std::vector<Register> colours;
+
+    // Nodes of the interference graph, the colours then the temporaries
+    std::vector<Register> node_registers;
+    std::unordered_map<Register, size_t> register_nodes;
+
+    std::vector<NodeState> states;
+    std::vector<size_t> degrees;
+    std::vector<std::vector<size_t>> adjacency_lists;
+    std::unordered_set<uint64_t> adjacency_set;
+    std::vector<size_t> aliases;
+    std::vector<size_t> node_colours;
+    std::vector<double> spill_costs;
+    std::vector<double> calls_crossed;
+
+    std::vector<Move> moves;
+    std::vector<std::vector<size_t>> node_moves;
+
+    std::set<size_t> simplify_worklist;
+    std::set<size_t> freeze_worklist;
+    std::set<size_t> spill_worklist;
+    std::set<size_t> move_worklist;
+    std::vector<size_t> select_stack;
+
+    size_t numColours() const { return colours.size(); }
+    bool isPrecoloured(size_t node) const { return states[node] == NodeState::PRECOLOURED; }
+
+    // Whether the node is still in the graph, not yet simplified or coalesced away
+    bool inGraph(size_t node) const { return states[node] != NodeState::SELECTED && states[node] != NodeState::COALESCED; }
+
+    // Build the interference graph and moves from the liveness of the function body
+    void build(std::list<AssemblyInstruction>& function_body);
+
+    void addEdge(size_t u, size_t v);
+    bool interferes(size_t u, size_t v) const;
+
+    std::vector<size_t> nodeMoves(size_t node) const;
+    bool moveRelated(size_t node) const;
+
+    void makeWorklists();
+    void setState(size_t node, NodeState state);
+
+    void simplify();
+    void decrementDegree(size_t node);
+    void enableMoves(size_t node);
+
+    void coalesce();
+    void addWorklist(size_t node);
+    bool georgeTest(size_t node, size_t precoloured);
+    bool briggsTest(size_t u, size_t v);
+    size_t getAlias(size_t node);
+    void combine(size_t u, size_t v);
+
+    void freeze();
+    void freezeMoves(size_t node);
+
+    void selectSpill();
+
+    void assignColours();
+
+    // Colour the function's temporaries with the colours, returning whether none were spilled
+    bool colour(std::list<AssemblyInstruction>& function_body);
+
+    // Give each spilled node a stack space not shared with any node it interferes with; returns the number of spaces
+    size_t assignStackOffsets();
+
+  public:
+    using RegisterAllocator::RegisterAllocator;
+
+    int32_t allocateRegisters(std::list<AssemblyInstruction>& function_body) override;
+};
@@ -9,87 +9,73 @@
 #include "utillities/overload.h"
 
 #include <iostream>
-#include <regex>
 #include <cassert>
+#include <unordered_set>
 
 using namespace Assembly;
 
-void LinearScanningRegisterAllocator::activateIntervals(size_t current) {
-    for (auto& interval : intervals) {
-        if (interval.start == current) {
-            assignInterval(interval, interval.assignment);
+bool LinearScanningRegisterAllocator::Interval::overlaps(const Interval& other) const {
+    if (end < other.start || other.end < start) return false;
+
+    // Walk both sorted lists of ranges together
+    auto it = ranges.begin();
+    auto other_it = other.ranges.begin();
+    while (it != ranges.end() && other_it != other.ranges.end()) {
+        if (it->second < other_it->first) {
+            ++it;
+        } else if (other_it->second < it->first) {
+            ++other_it;
+        } else {
+            return true;
         }
     }
-};
+    return false;
+}
 
 void LinearScanningRegisterAllocator::constructIntervals(std::list<AssemblyInstruction>& function_body) {
+    ControlFlowGraph cfg {function_body};
+    Liveness liveness {cfg};
 
-    auto commitInterval = [&](Interval& interval) { 
-        if (isRealRegister(interval.original_register)) {
-            real_intervals[interval.original_register].push_back(interval);
+    for (auto& [reg, ranges] : liveness.liveRanges()) {
+        if (ranges.empty()) continue;
+        if (reg.isReal()) {
+            real_intervals[reg] = Interval(std::move(ranges), reg);
         } else {
-            intervals.push_back(interval); 
-        }
-    };
-
-    std::unordered_map<Register, Interval> uncomitted_intervals;
-
-    size_t current = -1;
-    for (auto &instr : function_body) {
-        ++current;
-
-        for (auto &reg : instr.getUsedRegisters()) {
-            if (stack_ptr_set.count(reg) || stack_base_ptr_set.count(reg)) continue;
-            if (uncomitted_intervals.count(reg)) {
-                uncomitted_intervals[reg].end = current;
-            } else {
-                // Open a new interval for the register
-                uncomitted_intervals[reg] = Interval(current, current, reg); 
-            }
+            intervals.emplace_back(std::move(ranges), reg);
         }
     }
 
-    // Commit all uncomitted intrevals
-    for (auto& [_, interval] : uncomitted_intervals) {
-        commitInterval(interval);
-    }
+    // Count the instructions using each temporary and the calls it is live across
+    std::unordered_map<Register, double> uses;
+    std::unordered_map<Register, double> calls_crossed;
+    auto& registers = liveness.getRegisters();
 
-    // Sort intervals by starting
-    intervals.sort([&](const Interval& first, const Interval& second) -> bool { return first.start < second.start; });
-}
+    liveness.forEachLiveOut([&](size_t i, const RegisterBits& live) {
+        double frequency = cfg.frequency(i);
 
-void LinearScanningRegisterAllocator::extendToLabels(std::list<AssemblyInstruction>& function_body) {
+        RegisterBits used = liveness.getReads(i);
+        used.unite(liveness.getWrites(i));
+        used.forEach([&](size_t bit) { uses[registers[bit]] += frequency; });
 
-    active_intervals = {};
-    std::unordered_map<std::string, size_t> label_indices;
-    std::unordered_map<std::string, std::unordered_set<Interval*>> label_to_no_clobber_intervals;
-
-    size_t current = -1;
-    for (auto &instr : function_body) {
-        ++current;
-
-        finishInactiveIntervals(current);
-        activateIntervals(current);
-
-        if (std::get_if<Label>(&instr)) {
-            label_indices[instr.toString()] = current;
-            for (auto active_interval : active_intervals) {
-                // This interval should be considered still active at any code that jumps to the label
-                //
-                // Any code that jumps to this label should not clobber any register active at the label definition
-                label_to_no_clobber_intervals[instr.toString()].insert(active_interval);
-            }
-            continue;
-        }
+        if (!std::get_if<Call>(cfg.instructions[i])) return;
+        auto& live_across = call_live_registers[i];
+        live.forEach([&](size_t bit) {
+            if (!registers[bit].isAbstract()) return;
+            calls_crossed[registers[bit]] += frequency;
+            live_across.push_back(registers[bit]);
+        });
+    });
 
-        for (auto &label : instr.getUsedLabels()) {
-            // This is an instruction that MAY jump to label
-            auto& no_clobber = label_to_no_clobber_intervals[label + ":"];
-            for (auto interval : no_clobber) {
-                if (interval->end < current) interval->end = current;
-            }
-        }
+    for (auto& interval : intervals) {
+        interval.uses = uses[interval.original_register];
+        interval.calls_crossed = calls_crossed[interval.original_register];
     }
+
+    // Sort intervals by starting, then by register, so the allocation does not depend on hashing order
+    intervals.sort([&](const Interval& first, const Interval& second) -> bool {
+        if (first.start != second.start) return first.start < second.start;
+        return first.original_register < second.original_register;
+    });
 }
 
 void LinearScanningRegisterAllocator::printIntervals(bool print_reals_too) {
@@ -101,10 +87,8 @@ void LinearScanningRegisterAllocator::printIntervals(bool print_reals_too) {
 
     if (print_reals_too) {
         std::cout << "Printing Real Intervals " << "\n";
-        for (auto& [real_name, interval_list] : real_intervals) {
-            for (auto& interval : interval_list) {
-                std::cout << interval.toString() << "\n";
-            }
+        for (auto& [real_name, interval] : real_intervals) {
+            std::cout << interval.toString() << "\n";
         }
         std::cout << "Done Printing Real Intervals " << "\n";
     }
@@ -112,166 +96,132 @@ void LinearScanningRegisterAllocator::printIntervals(bool print_reals_too) {
     std::cout << "\n";
 }
 
-void LinearScanningRegisterAllocator::freeInterval(Interval& interval) {
-    // Free register or stack space, and remove from active intervals
-    std::visit(util::overload {
-        [&](StackOffset offset) {
-            free_stack_spaces.insert(offset);
-        },
-        [&](Register reg) {
-            if (allocatable_registers.count(reg)) {
-                free_registers.insert(reg);
-            }
-        },
-        [&](auto&){}
-    }, interval.assignment);
-
-    active_intervals.remove(&interval);
-}
-
 size_t LinearScanningRegisterAllocator::getFreeStackOffset() {
-    // If there is a free stack space we used before, take that
-    // This prevents us from having to allocate a larger stack frame than necessary
-    for (auto offset : free_stack_spaces) {
-        free_stack_spaces.erase(offset);
-        return offset;
-    }
-
     // Allocate a new stack space
     next_stack_offset += 4;
     return next_stack_offset - 4;
 }
 
-void LinearScanningRegisterAllocator::assignInterval(Interval& interval, Assignment predetermined) {
+bool LinearScanningRegisterAllocator::assignmentIsTaken(Interval& interval, Assignment assignment) {
+    for (auto active_interval : active_intervals) {
+        if (active_interval->assignmentIs(assignment) && active_interval->overlaps(interval)) return true;
+    }
+    return false;
+}
+
+void LinearScanningRegisterAllocator::assignInterval(Interval& interval) {
     // Interval becomes active
     active_intervals.push_back(&interval);
 
-    // If we are supposed to assign to a specific register/offset, do that
-    if (!std::get_if<std::monostate>(&predetermined)) {
-        interval.assignment = predetermined;
-        std::visit(util::overload {
-            [&](Register& reg) { free_registers.erase(reg); },
-            [&](StackOffset offset) { free_stack_spaces.erase(offset); },
-            [&](auto&) {}
-        }, predetermined);
-        return;
-    }
+    auto registers = preferredRegisters(allocatable_registers, interval.calls_crossed, interval.uses);
 
     // If there is a free register, take that
-    for (auto &reg : free_registers) {
+    for (auto reg : registers) {
         if (intervalOverlapsWith(interval, reg)) continue; // Real register cannot be clobbered
+        if (assignmentIsTaken(interval, reg)) continue;
         interval.assignment = reg;
-        free_registers.erase(reg);
+        return;
+    }
+
+    // If the active intervals holding a register weigh less than this one, spill them and take their register
+    Assignment evicted_register;
+    double evicted_uses = interval.uses;
+    for (auto reg : registers) {
+        if (intervalOverlapsWith(interval, reg)) continue;
+
+        double uses = 0;
+        for (auto active_interval : active_intervals) {
+            if (active_interval->assignmentIs(reg) && active_interval->overlaps(interval)) uses += active_interval->uses;
+        }
+        if (uses < evicted_uses) {
+            evicted_register = reg;
+            evicted_uses = uses;
+        }
+    }
+
+    if (Register* reg_ptr = std::get_if<Register>(&evicted_register)) {
+        for (auto active_interval : active_intervals) {
+            if (active_interval->assignmentIs(*reg_ptr) && active_interval->overlaps(interval)) {
+                // Finished intervals are not checked for sharing stack spaces, so an evicted interval gets its own
+                active_interval->assignment = getFreeStackOffset();
+            }
+        }
+        interval.assignment = *reg_ptr;
         return;
     }
 
     // Must spill to stack
 
+    // If there is a free stack space we used before, take that
+    // This prevents us from having to allocate a larger stack frame than necessary
+    for (StackOffset offset = 4; offset < next_stack_offset; offset += 4) {
+        if (assignmentIsTaken(interval, offset)) continue;
+        interval.assignment = offset;
+        return;
+    }
+
     // Allocate a new stack space
     interval.assignment = getFreeStackOffset();
 }
 
 void LinearScanningRegisterAllocator::finishInactiveIntervals(size_t current_instruction) {
-    std::list<Interval*> inactive;
-
-    for (auto interval : active_intervals) {
-        if (interval->end < current_instruction) {
-            inactive.push_back(interval);
-        }
-    }
-
-    for (auto interval : inactive) {
-        freeInterval(*interval);
-    }
+    active_intervals.remove_if([&](Interval* interval) { return interval->end < current_instruction; });
 }
 
 bool LinearScanningRegisterAllocator::intervalOverlapsWith(Interval& interval, Register real_reg) {
-    auto& interval_list = real_intervals[real_reg];
-    for (auto& real_interval : interval_list) {
-        if (interval.start <= real_interval.start && interval.start <= real_interval.end) return true;
-        if (real_interval.start <= interval.start && real_interval.start <= interval.end) return true;
-    }
-    return false;
+    auto real_interval = real_intervals.find(real_reg);
+    return real_interval != real_intervals.end() && interval.overlaps(real_interval->second);
 }
 
-int32_t LinearScanningRegisterAllocator::allocateRegisters(std::list<AssemblyInstruction>& function_body) {
-    checkAllTemporariesInitialized(function_body);
-
-    // Construct the live intervals
-    constructIntervals(function_body);
-    extendToLabels(function_body);
-
-    // Assign each interval a register or stack space
+bool LinearScanningRegisterAllocator::assignIntervals() {
     active_intervals = {};
-    free_registers = allocatable_registers;
+    next_stack_offset = 4;
+    reg_offsets = {};
 
     for (auto& interval : intervals) {
+        interval.assignment = std::monostate();
         finishInactiveIntervals(interval.start);
         assignInterval(interval);
     }
 
-    // Do actual instruction replacement
-    std::list<AssemblyInstruction> new_instructions;
+    // Record the spilled intervals only now, as later intervals may have evicted them
+    bool spilled = false;
+    for (auto& interval : intervals) {
+        if (StackOffset* offset_ptr = std::get_if<StackOffset>(&interval.assignment)) {
+            reg_offsets[interval.original_register] = *offset_ptr;
+            spilled = true;
+        }
+    }
+    return !spilled;
+}
 
-    active_intervals = {};
+int32_t LinearScanningRegisterAllocator::allocateRegisters(std::list<AssemblyInstruction>& function_body) {
+    checkAllTemporariesInitialized(function_body);
 
-    size_t current = -1;
-    for (auto &instruction : function_body) {
-        ++current;
-
-        finishInactiveIntervals(current);
-        activateIntervals(current);
-
-        // If this is a call, save caller saved registers
-        std::unordered_map<Register, StackOffset> caller_save_offsets;
-        if (std::get_if<Call>(&instruction)) {
-            for (auto& real_reg : allocatable_registers) {
-                if (real_reg == REG32_ACCUM) continue;
-                caller_save_offsets[real_reg] = getFreeStackOffset();
-                new_instructions.emplace_back(
-                    Mov(
-                        EffectiveAddress(REG32_STACKBASEPTR, -1 * caller_save_offsets[real_reg]),
-                        real_reg
-                    )
-                );
-            }
-        }
+    // Construct the live intervals
+    constructIntervals(function_body);
 
-        // Replace abstract registers with allocated registers
-        std::string original_string = instruction.toString();
-        bool any_regs = false;
-        for (auto active_interval : active_intervals) {
-            if (Register* reg_ptr = std::get_if<Register>(&active_interval->assignment)) {
-                instruction.replaceRegister(active_interval->original_register, *reg_ptr);
-                any_regs = true;
-            }
-        }
-        if (any_regs) instruction.tagWithComment("Reg allocated, original was " + original_string);
+    // Assign each interval a register or stack space, keeping the instruction registers free if any is spilled
+    allocatable_registers = registerPool(function_body, false);
+    if (!assignIntervals()) {
+        allocatable_registers = registerPool(function_body, true);
+        assignIntervals();
+    }
 
-        // Replace abstract registers with instruction registers with loading/storing stack memory
-        for (auto active_interval : active_intervals) {
-            if (StackOffset* offset_ptr = std::get_if<StackOffset>(&active_interval->assignment)) {
-                reg_offsets[active_interval->original_register] = *offset_ptr;
-            }
-        }
-        replaceAbstracts(instruction, new_instructions);
-
-        // If this is a call, restore currently used caller saved registers
-        if (std::get_if<Call>(&instruction)) {
-            for (auto& real_reg : allocatable_registers) {
-                if (real_reg == REG32_ACCUM) continue;
-                new_instructions.emplace_back(
-                    Mov(
-                        real_reg,
-                        EffectiveAddress(REG32_STACKBASEPTR, -1 * caller_save_offsets[real_reg])
-                    )
-                );
-                free_stack_spaces.insert(caller_save_offsets[real_reg]);
-            }
-        }
+    std::unordered_map<Register, Interval*> register_intervals;
+    for (auto& interval : intervals) {
+        register_intervals[interval.original_register] = &interval;
     }
 
-    function_body = new_instructions;
+    // Do actual instruction replacement
+    replaceTemporaries(
+        function_body,
+        [&](Register reg) -> std::optional<Register> {
+            if (Register* reg_ptr = std::get_if<Register>(&register_intervals[reg]->assignment)) return *reg_ptr;
+            return std::nullopt;
+        },
+        [&]() { return getFreeStackOffset(); }
+    );
 
     return (next_stack_offset - 4) / 4;
 }
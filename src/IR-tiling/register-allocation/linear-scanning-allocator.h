@@ -1,6 +1,7 @@
 #pragma once
 
 #include "register-allocator.h"
+#include "liveness.h"
 
 #include <unordered_map>
 #include <vector>
@@ -8,70 +9,85 @@
 #include <variant>
 
 // Register allocator that greedily allocates registers based on the live interval of temporaries.
+//
+// Live intervals come from dataflow liveness, so they may have holes where the temporary's value is dead; two
+// intervals only compete for a register if their ranges overlap. Only the registers holding values live across a call
+// are saved around it.
+//
+// Intervals are weighed by their uses, counting 10 for each loop a use is in. When no register is free, the active
+// intervals holding one are spilled instead if they weigh less than the new interval, so values used in loops stay in
+// registers.
 class LinearScanningRegisterAllocator : public RegisterAllocator {
 
     using StackOffset = size_t;
-    using Register = std::string;
+    using Register = Assembly::Register;
     using Assignment = std::variant<std::monostate, StackOffset, Register>;
 
     struct Interval {
         size_t start;
         size_t end;
 
+        // Instructions the register is live at, sorted, from start to end
+        std::vector<Liveness::Range> ranges;
+
         Register original_register;
         Assignment assignment;
 
+        // Instructions using the register, and calls the register is live across, counted by their frequency
+        double uses = 0;
+        double calls_crossed = 0;
+
         bool assignmentIs(Assignment other_assignment) {
             return assignment == other_assignment;
         }
 
-        Interval(size_t start, size_t end, Register original_register) 
-            : start{start}, end{end}, original_register{original_register}, assignment{} {}
+        // Whether both registers are live at some instruction
+        bool overlaps(const Interval& other) const;
+
+        Interval(std::vector<Liveness::Range> ranges, Register original_register)
+            : start{ranges.front().first}, end{ranges.back().second}, ranges{std::move(ranges)},
+              original_register{original_register}, assignment{} {}
         Interval() = default;
 
         std::string toString() {
             std::string assignment_string = "";
 
-            if (std::get_if<Register>(&assignment)) assignment_string = std::get<Register>(assignment) ;
+            if (std::get_if<Register>(&assignment)) assignment_string = std::get<Register>(assignment).toString();
             if (std::get_if<StackOffset>(&assignment)) assignment_string = std::to_string(std::get<StackOffset>(assignment));
 
-            return "Interval(" + std::to_string(start) + ", " + std::to_string(end) + ", " 
-            + original_register 
-            + " -> " 
-            + assignment_string;
+            std::string ranges_string = "";
+            for (auto& [first, last] : ranges) {
+                ranges_string += " [" + std::to_string(first) + ", " + std::to_string(last) + "]";
+            }
+
+            return "Interval(" + std::to_string(start) + ", " + std::to_string(end) + ", "
+            + original_register.toString()
+            + " -> "
+            + assignment_string
+            + ")" + ranges_string;
         }
     };
 
-    std::unordered_set<Register> allocatable_registers = {
-        Assembly::REG32_ACCUM,
-        Assembly::REG32_BASE,
-        // Assembly::REG32_COUNTER,
-        Assembly::REG32_DATA,
-        // Assembly::REG32_SOURCE,
-        // Assembly::REG32_DEST
-    };
+    // The registers intervals may be assigned, in order of preference
+    std::vector<Register> allocatable_registers;
     size_t next_stack_offset = 4;
 
-    std::unordered_set<Register> free_registers = {};
-    std::unordered_set<StackOffset> free_stack_spaces = {};
-
     std::list<Interval> intervals = {};
-    std::unordered_map<std::string, std::list<Interval>> real_intervals = {};
+    std::unordered_map<Register, Interval> real_intervals = {};
 
     std::list<Interval*> active_intervals = {};
 
-    void activateIntervals(size_t current);
-
     void constructIntervals(std::list<AssemblyInstruction>& function_body);
 
-    // Extend intervals to cover jumping to labels which use the abstract register
-    void extendToLabels(std::list<AssemblyInstruction>& function_body);
-
     size_t getFreeStackOffset();
 
-    void assignInterval(Interval& interval, Assignment predetermined=std::monostate());
+    // Whether an active interval assigned the register or stack space overlaps the interval
+    bool assignmentIsTaken(Interval& interval, Assignment assignment);
 
-    void freeInterval(Interval& interval);
+    void assignInterval(Interval& interval);
+
+    // Assign every interval a register or stack space, returning whether all got registers
+    bool assignIntervals();
 
     void finishInactiveIntervals(size_t current_instruction);
 
@@ -81,5 +97,7 @@ class LinearScanningRegisterAllocator : public RegisterAllocator {
     void printIntervals(bool print_reals_too=true);
 
   public:
+    using RegisterAllocator::RegisterAllocator;
+
     int32_t allocateRegisters(std::list<AssemblyInstruction>& function_body) override;
 };
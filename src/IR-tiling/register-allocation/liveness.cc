@@ -0,0 +1,97 @@
+#include "liveness.h"
+
+#include <algorithm>
+
+using namespace Assembly;
+
+bool Liveness::isTracked(Register reg) {
+    return reg != REG32_STACKPTR && reg != REG32_STACKBASEPTR;
+}
+
+size_t Liveness::number(Register reg) {
+    auto [it, inserted] = register_numbers.emplace(reg, registers.size());
+    if (inserted) registers.push_back(reg);
+    return it->second;
+}
+
+Liveness::Liveness(const ControlFlowGraph& cfg) : cfg{cfg} {
+    // Number the registers, then record the ones each instruction reads and writes
+    for (auto instruction : cfg.instructions) {
+        for (auto reg : instruction->getUsedRegisters()) {
+            if (isTracked(reg)) number(reg);
+        }
+    }
+
+    for (auto instruction : cfg.instructions) {
+        reads.emplace_back(registers.size());
+        writes.emplace_back(registers.size());
+        for (auto reg : instruction->getReadRegisters()) {
+            if (isTracked(reg)) reads.back().set(register_numbers[reg]);
+        }
+        for (auto reg : instruction->getWriteRegisters()) {
+            if (isTracked(reg)) writes.back().set(register_numbers[reg]);
+        }
+    }
+
+    // Summarize each block by the registers it reads before writing (gen), and the registers it writes (kill)
+    size_t num_blocks = cfg.blocks.size();
+    std::vector<RegisterBits> gen(num_blocks, RegisterBits(registers.size()));
+    std::vector<RegisterBits> kill(num_blocks, RegisterBits(registers.size()));
+
+    for (size_t b = 0; b < num_blocks; ++b) {
+        for (size_t i = cfg.blocks[b].first; i < cfg.blocks[b].end; ++i) {
+            RegisterBits read = reads[i];
+            read.subtract(kill[b]);
+            gen[b].unite(read);
+            kill[b].unite(writes[i]);
+        }
+    }
+
+    // Iterate live_in = gen + (live_out - kill), live_out = union of successors' live_in, until nothing changes.
+    // Blocks are visited last to first, so most are visited after their successors.
+    live_in.assign(num_blocks, RegisterBits(registers.size()));
+    live_out.assign(num_blocks, RegisterBits(registers.size()));
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t b = num_blocks; b-- > 0;) {
+            for (auto successor : cfg.blocks[b].successors) {
+                live_out[b].unite(live_in[successor]);
+            }
+
+            RegisterBits in = live_out[b];
+            in.subtract(kill[b]);
+            in.unite(gen[b]);
+            changed |= live_in[b].unite(in);
+        }
+    }
+}
+
+std::unordered_map<Register, std::vector<Liveness::Range>> Liveness::liveRanges() const {
+    std::vector<std::vector<Range>> ranges(registers.size());
+
+    // Walk the instructions last to first, so each register's ranges are found in decreasing order
+    forEachLiveOut([&](size_t i, const RegisterBits& live) {
+        // Live at the instruction: live after it, or used by it
+        RegisterBits live_at = live;
+        live_at.unite(reads[i]);
+        live_at.unite(writes[i]);
+
+        live_at.forEach([&](size_t reg) {
+            auto& reg_ranges = ranges[reg];
+            if (!reg_ranges.empty() && reg_ranges.back().first == i + 1) {
+                reg_ranges.back().first = i;
+            } else {
+                reg_ranges.emplace_back(i, i);
+            }
+        });
+    });
+
+    std::unordered_map<Register, std::vector<Range>> result;
+    for (size_t reg = 0; reg < registers.size(); ++reg) {
+        std::reverse(ranges[reg].begin(), ranges[reg].end());
+        result[registers[reg]] = std::move(ranges[reg]);
+    }
+    return result;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "control-flow-graph.h"
+#include "IR-tiling/assembly/registers.h"
+
+// Set of registers, as one bit per register numbered by Liveness
+class RegisterBits {
+    std::vector<uint64_t> words;
+
+  public:
+    explicit RegisterBits(size_t size = 0) : words((size + 63) / 64) {}
+
+    void set(size_t bit) { words[bit / 64] |= uint64_t{1} << (bit % 64); }
+    void reset(size_t bit) { words[bit / 64] &= ~(uint64_t{1} << (bit % 64)); }
+    bool test(size_t bit) const { return words[bit / 64] >> (bit % 64) & 1; }
+
+    // Add the bits of other, returning whether any were new
+    bool unite(const RegisterBits& other) {
+        bool changed = false;
+        for (size_t i = 0; i < words.size(); ++i) {
+            uint64_t united = words[i] | other.words[i];
+            changed |= united != words[i];
+            words[i] = united;
+        }
+        return changed;
+    }
+
+    // Remove the bits of other
+    void subtract(const RegisterBits& other) {
+        for (size_t i = 0; i < words.size(); ++i) words[i] &= ~other.words[i];
+    }
+
+    // Call f with each set bit, in increasing order
+    template <typename Function>
+    void forEach(Function f) const {
+        for (size_t i = 0; i < words.size(); ++i) {
+            for (uint64_t word = words[i]; word; word &= word - 1) {
+                f(i * 64 + __builtin_ctzll(word));
+            }
+        }
+    }
+};
+
+// Liveness of the registers of a function body, by backward dataflow over its control flow graph.
+//
+// A register is live at an instruction if it is read or written there, or its value may be read later without being
+// written first. The stack and base pointers are not tracked.
+class Liveness {
+  public:
+    // Instructions from first to last inclusive
+    using Range = std::pair<size_t, size_t>;
+
+  private:
+    const ControlFlowGraph& cfg;
+
+    // Every tracked register, numbered by its index
+    std::vector<Assembly::Register> registers;
+    std::unordered_map<Assembly::Register, size_t> register_numbers;
+
+    // Registers read and written by each instruction
+    std::vector<RegisterBits> reads;
+    std::vector<RegisterBits> writes;
+
+    // Registers live on entry to and exit from each block
+    std::vector<RegisterBits> live_in;
+    std::vector<RegisterBits> live_out;
+
+    size_t number(Assembly::Register reg);
+    static bool isTracked(Assembly::Register reg);
+
+  public:
+    explicit Liveness(const ControlFlowGraph& cfg);
+
+    // The tracked registers, indexed by the bit numbering the sets below use
+    const std::vector<Assembly::Register>& getRegisters() const { return registers; }
+
+    const RegisterBits& getReads(size_t instruction) const { return reads[instruction]; }
+    const RegisterBits& getWrites(size_t instruction) const { return writes[instruction]; }
+    const RegisterBits& getLiveOut(size_t block) const { return live_out[block]; }
+
+    // The instructions each register is live at, as sorted ranges; a register's value is dead in the holes between them
+    std::unordered_map<Assembly::Register, std::vector<Range>> liveRanges() const;
+
+    // Call f with the index of each instruction and the registers live after it, from the last instruction to the first
+    template <typename Function>
+    void forEachLiveOut(Function f) const {
+        for (size_t b = cfg.blocks.size(); b-- > 0;) {
+            RegisterBits live = live_out[b];
+
+            for (size_t i = cfg.blocks[b].end; i-- > cfg.blocks[b].first;) {
+                f(i, static_cast<const RegisterBits&>(live));
+                live.subtract(writes[i]);
+                live.unite(reads[i]);
+            }
+        }
+    }
+};
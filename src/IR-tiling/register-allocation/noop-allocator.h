@@ -6,5 +6,7 @@
 class NoopRegisterAllocator : public RegisterAllocator {
 
   public:
+    using RegisterAllocator::RegisterAllocator;
+
     int32_t allocateRegisters(std::list<AssemblyInstruction>& function_body) override { return 0; }
 };
@@ -1,4 +1,4 @@
-#include <unordered_map>
+#include <algorithm>
 #include <string>
 
 #include "register-allocator.h"
@@ -9,45 +9,101 @@ using namespace Assembly;
 
 // Helper for asserting temporaries are not used without values being set
 void RegisterAllocator::checkAllTemporariesInitialized(std::list<AssemblyInstruction>& function_body) {
-    std::unordered_set<std::string> initialized;
+    std::vector<bool> initialized;
 
     for (auto& instr : function_body) {
-        for (auto& reg : instr.getReadRegisters()) {
-            if (!isRealRegister(reg) && !initialized.count(reg)) {
-                THROW_CompilerError("Temporary " + reg + " was never initialized!");
+        for (auto reg : instr.getReadRegisters()) {
+            if (reg.isAbstract() && (reg.abstractIndex() >= initialized.size() || !initialized[reg.abstractIndex()])) {
+                THROW_CompilerError("Temporary " + reg.toString() + " was never initialized!");
             }
         }
 
-        for (auto& reg : instr.getWriteRegisters()) {
-            if (!isRealRegister(reg) && !initialized.count(reg)) {
+        for (auto reg : instr.getWriteRegisters()) {
+            if (reg.isAbstract()) {
                 // Temporary is set to a value as of this instruction
-                initialized.insert(reg);
+                if (reg.abstractIndex() >= initialized.size()) initialized.resize(reg.abstractIndex() + 1);
+                initialized[reg.abstractIndex()] = true;
             }
         }
     }
 }
 
-AssemblyInstruction RegisterAllocator::loadAbstractRegister(std::string reg_to, std::string abstract_reg) {
+std::vector<Register> RegisterAllocator::registerPool(std::list<AssemblyInstruction>& function_body, bool spilling) {
+    auto pool = allocatableRegisters(target);
+    if (!spilling) return pool;
+
+    size_t num_instruction_registers = 0;
+    for (auto& instr : function_body) {
+        num_instruction_registers = std::max(num_instruction_registers, instr.getUsedAbstractRegisters().size());
+    }
+    num_instruction_registers = std::min(num_instruction_registers, instruction_registers.size());
+
+    for (size_t i = 0; i < num_instruction_registers; ++i) {
+        pool.erase(std::remove(pool.begin(), pool.end(), instruction_registers[i]), pool.end());
+    }
+    return pool;
+}
+
+std::vector<Register> RegisterAllocator::callerSavedRegisters(
+    AssemblyInstruction& call, const std::unordered_set<Register>& live_across
+) {
+    // Functions the compiler generates keep the callee saved registers intact, the runtime's clobber what the call writes
+    bool calls_runtime = false;
+    if (auto label = std::get_if<LabelUse>(&std::get<Call>(call).getOp(1))) calls_runtime = isRuntimeFunction(label->text);
+
+    auto callee_saved = calleeSavedRegisters(target);
+    auto& written = call.getWriteRegisters();
+    std::vector<Register> result;
+    for (auto reg : allocatableRegisters(target)) {
+        if (reg == REG32_ACCUM || !live_across.count(reg)) continue; // eax holds the return value
+
+        bool clobbered = calls_runtime ? written.count(reg) : !std::count(callee_saved.begin(), callee_saved.end(), reg);
+        if (clobbered) result.push_back(reg);
+    }
+    return result;
+}
+
+std::vector<Register> RegisterAllocator::preferredRegisters(
+    const std::vector<Register>& pool, double calls_crossed, double uses
+) {
+    if (calls_crossed == 0) return pool;
+
+    // A caller saved register is stored and loaded at each call, a stack space once per use
+    auto callee_saved = calleeSavedRegisters(target);
+    bool caller_saved_worthwhile = 2 * calls_crossed <= uses;
+
+    std::vector<Register> result;
+    for (auto reg : pool) {
+        if (std::count(callee_saved.begin(), callee_saved.end(), reg)) result.push_back(reg);
+    }
+    for (auto reg : pool) {
+        if (caller_saved_worthwhile && !std::count(callee_saved.begin(), callee_saved.end(), reg)) result.push_back(reg);
+    }
+    return result;
+}
+
+AssemblyInstruction RegisterAllocator::loadAbstractRegister(Register reg_to, Register abstract_reg) {
     return Mov(reg_to, EffectiveAddress(REG32_STACKBASEPTR, -1 * reg_offsets[abstract_reg]));
 }
 
-AssemblyInstruction RegisterAllocator::storeAbstractRegister(std::string abstract_reg, std::string reg_from) {
+AssemblyInstruction RegisterAllocator::storeAbstractRegister(Register abstract_reg, Register reg_from) {
     return Mov(EffectiveAddress(REG32_STACKBASEPTR, -1 * reg_offsets[abstract_reg]), reg_from);
 }
 
 void RegisterAllocator::replaceAbstracts(AssemblyInstruction& instruction, std::list<AssemblyInstruction>& target) {
-    std::string original_instruction_text = instruction.toString();
-
     auto used_registers = instruction.getUsedAbstractRegisters();
     auto read_registers = instruction.getReadAbstractRegisters();
     auto write_registers = instruction.getWriteAbstractRegisters();
 
-    target.push_back(LineBreak());
+    // The original instruction is only rendered for the annotated listing, or an error
+    std::string original_instruction_text = annotate || used_registers.size() > 3 ? instruction.toString() : "";
+
+    if (annotate) target.push_back(LineBreak());
 
     // Each x86 instruction can use at most 3 registers; just asserting this is true
     if (used_registers.size() > 3) {
         std::string found_registers = "";
-        for (auto& reg : used_registers) found_registers += " " + reg;
+        for (auto reg : used_registers) found_registers += " " + reg.toString();
         THROW_CompilerError(
             "x86 instruction using more than 3 registers? Something is wrong.\n"
             "Instruction: " + original_instruction_text + "\n"
@@ -55,30 +111,102 @@ void RegisterAllocator::replaceAbstracts(AssemblyInstruction& instruction, std::
         );
     }
 
-    // Replace each abstract register the instruction uses with a real register
-    size_t next_real_reg = 0;
-    std::unordered_map<std::string, std::string> abstract_to_real;
+    // Replace each abstract register the instruction uses with a real register, the i'th used with the i'th instruction register
+    auto realRegisterFor = [&](Register abstract_reg) {
+        return instruction_registers[std::find(used_registers.begin(), used_registers.end(), abstract_reg) - used_registers.begin()];
+    };
 
-    for (auto& reg : used_registers) {
-        abstract_to_real[reg] = instruction_registers[next_real_reg++];
-        instruction.replaceRegister(reg, abstract_to_real[reg]);
+    for (auto reg : used_registers) {
+        instruction.replaceRegister(reg, realRegisterFor(reg));
     }
 
     // Add a load instruction for each abstract register the instruction reads
-    for (auto& reg : read_registers) {
-        target.emplace_back(loadAbstractRegister(abstract_to_real[reg], reg));
-        target.back().tagWithComment("Load from " + reg);
+    for (auto reg : read_registers) {
+        target.emplace_back(loadAbstractRegister(realRegisterFor(reg), reg));
+        if (annotate) target.back().tagWithComment("Load from " + reg.toString());
     }
 
     // Add the original instruction, now modified to use real registers
-    if (next_real_reg > 0 && !instruction.hasComment()) {
+    if (annotate && !used_registers.empty() && !instruction.hasComment()) {
         instruction.tagWithComment(original_instruction_text); // Tag if we did replacement
     }
     target.push_back(instruction);
 
     // Add a store instruction for each abstract register the instruction writes
-    for (auto& reg : write_registers) {
-        target.emplace_back(storeAbstractRegister(reg, abstract_to_real[reg]));
-        target.back().tagWithComment("Store to " + reg);
+    for (auto reg : write_registers) {
+        target.emplace_back(storeAbstractRegister(reg, realRegisterFor(reg)));
+        if (annotate) target.back().tagWithComment("Store to " + reg.toString());
     }
 }  
+
+void RegisterAllocator::replaceTemporaries(
+    std::list<AssemblyInstruction>& function_body,
+    const std::function<std::optional<Register>(Register)>& allocatedRegister,
+    const std::function<size_t()>& newStackOffset
+) {
+    std::list<AssemblyInstruction> new_instructions;
+
+    // Stack spaces caller saved registers are kept in during calls
+    std::unordered_map<Register, size_t> caller_save_offsets;
+
+    size_t index = 0;
+    for (auto &instruction : function_body) {
+        // If this is a call, save the caller saved registers holding values live across it
+        std::vector<Register> caller_saved;
+        if (std::get_if<Call>(&instruction)) {
+            std::unordered_set<Register> live_across;
+            for (auto reg : call_live_registers[index]) {
+                if (auto allocated = allocatedRegister(reg)) live_across.insert(*allocated);
+            }
+
+            caller_saved = callerSavedRegisters(instruction, live_across);
+            for (auto& real_reg : caller_saved) {
+                if (!caller_save_offsets.count(real_reg)) caller_save_offsets[real_reg] = newStackOffset();
+                new_instructions.emplace_back(
+                    Mov(
+                        EffectiveAddress(REG32_STACKBASEPTR, -1 * caller_save_offsets[real_reg]),
+                        real_reg
+                    )
+                );
+            }
+        }
+        ++index;
+
+        // Replace abstract registers with allocated registers
+        std::string original_string = annotate ? instruction.toString() : "";
+        bool any_regs = false;
+        for (auto reg : instruction.getUsedAbstractRegisters()) {
+            if (auto allocated = allocatedRegister(reg)) {
+                instruction.replaceRegister(reg, *allocated);
+                any_regs = true;
+            }
+        }
+
+        // Drop moves whose temporaries were coalesced, or spilled to the same stack space
+        if (auto move = std::get_if<Mov>(&instruction)) {
+            auto dest = std::get_if<Register>(&move->getOp(1));
+            auto source = std::get_if<Register>(&move->getOp(2));
+            if (dest && source && (*dest == *source
+                || (dest->isAbstract() && source->isAbstract() && reg_offsets[*dest] == reg_offsets[*source]))) {
+                if (annotate) new_instructions.emplace_back(Comment("Coalesced " + original_string));
+                continue;
+            }
+        }
+        if (any_regs && annotate) instruction.tagWithComment("Reg allocated, original was " + original_string);
+
+        // Replace abstract registers with instruction registers with loading/storing stack memory
+        replaceAbstracts(instruction, new_instructions);
+
+        // If this is a call, restore caller saved registers
+        for (auto& real_reg : caller_saved) {
+            new_instructions.emplace_back(
+                Mov(
+                    real_reg,
+                    EffectiveAddress(REG32_STACKBASEPTR, -1 * caller_save_offsets[real_reg])
+                )
+            );
+        }
+    }
+
+    function_body = new_instructions;
+}
@@ -1,31 +1,74 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <list>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "IR-tiling/assembly/assembly-instruction.h"
 #include "IR-tiling/assembly/registers.h"
+#include "IR-tiling/assembly/target.h"
 
 // Abstract class for a register allocation algorithm.
 class RegisterAllocator {
   protected:
-    std::unordered_map<std::string, int> reg_offsets;
+    // Whether to tag instructions with comments explaining the allocation, for an annotated listing
+    bool annotate;
+
+    // Machine the function is allocated for, which decides the registers available
+    Assembly::Target target;
+
+    std::unordered_map<Assembly::Register, int> reg_offsets;
+
+    // Temporaries live across each call, by the index of the call instruction
+    std::unordered_map<size_t, std::vector<Assembly::Register>> call_live_registers;
 
     // Registers stack-allocated temporaries are loaded into before being used in an instruction
-    std::vector<std::string> instruction_registers 
+    std::vector<Assembly::Register> instruction_registers 
       = {Assembly::REG32_COUNTER, Assembly::REG32_SOURCE, Assembly::REG32_DEST};
 
+    // The registers temporaries may be kept in. If spilling, the instruction registers spilled temporaries are loaded
+    // into are left out, as many as any one instruction of the function uses.
+    std::vector<Assembly::Register> registerPool(std::list<AssemblyInstruction>& function_body, bool spilling);
+
+    // The registers holding values live across the call that the called function may clobber, so the caller saves them
+    std::vector<Assembly::Register> callerSavedRegisters(
+        AssemblyInstruction& call, const std::unordered_set<Assembly::Register>& live_across
+    );
+
+    // The registers of the pool a temporary may be given, in order of preference. Temporaries live across calls prefer
+    // callee saved registers, and are kept off caller saved ones when saving them at each call would cost more memory
+    // accesses than keeping the temporary on the stack. The calls crossed and uses are counted by their frequency.
+    std::vector<Assembly::Register> preferredRegisters(
+        const std::vector<Assembly::Register>& pool, double calls_crossed, double uses
+    );
+
     // Helper for asserting temporaries are not used without values being set
     void checkAllTemporariesInitialized(std::list<AssemblyInstruction>& function_body);
 
     // Generate code to load the abstract register
-    AssemblyInstruction loadAbstractRegister(std::string reg_to, std::string abstract_reg);
+    AssemblyInstruction loadAbstractRegister(Assembly::Register reg_to, Assembly::Register abstract_reg);
 
     // Generate code to store the abstract register
-    AssemblyInstruction storeAbstractRegister(std::string abstract_reg, std::string reg_from);
+    AssemblyInstruction storeAbstractRegister(Assembly::Register abstract_reg, Assembly::Register reg_from);
 
     // Generate code to load all abstract registers into real registers, and replace the use of abstracts with reals
     void replaceAbstracts(AssemblyInstruction& instruction, std::list<AssemblyInstruction>& target);
+
+    // Replace the temporaries of the function body with the registers they were allocated, or their stack spaces, and
+    // save the registers each call clobbers around it. Moves left copying a register or stack space to itself are
+    // dropped. The stack spaces saved registers are kept in are taken from newStackOffset, once per register.
+    void replaceTemporaries(
+        std::list<AssemblyInstruction>& function_body,
+        const std::function<std::optional<Assembly::Register>(Assembly::Register)>& allocatedRegister,
+        const std::function<size_t()>& newStackOffset
+    );
   public:
+    explicit RegisterAllocator(bool annotate = false, Assembly::Target target = Assembly::Target::X86)
+        : annotate{annotate}, target{target} {}
+
     // Allocate concrete registers or "spill to stack" for all abstract registers in a function body, mutating it.
     //
     // Returns the number of stack spaces required for the function.
@@ -7,44 +7,52 @@
 #include "IR-tiling/assembly/assembly-instruction.h"
 #include "IR-tiling/assembly/registers.h"
 
-#include <regex>
-
 using namespace Assembly;
 
-size_t IRToTilesConverter::abstract_reg_count = 0;
+StatementTile IRToTilesConverter::tileFunctionBody(const FlatIR &body) {
+    this->body = &body;
+    memo.assign(body.size(), Tile());
+    tiled.assign(body.size(), false);
+
+    return tile(body.root());
+}
 
-void IRToTilesConverter::decideIsCandidate(ExpressionIR& ir, Tile candidate) {
-    Tile& optimal_tile = expression_memo[&ir];
+void IRToTilesConverter::decideIsCandidate(IRNodeId id, Tile candidate) {
+    Tile& optimal_tile = memo[id];
     if (candidate.getCost() < optimal_tile.getCost()) {
         optimal_tile = candidate;
     }
 };
 
-void IRToTilesConverter::decideIsCandidate(StatementIR& ir, Tile candidate) {
-    Tile& optimal_tile = statement_memo[&ir];
-    if (candidate.getCost() < optimal_tile.getCost()) {
-        optimal_tile = candidate;
+Register IRToTilesConverter::temporaryRegister(TempId temp) {
+    auto [it, inserted] = temporary_registers.try_emplace(temp);
+    if (inserted) {
+        it->second = newAbstractRegister();
     }
-};
+    return it->second;
+}
 
-ExpressionTile IRToTilesConverter::tile(const std::string &abstract_reg, ExpressionIR &ir) {
-    if (expression_memo.count(&ir)) {
-        return expression_memo[&ir].pairWith(abstract_reg);
+ExpressionTile IRToTilesConverter::tile(Register abstract_reg, IRNodeId id) {
+    if (tiled[id]) {
+        return memo[id].pairWith(abstract_reg);
     }
+    tiled[id] = true;
+
+    const FlatIR::Node &node = (*body)[id];
 
     // Generic tile that must be applicable, if no specialized tiles are applicable
     Tile generic_tile;
 
-    std::visit(util::overload {
-        [&](BinOpIR &node) {
+    switch (node.kind) {
+        case FlatIR::Kind::BIN_OP: {
             
             // Generic tile that is always applicable : store operands in abstract registers, then do something
-            std::string operand1_reg = newAbstractRegister();
-            std::string operand2_reg = newAbstractRegister();
+            Register operand1_reg = newAbstractRegister();
+            Register operand2_reg = newAbstractRegister();
 
             generic_tile = Tile({
-                tile(operand1_reg, node.getLeft()),
-                tile(operand2_reg, node.getRight())
+                tile(operand1_reg, node.first),
+                tile(operand2_reg, node.second)
             });
 
             switch (node.op) {
@@ -157,162 +165,170 @@ ExpressionTile IRToTilesConverter::tile(const std::string &abstract_reg, Express
                     THROW_CompilerError("Operation is not supported in Joosc");
                 }
             }
-        },
+            break;
+        }
 
-        [&](ConstIR &node) {
+        case FlatIR::Kind::CONST: {
             // 32-bit immediate
             generic_tile = Tile({
-                Mov(Tile::ABSTRACT_REG, node.getValue())
+                Mov(Tile::ABSTRACT_REG, static_cast<int32_t>(node.value))
             });
-        },
+            break;
+        }
 
-        [&](MemIR &node) {
-            std::string address_reg = newAbstractRegister();
+        case FlatIR::Kind::MEM: {
+            Register address_reg = newAbstractRegister();
 
             generic_tile = Tile({
-                tile(address_reg, node.getAddress()),
+                tile(address_reg, node.first),
                 Mov(Tile::ABSTRACT_REG, EffectiveAddress(address_reg))
             });
-        },
+            break;
+        }
 
-        [&](NameIR &node) {
+        case FlatIR::Kind::NAME: {
             generic_tile = Tile({
-                Mov(Tile::ABSTRACT_REG, LabelUse(node.getName()))
+                Mov(Tile::ABSTRACT_REG, LabelUse(body->text(node)))
             });
-        },
+            break;
+        }
+
+        case FlatIR::Kind::TEMP: {
+            static const util::Symbol ret_name {CGConstants::ABSTRACT_RET};
+            static const util::Symbol arg_prefix {CGConstants::ABSTRACT_ARG_PREFIX};
+
+            util::Symbol prefix = temps.prefix(node.id);
+            int32_t number = temps.number(node.id);
 
-        [&](TempIR &node) {
             // Special registers : ABSTRACT_RET is REG32_ACCUM
-            if (node.getName() == CGConstants::ABSTRACT_RET) {
+            if (prefix == ret_name && number == IRNameTable::NO_NUMBER) {
                 generic_tile = Tile({
                     Mov(Tile::ABSTRACT_REG, REG32_ACCUM)
                 });
             }
             // Special registers : ABSTRACT_ARG_PREFIX# is stack offset from caller
-            else if (node.getName().rfind(CGConstants::ABSTRACT_ARG_PREFIX, 0) == 0) {
-                int arg_num 
-                    = std::stoi(std::regex_replace(node.getName(), std::regex(CGConstants::ABSTRACT_ARG_PREFIX), ""));
+            else if (prefix == arg_prefix && number != IRNameTable::NO_NUMBER) {
+                int arg_num = number;
 
                 generic_tile = Tile({
                     Mov(
                         Tile::ABSTRACT_REG, 
-                        EffectiveAddress(REG32_STACKBASEPTR, 4 * (arg_num + 2))
+                        EffectiveAddress(REG32_STACKBASEPTR, stackWordSize(target) * (arg_num + 2))
                     )
                 });
             } 
             // Special temp : Static variable in .data section
-            else if (node.isGlobal) {
+            else if (node.is_global) {
                 generic_tile = Tile({
                     Mov(
                         Tile::ABSTRACT_REG,
-                        EffectiveAddress(node.getName())
+                        EffectiveAddress(LabelUse(temps.name(node.id)))
                     )
                 });
             }
             // Not special
             else {
                 generic_tile = Tile({
-                    Mov(Tile::ABSTRACT_REG, escapeTemporary(node.getName()))
+                    Mov(Tile::ABSTRACT_REG, temporaryRegister(node.id))
                 });
             }
-        },
+            break;
+        }
 
-        [&](ESeqIR &node) {
+        case FlatIR::Kind::ESEQ: {
             THROW_CompilerError("ESeqIR should not exist after canonicalization"); 
-        },
+        }
 
-        [&](CallIR &node) {
+        case FlatIR::Kind::CALL: {
             THROW_CompilerError("CallIR should not be considered an expression after canonicalization"); 
         }
-    }, ir);
+
+        default: {
+            THROW_CompilerError("Statement " + body->label(id) + " is not an expression");
+        }
+    }
 
     if (generic_tile.getCost() == Tile().getCost()) {
-        THROW_CompilerError("Generic tile was not assigned to " + std::visit([&](auto &x){ return x.label(); }, ir));
+        THROW_CompilerError("Generic tile was not assigned to " + body->label(id));
     }
-    decideIsCandidate(ir, generic_tile);
+    decideIsCandidate(id, generic_tile);
 
-    return expression_memo[&ir].pairWith(abstract_reg);
+    return memo[id].pairWith(abstract_reg);
 }
 
-StatementTile IRToTilesConverter::tile(StatementIR &ir) {
-    if (statement_memo.count(&ir)) {
-        return &statement_memo[&ir];
+StatementTile IRToTilesConverter::tile(IRNodeId id) {
+    if (tiled[id]) {
+        return &memo[id];
     }
+    tiled[id] = true;
+
+    const FlatIR::Node &node = (*body)[id];
 
     // Generic tile that must be applicable, if no specialized tiles are applicable
     Tile generic_tile;
     
-    std::visit(util::overload {
-        [&](CJumpIR &node) {
-            std::string cond_reg = newAbstractRegister();
+    switch (node.kind) {
+        case FlatIR::Kind::CJUMP: {
+            Register cond_reg = newAbstractRegister();
 
             generic_tile = Tile({
-                tile(cond_reg, node.getCondition()),
+                tile(cond_reg, node.first),
                 Test(cond_reg, cond_reg),
-                JumpIfNZ(LabelUse(node.trueLabel()))
+                JumpIfNZ(LabelUse(labels.name(node.id)))
             });
-        },
+            break;
+        }
 
-        [&](JumpIR &node) {
-            if (auto target = std::get_if<NameIR>(&node.getTarget())) {
-                generic_tile = Tile({
-                    Jump(LabelUse(target->getName()))
-                });
-            } else {
-                std::string target_reg = newAbstractRegister();
+        case FlatIR::Kind::JUMP: {
+            generic_tile = Tile({
+                Jump(LabelUse(labels.name(node.id)))
+            });
+            break;
+        }
 
-                generic_tile = Tile({
-                    tile(target_reg, node.getTarget()),
-                    Jump(target_reg)
-                });
-            }
-        },
+        case FlatIR::Kind::LABEL: {
+            generic_tile = Tile({Label(labels.name(node.id))});
+            break;
+        }
 
-        [&](LabelIR &node) {
-            generic_tile = Tile({Label(node.getName())});
-        },
+        case FlatIR::Kind::MOVE: {
+            const FlatIR::Node &target = (*body)[node.first];
 
-        [&](MoveIR &node) {
             // Behaviour depends on target type
-            std::visit(util::overload {
-
-                [&](TempIR& target) {
-                    if (target.isGlobal) {
-                        // Update global variable
-                        std::string temp_value_reg = newAbstractRegister();
-
-                        generic_tile = Tile({
-                            tile(temp_value_reg, node.getSource()),
-                            Mov(EffectiveAddress(target.getName()), temp_value_reg)
-                        });
-                    } else {
-                        generic_tile = Tile({
-                            tile(escapeTemporary(target.getName()), node.getSource())
-                        });
-                    }
-                },
-
-                [&](MemIR& target) {
-                    std::string address_reg = newAbstractRegister();
-                    std::string source_reg = newAbstractRegister();
+            if (target.kind == FlatIR::Kind::TEMP) {
+                if (target.is_global) {
+                    // Update global variable
+                    Register temp_value_reg = newAbstractRegister();
 
                     generic_tile = Tile({
-                        tile(source_reg, node.getSource()),
-                        tile(address_reg, target.getAddress()),
-                        Mov(EffectiveAddress(address_reg), source_reg)
+                        tile(temp_value_reg, node.second),
+                        Mov(EffectiveAddress(LabelUse(temps.name(target.id))), temp_value_reg)
                     });
-                },
-
-                [&](auto&) { THROW_CompilerError("Invalid MoveIR target"); }
+                } else {
+                    generic_tile = Tile({
+                        tile(temporaryRegister(target.id), node.second)
+                    });
+                }
+            } else if (target.kind == FlatIR::Kind::MEM) {
+                Register address_reg = newAbstractRegister();
+                Register source_reg = newAbstractRegister();
 
-            }, node.getTarget());
-        },
+                generic_tile = Tile({
+                    tile(source_reg, node.second),
+                    tile(address_reg, target.first),
+                    Mov(EffectiveAddress(address_reg), source_reg)
+                });
+            } else {
+                THROW_CompilerError("Invalid MoveIR target");
+            }
+            break;
+        }
 
-        [&](ReturnIR &node) {
-            if (node.getRet()) {
+        case FlatIR::Kind::RETURN: {
+            if (node.first != FlatIR::NO_NODE) {
                 // Return a value by placing it in REG32_ACCUM
                 generic_tile.add_instructions_after({
-                    tile(REG32_ACCUM, *node.getRet())
+                    tile(REG32_ACCUM, node.first)
                 });
             }
             // Function epilogue
@@ -322,92 +338,102 @@ StatementTile IRToTilesConverter::tile(StatementIR &ir) {
                 Pop(REG32_STACKBASEPTR),
                 Ret()
             });
-        },
+            break;
+        }
 
-        [&](CallIR &node) {
+        case FlatIR::Kind::CALL: {
+            auto args = body->list(node);
+            const FlatIR::Node &called = (*body)[node.first];
             std::string called_function = "";
-            if (auto name = std::get_if<NameIR>(&node.getTarget())) {
-                called_function = name->getName();
+            if (called.kind == FlatIR::Kind::NAME) {
+                called_function = body->text(called);
             }
 
             // Special case : __malloc call
             if (called_function == "__malloc") {
-                if (node.getArgs().size() != 1) {
-                    THROW_CompilerError("malloc called with " + std::to_string(node.getArgs().size()) + " args instead of 1");
+                if (args.size() != 1) {
+                    THROW_CompilerError("malloc called with " + std::to_string(args.size()) + " args instead of 1");
                 }
 
                 generic_tile.add_instructions_after({
-                    tile(REG32_ACCUM, *node.getArgs().front()),
-                    Call(LabelUse(called_function))
+                    tile(REG32_ACCUM, args[0]),
+                    Call(LabelUse(called_function), target)
                 });
 
-                return;
+                break;
             }
 
             // Special case : NATIVEjava.io.OutputStream.nativeWrite call
             if (called_function == "NATIVEjava.io.OutputStream.nativeWrite") {
-                if (node.getArgs().size() != 1) {
-                    THROW_CompilerError("NATIVEjava.io.OutputStream.nativeWrite called with " + std::to_string(node.getArgs().size()) + " args instead of 1");
+                if (args.size() != 1) {
+                    THROW_CompilerError("NATIVEjava.io.OutputStream.nativeWrite called with " + std::to_string(args.size()) + " args instead of 1");
                 }
 
                 generic_tile.add_instructions_after({
-                    tile(REG32_ACCUM, *node.getArgs().front()),
-                    Call(LabelUse(called_function))
+                    tile(REG32_ACCUM, args[0]),
+                    Call(LabelUse(called_function), target)
                 });
 
-                return;
+                break;
             }
 
             // Not a special case
 
             // Push arguments onto stack, in reverse order (CDECL)
-            for (auto &arg : node.getArgs()) {
-                std::string argument_register = newAbstractRegister();
+            for (IRNodeId arg : args) {
+                Register argument_register = newAbstractRegister();
                 generic_tile.add_instructions_before({
-                    tile(argument_register, *arg),
+                    tile(argument_register, arg),
                     Push(argument_register)
                 });
             }
             generic_tile.add_instructions_before({Comment("Call: pushing arguments onto stack")});
 
             // Perform call
-            if (std::get_if<NameIR>(&node.getTarget())) {
+            if (called.kind == FlatIR::Kind::NAME) {
                 // Perform call instruction on function label
-                generic_tile.add_instruction(Call(LabelUse(called_function)));
+                generic_tile.add_instruction(Call(LabelUse(called_function), target));
             } else {
                 // Perform call on arbitrary expression
-                std::string function_address = newAbstractRegister();
+                Register function_address = newAbstractRegister();
                 generic_tile.add_instructions_after({
-                    tile(function_address, node.getTarget()),
-                    Call(function_address)
+                    tile(function_address, node.first),
+                    Call(function_address, target)
                 });
             }
 
             // Pop arguments from stack
             generic_tile.add_instruction(Comment("Call: popping arguments off stack"));
-            generic_tile.add_instruction(Add(REG32_STACKPTR, 4 * node.getNumArgs()));
-        },
+            generic_tile.add_instruction(Add(REG32_STACKPTR, stackWordSize(target) * static_cast<int32_t>(args.size())));
+            break;
+        }
 
-        [&](SeqIR &node) {
+        case FlatIR::Kind::SEQ: {
             generic_tile = Tile(std::vector<Instruction>());
-            for (auto& stmt : node.getStmts()) {
-                generic_tile.add_instruction(tile(*stmt));
+            for (IRNodeId stmt : body->list(node)) {
+                generic_tile.add_instruction(tile(stmt));
             }
-        },
+            break;
+        }
 
-        [&](ExpIR &node) {
+        case FlatIR::Kind::EXP: {
             THROW_CompilerError("ExpIR should not exist after canonicalization"); 
-        },
+        }
 
-        [&](CommentIR &node) {
-            generic_tile = Tile({Comment(node.getText())});
+        case FlatIR::Kind::COMMENT: {
+            generic_tile = Tile({Comment(body->text(node))});
+            break;
         }
-    }, ir);
+
+        default: {
+            THROW_CompilerError("Expression " + body->label(id) + " is not a statement");
+        }
+    }
 
     if (generic_tile.getCost() == Tile().getCost()) {
-        THROW_CompilerError("Generic tile was not assigned to " + std::visit([&](auto &x){ return x.label(); }, ir));
+        THROW_CompilerError("Generic tile was not assigned to " + body->label(id));
     }
-    decideIsCandidate(ir, generic_tile);
+    decideIsCandidate(id, generic_tile);
 
-    return &statement_memo[&ir];
+    return &memo[id];
 }
@@ -1,35 +1,59 @@
 #pragma once
 
 #include "IR/ir.h"
+#include "IR/flat-ir.h"
 #include "tile.h"
+#include "IR-tiling/assembly/target.h"
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 // Convert Canonical IR to x86 assembly
 //
 // Uses the Optimal Tiling Algorithm, with memoization.
+// Converters share no state, so separate functions can be tiled concurrently by separate converters.
 class IRToTilesConverter {
-    static size_t abstract_reg_count;
-    static std::string newAbstractRegister() { return "%_ABSTRACT_REG" + std::to_string(abstract_reg_count++) + "%"; }
+    // Names of the temporaries and labels of the compilation unit the function belongs to
+    const IRNameTable &temps;
+    const IRNameTable &labels;
 
-    // Holds the computed best tile for the subtree rooted at every IR in the IR AST.
-    // The best tile for each subtree is computed at most once.
-    std::unordered_map<ExpressionIR*, Tile> expression_memo;
-    std::unordered_map<StatementIR*, Tile> statement_memo;
+    // Arguments are pushed, and found above the return address, in stack words of the target
+    Assembly::Target target;
+
+    // Abstract registers are numbered per converter; they only need to be unique within a function
+    uint32_t abstract_reg_count = 0;
+    Assembly::Register newAbstractRegister() { return Assembly::Register::abstract(abstract_reg_count++); }
+
+    // The abstract register holding each temporary used by the function
+    std::unordered_map<TempId, Assembly::Register> temporary_registers;
+
+    // The function being tiled
+    const FlatIR *body = nullptr;
+
+    // Holds the computed best tile for the subtree rooted at every node in the function, indexed by node id.
+    // The best tile for each subtree is computed at most once. Sized before tiling starts, since
+    // tiles refer to the tiles of their subtrees by address.
+    std::vector<Tile> memo;
+    std::vector<bool> tiled;
 
     // Assign a tile to the subtree, if it is better than the currently assigned tile.
-    void decideIsCandidate(ExpressionIR& ir, Tile candidate);
-    void decideIsCandidate(StatementIR& ir, Tile candidate); 
+    void decideIsCandidate(IRNodeId id, Tile candidate);
 
-    // Escape the temporary, so no temporary is a substring of another
-    inline std::string escapeTemporary(const std::string& s) { return "%" + s + "%"; }
+    // The abstract register holding the temporary
+    Assembly::Register temporaryRegister(TempId temp);
 
-  public:
     // Tile the expression, producing the lowest cost tile
     // Generates instructions that store the result in abstract_reg
-    ExpressionTile tile(const std::string& abstract_reg, ExpressionIR& node);
+    ExpressionTile tile(Assembly::Register abstract_reg, IRNodeId id);
 
     // Tile the statement, producing the lowest cost tile
     // Generates instructions that implement the statement
-    StatementTile tile(StatementIR& node);
+    StatementTile tile(IRNodeId id);
+
+  public:
+    IRToTilesConverter(const IRNameTable &temps, const IRNameTable &labels, Assembly::Target target = Assembly::Target::X86)
+        : temps{temps}, labels{labels}, target{target} {}
+
+    // Tile the body of a function, producing the lowest cost tile; the tile refers to the converter's memo
+    StatementTile tileFunctionBody(const FlatIR& body);
 };
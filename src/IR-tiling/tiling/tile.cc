@@ -4,7 +4,6 @@
 #include "utillities/overload.h"
 
 #include <limits>
-#include <regex>
 
 void Tile::calculateCost() {
     // Cost is defined as the number of assembly instructions used to implement tile
@@ -79,7 +78,7 @@ void Tile::add_instructions_before(std::vector<Instruction> before_instructions)
     this->instructions = before_instructions;
 }
 
-void Tile::assignAbstract(std::string reg) {
+void Tile::assignAbstract(Assembly::Register reg) {
     for (auto& instr : this->instructions) {
         std::visit(util::overload {
             [&](AssemblyInstruction& asmb) {
@@ -95,13 +94,13 @@ void Tile::assignAbstract(std::string reg) {
     }
 }
 
-Tile Tile::assignAbstractToCopy(std::string reg) {
+Tile Tile::assignAbstractToCopy(Assembly::Register reg) {
     Tile copy_tile = *this;
     copy_tile.assignAbstract(reg);
     return copy_tile;
 }
 
-ExpressionTile Tile::pairWith(std::string abstract_reg) {
+ExpressionTile Tile::pairWith(Assembly::Register abstract_reg) {
     return std::make_pair(this, abstract_reg);
 }
 
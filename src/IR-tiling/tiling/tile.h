@@ -11,7 +11,7 @@
 class Tile;
 
 using StatementTile = Tile*;
-using ExpressionTile = std::pair<Tile*, std::string>;
+using ExpressionTile = std::pair<Tile*, Assembly::Register>;
 
 using Instruction = std::variant<AssemblyInstruction, StatementTile, ExpressionTile>;
 
@@ -34,16 +34,16 @@ class Tile {
 
   public:
     // Represents a placeholder abstract register within the assembly instructions
-    static const inline std::string ABSTRACT_REG = "\%\%PLACEHOLDER_ABSTRACT_REG\%\%";
+    static constexpr inline Assembly::Register ABSTRACT_REG = Assembly::Register::placeholder();
 
     // Replaces uses of Tile::ABSTRACT_REG with reg
-    void assignAbstract(std::string reg);
+    void assignAbstract(Assembly::Register reg);
     
     // Creates copy of tile with replaced uses of Tile::ABSTRACT_REG with reg
-    Tile assignAbstractToCopy(std::string reg);
+    Tile assignAbstractToCopy(Assembly::Register reg);
 
     // Produce a pair with the tile and the abstract reg it uses
-    ExpressionTile pairWith(std::string abstract_reg);
+    ExpressionTile pairWith(Assembly::Register abstract_reg);
 
     // Get cost of the tile
     int getCost();
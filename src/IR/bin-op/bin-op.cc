@@ -27,7 +27,7 @@ std::unique_ptr<ExpressionIR> BinOpIR::makeExpr(OpType op, std::unique_ptr<Expre
     );
 }
 
-std::string BinOpIR::label() {
+std::string BinOpIR::label(OpType op) {
     switch(op) {
         case ADD: return "ADD";
         case SUB: return "SUB";
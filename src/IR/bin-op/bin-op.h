@@ -3,6 +3,7 @@
 #include <memory>
 #include "IR/ir_variant.h"
 #include <cassert>
+#include <string>
 
 class BinOpIR {
     std::unique_ptr<ExpressionIR> left;
@@ -17,7 +18,8 @@ public:
     BinOpIR(OpType op, std::unique_ptr<ExpressionIR> left, std::unique_ptr<ExpressionIR> right) : op(op), left{std::move(left)}, right{std::move(right)} {}
     ExpressionIR &getLeft() { assert(left.get()); return *left.get(); }
     ExpressionIR &getRight() { assert(right.get()); return *right.get(); }
-    std::string label();
+    std::string label() { return label(op); }
+    static std::string label(OpType op);
     
     bool isConstant();
     static std::unique_ptr<ExpressionIR> makeNegate(std::unique_ptr<ExpressionIR> negated);
@@ -1,7 +1,7 @@
 #include "cjump.h"
 #include "IR/ir.h"
 
-std::unique_ptr<StatementIR> CJumpIR::makeStmt(std::unique_ptr<ExpressionIR> cond, std::string true_label, std::string false_label) {
+std::unique_ptr<StatementIR> CJumpIR::makeStmt(std::unique_ptr<ExpressionIR> cond, LabelId true_label, LabelId false_label) {
     #warning Should do cond preprocessing
     return std::make_unique<StatementIR>(
         std::in_place_type<CJumpIR>,
@@ -2,19 +2,20 @@
 
 #include <memory>
 #include "IR/ir_variant.h"
+#include "IR/ir-names.h"
 #include <cassert>
 #include <string>
 
 class CJumpIR {
     std::unique_ptr<ExpressionIR> cond;
-    std::string true_label;
-    std::string false_label;
+    LabelId true_label;
+    LabelId false_label;
 
 public:
-    CJumpIR(std::unique_ptr<ExpressionIR> cond, std::string true_label, std::string false_label = "") : cond{std::move(cond)}, true_label(true_label), false_label(false_label) {}
+    CJumpIR(std::unique_ptr<ExpressionIR> cond, LabelId true_label, LabelId false_label = NO_LABEL) : cond{std::move(cond)}, true_label(true_label), false_label(false_label) {}
     ExpressionIR &getCondition() { assert(cond.get()); return *cond.get(); }
-    std::string trueLabel() { return true_label; }
-    std::string falseLabel() { return false_label; }
+    LabelId trueLabel() { return true_label; }
+    LabelId falseLabel() { return false_label; }
     std::string label() { return "CJUMP"; }
-    static std::unique_ptr<StatementIR> makeStmt(std::unique_ptr<ExpressionIR> cond, std::string true_label, std::string false_label = "");
+    static std::unique_ptr<StatementIR> makeStmt(std::unique_ptr<ExpressionIR> cond, LabelId true_label, LabelId false_label = NO_LABEL);
 };
@@ -1,14 +1,22 @@
 #include "code-gen-constants.h"
 #include "utillities/util.h"
 
-size_t CGConstants::next_method_id = 0;
-std::unordered_map<MethodDeclarationObject*, std::string> CGConstants::method_labels = {};
-
-size_t CGConstants::next_field_id = 0;
-std::unordered_map<FieldDeclarationObject*, std::string> CGConstants::field_labels = {};
-
-size_t CGConstants::next_variable_id = 0;
-std::unordered_map<LocalVariableDeclarationObject*, std::string> CGConstants::variable_labels = {};
-
-size_t CGConstants::next_parameter_id = 0;
-std::unordered_map<FormalParameterDeclarationObject*, std::string> CGConstants::parameter_labels = {};
+std::string CGConstants::methodSignature(MethodDeclarationObject* method) {
+    std::string signature = method->full_qualified_name;
+    for ( auto parameter : method->getParameters() ) {
+        auto &type = parameter->type;
+        signature += "#";
+        if ( auto cls = type.getIfNonArrayIsClass() ) {
+            signature += cls->full_qualified_name;
+        } else if ( auto ifc = type.getIfNonArrayIsInterface() ) {
+            signature += ifc->full_qualified_name;
+        } else {
+            signature += getPrimitiveName(*type.getIfNonArrayIsPrimitive());
+        }
+        // NASM does not allow brackets in labels
+        if ( type.is_array ) {
+            signature += "@";
+        }
+    }
+    return signature;
+}
@@ -4,39 +4,32 @@
 #include <string>
 
 #include "environment-builder/symboltableentry.h"
+#include "IR/ir-names.h"
 #include "variant-ast/classes.h"
 
 // Conventions that need to be the same across different code gen components
 class CGConstants {
-    static size_t next_method_id;
-    static std::unordered_map<MethodDeclarationObject*, std::string> method_labels;
-
-    static size_t next_field_id;
-    static std::unordered_map<FieldDeclarationObject*, std::string> field_labels;
-
-    static size_t next_variable_id;
-    static std::unordered_map<LocalVariableDeclarationObject*, std::string> variable_labels;
-
-    static size_t next_parameter_id;
-    static std::unordered_map<FormalParameterDeclarationObject*, std::string> parameter_labels;
+    // Labels of declarations visible to other compilation units are derived from the declaration itself,
+    // so they are the same in every compile and one unit's output does not depend on the others
+    static std::string generateGlobalLabel(const std::string &qualified_name, const std::string &prefix) {
+        return global_data_prefix + prefix + "__#" + qualified_name;
+    }
 
-    static inline size_t next_class_id;
-    static inline std::unordered_map<ClassDeclarationObject*, std::string> class_labels;
+    // Fully qualified name of the method followed by its parameter types, distinguishing overloads
+    static std::string methodSignature(MethodDeclarationObject* method);
 
-    // Unified way of generating unique labels for objects
-    template <typename declObj>
-    static std::string generateUniqueLabel(
-      declObj obj,
-      const std::string &actual_name, 
-      const std::string &prefix,
-      size_t &id_counter, 
-      std::unordered_map<declObj, std::string> &labels
-    ) {
-        if (!labels.count(obj)) {
-            std::string label = global_data_prefix + prefix + "_ID" + std::to_string(id_counter++) + "__#" + actual_name;
-            labels[obj] = label;
+    static std::string methodLabel(MethodDeclarationObject* method) {
+        if (method->ast_reference->hasModifier(Modifier::NATIVE)) {
+            return "NATIVE" + method->full_qualified_name;
         }
-        return labels[obj];
+        std::string prefix = method->is_constructor ? "_CONSTRUCTOR"
+            : method->ast_reference->hasModifier(Modifier::STATIC) ? "_STATIC_METHOD" : "_METHOD";
+        return generateGlobalLabel(methodSignature(method), prefix);
+    }
+
+    static std::string fieldLabel(FieldDeclarationObject* field) {
+        std::string prefix = field->ast_reference->hasModifier(Modifier::STATIC) ? "_STATIC_FIELD" : "_FIELD";
+        return generateGlobalLabel(field->full_qualified_name, prefix);
     }
 
   public:
@@ -47,37 +40,32 @@ class CGConstants {
     //
     // Returns the same label for the same object every time.
     static std::string uniqueMethodLabel(MethodDeclarationObject* method) {
-        if (method->ast_reference->hasModifier(Modifier::NATIVE)) {
-            return "NATIVE" + method->full_qualified_name;
-        }
-        return generateUniqueLabel(method, method->full_qualified_name, "_METHOD", next_method_id, method_labels);
+        return methodLabel(method);
     };
 
     static std::string uniqueStaticMethodLabel(MethodDeclarationObject* method) {
-        if (method->ast_reference->hasModifier(Modifier::NATIVE)) {
-            return "NATIVE" + method->full_qualified_name;
-        }
-        return generateUniqueLabel(method, method->full_qualified_name, "_STATIC_METHOD", next_method_id, method_labels);
+        return methodLabel(method);
     };
 
     static std::string uniqueFieldLabel(FieldDeclarationObject* field) {
-        return generateUniqueLabel(field, field->full_qualified_name, "_FIELD", next_field_id, field_labels);
+        return fieldLabel(field);
     };
 
     static std::string uniqueStaticFieldLabel(FieldDeclarationObject* field) {
-        return generateUniqueLabel(field, field->full_qualified_name, "_STATIC_FIELD", next_field_id, field_labels);
+        return fieldLabel(field);
     };
 
-    static std::string uniqueLocalVariableLabel(LocalVariableDeclarationObject* variable) {
-        return generateUniqueLabel(variable, variable->identifier, "_LOCAL_VARIABLE", next_variable_id, variable_labels);
-    };
+    static std::string uniqueClassLabel(ClassDeclarationObject* class_obj) {
+        return generateGlobalLabel(class_obj->full_qualified_name, "_CLASS");
+    }
 
-    static std::string uniqueParameterLabel(FormalParameterDeclarationObject* parameter) {
-        return generateUniqueLabel(parameter, parameter->identifier, "_PARAMETER", next_parameter_id, parameter_labels);
-    };
+    // Functions that initialize the static fields and the dispatch vector of a class
+    static std::string uniqueStaticInitLabel(ClassDeclarationObject* class_obj) {
+        return generateGlobalLabel(class_obj->full_qualified_name, "_STATIC_INIT");
+    }
 
-    static std::string uniqueClassLabel(ClassDeclarationObject* class_obj) {
-        return generateUniqueLabel(class_obj, class_obj->identifier, "_CLASS", next_class_id, class_labels);
+    static std::string uniqueDispatchVectorInitLabel(ClassDeclarationObject* class_obj) {
+        return generateGlobalLabel(class_obj->full_qualified_name, "_DV_INIT");
     }
 
     // The prefix for abstract argument registers
@@ -88,3 +76,46 @@ class CGConstants {
     // Placing values in this register returns it to the caller.
     const static inline std::string ABSTRACT_RET = "_RET";
 };
+
+// Temporaries for local variables and parameters.
+//
+// These are only referred to within their own compilation unit, so each unit numbers them with its own
+// LocalTemps, and a unit's IR is independent of the units built before it.
+class LocalTemps {
+    IRNameTable &temps;
+
+    size_t next_variable_id = 0;
+    std::unordered_map<LocalVariableDeclarationObject*, TempId> variable_temps;
+
+    size_t next_parameter_id = 0;
+    std::unordered_map<FormalParameterDeclarationObject*, TempId> parameter_temps;
+
+    // Unified way of generating unique temporaries for local objects
+    template <typename declObj>
+    TempId generateUniqueTemp(
+      declObj obj,
+      const std::string &actual_name, 
+      const std::string &prefix,
+      size_t &id_counter, 
+      std::unordered_map<declObj, TempId> &local_temps
+    ) {
+        auto [it, inserted] = local_temps.try_emplace(obj);
+        if (inserted) {
+            std::string label = CGConstants::global_data_prefix + prefix + "_ID" + std::to_string(id_counter++) + "__#" + actual_name;
+            it->second = temps.add(label);
+        }
+        return it->second;
+    }
+
+  public:
+    explicit LocalTemps(IRNameTable &temps) : temps{temps} {}
+
+    // Returns the same temporary for the same object every time.
+    TempId localVariableTemp(LocalVariableDeclarationObject* variable) {
+        return generateUniqueTemp(variable, variable->identifier, "_LOCAL_VARIABLE", next_variable_id, variable_temps);
+    };
+
+    TempId parameterTemp(FormalParameterDeclarationObject* parameter) {
+        return generateUniqueTemp(parameter, parameter->identifier, "_PARAMETER", next_parameter_id, parameter_temps);
+    };
+};
@@ -8,6 +8,7 @@
 #include <unordered_set>
 #include "IR/ir_variant.h"
 #include "IR/func-decl/func-decl.h"
+#include "IR/ir-names.h"
 #include "exceptions/exceptions.h"
 
 class CompUnitIR {
@@ -25,7 +26,16 @@ class CompUnitIR {
     std::vector<std::pair<std::string, std::unique_ptr<StatementIR>>> child_canonical_static_fields;
 
   public:
+    // Names of the temporaries and labels used in the unit, indexed by their ids
+    IRNameTable temps;
+    IRNameTable labels;
+
     std::vector<std::unique_ptr<StatementIR>> start_statements;
+
+    // Functions the static field initializers and the start statements are emitted as
+    std::string static_init_label;
+    std::string dispatch_vector_init_label;
+
     CompUnitIR(std::string name) : name(name) {}
 
     void appendFunc(std::string name, std::unique_ptr<FuncDeclIR> func) {
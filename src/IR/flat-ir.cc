@@ -0,0 +1,166 @@
+#include "flat-ir.h"
+#include "utillities/overload.h"
+
+FlatIR::FlatIR(StatementIR &body) {
+    flatten(body);
+}
+
+IRNodeId FlatIR::add(Node node) {
+    nodes.push_back(node);
+    return nodes.size() - 1;
+}
+
+uint32_t FlatIR::addText(const std::string &text) {
+    texts.push_back(text);
+    return texts.size() - 1;
+}
+
+void FlatIR::setList(Node &node, const std::vector<IRNodeId> &ids) {
+    node.list_begin = lists.size();
+    node.list_size = ids.size();
+    lists.insert(lists.end(), ids.begin(), ids.end());
+}
+
+IRNodeId FlatIR::flatten(CallIR &node) {
+    Node flat {Kind::CALL};
+    flat.first = flatten(node.getTarget());
+    std::vector<IRNodeId> args;
+    for (auto &arg : node.getArgs()) {
+        args.push_back(flatten(*arg));
+    }
+    setList(flat, args);
+    return add(flat);
+}
+
+// Children are flattened in the order the IR visitors visit them, before their parent
+IRNodeId FlatIR::flatten(ExpressionIR &ir) {
+    return std::visit(util::overload {
+        [&](BinOpIR &node) {
+            Node flat {Kind::BIN_OP};
+            flat.op = node.op;
+            flat.first = flatten(node.getLeft());
+            flat.second = flatten(node.getRight());
+            return add(flat);
+        },
+
+        [&](CallIR &node) { return flatten(node); },
+
+        [&](ConstIR &node) {
+            Node flat {Kind::CONST};
+            flat.value = node.getValue();
+            return add(flat);
+        },
+
+        [&](ESeqIR &node) {
+            Node flat {Kind::ESEQ};
+            flat.first = flatten(node.getStmt());
+            flat.second = flatten(node.getExpr());
+            return add(flat);
+        },
+
+        [&](MemIR &node) {
+            Node flat {Kind::MEM};
+            flat.first = flatten(node.getAddress());
+            return add(flat);
+        },
+
+        [&](NameIR &node) {
+            Node flat {Kind::NAME};
+            flat.is_global = node.isGlobal;
+            flat.id = addText(node.getName());
+            return add(flat);
+        },
+
+        [&](TempIR &node) {
+            Node flat {Kind::TEMP};
+            flat.is_global = node.isGlobal;
+            flat.id = node.getId();
+            return add(flat);
+        }
+    }, ir);
+}
+
+IRNodeId FlatIR::flatten(StatementIR &ir) {
+    return std::visit(util::overload {
+        [&](CJumpIR &node) {
+            Node flat {Kind::CJUMP};
+            flat.first = flatten(node.getCondition());
+            flat.id = node.trueLabel();
+            flat.false_label = node.falseLabel();
+            return add(flat);
+        },
+
+        [&](ExpIR &node) {
+            Node flat {Kind::EXP};
+            flat.first = flatten(node.getExpr());
+            return add(flat);
+        },
+
+        [&](JumpIR &node) {
+            Node flat {Kind::JUMP};
+            flat.id = node.getTarget();
+            return add(flat);
+        },
+
+        [&](LabelIR &node) {
+            Node flat {Kind::LABEL};
+            flat.id = node.getId();
+            return add(flat);
+        },
+
+        [&](MoveIR &node) {
+            Node flat {Kind::MOVE};
+            flat.first = flatten(node.getTarget());
+            flat.second = flatten(node.getSource());
+            return add(flat);
+        },
+
+        [&](ReturnIR &node) {
+            Node flat {Kind::RETURN};
+            if (node.getRet()) {
+                flat.first = flatten(*node.getRet());
+            }
+            return add(flat);
+        },
+
+        [&](SeqIR &node) {
+            Node flat {Kind::SEQ};
+            std::vector<IRNodeId> stmts;
+            for (auto &stmt : node.getStmts()) {
+                stmts.push_back(flatten(*stmt));
+            }
+            setList(flat, stmts);
+            return add(flat);
+        },
+
+        [&](CallIR &node) { return flatten(node); },
+
+        [&](CommentIR &node) {
+            Node flat {Kind::COMMENT};
+            flat.id = addText(node.getText());
+            return add(flat);
+        }
+    }, ir);
+}
+
+std::string FlatIR::label(IRNodeId id) const {
+    const Node &node = nodes[id];
+    switch (node.kind) {
+        case Kind::BIN_OP: return BinOpIR::label(node.op);
+        case Kind::CALL: return "CALL";
+        case Kind::CONST: return "CONST (" + std::to_string(node.value) + ")";
+        case Kind::ESEQ: return "ESEQ";
+        case Kind::MEM: return "MEM";
+        case Kind::NAME: return "NAME(" + text(node) + ")";
+        case Kind::TEMP: return "TEMP(" + std::to_string(node.id) + ")";
+        case Kind::CJUMP: return "CJUMP";
+        case Kind::EXP: return "EXP";
+        case Kind::JUMP: return "JUMP";
+        case Kind::LABEL: return "LABEL(" + std::to_string(node.id) + ")";
+        case Kind::MOVE: return "MOVE";
+        case Kind::RETURN: return "RETURN";
+        case Kind::SEQ: return "SEQ";
+        case Kind::COMMENT: return "COMMENT(" + text(node) + ")";
+    }
+    return "";
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "IR/ir.h"
+
+// Index of an expression or statement in its function's FlatIR
+using IRNodeId = uint32_t;
+
+// The IR of one function body stored flat: every expression and statement is a node in one contiguous array,
+// in post-order, so children come before their parents and the root of the body is the last node. Nodes refer to
+// their children by id, and passes keep per-node results in vectors indexed by the id, instead of following
+// pointers through the tree and keeping maps keyed by a node's address.
+//
+// The tiler tiles each function's canonical IR from it, and the simulator steps through its nodes in order.
+// The IR builder and the canonicalizer build and rewrite the tree, which is flattened once it is final.
+class FlatIR {
+  public:
+    enum class Kind : uint8_t {
+        // Expressions
+        BIN_OP, CALL, CONST, ESEQ, MEM, NAME, TEMP,
+        // Statements, along with CALL in canonical IR
+        CJUMP, EXP, JUMP, LABEL, MOVE, RETURN, SEQ, COMMENT
+    };
+
+    static constexpr IRNodeId NO_NODE = std::numeric_limits<IRNodeId>::max();
+
+    struct Node {
+        Kind kind;
+        BinOpIR::OpType op = BinOpIR::ADD; // BIN_OP
+        bool is_global = false; // NAME and TEMP
+
+        // Left and right of BIN_OP, statement and expression of ESEQ, target and source of MOVE, and the first is
+        // the target of CALL, address of MEM, condition of CJUMP, expression of EXP and value of RETURN, if any
+        IRNodeId first = NO_NODE;
+        IRNodeId second = NO_NODE;
+
+        // Arguments of CALL and statements of SEQ, as a range of the lists array
+        uint32_t list_begin = 0;
+        uint32_t list_size = 0;
+
+        int64_t value = 0; // CONST
+
+        // Temporary of TEMP, label of LABEL and JUMP, true label of CJUMP, and text of NAME and COMMENT,
+        // as an index of the texts array
+        uint32_t id = 0;
+        LabelId false_label = NO_LABEL; // CJUMP
+    };
+
+    // The arguments of a CALL or the statements of a SEQ
+    class List {
+        const IRNodeId *first;
+        const IRNodeId *last;
+
+      public:
+        List(const IRNodeId *first, const IRNodeId *last) : first{first}, last{last} {}
+
+        const IRNodeId *begin() const { return first; }
+        const IRNodeId *end() const { return last; }
+        size_t size() const { return last - first; }
+        IRNodeId operator[](size_t i) const { return first[i]; }
+    };
+
+  private:
+    std::vector<Node> nodes;
+    std::vector<IRNodeId> lists;
+    std::vector<std::string> texts;
+
+    IRNodeId add(Node node);
+    uint32_t addText(const std::string &text);
+    void setList(Node &node, const std::vector<IRNodeId> &ids);
+
+    IRNodeId flatten(ExpressionIR &ir);
+    IRNodeId flatten(StatementIR &ir);
+    IRNodeId flatten(CallIR &node); // An expression, or a statement in canonical IR
+
+  public:
+    // Flatten the tree rooted at body, which is left as it is
+    explicit FlatIR(StatementIR &body);
+
+    size_t size() const { return nodes.size(); }
+    IRNodeId root() const { return nodes.size() - 1; }
+    const Node &operator[](IRNodeId id) const { return nodes[id]; }
+
+    List list(const Node &node) const {
+        return List(lists.data() + node.list_begin, lists.data() + node.list_begin + node.list_size);
+    }
+    const std::string &text(const Node &node) const { return texts[node.id]; }
+
+    // The label of the node, as its class in the tree gives it
+    std::string label(IRNodeId id) const;
+};
@@ -0,0 +1,30 @@
+#include "ir-names.h"
+
+uint32_t IRNameTable::add(util::Symbol prefix, int32_t number) {
+    names.push_back({prefix, number});
+    return names.size() - 1;
+}
+
+uint32_t IRNameTable::get(util::Symbol prefix, int32_t number) {
+    auto [it, inserted] = ids.try_emplace({prefix, number}, names.size());
+    if ( inserted ) {
+        names.push_back({prefix, number});
+    }
+    return it->second;
+}
+
+std::optional<uint32_t> IRNameTable::find(util::Symbol prefix, int32_t number) const {
+    auto it = ids.find({prefix, number});
+    if ( it == ids.end() ) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::string IRNameTable::name(uint32_t id) const {
+    const Name &name = names[id];
+    if ( name.number == NO_NUMBER ) {
+        return name.prefix.str();
+    }
+    return name.prefix + std::to_string(name.number);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utillities/symbol.h"
+
+// Temporaries and labels are referred to by ids, numbered densely from 0 within their compilation unit,
+// so later passes can keep per-temporary or per-label state in arrays instead of maps keyed by name
+using TempId = uint32_t;
+using LabelId = uint32_t;
+
+// Absent label, e.g. the false label of a CJumpIR that falls through
+constexpr LabelId NO_LABEL = std::numeric_limits<LabelId>::max();
+
+// Names of the temporaries or the labels of one compilation unit, indexed by id.
+//
+// A name is a prefix, optionally followed by a number, and is only rendered as a string when it is printed.
+class IRNameTable {
+  public:
+    static constexpr int32_t NO_NUMBER = -1;
+
+  private:
+    struct Name {
+        util::Symbol prefix;
+        int32_t number;
+
+        bool operator==(const Name &other) const { return prefix == other.prefix && number == other.number; }
+    };
+
+    struct NameHash {
+        size_t operator()(const Name &name) const { return name.prefix.hash() * 31 + std::hash<int32_t>{}(name.number); }
+    };
+
+    std::vector<Name> names;
+    std::unordered_map<Name, uint32_t, NameHash> ids; // Ids handed out by get
+
+  public:
+    // A new id, printed as the prefix followed by the number; for generated names, which are unique by construction
+    uint32_t add(util::Symbol prefix, int32_t number = NO_NUMBER);
+
+    // The id printed as the name (or the prefix followed by the number), the same on every call
+    uint32_t get(util::Symbol prefix, int32_t number = NO_NUMBER);
+
+    // The id get would return, if it has been handed out
+    std::optional<uint32_t> find(util::Symbol prefix, int32_t number = NO_NUMBER) const;
+
+    util::Symbol prefix(uint32_t id) const { return names[id].prefix; }
+    int32_t number(uint32_t id) const { return names[id].number; }
+    std::string name(uint32_t id) const;
+
+    size_t size() const { return names.size(); }
+};
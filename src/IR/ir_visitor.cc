@@ -84,7 +84,7 @@ void IRSkipVisitor::visit_children(ExpIR &node) {
     this->operator()(node.getExpr());
 }
 void IRSkipVisitor::visit_children(JumpIR &node) {
-    this->operator()(node.getTarget());
+    // No children
 }
 void IRSkipVisitor::visit_children(LabelIR &node) {
     // No children
@@ -3,17 +3,17 @@
 #include <string>
 #include <memory>
 #include "IR/ir_variant.h"
-#include <cassert>
+#include "IR/ir-names.h"
 
 class JumpIR {
-    std::unique_ptr<ExpressionIR> target;
+    LabelId target;
 
   public:
-    JumpIR(std::unique_ptr<ExpressionIR> target) : target{std::move(target)} {}
+    JumpIR(LabelId target) : target{target} {}
 
-    ExpressionIR &getTarget() { assert(target.get()); return *target.get(); }
+    LabelId getTarget() { return target; }
 
     std::string label() { return "JUMP"; }
 
-    static std::unique_ptr<StatementIR> makeStmt(std::unique_ptr<ExpressionIR> target);
+    static std::unique_ptr<StatementIR> makeStmt(LabelId target);
 };
@@ -1,23 +1,19 @@
 #pragma once
 
 #include "IR/ir_variant.h"
+#include "IR/ir-names.h"
 #include <memory>
 #include <string>
 
 class LabelIR {
-    static size_t num_labels;
-    std::string name;
+    LabelId id; // Names are in the labels table of the compilation unit
 
   public:
-    LabelIR(std::string name) : name{std::move(name)} {}
+    LabelIR(LabelId id) : id{id} {}
 
-    std::string &getName() { return name; }
-    static std::string generateName(std::string prefix = "") {
-        num_labels++;
-        return ( ( prefix.empty() ? "label" : prefix ) + std::to_string(num_labels) );
-    }
+    LabelId getId() { return id; }
     
-    std::string label() { return "LABEL(" + name + ")"; }
+    std::string label() { return "LABEL(" + std::to_string(id) + ")"; }
 
-    static std::unique_ptr<StatementIR> makeStmt(std::string str);
+    static std::unique_ptr<StatementIR> makeStmt(LabelId id);
 };
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "IR/ir-names.h"
+
+// Generates fresh temporaries or labels in a name table, named by a prefix and a sequence number.
+//
+// Each compilation unit is built and canonicalized with its own generators, so names only have to be
+// unique within the unit, and compilations running at the same time do not share a counter.
+class NameGenerator {
+    IRNameTable &table;
+    util::Symbol default_prefix;
+    int32_t num_names = 0;
+
+  public:
+    NameGenerator(IRNameTable &table, util::Symbol default_prefix) : table{table}, default_prefix{default_prefix} {}
+
+    uint32_t generate() { return table.add(default_prefix, ++num_names); }
+    uint32_t generate(util::Symbol prefix) { return table.add(prefix, ++num_names); }
+};
@@ -0,0 +1,50 @@
+#include "program-units.h"
+
+#include <cassert>
+
+#include "exceptions/exceptions.h"
+#include "utillities/overload.h"
+
+namespace {
+
+// Turn the statements into a function of the compilation unit that returns once they have run
+void appendInitFunction(CompUnitIR &cu, const std::string &label, std::vector<std::unique_ptr<StatementIR>> statements) {
+    statements.push_back(ReturnIR::makeStmt(ConstIR::makeZero()));
+    cu.appendFunc(label, std::make_unique<FuncDeclIR>(label, SeqIR::makeStmt(std::move(statements)), 0));
+}
+
+} // namespace
+
+ProgramUnits prepareProgramUnits(std::vector<IR> &ir_trees) {
+    ProgramUnits program;
+
+    for (auto &ir : ir_trees) {
+        std::visit(util::overload {
+            [&](CompUnitIR &cu) {
+                // Static fields are stored by the entrypoint, with the initializers run as a function of the unit
+                std::vector<std::unique_ptr<StatementIR>> field_initializers;
+                for (auto &[field_name, field_initalizer] : cu.getCanonFieldList()) {
+                    assert(field_initalizer);
+                    program.static_fields.push_back(field_name);
+                    field_initializers.push_back(std::move(field_initalizer));
+                }
+                cu.getCanonFieldList().clear();
+
+                if (!field_initializers.empty()) {
+                    appendInitFunction(cu, cu.static_init_label, std::move(field_initializers));
+                    program.static_initializers.push_back(cu.static_init_label);
+                }
+                if (!cu.start_statements.empty()) {
+                    appendInitFunction(cu, cu.dispatch_vector_init_label, std::move(cu.start_statements));
+                    cu.start_statements.clear();
+                    program.dispatch_vector_initializers.push_back(cu.dispatch_vector_init_label);
+                }
+
+                program.comp_units.push_back(&cu);
+            },
+            [&](auto&) { THROW_CompilerError("shouldn't happen"); }
+        }, ir);
+    }
+
+    return program;
+}
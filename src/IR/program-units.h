@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "IR/ir.h"
+
+// The compilation units of a program, ready for a backend to emit.
+//
+// The static field initializers and the dispatch vector setup of each unit are moved into functions of the unit,
+// which the program's entrypoint calls in order before the entrypoint method, so each unit only depends on itself.
+struct ProgramUnits {
+    std::vector<CompUnitIR*> comp_units;
+    std::vector<std::string> static_fields;
+    std::vector<std::string> static_initializers;
+    std::vector<std::string> dispatch_vector_initializers;
+};
+
+// Collect the compilation units of the canonical IR trees, moving their initialization code into functions
+ProgramUnits prepareProgramUnits(std::vector<IR> &ir_trees);
@@ -1,26 +1,22 @@
 #pragma once
 
 #include "IR/ir_variant.h"
+#include "IR/ir-names.h"
 #include <memory>
 #include <string>
 
 class TempIR {
-    static size_t num_temps;
-    std::string name;
+    TempId id; // Names are in the temporaries table of the compilation unit
 
 public:
     bool isGlobal = false; // Is a static field
 
-    TempIR(std::string name, bool isGlobal=false) : name{std::move(name)}, isGlobal{isGlobal} {}
+    TempIR(TempId id, bool isGlobal=false) : id{id}, isGlobal{isGlobal} {}
 
-    std::string &getName() { return name; }
-    static std::string generateName(std::string prefix = "") {
-        num_temps++;
-        return (prefix.empty() ? "temp" : prefix) + std::to_string(num_temps);
-    }
+    TempId getId() { return id; }
 
-    std::string label() { return "TEMP(" + name + ")"; }
+    std::string label() { return "TEMP(" + std::to_string(id) + ")"; }
     bool isConstant() { return false; }
 
-    static std::unique_ptr<ExpressionIR> makeExpr(std::string str, bool isGlobal=false);
+    static std::unique_ptr<ExpressionIR> makeExpr(TempId id, bool isGlobal=false);
 };
@@ -4,8 +4,6 @@
 #include <sstream>
 #include <variant>
 
-std::vector<const std::string *> AddLocation::filenames;
-
 void AddLocation::operator()(CompilationUnit &node) {
     node.location = loc;
 }
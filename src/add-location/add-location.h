@@ -3,12 +3,25 @@
 #include "parsing/bison/location.hh"
 #include "variant-ast/astnode.h"
 #include "variant-ast/packages.h"
-#include <vector>
+#include <deque>
+#include <mutex>
+#include <string>
+
+// Owns the file names that locations point to, for as long as the ASTs of a compilation live
+class LocationFileNames {
+    std::mutex mutex; // Files are parsed concurrently
+    std::deque<std::string> filenames; // Grows without moving the names already added
+
+  public:
+    const std::string *add(const std::string &filename) {
+        std::lock_guard<std::mutex> lock {mutex};
+        return &filenames.emplace_back(filename);
+    }
+};
 
 class AddLocation {
     yy::location loc;
 public:
-    static std::vector<const std::string *> filenames;
     void operator()(CompilationUnit &node);
 
     void operator()(QualifiedIdentifier &node);
@@ -58,21 +71,6 @@ public:
 
     static std::string getString(yy::location &loc);
 
-    static void deleteFileNames() {
-        for ( auto filename : filenames ) {
-            delete filename;
-        }
-        filenames.clear();
-    }
-
-    AddLocation(yy::location &location) {
-        if ( location.begin.filename ) {
-            filenames.push_back(new std::string(*location.begin.filename));
-            yy::position begin{filenames.back(), location.begin.line, location.begin.column};
-            yy::position end{filenames.back(), location.end.line, location.end.column};
-            loc = {begin, end};
-        } else {
-            loc = location;
-        }
-    }
+    // The location's file name must outlive the AST; see LocationFileNames
+    AddLocation(yy::location &location) : loc{location} {}
 };
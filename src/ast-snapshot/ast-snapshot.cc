@@ -0,0 +1,669 @@
+#include "ast-snapshot.h"
+#include "add-location/add-location.h"
+#include "exceptions/exceptions.h"
+#include "utillities/overload.h"
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+
+// Identifies the file format; bump the version whenever the AST, the environment (see environment-snapshot.cc)
+// or the encoding below changes
+static const std::string SNAPSHOT_MAGIC = "joosc-ast-snapshot";
+static const int64_t SNAPSHOT_VERSION = 2;
+
+// Size and modification time of a file, or nullopt if it cannot be read
+static std::optional<std::pair<uint64_t, int64_t>> fileStamp(const std::string &path) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(path, error);
+    if ( error ) { return std::nullopt; }
+    auto modified_time = std::filesystem::last_write_time(path, error);
+    if ( error ) { return std::nullopt; }
+    return std::make_pair(size, (int64_t) modified_time.time_since_epoch().count());
+}
+
+std::string snapshotPath(const std::string &filename) {
+    std::error_code error;
+    auto path = std::filesystem::absolute(filename, error);
+    return error ? filename : path.lexically_normal().string();
+}
+
+bool AstSnapshotUnit::matchesFile() const {
+    auto stamp = fileStamp(path);
+    return stamp && stamp->first == file_size && stamp->second == modified_time;
+}
+
+/***************************************************************
+ *                         Writing
+ ***************************************************************/
+
+AstSnapshotWriter::AstSnapshotWriter() {
+    writeString(SNAPSHOT_MAGIC);
+    writeInt(SNAPSHOT_VERSION);
+}
+
+void AstSnapshotWriter::addUnit(const std::string &filename, AstNodeVariant &ast) {
+    auto path = snapshotPath(filename);
+    auto stamp = fileStamp(path);
+    if ( !stamp ) {
+        THROW_CompilerError("Cannot add " + filename + " to snapshot; file cannot be read");
+    }
+
+    writeBool(true); // Another unit follows
+    writeString(filename);
+    writeString(path);
+    writeInt(stamp->first);
+    writeInt(stamp->second);
+    write(std::get<CompilationUnit>(ast));
+}
+
+void AstSnapshotWriter::writeToFile(const std::string &snapshot_file) {
+    writeBool(false); // No more units
+    writeBool(environment.has_value());
+    if ( environment ) { writeString(*environment); }
+
+    std::ofstream output {snapshot_file, std::ios::binary};
+    output.write(buffer.data(), buffer.size());
+    if ( !output ) {
+        THROW_CompilerError("Cannot write snapshot " + snapshot_file);
+    }
+}
+
+void AstSnapshotWriter::writeLocation(const yy::location &location) {
+    // Every location in a unit refers to the unit's file, if it refers to one at all
+    writeBool(location.begin.filename != nullptr);
+    writeInt(location.begin.line);
+    writeInt(location.begin.column);
+    writeInt(location.end.line);
+    writeInt(location.end.column);
+}
+
+void AstSnapshotWriter::write(const CompilationUnit &node) {
+    writeLocation(node.location);
+    write(node.package_declaration);
+    write(node.single_type_import_declaration);
+    write(node.type_import_on_demand_declaration);
+    write(node.class_declarations);
+    write(node.interface_declarations);
+}
+
+void AstSnapshotWriter::write(const QualifiedIdentifier &node) {
+    writeLocation(node.location);
+    write(node.identifiers);
+}
+
+void AstSnapshotWriter::write(const Identifier &node) {
+    writeLocation(node.location);
+    writeString(node.name);
+}
+
+void AstSnapshotWriter::write(const Type &node) {
+    writeLocation(node.location);
+    write(node.non_array_type);
+    writeBool(node.is_array);
+}
+
+void AstSnapshotWriter::write(const PrimitiveType &node) {
+    writeInt(static_cast<int64_t>(node));
+}
+
+void AstSnapshotWriter::write(const ClassDeclaration &node) {
+    writeLocation(node.location);
+    write(node.modifiers);
+    write(node.class_name);
+    write(node.extends_class);
+    write(node.implements);
+    write(node.field_declarations);
+    write(node.method_declarations);
+}
+
+void AstSnapshotWriter::write(const InterfaceDeclaration &node) {
+    writeLocation(node.location);
+    write(node.modifiers);
+    write(node.interface_name);
+    write(node.extends_class);
+    write(node.method_declarations);
+}
+
+void AstSnapshotWriter::write(const FieldDeclaration &node) {
+    writeLocation(node.location);
+    write(node.modifiers);
+    write(node.type);
+    write(node.variable_declarator);
+}
+
+void AstSnapshotWriter::write(const MethodDeclaration &node) {
+    writeLocation(node.location);
+    write(node.modifiers);
+    write(node.type);
+    write(node.function_name);
+    write(node.parameters);
+    write(node.body);
+}
+
+void AstSnapshotWriter::write(const VariableDeclarator &node) {
+    writeLocation(node.location);
+    write(node.variable_name);
+    write(node.expression);
+}
+
+void AstSnapshotWriter::write(const FormalParameter &node) {
+    writeLocation(node.location);
+    write(node.type);
+    write(node.parameter_name);
+}
+
+void AstSnapshotWriter::write(const Modifier &node) {
+    writeInt(static_cast<int64_t>(node));
+}
+
+void AstSnapshotWriter::write(const LocalVariableDeclaration &node) {
+    writeLocation(node.location);
+    write(node.type);
+    write(node.variable_declarator);
+}
+
+void AstSnapshotWriter::write(const Block &node) {
+    writeLocation(node.location);
+    write(node.statements);
+}
+
+void AstSnapshotWriter::write(const IfThenStatement &node) {
+    writeLocation(node.location);
+    write(node.if_clause);
+    write(node.then_clause);
+}
+
+void AstSnapshotWriter::write(const IfThenElseStatement &node) {
+    writeLocation(node.location);
+    write(node.if_clause);
+    write(node.then_clause);
+    write(node.else_clause);
+}
+
+void AstSnapshotWriter::write(const WhileStatement &node) {
+    writeLocation(node.location);
+    write(node.condition_expression);
+    write(node.body_statement);
+}
+
+void AstSnapshotWriter::write(const ForStatement &node) {
+    writeLocation(node.location);
+    write(node.init_statement);
+    write(node.condition_expression);
+    write(node.update_statement);
+    write(node.body_statement);
+}
+
+void AstSnapshotWriter::write(const ReturnStatement &node) {
+    writeLocation(node.location);
+    write(node.return_expression);
+}
+
+void AstSnapshotWriter::write(const EmptyStatement &) {
+    // Nothing to store
+}
+
+void AstSnapshotWriter::write(const InfixExpression &node) {
+    writeLocation(node.location);
+    write(node.expression1);
+    write(node.expression2);
+    writeInt(static_cast<int64_t>(node.op));
+}
+
+void AstSnapshotWriter::write(const PrefixExpression &node) {
+    writeLocation(node.location);
+    write(node.expression);
+    writeInt(static_cast<int64_t>(node.op));
+}
+
+void AstSnapshotWriter::write(const CastExpression &node) {
+    writeLocation(node.location);
+    write(node.type);
+    write(node.expression);
+}
+
+void AstSnapshotWriter::write(const Assignment &node) {
+    writeLocation(node.location);
+    write(node.assigned_to);
+    write(node.assigned_from);
+}
+
+void AstSnapshotWriter::write(const QualifiedThis &node) {
+    writeLocation(node.location);
+    write(node.qualified_this);
+}
+
+void AstSnapshotWriter::write(const ArrayCreationExpression &node) {
+    writeLocation(node.location);
+    write(node.type);
+    write(node.expression);
+}
+
+void AstSnapshotWriter::write(const Literal &node) {
+    writeLocation(node.location);
+    writeInt(node.index());
+    std::visit(util::overload {
+        [&](int64_t value) { writeInt(value); },
+        [&](bool value) { writeBool(value); },
+        [&](char value) { writeInt(value); },
+        [&](const std::string &value) { writeString(value); },
+        [&](std::nullptr_t) {}
+    }, static_cast<const LiteralVariant&>(node));
+}
+
+void AstSnapshotWriter::write(const ClassInstanceCreationExpression &node) {
+    writeLocation(node.location);
+    write(node.class_name);
+    write(node.arguments);
+}
+
+void AstSnapshotWriter::write(const FieldAccess &node) {
+    writeLocation(node.location);
+    write(node.expression);
+    write(node.identifier);
+}
+
+void AstSnapshotWriter::write(const ArrayAccess &node) {
+    writeLocation(node.location);
+    write(node.array);
+    write(node.selector);
+}
+
+void AstSnapshotWriter::write(const MethodInvocation &node) {
+    writeLocation(node.location);
+    write(node.parent_expr);
+    write(node.method_name);
+    write(node.arguments);
+}
+
+void AstSnapshotWriter::write(const InstanceOfExpression &node) {
+    writeLocation(node.location);
+    write(node.expression);
+    write(node.type);
+}
+
+void AstSnapshotWriter::write(const ParenthesizedExpression &node) {
+    writeLocation(node.location);
+    write(node.expression);
+}
+
+/***************************************************************
+ *                         Reading
+ *
+ * Children are read inside braced initializers, which are
+ * evaluated left to right, so they are read in the order
+ * they were written.
+ ***************************************************************/
+
+AstSnapshot AstSnapshotReader::readFile(
+    const std::string &snapshot_file, LocationFileNames &filenames, AstArena &arena
+) {
+    std::ifstream input {snapshot_file, std::ios::binary};
+    if ( !input ) {
+        THROW_CompilerError("Cannot open snapshot " + snapshot_file);
+    }
+    input.seekg(0, std::ios::end);
+    std::string contents(input.tellg(), '\0');
+    input.seekg(0);
+    input.read(contents.data(), contents.size());
+
+    return readContents(contents, snapshot_file, filenames, arena);
+}
+
+AstSnapshot AstSnapshotReader::readContents(
+    const std::string &contents, const std::string &snapshot_file, LocationFileNames &filenames, AstArena &arena
+) {
+    AstSnapshotReader reader {contents.data(), contents.data() + contents.size(), arena};
+    if ( reader.readString() != SNAPSHOT_MAGIC || reader.readInt() != SNAPSHOT_VERSION ) {
+        THROW_CompilerError("Snapshot " + snapshot_file + " was not written by this version of joosc");
+    }
+
+    AstSnapshot snapshot;
+    auto &units = snapshot.units;
+    while ( reader.readBool() ) {
+        auto filename = reader.readString();
+        auto path = reader.readString();
+        uint64_t file_size = reader.readInt();
+        int64_t modified_time = reader.readInt();
+
+        // Locations keep a pointer to their file name, which must outlive the AST
+        reader.filename = filenames.add(filename);
+
+        units.emplace_back(
+            std::move(filename), std::move(path), file_size, modified_time,
+            AstNodeVariant{std::in_place_type<CompilationUnit>, reader.read(Tag<CompilationUnit>{})}
+        );
+    }
+
+    if ( reader.readBool() ) {
+        snapshot.environment = reader.readString();
+    }
+
+    return snapshot;
+}
+
+yy::location AstSnapshotReader::readLocation() {
+    const std::string *location_file = readBool() ? filename : nullptr;
+    int begin_line = readInt();
+    int begin_column = readInt();
+    int end_line = readInt();
+    int end_column = readInt();
+    yy::position begin_position {location_file, begin_line, begin_column};
+    yy::position end_position {location_file, end_line, end_column};
+    return {begin_position, end_position};
+}
+
+CompilationUnit AstSnapshotReader::read(Tag<CompilationUnit>) {
+    auto location = readLocation();
+    CompilationUnit node {
+        read(Tag<AstPtr<QualifiedIdentifier>>{}),
+        read(Tag<std::vector<QualifiedIdentifier>>{}),
+        read(Tag<std::vector<QualifiedIdentifier>>{}),
+        read(Tag<std::vector<ClassDeclaration>>{}),
+        read(Tag<std::vector<InterfaceDeclaration>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+QualifiedIdentifier AstSnapshotReader::read(Tag<QualifiedIdentifier>) {
+    auto location = readLocation();
+    QualifiedIdentifier node {read(Tag<std::vector<Identifier>>{})};
+    node.location = location;
+    return node;
+}
+
+Identifier AstSnapshotReader::read(Tag<Identifier>) {
+    auto location = readLocation();
+    Identifier node {readString()};
+    node.location = location;
+    return node;
+}
+
+Type AstSnapshotReader::read(Tag<Type>) {
+    auto location = readLocation();
+    Type node {read(Tag<AstPtr<NonArrayType>>{}), readBool()};
+    node.location = location;
+    return node;
+}
+
+PrimitiveType AstSnapshotReader::read(Tag<PrimitiveType>) {
+    return static_cast<PrimitiveType>(readInt());
+}
+
+ClassDeclaration AstSnapshotReader::read(Tag<ClassDeclaration>) {
+    auto location = readLocation();
+    ClassDeclaration node {
+        read(Tag<std::vector<Modifier>>{}),
+        read(Tag<AstPtr<Identifier>>{}),
+        read(Tag<AstPtr<QualifiedIdentifier>>{}),
+        read(Tag<std::vector<QualifiedIdentifier>>{}),
+        read(Tag<std::vector<FieldDeclaration>>{}),
+        read(Tag<std::vector<MethodDeclaration>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+InterfaceDeclaration AstSnapshotReader::read(Tag<InterfaceDeclaration>) {
+    auto location = readLocation();
+    InterfaceDeclaration node {
+        read(Tag<std::vector<Modifier>>{}),
+        read(Tag<AstPtr<Identifier>>{}),
+        read(Tag<std::vector<QualifiedIdentifier>>{}),
+        read(Tag<std::vector<MethodDeclaration>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+FieldDeclaration AstSnapshotReader::read(Tag<FieldDeclaration>) {
+    auto location = readLocation();
+    FieldDeclaration node {
+        read(Tag<std::vector<Modifier>>{}),
+        read(Tag<AstPtr<Type>>{}),
+        read(Tag<AstPtr<VariableDeclarator>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+MethodDeclaration AstSnapshotReader::read(Tag<MethodDeclaration>) {
+    auto location = readLocation();
+    MethodDeclaration node {
+        read(Tag<std::vector<Modifier>>{}),
+        read(Tag<AstPtr<Type>>{}),
+        read(Tag<AstPtr<Identifier>>{}),
+        read(Tag<std::vector<FormalParameter>>{}),
+        read(Tag<AstPtr<Block>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+VariableDeclarator AstSnapshotReader::read(Tag<VariableDeclarator>) {
+    auto location = readLocation();
+    VariableDeclarator node {
+        read(Tag<AstPtr<Identifier>>{}),
+        read(Tag<AstPtr<Expression>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+FormalParameter AstSnapshotReader::read(Tag<FormalParameter>) {
+    auto location = readLocation();
+    FormalParameter node {
+        read(Tag<AstPtr<Type>>{}),
+        read(Tag<AstPtr<Identifier>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+Modifier AstSnapshotReader::read(Tag<Modifier>) {
+    return static_cast<Modifier>(readInt());
+}
+
+LocalVariableDeclaration AstSnapshotReader::read(Tag<LocalVariableDeclaration>) {
+    auto location = readLocation();
+    LocalVariableDeclaration node {
+        read(Tag<AstPtr<Type>>{}),
+        read(Tag<AstPtr<VariableDeclarator>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+Block AstSnapshotReader::read(Tag<Block>) {
+    auto location = readLocation();
+    Block node {std::vector<LocalVariableDeclaration>{}, read(Tag<std::vector<Statement>>{})};
+    node.location = location;
+    return node;
+}
+
+IfThenStatement AstSnapshotReader::read(Tag<IfThenStatement>) {
+    auto location = readLocation();
+    IfThenStatement node {
+        read(Tag<AstPtr<Expression>>{}),
+        read(Tag<AstPtr<Statement>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+IfThenElseStatement AstSnapshotReader::read(Tag<IfThenElseStatement>) {
+    auto location = readLocation();
+    IfThenElseStatement node {
+        read(Tag<AstPtr<Expression>>{}),
+        read(Tag<AstPtr<Statement>>{}),
+        read(Tag<AstPtr<Statement>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+WhileStatement AstSnapshotReader::read(Tag<WhileStatement>) {
+    auto location = readLocation();
+    WhileStatement node {
+        read(Tag<AstPtr<Expression>>{}),
+        read(Tag<AstPtr<Statement>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+ForStatement AstSnapshotReader::read(Tag<ForStatement>) {
+    auto location = readLocation();
+    ForStatement node {
+        read(Tag<AstPtr<Statement>>{}),
+        read(Tag<AstPtr<Expression>>{}),
+        read(Tag<AstPtr<Statement>>{}),
+        read(Tag<AstPtr<Statement>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+ReturnStatement AstSnapshotReader::read(Tag<ReturnStatement>) {
+    auto location = readLocation();
+    ReturnStatement node {read(Tag<AstPtr<Expression>>{})};
+    node.location = location;
+    return node;
+}
+
+EmptyStatement AstSnapshotReader::read(Tag<EmptyStatement>) {
+    return EmptyStatement{};
+}
+
+InfixExpression AstSnapshotReader::read(Tag<InfixExpression>) {
+    auto location = readLocation();
+    InfixExpression node {
+        read(Tag<AstPtr<Expression>>{}),
+        read(Tag<AstPtr<Expression>>{}),
+        static_cast<InfixOperator>(readInt())
+    };
+    node.location = location;
+    return node;
+}
+
+PrefixExpression AstSnapshotReader::read(Tag<PrefixExpression>) {
+    auto location = readLocation();
+    PrefixExpression node {
+        read(Tag<AstPtr<Expression>>{}),
+        static_cast<PrefixOperator>(readInt())
+    };
+    node.location = location;
+    return node;
+}
+
+CastExpression AstSnapshotReader::read(Tag<CastExpression>) {
+    auto location = readLocation();
+    CastExpression node {
+        read(Tag<AstPtr<Type>>{}),
+        read(Tag<AstPtr<Expression>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+Assignment AstSnapshotReader::read(Tag<Assignment>) {
+    auto location = readLocation();
+    Assignment node {
+        read(Tag<AstPtr<Expression>>{}),
+        read(Tag<AstPtr<Expression>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+QualifiedThis AstSnapshotReader::read(Tag<QualifiedThis>) {
+    auto location = readLocation();
+    QualifiedThis node {read(Tag<AstPtr<QualifiedIdentifier>>{})};
+    node.location = location;
+    return node;
+}
+
+ArrayCreationExpression AstSnapshotReader::read(Tag<ArrayCreationExpression>) {
+    auto location = readLocation();
+    ArrayCreationExpression node {
+        read(Tag<AstPtr<Type>>{}),
+        read(Tag<AstPtr<Expression>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+Literal AstSnapshotReader::read(Tag<Literal>) {
+    auto location = readLocation();
+    Literal node {nullptr};
+    switch ( readInt() ) {
+        case 0: node = readInt(); break;
+        case 1: node = readBool(); break;
+        case 2: node = static_cast<char>(readInt()); break;
+        case 3: node = readString(); break;
+        case 4: node = nullptr; break;
+        default: corrupt();
+    }
+    node.location = location;
+    return node;
+}
+
+ClassInstanceCreationExpression AstSnapshotReader::read(Tag<ClassInstanceCreationExpression>) {
+    auto location = readLocation();
+    ClassInstanceCreationExpression node {
+        read(Tag<AstPtr<QualifiedIdentifier>>{}),
+        read(Tag<std::vector<Expression>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+FieldAccess AstSnapshotReader::read(Tag<FieldAccess>) {
+    auto location = readLocation();
+    FieldAccess node {
+        read(Tag<AstPtr<Expression>>{}),
+        read(Tag<AstPtr<Identifier>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+ArrayAccess AstSnapshotReader::read(Tag<ArrayAccess>) {
+    auto location = readLocation();
+    ArrayAccess node {
+        read(Tag<AstPtr<Expression>>{}),
+        read(Tag<AstPtr<Expression>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+MethodInvocation AstSnapshotReader::read(Tag<MethodInvocation>) {
+    auto location = readLocation();
+    MethodInvocation node {
+        read(Tag<AstPtr<Expression>>{}),
+        read(Tag<AstPtr<Identifier>>{}),
+        read(Tag<std::vector<Expression>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+InstanceOfExpression AstSnapshotReader::read(Tag<InstanceOfExpression>) {
+    auto location = readLocation();
+    InstanceOfExpression node {
+        read(Tag<AstPtr<Expression>>{}),
+        read(Tag<AstPtr<Type>>{})
+    };
+    node.location = location;
+    return node;
+}
+
+ParenthesizedExpression AstSnapshotReader::read(Tag<ParenthesizedExpression>) {
+    auto location = readLocation();
+    ParenthesizedExpression node {read(Tag<AstPtr<Expression>>{})};
+    node.location = location;
+    return node;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "variant-ast/astnode.h"
+#include "add-location/add-location.h"
+#include "snapshot-encoding.h"
+
+// Absolute path of a file, as used to match input files against snapshot units
+std::string snapshotPath(const std::string &filename);
+
+// A compilation unit stored in a snapshot, along with the file it was parsed from
+struct AstSnapshotUnit {
+    std::string filename; // File name as given on the command line, used in locations
+    std::string path; // Absolute path, used to match input files against the snapshot
+    uint64_t file_size;
+    int64_t modified_time;
+    AstNodeVariant ast;
+
+    // Whether the file on disk is unchanged since the snapshot was written
+    bool matchesFile() const;
+
+    AstSnapshotUnit(std::string filename, std::string path, uint64_t file_size, int64_t modified_time, AstNodeVariant &&ast)
+        : filename{std::move(filename)}, path{std::move(path)},
+        file_size{file_size}, modified_time{modified_time}, ast{std::move(ast)} {}
+};
+
+// The compilation units stored in a snapshot, and the environment written for them, if any
+struct AstSnapshot {
+    std::vector<AstSnapshotUnit> units;
+    std::optional<std::string> environment; // Restored with readEnvironment, see environment-snapshot.h
+};
+
+// Serializes parsed and weeded compilation units (e.g. the standard library) to a snapshot file,
+// so later compiles can load them instead of scanning, parsing and weeding the same files again.
+//
+// The units' environment, type links and hierarchy can be stored along with them (see environment-snapshot.h).
+// Everything the later passes annotate is rebuilt, since it depends on the rest of the program.
+class AstSnapshotWriter : SnapshotEncoder {
+    std::optional<std::string> environment;
+
+    void writeLocation(const yy::location &location);
+
+    template <typename T>
+    void write(const AstPtr<T> &node) {
+        writeBool(node != nullptr);
+        if ( node ) { write(*node); }
+    }
+
+    template <typename T>
+    void write(const std::vector<T> &nodes) {
+        writeInt(nodes.size());
+        for ( auto &node : nodes ) { write(node); }
+    }
+
+    template <typename... Ts>
+    void write(const std::variant<Ts...> &node) {
+        writeInt(node.index());
+        std::visit([&](auto &alternative) { write(alternative); }, node);
+    }
+
+    void write(const CompilationUnit &node);
+    void write(const QualifiedIdentifier &node);
+    void write(const Identifier &node);
+    void write(const Type &node);
+    void write(const PrimitiveType &node);
+    void write(const ClassDeclaration &node);
+    void write(const InterfaceDeclaration &node);
+    void write(const FieldDeclaration &node);
+    void write(const MethodDeclaration &node);
+    void write(const VariableDeclarator &node);
+    void write(const FormalParameter &node);
+    void write(const Modifier &node);
+    void write(const LocalVariableDeclaration &node);
+    void write(const Block &node);
+    void write(const IfThenStatement &node);
+    void write(const IfThenElseStatement &node);
+    void write(const WhileStatement &node);
+    void write(const ForStatement &node);
+    void write(const ReturnStatement &node);
+    void write(const EmptyStatement &node);
+    void write(const InfixExpression &node);
+    void write(const PrefixExpression &node);
+    void write(const CastExpression &node);
+    void write(const Assignment &node);
+    void write(const QualifiedThis &node);
+    void write(const ArrayCreationExpression &node);
+    void write(const Literal &node);
+    void write(const ClassInstanceCreationExpression &node);
+    void write(const FieldAccess &node);
+    void write(const ArrayAccess &node);
+    void write(const MethodInvocation &node);
+    void write(const InstanceOfExpression &node);
+    void write(const ParenthesizedExpression &node);
+
+  public:
+    AstSnapshotWriter();
+
+    // Add the AST parsed from filename to the snapshot
+    void addUnit(const std::string &filename, AstNodeVariant &ast);
+
+    // Store the environment written by writeEnvironment for the units added
+    void setEnvironment(std::string environment) { this->environment = std::move(environment); }
+
+    // Throws CompilerError if the snapshot cannot be written
+    void writeToFile(const std::string &snapshot_file);
+};
+
+// Loads the compilation units stored by AstSnapshotWriter
+class AstSnapshotReader : SnapshotDecoder {
+    const std::string *filename = nullptr; // Owned by the compilation, like locations set by the parser
+    AstArena &arena; // Where the loaded nodes are made
+
+    template <typename T> struct Tag {};
+
+    yy::location readLocation();
+
+    template <typename T>
+    AstPtr<T> read(Tag<AstPtr<T>>) {
+        if ( !readBool() ) { return nullptr; }
+        return arena.make<T>(read(Tag<T>{}));
+    }
+
+    template <typename T>
+    std::vector<T> read(Tag<std::vector<T>>) {
+        std::vector<T> nodes;
+        size_t size = readInt();
+        nodes.reserve(size);
+        for ( size_t i = 0; i < size; i++ ) {
+            nodes.emplace_back(read(Tag<T>{}));
+        }
+        return nodes;
+    }
+
+    template <typename Variant, size_t I = 0>
+    Variant readAlternative(size_t index) {
+        if constexpr ( I < std::variant_size_v<Variant> ) {
+            if ( index == I ) {
+                return Variant{std::in_place_index<I>, read(Tag<std::variant_alternative_t<I, Variant>>{})};
+            }
+            return readAlternative<Variant, I + 1>(index);
+        } else {
+            corrupt();
+        }
+    }
+
+    template <typename... Ts>
+    std::variant<Ts...> read(Tag<std::variant<Ts...>>) {
+        return readAlternative<std::variant<Ts...>>(readInt());
+    }
+
+    CompilationUnit read(Tag<CompilationUnit>);
+    QualifiedIdentifier read(Tag<QualifiedIdentifier>);
+    Identifier read(Tag<Identifier>);
+    Type read(Tag<Type>);
+    PrimitiveType read(Tag<PrimitiveType>);
+    ClassDeclaration read(Tag<ClassDeclaration>);
+    InterfaceDeclaration read(Tag<InterfaceDeclaration>);
+    FieldDeclaration read(Tag<FieldDeclaration>);
+    MethodDeclaration read(Tag<MethodDeclaration>);
+    VariableDeclarator read(Tag<VariableDeclarator>);
+    FormalParameter read(Tag<FormalParameter>);
+    Modifier read(Tag<Modifier>);
+    LocalVariableDeclaration read(Tag<LocalVariableDeclaration>);
+    Block read(Tag<Block>);
+    IfThenStatement read(Tag<IfThenStatement>);
+    IfThenElseStatement read(Tag<IfThenElseStatement>);
+    WhileStatement read(Tag<WhileStatement>);
+    ForStatement read(Tag<ForStatement>);
+    ReturnStatement read(Tag<ReturnStatement>);
+    EmptyStatement read(Tag<EmptyStatement>);
+    InfixExpression read(Tag<InfixExpression>);
+    PrefixExpression read(Tag<PrefixExpression>);
+    CastExpression read(Tag<CastExpression>);
+    Assignment read(Tag<Assignment>);
+    QualifiedThis read(Tag<QualifiedThis>);
+    ArrayCreationExpression read(Tag<ArrayCreationExpression>);
+    Literal read(Tag<Literal>);
+    ClassInstanceCreationExpression read(Tag<ClassInstanceCreationExpression>);
+    FieldAccess read(Tag<FieldAccess>);
+    ArrayAccess read(Tag<ArrayAccess>);
+    MethodInvocation read(Tag<MethodInvocation>);
+    InstanceOfExpression read(Tag<InstanceOfExpression>);
+    ParenthesizedExpression read(Tag<ParenthesizedExpression>);
+
+    AstSnapshotReader(const char *begin, const char *end, AstArena &arena) : SnapshotDecoder{begin, end}, arena{arena} {}
+
+  public:
+    // Throws CompilerError if the snapshot cannot be read or was written by a different compiler version.
+    // The file names the loaded locations refer to are added to filenames, and the nodes are made in arena.
+    static AstSnapshot readFile(
+        const std::string &snapshot_file, LocationFileNames &filenames, AstArena &arena
+    );
+
+    // Like readFile, for a snapshot already loaded into memory
+    static AstSnapshot readContents(
+        const std::string &contents, const std::string &snapshot_file, LocationFileNames &filenames, AstArena &arena
+    );
+};
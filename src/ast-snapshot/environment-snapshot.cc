@@ -0,0 +1,471 @@
+#include "environment-snapshot.h"
+#include "snapshot-encoding.h"
+#include "environment-builder/symboltable.h"
+#include "variant-ast/astvisitor/defaultskipvisitor.h"
+#include "exceptions/exceptions.h"
+#include "utillities/overload.h"
+
+#include <unordered_map>
+
+/***************************************************************
+ * Declarations and type links are numbered in the order this
+ * walk finds them, which is the same when writing and reading,
+ * so the environment refers to them by number.
+ ***************************************************************/
+
+namespace {
+
+class DeclarationWalk : public DefaultSkipVisitor<void> {
+  public:
+    std::vector<TypeDeclaration> types;
+    std::vector<FieldDeclaration*> fields;
+    std::vector<MethodDeclaration*> methods;
+    std::vector<FormalParameter*> parameters;
+    std::vector<LocalVariableDeclaration*> locals;
+    std::vector<Type*> type_nodes;
+    std::vector<ClassInstanceCreationExpression*> creations;
+
+    using DefaultSkipVisitor<void>::operator();
+
+    void operator()(ClassDeclaration &node) override { types.push_back(node.environment); visit_children(node); }
+    void operator()(InterfaceDeclaration &node) override { types.push_back(node.environment); visit_children(node); }
+    void operator()(FieldDeclaration &node) override { fields.push_back(&node); visit_children(node); }
+    void operator()(MethodDeclaration &node) override { methods.push_back(&node); visit_children(node); }
+    void operator()(FormalParameter &node) override { parameters.push_back(&node); visit_children(node); }
+    void operator()(LocalVariableDeclaration &node) override { locals.push_back(&node); visit_children(node); }
+    void operator()(Type &node) override { type_nodes.push_back(&node); visit_children(node); }
+    void operator()(ClassInstanceCreationExpression &node) override { creations.push_back(&node); visit_children(node); }
+
+    void visit(AstNodeVariant &node) override { std::visit(*this, node); }
+};
+
+TypeDeclarationObject* typeObject(TypeDeclaration type) {
+    return std::visit([](auto type) -> TypeDeclarationObject* { return type; }, type);
+}
+
+/***************************************************************
+ *                         Writing
+ ***************************************************************/
+
+class EnvironmentWriter : public SnapshotEncoder {
+    template <typename T>
+    void writeId(std::unordered_map<T*, int64_t> &ids, T *entry) {
+        if ( !entry ) { writeInt(-1); return; }
+        auto id = ids.find(entry);
+        if ( id == ids.end() ) {
+            THROW_CompilerError("Snapshot units refer to a declaration outside of them");
+        }
+        writeInt(id->second);
+    }
+
+  public:
+    std::unordered_map<PackageDeclarationObject*, int64_t> package_ids;
+    std::unordered_map<TypeDeclarationObject*, int64_t> type_ids;
+    std::unordered_map<FieldDeclarationObject*, int64_t> field_ids;
+    std::unordered_map<MethodDeclarationObject*, int64_t> method_ids;
+
+    void writePackage(PackageDeclarationObject *package) { writeId(package_ids, package); }
+    void writeType(TypeDeclarationObject *type) { writeId(type_ids, type); }
+    void writeType(TypeDeclaration type) { writeType(typeObject(type)); }
+    void writeField(FieldDeclarationObject *field) { writeId(field_ids, field); }
+    void writeMethod(MethodDeclarationObject *method) { writeId(method_ids, method); }
+
+    void writeLinkedType(const LinkedType &type) {
+        writeInt(type.linked_type.index());
+        std::visit(util::overload {
+            [&](PrimitiveType primitive) { writeInt(static_cast<int64_t>(primitive)); },
+            [&](ClassDeclarationObject *cls) { writeType(cls); },
+            [&](InterfaceDeclarationObject *interface) { writeType(interface); },
+            [&](std::nullptr_t) {}
+        }, type.linked_type);
+        writeBool(type.is_array);
+        writeBool(type.not_expression);
+    }
+};
+
+} // namespace
+
+std::string writeEnvironment(std::vector<AstNodeVariant*> &units, PackageDeclarationObject &root) {
+    EnvironmentWriter out;
+
+    DeclarationWalk walk;
+    for ( auto unit : units ) { walk.visit(*unit); }
+    for ( auto type : walk.types ) { out.type_ids.emplace(typeObject(type), out.type_ids.size()); }
+    for ( auto field : walk.fields ) { out.field_ids.emplace(field->environment, out.field_ids.size()); }
+    for ( auto method : walk.methods ) { out.method_ids.emplace(method->environment, out.method_ids.size()); }
+
+    // Packages, each after the package containing it; the root is package 0
+    std::vector<std::pair<int64_t, PackageDeclarationObject*>> packages;
+    out.package_ids.emplace(&root, 0);
+    for ( auto unit : units ) {
+        auto &node = std::get<CompilationUnit>(*unit);
+        if ( !node.package_declaration ) { continue; }
+
+        auto package = &root;
+        for ( auto &identifier : node.package_declaration->identifiers ) {
+            auto sub_package = &std::get<PackageDeclarationObject>(
+                *package->sub_packages->lookupUniqueSymbol(identifier.name)
+            );
+            if ( out.package_ids.emplace(sub_package, packages.size() + 1).second ) {
+                packages.emplace_back(out.package_ids.at(package), sub_package);
+            }
+            package = sub_package;
+        }
+    }
+    out.writeInt(packages.size());
+    for ( auto &[parent, package] : packages ) {
+        out.writeInt(parent);
+        out.writeString(package->identifier);
+        out.writeString(package->full_qualified_name);
+    }
+
+    // The package of each unit, and the names of the types it declares
+    out.writeInt(units.size());
+    for ( auto unit : units ) {
+        auto &node = std::get<CompilationUnit>(*unit);
+        out.writePackage(node.cu_namespace.getCurrentPackage());
+
+        DeclarationWalk unit_walk;
+        unit_walk.visit(*unit);
+        for ( auto type : unit_walk.types ) {
+            out.writeString(typeObject(type)->full_qualified_name);
+        }
+    }
+    out.writeInt(walk.types.size());
+    out.writeInt(walk.fields.size());
+    out.writeInt(walk.methods.size());
+
+    // Type linking
+    for ( auto unit : units ) {
+        auto &cu_namespace = std::get<CompilationUnit>(*unit).cu_namespace;
+        out.writeType(cu_namespace.getDeclaredType());
+        out.writeInt(cu_namespace.getSingleImports().size());
+        for ( auto type : cu_namespace.getSingleImports() ) { out.writeType(type); }
+        out.writeInt(cu_namespace.getStarImports().size());
+        for ( auto package : cu_namespace.getStarImports() ) { out.writePackage(package); }
+    }
+    for ( auto type : walk.types ) {
+        std::visit(util::overload {
+            [&](ClassDeclarationObject *cls) {
+                out.writeType(cls->extended);
+                out.writeInt(cls->implemented.size());
+                for ( auto interface : cls->implemented ) { out.writeType(interface); }
+            },
+            [&](InterfaceDeclarationObject *interface) {
+                out.writeInt(interface->extended.size());
+                for ( auto extended : interface->extended ) { out.writeType(extended); }
+            }
+        }, type);
+    }
+    out.writeInt(walk.type_nodes.size());
+    for ( auto type_node : walk.type_nodes ) { out.writeLinkedType(type_node->link); }
+    out.writeInt(walk.creations.size());
+    for ( auto creation : walk.creations ) { out.writeLinkedType(creation->link); }
+
+    // Hierarchy checking
+    for ( auto type : walk.types ) {
+        auto object = typeObject(type);
+
+        out.writeInt(object->all_methods.size());
+        for ( auto &[name, method] : object->all_methods ) {
+            out.writeString(name);
+            out.writeMethod(method);
+        }
+        out.writeInt(object->overloaded_methods.size());
+        for ( auto &[name, methods] : object->overloaded_methods ) {
+            out.writeString(name);
+            out.writeInt(methods.size());
+            for ( auto method : methods ) { out.writeMethod(method); }
+        }
+        out.writeInt(object->method_list.size());
+        for ( auto method : object->method_list ) { out.writeMethod(method); }
+
+        if ( auto cls = std::get_if<ClassDeclarationObject*>(&type) ) {
+            out.writeInt((*cls)->accessible_fields.size());
+            for ( auto &[name, field] : (*cls)->accessible_fields ) {
+                out.writeString(name);
+                out.writeField(field);
+            }
+        }
+    }
+
+    return out.contents();
+}
+
+/***************************************************************
+ *                         Reading
+ ***************************************************************/
+
+namespace {
+
+class EnvironmentReader : public SnapshotDecoder {
+    template <typename T>
+    T* readId(std::vector<T*> &entries) {
+        int64_t id = readInt();
+        if ( id == -1 ) { return nullptr; }
+        if ( id < 0 || id >= (int64_t) entries.size() ) { corrupt(); }
+        return entries[id];
+    }
+
+  public:
+    std::vector<PackageDeclarationObject*> packages;
+    std::vector<TypeDeclaration> types;
+    std::vector<FieldDeclarationObject*> fields;
+    std::vector<MethodDeclarationObject*> methods;
+
+    using SnapshotDecoder::SnapshotDecoder;
+
+    PackageDeclarationObject* readPackage() { return readId(packages); }
+    FieldDeclarationObject* readField() { return readId(fields); }
+    MethodDeclarationObject* readMethod() { return readId(methods); }
+
+    TypeDeclaration readType() {
+        int64_t id = readInt();
+        if ( id == -1 ) { return static_cast<ClassDeclarationObject*>(nullptr); }
+        if ( id < 0 || id >= (int64_t) types.size() ) { corrupt(); }
+        return types[id];
+    }
+
+    template <typename T>
+    T* readType() {
+        auto type = readType();
+        if ( auto object = std::get_if<T*>(&type) ) { return *object; }
+        if ( typeObject(type) ) { corrupt(); }
+        return nullptr;
+    }
+
+    LinkedType readLinkedType() {
+        LinkedType type;
+        switch ( readInt() ) {
+            case 0: type.linked_type = static_cast<PrimitiveType>(readInt()); break;
+            case 1: type.linked_type = readType<ClassDeclarationObject>(); break;
+            case 2: type.linked_type = readType<InterfaceDeclarationObject>(); break;
+            case 3: type.linked_type = nullptr; break;
+            default: corrupt();
+        }
+        type.is_array = readBool();
+        type.not_expression = readBool();
+        return type;
+    }
+};
+
+// Adds the declarations of a unit to the environment, as environment building does. The conflicts environment
+// building rejects were ruled out when the environment was written.
+class DeclarationRestorer : public DefaultSkipVisitor<void> {
+    EnvironmentReader &in;
+    PackageDeclarationObject *current_package;
+    TypeDeclaration current_type;
+    MethodDeclarationObject *current_method = nullptr;
+
+    template <typename AstNodeType, typename SymbolTableEntryType>
+    void linkDeclaration(AstNodeType &node, SymbolTableEntryType &env) {
+        node.environment = &env;
+        env.ast_reference = &node;
+    }
+
+    template <typename T>
+    T* addType(SymbolTable &table, util::Symbol name) {
+        auto type_env = table.addSymbol<T>(name);
+        type_env->package_contained_in = current_package;
+        type_env->full_qualified_name = in.readString();
+        in.types.push_back(type_env);
+        current_type = type_env;
+        return type_env;
+    }
+
+  public:
+    using DefaultSkipVisitor<void>::operator();
+
+    void operator()(ClassDeclaration &node) override {
+        linkDeclaration(node, *addType<ClassDeclarationObject>(*current_package->classes, node.class_name->name));
+        visit_children(node);
+    }
+
+    void operator()(InterfaceDeclaration &node) override {
+        linkDeclaration(
+            node, *addType<InterfaceDeclarationObject>(*current_package->interfaces, node.interface_name->name)
+        );
+        visit_children(node);
+    }
+
+    void operator()(FieldDeclaration &node) override {
+        auto current_class = std::get_if<ClassDeclarationObject*>(&current_type);
+        if ( !current_class ) { in.corrupt(); }
+
+        auto field_env = (*current_class)->fields->addSymbol<FieldDeclarationObject>(
+            node.variable_declarator->variable_name->name
+        );
+        field_env->containing_class = *current_class;
+        field_env->full_qualified_name = (*current_class)->full_qualified_name + "." + field_env->identifier;
+        in.fields.push_back(field_env);
+
+        linkDeclaration(node, *field_env);
+        visit_children(node);
+    }
+
+    void operator()(MethodDeclaration &node) override {
+        std::visit([&](auto cls_or_int_obj) {
+            current_method = cls_or_int_obj->methods->template addSymbol<MethodDeclarationObject>(
+                node.function_name->name
+            );
+            current_method->containing_type = cls_or_int_obj;
+            current_method->full_qualified_name = cls_or_int_obj->full_qualified_name + "." + current_method->identifier;
+        }, current_type);
+        in.methods.push_back(current_method);
+
+        linkDeclaration(node, *current_method);
+        visit_children(node);
+
+        current_method->scope_manager.closeAllScopes();
+    }
+
+    void operator()(Block &node) override {
+        node.scope_id = current_method->scope_manager.createNewScope();
+        current_method->scope_manager.openScope(node.scope_id);
+        visit_children(node);
+        current_method->scope_manager.closeScope(node.scope_id);
+    }
+
+    void operator()(ForStatement &node) override {
+        node.scope_id = current_method->scope_manager.createNewScope();
+        current_method->scope_manager.openScope(node.scope_id);
+        visit_children(node);
+        current_method->scope_manager.closeScope(node.scope_id);
+    }
+
+    void operator()(FormalParameter &node) override {
+        auto param_env = current_method->parameters->addSymbol<FormalParameterDeclarationObject>(
+            node.parameter_name->name
+        );
+        current_method->parameter_list.push_back(param_env);
+
+        linkDeclaration(node, *param_env);
+        visit_children(node);
+    }
+
+    void operator()(LocalVariableDeclaration &node) override {
+        auto var_env = current_method->scope_manager.addVariable(node.variable_declarator->variable_name->name);
+        if ( !var_env ) { in.corrupt(); }
+
+        linkDeclaration(node, *var_env);
+        visit_children(node);
+    }
+
+    DeclarationRestorer(EnvironmentReader &in, PackageDeclarationObject &package) :
+        in{in}, current_package{&package}, current_type{static_cast<ClassDeclarationObject*>(nullptr)} {}
+
+    void visit(AstNodeVariant &node) override { std::visit(*this, node); }
+};
+
+} // namespace
+
+void readEnvironment(
+    const std::string &environment, std::vector<AstNodeVariant*> &units, PackageDeclarationObject &root
+) {
+    EnvironmentReader in {environment.data(), environment.data() + environment.size()};
+
+    // Packages
+    in.packages.push_back(&root);
+    int64_t package_count = in.readInt();
+    for ( int64_t i = 0; i < package_count; i++ ) {
+        auto parent = in.readPackage();
+        if ( !parent ) { in.corrupt(); }
+        auto package = parent->sub_packages->addSymbol<PackageDeclarationObject>(in.readString());
+        package->full_qualified_name = in.readString();
+        in.packages.push_back(package);
+    }
+
+    // Environment building
+    if ( in.readInt() != (int64_t) units.size() ) { in.corrupt(); }
+    std::vector<PackageDeclarationObject*> unit_packages;
+    for ( auto unit : units ) {
+        auto package = unit_packages.emplace_back(in.readPackage());
+        if ( !package ) { in.corrupt(); }
+        DeclarationRestorer(in, *package).visit(*unit);
+    }
+
+    DeclarationWalk walk;
+    for ( auto unit : units ) { walk.visit(*unit); }
+    if ( in.readInt() != (int64_t) walk.types.size()
+        || in.readInt() != (int64_t) walk.fields.size()
+        || in.readInt() != (int64_t) walk.methods.size()
+    ) {
+        in.corrupt();
+    }
+
+    // Type linking
+    for ( size_t i = 0; i < units.size(); i++ ) {
+        auto declared_type = in.readType();
+
+        std::vector<TypeDeclaration> single_imports(in.readInt());
+        for ( auto &type : single_imports ) { type = in.readType(); }
+        std::vector<PackageDeclarationObject*> star_imports(in.readInt());
+        for ( auto &package : star_imports ) { package = in.readPackage(); }
+
+        std::get<CompilationUnit>(*units[i]).cu_namespace = CompilationUnitNamespace(
+            unit_packages[i],
+            &root,
+            declared_type,
+            single_imports,
+            star_imports
+        );
+    }
+    for ( auto type : walk.types ) {
+        std::visit(util::overload {
+            [&](ClassDeclarationObject *cls) {
+                cls->extended = in.readType<ClassDeclarationObject>();
+                cls->implemented.resize(in.readInt());
+                for ( auto &interface : cls->implemented ) { interface = in.readType<InterfaceDeclarationObject>(); }
+            },
+            [&](InterfaceDeclarationObject *interface) {
+                interface->extended.resize(in.readInt());
+                for ( auto &extended : interface->extended ) { extended = in.readType<InterfaceDeclarationObject>(); }
+            }
+        }, type);
+    }
+    if ( in.readInt() != (int64_t) walk.type_nodes.size() ) { in.corrupt(); }
+    for ( auto type_node : walk.type_nodes ) { type_node->link = in.readLinkedType(); }
+    if ( in.readInt() != (int64_t) walk.creations.size() ) { in.corrupt(); }
+    for ( auto creation : walk.creations ) { creation->link = in.readLinkedType(); }
+
+    // Declarations take the types they were declared with, as in type linking
+    for ( auto field : walk.fields ) { field->environment->type = field->type->link; }
+    for ( auto method : walk.methods ) {
+        if ( method->type ) {
+            method->environment->return_type = method->type->link;
+        } else {
+            method->environment->is_constructor = true;
+        }
+    }
+    for ( auto parameter : walk.parameters ) { parameter->environment->type = parameter->type->link; }
+    for ( auto local : walk.locals ) { local->environment->type = local->type->link; }
+
+    // Hierarchy checking
+    for ( auto type : walk.types ) {
+        auto object = typeObject(type);
+
+        int64_t all_method_count = in.readInt();
+        for ( int64_t i = 0; i < all_method_count; i++ ) {
+            auto name = in.readString();
+            object->all_methods.emplace(std::move(name), in.readMethod());
+        }
+        int64_t overloaded_count = in.readInt();
+        for ( int64_t i = 0; i < overloaded_count; i++ ) {
+            auto &methods = object->overloaded_methods[in.readString()];
+            int64_t method_count = in.readInt();
+            for ( int64_t j = 0; j < method_count; j++ ) { methods.push_back(in.readMethod()); }
+        }
+        int64_t method_list_count = in.readInt();
+        for ( int64_t i = 0; i < method_list_count; i++ ) { object->method_list.insert(in.readMethod()); }
+
+        if ( auto cls = std::get_if<ClassDeclarationObject*>(&type) ) {
+            int64_t field_count = in.readInt();
+            for ( int64_t i = 0; i < field_count; i++ ) {
+                auto name = in.readString();
+                (*cls)->accessible_fields.emplace(std::move(name), in.readField());
+            }
+        }
+    }
+
+    if ( !in.atEnd() ) { in.corrupt(); }
+}
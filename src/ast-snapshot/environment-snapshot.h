@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "variant-ast/astnode.h"
+#include "environment-builder/symboltableentry.h"
+
+// Serializes what environment building, type linking and hierarchy checking worked out for a set of compilation
+// units (e.g. the standard library): their packages, the symbol tables of their types, every type link, and the
+// inherited methods and fields of each type, which are also what dispatch vectors are built from.
+//
+// The units must have been analysed on their own, with root holding only their declarations, so everything they
+// refer to is one of theirs.
+//
+// Throws CompilerError if a unit refers to a type or member of another unit.
+std::string writeEnvironment(std::vector<AstNodeVariant*> &units, PackageDeclarationObject &root);
+
+// Restores the environment written by writeEnvironment into the same units, as if environment building, type
+// linking and hierarchy checking had run over them. root must not yet hold any of their packages.
+//
+// Throws CompilerError if the environment was not written for these units.
+void readEnvironment(const std::string &environment, std::vector<AstNodeVariant*> &units, PackageDeclarationObject &root);
@@ -0,0 +1,33 @@
+#include "snapshot-encoding.h"
+#include "exceptions/exceptions.h"
+
+#include <cstring>
+
+void SnapshotEncoder::writeInt(int64_t value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void SnapshotEncoder::writeString(const std::string &value) {
+    writeInt(value.size());
+    buffer.append(value);
+}
+
+void SnapshotDecoder::corrupt() {
+    THROW_CompilerError("Snapshot is truncated or corrupt");
+}
+
+int64_t SnapshotDecoder::readInt() {
+    int64_t value;
+    if ( end - cursor < (ptrdiff_t) sizeof(value) ) { corrupt(); }
+    std::memcpy(&value, cursor, sizeof(value));
+    cursor += sizeof(value);
+    return value;
+}
+
+std::string SnapshotDecoder::readString() {
+    int64_t size = readInt();
+    if ( size < 0 || end - cursor < size ) { corrupt(); }
+    std::string value {cursor, (size_t) size};
+    cursor += size;
+    return value;
+}
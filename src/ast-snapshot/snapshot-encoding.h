@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Appends integers and strings to a snapshot in the host's byte order, as snapshots are only read back by
+// the compiler that wrote them
+class SnapshotEncoder {
+  protected:
+    std::string buffer;
+
+  public:
+    void writeInt(int64_t value);
+    void writeBool(bool value) { writeInt(value); }
+    void writeString(const std::string &value);
+
+    const std::string &contents() const { return buffer; }
+};
+
+// Reads back what a SnapshotEncoder wrote
+class SnapshotDecoder {
+  protected:
+    const char *cursor;
+    const char *end;
+
+  public:
+    SnapshotDecoder(const char *begin, const char *end) : cursor{begin}, end{end} {}
+
+    // Throw CompilerError if the data ends early
+    int64_t readInt();
+    bool readBool() { return readInt() != 0; }
+    std::string readString();
+
+    bool atEnd() const { return cursor == end; }
+
+    [[noreturn]] void corrupt();
+};
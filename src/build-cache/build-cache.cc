@@ -0,0 +1,161 @@
+#include "build-cache.h"
+#include "IR/ir_visitor.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+// Bump whenever tiling, register allocation or the assembly layout changes, so stale entries are not reused
+static const std::string CACHE_VERSION = "joosc-build-cache-11";
+
+// A pre-order walk of the IR; every node contributes its kind and contents, and nodes with a variable
+// number of children their count, so different trees cannot produce the same sequence
+class IRFingerprinter : public IRSkipVisitor {
+    std::string input;
+
+  public:
+    void add(const std::string &value) {
+        input += value;
+        input += '\xff'; // Separator, since no value contains a 0xff byte
+    }
+
+    void add(int64_t value) { add(std::to_string(value)); }
+
+    using IRSkipVisitor::operator();
+
+    void operator()(CompUnitIR &node) override {
+        // Visit in declaration order, which is the order the functions are emitted in
+        add(node.getFunctionList().size());
+        for ( auto &func : node.getFunctionList() ) {
+            this->operator()(*func);
+        }
+        add(node.getCanonFieldList().size());
+        for ( auto &[name, initializer] : node.getCanonFieldList() ) {
+            add(name);
+            this->operator()(*initializer);
+        }
+        add(node.start_statements.size());
+        for ( auto &start_stmt : node.start_statements ) {
+            this->operator()(*start_stmt);
+        }
+        add(node.static_init_label);
+        add(node.dispatch_vector_init_label);
+
+        // Temporaries and labels are referred to by id, and their names appear in the output
+        add(node.temps.size());
+        for ( TempId temp = 0; temp < node.temps.size(); ++temp ) {
+            add(node.temps.name(temp));
+        }
+        add(node.labels.size());
+        for ( LabelId label = 0; label < node.labels.size(); ++label ) {
+            add(node.labels.name(label));
+        }
+    }
+
+    void operator()(FuncDeclIR &node) override { add(node.label()); add(node.getNumParams()); visit_children(node); }
+
+    void operator()(BinOpIR &node) override { add(node.label()); visit_children(node); }
+    void operator()(CallIR &node) override { add(node.label()); add(node.getNumArgs()); visit_children(node); }
+    void operator()(ConstIR &node) override { add(node.label()); }
+    void operator()(ESeqIR &node) override { add(node.label()); visit_children(node); }
+    void operator()(MemIR &node) override { add(node.label()); visit_children(node); }
+    void operator()(NameIR &node) override { add(node.label()); add(node.isGlobal); }
+    void operator()(TempIR &node) override { add(node.label()); add(node.isGlobal); }
+
+    void operator()(CJumpIR &node) override {
+        add(node.label());
+        add(node.trueLabel());
+        add(node.falseLabel());
+        visit_children(node);
+    }
+    void operator()(ExpIR &node) override { add(node.label()); visit_children(node); }
+    void operator()(JumpIR &node) override { add(node.label()); add(node.getTarget()); }
+    void operator()(LabelIR &node) override { add(node.label()); }
+    void operator()(MoveIR &node) override { add(node.label()); visit_children(node); }
+    void operator()(ReturnIR &node) override { add(node.label()); add(node.getRet() != nullptr); visit_children(node); }
+    void operator()(SeqIR &node) override { add(node.label()); add(node.getStmts().size()); visit_children(node); }
+    void operator()(CommentIR &node) override { add(node.label()); }
+
+    // The entry is stored under an FNV-1a hash of the input
+    BuildCache::Fingerprint result() {
+        uint64_t hash = 14695981039346656037ull;
+        for ( unsigned char c : input ) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        return {hash, std::move(input)};
+    }
+};
+
+BuildCache::Fingerprint BuildCache::fingerprint(
+    CompUnitIR &cu, const std::string &allocator_choice, bool annotated, bool object_file, Assembly::Target target
+) {
+    IRFingerprinter hasher;
+    hasher.add(CACHE_VERSION);
+    hasher.add(allocator_choice);
+    hasher.add(annotated);
+    hasher.add(object_file);
+    hasher.add(static_cast<int64_t>(target));
+    hasher(cu);
+    return hasher.result();
+}
+
+BuildCache::Fingerprint BuildCache::fingerprint(const std::string &contents, const std::string &command) {
+    IRFingerprinter hasher;
+    hasher.add(CACHE_VERSION);
+    hasher.add("contents");
+    hasher.add(command);
+    hasher.add(contents);
+    return hasher.result();
+}
+
+std::string BuildCache::entryPath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx", (unsigned long long) key);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+std::optional<std::string> BuildCache::load(const Fingerprint &fingerprint) const {
+    std::ifstream input {entryPath(fingerprint.key), std::ios::binary};
+    if ( !input ) {
+        return std::nullopt;
+    }
+    std::ostringstream contents;
+    contents << input.rdbuf();
+    std::string entry = contents.str();
+
+    // The entry starts with the size of the fingerprint input it was stored for, then the input itself; an entry
+    // for a different input whose hash collides is a miss
+    size_t header_end = entry.find('\n');
+    if ( header_end == std::string::npos
+        || entry.compare(0, header_end, std::to_string(fingerprint.input.size())) != 0
+        || entry.compare(header_end + 1, fingerprint.input.size(), fingerprint.input) != 0 ) {
+        return std::nullopt;
+    }
+    return entry.substr(header_end + 1 + fingerprint.input.size());
+}
+
+void BuildCache::store(const Fingerprint &fingerprint, const std::string &contents) const {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if ( error ) {
+        return;
+    }
+
+    // Write to a private file and rename it into place, so concurrent compiles never read a partial entry
+    auto path = entryPath(fingerprint.key);
+    auto temporary_path = path + "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream output {temporary_path, std::ios::binary};
+        output << fingerprint.input.size() << '\n' << fingerprint.input << contents;
+        if ( !output ) {
+            std::filesystem::remove(temporary_path, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary_path, path, error);
+    if ( error ) {
+        std::filesystem::remove(temporary_path, error);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "IR/ir.h"
+#include "IR-tiling/assembly/target.h"
+
+// Keeps the assembly emitted for each compilation unit between compiles, so a unit whose
+// canonical IR is unchanged reuses its cu_N.s (or cu_N.o) instead of being tiled and allocated again.
+//
+// The fingerprint of a unit is its canonical IR, which captures everything its assembly depends on:
+// its own source, and the field layouts, dispatch vector offsets and labels of what it refers to.
+// Global labels and temporary names do not depend on the rest of the program, so adding or
+// changing one file only invalidates the units whose IR actually changes.
+//
+// Entries are stored under a hash of the fingerprint, and keep the whole fingerprint to be compared
+// when loaded, so two units whose hashes collide never share assembly.
+class BuildCache {
+    std::string directory;
+
+    std::string entryPath(uint64_t key) const;
+
+  public:
+    // Everything an entry depends on, and the hash of it the entry is stored under
+    struct Fingerprint {
+        uint64_t key = 0;
+        std::string input;
+    };
+
+    explicit BuildCache(std::string directory) : directory{std::move(directory)} {}
+
+    // The unit's canonical IR and everything else that decides its assembly, and whether it is encoded as an object file
+    static Fingerprint fingerprint(
+        CompUnitIR &cu, const std::string &allocator_choice, bool annotated, bool object_file, Assembly::Target target
+    );
+
+    // A file's contents, for entries that only depend on the file and the command that builds them from it,
+    // e.g. the object assembled from it
+    static Fingerprint fingerprint(const std::string &contents, const std::string &command);
+
+    // The file stored for the fingerprint, if any; safe to call concurrently
+    std::optional<std::string> load(const Fingerprint &fingerprint) const;
+
+    // Store the file for the fingerprint; a cache that cannot be written only costs the next compile time
+    void store(const Fingerprint &fingerprint, const std::string &contents) const;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "compilation-context.h"
+#include "ast-snapshot/ast-snapshot.h"
+
+// The standard library snapshot, loaded and analysed once, so a compile server can check each program against it
+// instead of loading and analysing the library again for every compile.
+//
+// The analysis passes only annotate the units they run over, so the library's analysis holds for any program that
+// declares nothing in the library's packages. Environment building for such a program only adds its own packages
+// and types to the library's root package, and they are removed again once the program is compiled.
+struct AnalysedLibrary {
+    // Owns the library's ASTs and environment, and the dispatch vector graph of its methods, left uncoloured
+    CompilationContext context;
+
+    // The library's units in snapshot order, with the files they were parsed from
+    std::vector<AstSnapshotUnit> units;
+    std::unordered_map<std::string, size_t> unit_by_path;
+
+    // First identifier of each unit's package, or "" for the default package
+    std::unordered_set<std::string> top_level_packages;
+};
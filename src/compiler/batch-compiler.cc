@@ -0,0 +1,81 @@
+#include "batch-compiler.h"
+#include "compiler.h"
+#include "command-line.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+int BatchCompiler::run() {
+    std::ifstream manifest {manifest_file};
+    if ( !manifest ) {
+        std::cerr << "Cannot open manifest " << manifest_file << std::endl;
+        return Compiler::USAGE_ERROR;
+    }
+
+    if ( !stdlib_snapshot_file.empty() ) {
+        std::ifstream input {stdlib_snapshot_file, std::ios::binary};
+        if ( !input ) {
+            std::cerr << "Cannot open snapshot " << stdlib_snapshot_file << std::endl;
+            return Compiler::USAGE_ERROR;
+        }
+        std::ostringstream contents;
+        contents << input.rdbuf();
+        stdlib_snapshot_contents = contents.str();
+    }
+
+    std::string line;
+    while ( std::getline(manifest, line) ) {
+        std::istringstream fields {line};
+        std::string output_directory;
+        if ( !(fields >> output_directory) || output_directory[0] == '#' ) {
+            continue;
+        }
+
+        std::vector<std::string> arguments;
+        for ( std::string argument; fields >> argument; ) {
+            arguments.push_back(argument);
+        }
+
+        int return_code = compile(output_directory, arguments);
+        std::cout << return_code << " " << output_directory << std::endl;
+    }
+
+    return Compiler::VALID_PROGRAM;
+}
+
+int BatchCompiler::compile(const std::string &output_directory, std::vector<std::string> &arguments) {
+    // Keep stdout for the results
+    auto cout_buffer = std::cout.rdbuf(std::cerr.rdbuf());
+
+    Compiler compiler;
+    if ( !stdlib_snapshot_file.empty() ) {
+        compiler.setStdlibSnapshot(stdlib_snapshot_file, &stdlib_snapshot_contents);
+    }
+
+    std::vector<char*> argv {const_cast<char*>("joosc")};
+    for ( auto &argument : arguments ) {
+        argv.push_back(argument.data());
+    }
+    argv.push_back(nullptr);
+
+    int return_code;
+    try {
+        auto usage_error = parseCommandLine(compiler, argv.size() - 1, argv.data());
+        if ( usage_error ) {
+            return_code = *usage_error;
+        } else {
+            compiler.setOutputDirectory(output_directory);
+            return_code = compiler.run();
+        }
+    } catch ( const std::exception &e ) {
+        std::cerr << e.what() << std::endl;
+        return_code = Compiler::COMPILER_DEVELOPMENT_ERROR;
+    } catch ( ... ) {
+        std::cerr << "Unknown exception occured in batch compile" << std::endl;
+        return_code = Compiler::COMPILER_DEVELOPMENT_ERROR;
+    }
+
+    std::cout.rdbuf(cout_buffer);
+    return return_code;
+}
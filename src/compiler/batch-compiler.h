@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Compiles many independent programs in one process, so the standard library snapshot is read once
+// and no process is started per program.
+//
+// Each non-empty line of the manifest describes one program, with whitespace separated fields:
+//
+//     <output directory> <joosc argument>...<joosc argument>
+//
+// Lines starting with # are ignored. The program's assembly is written to its output directory
+// instead of output/, and once it is compiled a line is printed to stdout:
+//
+//     <return code> <output directory>
+//
+// Everything the compiler prints while compiling a program goes to stderr.
+class BatchCompiler {
+    std::string manifest_file;
+    std::string stdlib_snapshot_file;
+    std::string stdlib_snapshot_contents; // Read once, used by every program
+
+    // Compile as joosc would with the given arguments, returning its return code
+    int compile(const std::string &output_directory, std::vector<std::string> &arguments);
+
+  public:
+    BatchCompiler(std::string manifest_file, std::string stdlib_snapshot_file)
+        : manifest_file{std::move(manifest_file)}, stdlib_snapshot_file{std::move(stdlib_snapshot_file)} {}
+
+    // Compile every program in the manifest; returns the process exit code
+    int run();
+};
@@ -0,0 +1,215 @@
+#include "command-line.h"
+
+#include <unistd.h>
+#include <iostream>
+#include <exception>
+#include <sstream>
+#include <getopt.h>
+
+using namespace std;
+
+enum class CommandLineArg {
+    OUTPUT_RETURN = 'r',
+    TRACE_PARSING = 'p',
+    TRACE_SCANNING = 's',
+    STATIC_ANALYSIS_ONLY = 'a', // Don't emit IR/assembly; used for pre-A5 tests
+    RUN_AND_TEST_IR = 'i',
+    RUN_AND_TEST_JAVA_IR = 'j',
+    NO_OPTIMIZATION = 'O',
+    OPTIMIZED = 'b',
+    TIME_PASSES = 't',
+    TIME_PASSES_JSON = 'T',
+    THREADS = 'J',
+    STDLIB_SNAPSHOT = 'L',
+    WRITE_SNAPSHOT = 'W',
+    BUILD_CACHE = 'C',
+    SERVER = 'S',
+    BATCH = 'B',
+    ANNOTATE_ASSEMBLY = 'A',
+    EMIT_OBJECTS = 'E',
+    OUTPUT_EXECUTABLE = 'o',
+    RUNTIME = 'R',
+    TARGET = 'm',
+    EMIT_C = 'c'
+};
+
+
+struct cmd_error {};
+
+
+std::optional<int> parseCommandLine(
+    Compiler &compiler, int argc, char *argv[], std::string *server_socket, std::string *batch_manifest
+) {
+    const struct option longopts[] = {
+        { "output-return", no_argument, 0, 'r'},
+        { "trace-parsing", no_argument, 0, 'p'},
+        { "trace-scanning", no_argument, 0, 's'},
+        { "static-analysis", no_argument, 0, 'a'},
+        { "run-ir", no_argument, 0, 'i'},
+        { "run-java-ir", no_argument, 0, 'j'},
+        { "opt-none", no_argument, 0, 'O'},
+        { "optimized", required_argument, 0, 'b'},
+        { "time-passes", no_argument, 0, 't'},
+        { "time-passes-json", required_argument, 0, 'T'},
+        { "threads", required_argument, 0, 'J'},
+        { "stdlib-snapshot", required_argument, 0, 'L'},
+        { "write-snapshot", required_argument, 0, 'W'},
+        { "build-cache", required_argument, 0, 'C'},
+        { "server", required_argument, 0, 'S'},
+        { "batch", required_argument, 0, 'B'},
+        { "annotate-asm", no_argument, 0, 'A'},
+        { "emit-objects", no_argument, 0, 'E'},
+        { "output", required_argument, 0, 'o'},
+        { "runtime", required_argument, 0, 'R'},
+        { "target", required_argument, 0, 'm'},
+        { "emit-c", no_argument, 0, 'c'},
+        {0, 0, 0, 0}
+    };
+
+    int index;
+    char c = 0;
+
+    // Arguments may be parsed more than once per process; this makes getopt start over
+    optind = 0;
+
+    try {
+        // Handle optional arguments (eg. enable parse debugging)
+        while (true) {
+            c = getopt_long(argc, argv, "rpsaijOb:tT:J:L:W:C:S:B:AEo:R:m:c", longopts, &index);
+
+            if ( c == -1 ) break;
+
+            switch (c) {
+                case 'r':
+                    compiler.setOutputRC(true);
+                    break;
+                case 'p':
+                    compiler.setTraceParsing(true);
+                    break;
+                case 's':
+                    compiler.setTraceScanning(true);
+                    break;
+                case 'a':
+                    compiler.setEmitCode(false);
+                    break;
+                case 'i':
+                    compiler.setRunIR(true);
+                    break;
+                case 'j':
+                    compiler.setRunJavaIR(true);
+                    break;
+                case 'O':
+                    compiler.setOptimizationType(Compiler::OptimizationType::UNOPTIMIZED);
+                    std::cout << "compiled without optimization" << std::endl;
+                    break;
+                case 'b':
+                {
+                    std::string arg = std::string(optarg);
+                    if (arg == "opt-reg-only") {
+                        std::cout << "compiled with reg alloc optimization" << std::endl;
+                        compiler.setOptimizationType(Compiler::OptimizationType::REGISTER_ALLOCATION);
+                    } else if (arg == "opt-graph-colouring") {
+                        std::cout << "compiled with graph colouring reg alloc optimization" << std::endl;
+                        compiler.setOptimizationType(Compiler::OptimizationType::GRAPH_COLOURING);
+                    }
+                    break;
+                }
+                case 't':
+                    compiler.setTimePasses(true);
+                    break;
+                case 'T':
+                    compiler.setTimePassesJson(std::string(optarg));
+                    break;
+                case 'J':
+                {
+                    int threads = std::stoi(std::string(optarg));
+                    if (threads < 1) throw cmd_error();
+                    compiler.setThreads(threads);
+                    break;
+                }
+                case 'L':
+                    compiler.setStdlibSnapshot(std::string(optarg));
+                    break;
+                case 'W':
+                    compiler.setWriteSnapshot(std::string(optarg));
+                    break;
+                case 'C':
+                    compiler.setBuildCache(std::string(optarg));
+                    break;
+                case 'S':
+                    if (!server_socket) throw cmd_error();
+                    *server_socket = std::string(optarg);
+                    break;
+                case 'B':
+                    if (!batch_manifest) throw cmd_error();
+                    *batch_manifest = std::string(optarg);
+                    break;
+                case 'A':
+                    compiler.setAnnotateAssembly(true);
+                    break;
+                case 'E':
+                    compiler.setEmitObjects(true);
+                    break;
+                case 'o':
+                    compiler.setExecutable(std::string(optarg));
+                    break;
+                case 'R':
+                    compiler.setRuntime(std::string(optarg));
+                    break;
+                case 'm':
+                {
+                    auto target = Assembly::parseTarget(std::string(optarg));
+                    if (!target) throw cmd_error();
+                    compiler.setTarget(*target);
+                    break;
+                }
+                case 'c':
+                    compiler.setEmitC(true);
+                    break;
+                default:
+                    throw cmd_error();
+            }
+        }
+
+        // For each non-option argument, add to infiles
+        for (int i = optind; i < argc; i++) {
+            // Check that the file exists
+            if (access(argv[i], F_OK) == -1) {
+                cerr << "File " << argv[i] << " does not exist" << endl;
+                return compiler.finishWith(Compiler::USAGE_ERROR);
+            }
+
+            compiler.addInFile(argv[i]);
+        }
+
+        // A server takes its input files from each request, and a batch from its manifest
+        bool is_server = server_socket && !server_socket->empty();
+        bool is_batch = batch_manifest && !batch_manifest->empty();
+        if (is_server && is_batch) {
+            throw cmd_error();
+        }
+        if (compiler.inFilesEmpty() != (is_server || is_batch)) {
+            throw cmd_error();
+        }
+
+        // Object files are only encoded for x86, and C source replaces the assembly and objects altogether
+        if (compiler.emitsObjects() && (compiler.getTarget() != Assembly::Target::X86 || compiler.emitsC())) {
+            throw cmd_error();
+        }
+    } catch ( cmd_error & e ) {
+        cerr 
+            << "Usage:\n\t"
+            << argv[0]
+            << " <filename>"
+            << " [ --output-return [-r] \n\t\t--trace-parsing [-p] \n\t\t--trace-scanning [-s] \n\t\t--static-analysis [-a] \n\t\t--run-ir [-i] \n\t\t--run-java-ir [-j] \n\t\t--opt-none [-O] \n\t\t--optimized [-b] (opt-reg-only|opt-graph-colouring) \n\t\t--time-passes [-t] \n\t\t--time-passes-json [-T] <file> \n\t\t--threads [-J] <count> \n\t\t--stdlib-snapshot [-L] <file> \n\t\t--write-snapshot [-W] <file> \n\t\t--build-cache [-C] <directory> \n\t\t--annotate-asm [-A] \n\t\t--emit-objects [-E] \n\t\t--output [-o] <executable> \n\t\t--runtime [-R] <runtime.s> \n\t\t--target [-m] <x86|x86-64> \n\t\t--emit-c [-c]]"
+            << "\n\t" << argv[0] << " --server [-S] <socket> [ --stdlib-snapshot [-L] <file> ]"
+            << "\n\t" << argv[0] << " --batch [-B] <manifest> [ --stdlib-snapshot [-L] <file> ]"
+            << "\n";
+        return compiler.finishWith(Compiler::USAGE_ERROR);
+    } catch ( ... ) {
+        cerr << "Error occured on input\n";
+        return compiler.finishWith(Compiler::USAGE_ERROR);
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "compiler.h"
+
+// Configure the compiler from joosc's command line arguments.
+//
+// If server_socket is given, --server is accepted and its socket path is stored there, and likewise
+// for --batch and batch_manifest.
+// Returns the code to exit with if the arguments are invalid, and nullopt otherwise.
+std::optional<int> parseCommandLine(
+    Compiler &compiler, int argc, char *argv[], std::string *server_socket = nullptr, std::string *batch_manifest = nullptr
+);
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "add-location/add-location.h"
+#include "source-manager/source-manager.h"
+#include "environment-builder/symboltableentry.h"
+#include "environment-builder/symboltable.h"
+#include "IR-builder/dispatch-vector.h"
+#include "variant-ast/astnode.h"
+
+// Everything one compilation builds up and its passes share.
+//
+// Passes are given the parts they need instead of reaching for globals, so separate compilations
+// can run at the same time in one process (e.g. a compile server or a fuzzer).
+struct CompilationContext {
+    // Contents of the parsed files, which the scanner reads in place and locations point into
+    SourceManager sources;
+
+    // Names of the files the locations in the ASTs loaded from a snapshot point to.
+    // Declared before the ASTs, like the sources, so both are destroyed after them.
+    LocationFileNames filenames;
+
+    // Memory of the AST nodes, one arena per parsed file and one for the snapshot.
+    // Declared before the ASTs, so the nodes are destroyed before their memory is released.
+    std::deque<AstArena> ast_arenas;
+
+    // Every compilation unit of the program, and the file each was parsed from
+    std::vector<AstNodeVariant> asts;
+    std::vector<std::string> unit_names;
+
+    // Package containing every other package; filled in by environment building. A program compiled against an
+    // analysed library (see analysed-library.h) is added to the library's root package instead of its own.
+    PackageDeclarationObject own_root_package;
+    PackageDeclarationObject *root_package = &own_root_package;
+
+    // Method colouring and the resulting dispatch vector and field layout of each class
+    DVBuilder dispatch_vectors;
+
+    CompilationContext() = default;
+    CompilationContext(const CompilationContext&) = delete;
+    CompilationContext &operator=(const CompilationContext&) = delete;
+};
@@ -0,0 +1,193 @@
+#include "compile-server.h"
+#include "compiler.h"
+#include "command-line.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Read request fields until the terminating empty field or the end of the connection
+static std::vector<std::string> readRequest(int connection) {
+    std::vector<std::string> fields;
+    std::string field;
+    char buffer[4096];
+
+    while ( true ) {
+        ssize_t count = read(connection, buffer, sizeof(buffer));
+        if ( count < 0 && errno == EINTR ) { continue; }
+        if ( count <= 0 ) { break; }
+
+        for ( ssize_t i = 0; i < count; i++ ) {
+            if ( buffer[i] != '\0' ) {
+                field += buffer[i];
+            } else if ( field.empty() ) {
+                return fields;
+            } else {
+                fields.push_back(std::move(field));
+                field.clear();
+            }
+        }
+    }
+
+    return fields;
+}
+
+static void writeResponse(int connection, const std::string &response) {
+    size_t written = 0;
+    while ( written < response.size() ) {
+        ssize_t count = send(connection, response.data() + written, response.size() - written, MSG_NOSIGNAL);
+        if ( count < 0 && errno == EINTR ) { continue; }
+        if ( count <= 0 ) { return; } // Client went away
+        written += count;
+    }
+}
+
+int CompileServer::run() {
+    if ( !stdlib_snapshot_file.empty() ) {
+        std::ifstream input {stdlib_snapshot_file, std::ios::binary};
+        if ( !input ) {
+            std::cerr << "Cannot open snapshot " << stdlib_snapshot_file << std::endl;
+            return Compiler::USAGE_ERROR;
+        }
+        std::ostringstream contents;
+        contents << input.rdbuf();
+        stdlib_snapshot_contents = contents.str();
+
+        // Requests compile against the analysed library, or the snapshot alone if it cannot be analysed on its own
+        Compiler loader;
+        loader.setStdlibSnapshot(stdlib_snapshot_file, &stdlib_snapshot_contents);
+        library = loader.analyseLibrary();
+    }
+
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if ( socket_path.size() >= sizeof(address.sun_path) ) {
+        std::cerr << "Socket path " << socket_path << " is too long" << std::endl;
+        return Compiler::USAGE_ERROR;
+    }
+    std::strcpy(address.sun_path, socket_path.c_str());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path.c_str()); // Left behind by a server that did not stop cleanly
+    if ( listener < 0
+        || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || listen(listener, SOMAXCONN) < 0
+    ) {
+        std::cerr << "Cannot listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+        return Compiler::USAGE_ERROR;
+    }
+    std::cerr << "joosc server listening on " << socket_path << std::endl;
+
+    bool running = true;
+    while ( running ) {
+        int connection = accept(listener, nullptr, nullptr);
+        if ( connection < 0 ) {
+            if ( errno == EINTR ) { continue; }
+            std::cerr << "Cannot accept connection: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        running = handleConnection(connection);
+        close(connection);
+    }
+
+    close(listener);
+    unlink(socket_path.c_str());
+    return Compiler::VALID_PROGRAM;
+}
+
+bool CompileServer::handleConnection(int connection) {
+    auto fields = readRequest(connection);
+    if ( fields.empty() ) {
+        return true;
+    }
+
+    if ( fields[0] == "stop" ) {
+        return false;
+    }
+
+    if ( fields[0] != "compile" || fields.size() < 2 ) {
+        std::ostringstream response;
+        response << Compiler::USAGE_ERROR << "\ndiagnostics\nUnknown request " << fields[0] << "\n";
+        writeResponse(connection, response.str());
+        return true;
+    }
+
+    std::vector<std::string> arguments(fields.begin() + 2, fields.end());
+    writeResponse(connection, compile(fields[1], arguments));
+    return true;
+}
+
+std::string CompileServer::compile(const std::string &working_directory, std::vector<std::string> &arguments) {
+    std::ostringstream response;
+    std::error_code error;
+
+    auto server_directory = std::filesystem::current_path();
+    std::filesystem::current_path(working_directory, error);
+    if ( error ) {
+        response << Compiler::USAGE_ERROR << "\ndiagnostics\n"
+            << "Cannot change to directory " << working_directory << ": " << error.message() << "\n";
+        return response.str();
+    }
+
+    // Everything the compiler prints is returned to the client
+    std::ostringstream diagnostics;
+    auto cout_buffer = std::cout.rdbuf(diagnostics.rdbuf());
+    auto cerr_buffer = std::cerr.rdbuf(diagnostics.rdbuf());
+
+    Compiler compiler;
+    if ( !stdlib_snapshot_file.empty() ) {
+        compiler.setStdlibSnapshot(stdlib_snapshot_file, &stdlib_snapshot_contents);
+    }
+
+    std::vector<char*> argv {const_cast<char*>("joosc")};
+    for ( auto &argument : arguments ) {
+        argv.push_back(argument.data());
+    }
+    argv.push_back(nullptr);
+
+    int return_code;
+    try {
+        auto usage_error = parseCommandLine(compiler, argv.size() - 1, argv.data());
+        if ( library && compiler.getStdlibSnapshot() == stdlib_snapshot_file ) {
+            compiler.setLibrary(library.get());
+        }
+        return_code = usage_error ? *usage_error : compiler.run();
+    } catch ( const std::exception &e ) {
+        std::cerr << e.what() << std::endl;
+        return_code = Compiler::COMPILER_DEVELOPMENT_ERROR;
+    } catch ( ... ) {
+        std::cerr << "Unknown exception occured in compile server" << std::endl;
+        return_code = Compiler::COMPILER_DEVELOPMENT_ERROR;
+    }
+
+    std::cout.rdbuf(cout_buffer);
+    std::cerr.rdbuf(cerr_buffer);
+
+    response << return_code << "\n";
+
+    // Only report output emitted by this request, not what an earlier compile left behind
+    bool compiled = return_code == Compiler::VALID_PROGRAM || return_code == Compiler::WARN_PROGRAM;
+    if ( compiled && compiler.emitsCode() && std::filesystem::is_directory(compiler.getOutputDirectory()) ) {
+        std::vector<std::string> outputs;
+        for ( auto &entry : std::filesystem::directory_iterator(compiler.getOutputDirectory()) ) {
+            outputs.push_back(std::filesystem::absolute(entry.path()).string());
+        }
+        std::sort(outputs.begin(), outputs.end());
+        for ( auto &output : outputs ) {
+            response << "output " << output << "\n";
+        }
+    }
+
+    response << "diagnostics\n" << diagnostics.str();
+
+    std::filesystem::current_path(server_directory, error);
+    return response.str();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "analysed-library.h"
+
+// Keeps joosc resident with the standard library snapshot loaded and analysed, and compiles programs sent to it over
+// a Unix socket against it, so each compile skips process startup and only analyses the program's own files.
+//
+// Each connection carries one request: NUL-terminated, non-empty fields ending with an empty field.
+//
+//     compile\0<working directory>\0<joosc argument>\0...<joosc argument>\0\0
+//     stop\0\0
+//
+// A compile request is answered with
+//
+//     <return code>\n
+//     output <path>\n     (for each assembly file emitted)
+//     diagnostics\n
+//     <everything the compiler printed, until the connection is closed>
+//
+// Requests are handled one at a time, since compiling changes the working directory.
+class CompileServer {
+    std::string socket_path;
+    std::string stdlib_snapshot_file;
+    std::string stdlib_snapshot_contents; // Read once, used by every request
+    std::unique_ptr<AnalysedLibrary> library; // Analysed once from the snapshot, if it could be
+
+    // Handle one request; returns false if the server should stop
+    bool handleConnection(int connection);
+
+    // Compile as joosc would with the given arguments, returning the response to send
+    std::string compile(const std::string &working_directory, std::vector<std::string> &arguments);
+
+  public:
+    CompileServer(std::string socket_path, std::string stdlib_snapshot_file)
+        : socket_path{std::move(socket_path)}, stdlib_snapshot_file{std::move(stdlib_snapshot_file)} {}
+
+    // Serve requests until a stop request; returns the process exit code
+    int run();
+};
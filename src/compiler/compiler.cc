@@ -1,10 +1,13 @@
 #include "compiler.h"
 #include "exceptions/exceptions.h"
 #include "utillities/util.h"
+#include "utillities/thread_pool.h"
 
 #include "parsing/bison/driver.h"
 #include "parsing/bison/parser.hh"
 #include "weeder/astweeder.h"
+#include "ast-snapshot/ast-snapshot.h"
+#include "ast-snapshot/environment-snapshot.h"
 
 #include "environment-builder/environmentbuilder.h"
 #include "type-linking/typelinker.h"
@@ -29,7 +32,16 @@
 #include "IR-tiling/register-allocation/brainless-allocator.h"
 #include "IR/code-gen-constants.h"
 #include "IR-tiling/assembly-generator/assembly-generator.h"
-
+#include "compilation-context.h"
+#include "analysed-library.h"
+#include "build-cache/build-cache.h"
+#include "linker/linker.h"
+#include "C-generation/c-generator.h"
+
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <unordered_set>
 #include <regex>
 #include <variant>
 
@@ -38,14 +50,14 @@
     #include "graph/ir_graph.h"
 #endif
 
-std::string Compiler::getEntryPointMethod() {
+std::string Compiler::getEntryPointMethod(PackageDeclarationObject &root_package) {
     if (infiles.size() < 1) {
         THROW_CompilerError("No first file for entrypoint");
     }
 
     if ( !strfiles.empty() ) {
         std::string class_name = "Foo";
-        auto cls = Util::root_package->findClassDeclaration(class_name);
+        auto cls = root_package.findClassDeclaration(class_name);
         auto entry_method = cls->all_methods["test"];
         if (!entry_method) {
             THROW_CompilerError("Class '" + class_name + "' has no method 'test'");
@@ -57,7 +69,7 @@ std::string Compiler::getEntryPointMethod() {
     std::string base_file = first_file.substr(first_file.find_last_of("/") + 1);
     std::string class_name = std::regex_replace(base_file, std::regex(".java"), "");
 
-    auto cls = Util::root_package->findClassDeclaration(class_name);
+    auto cls = root_package.findClassDeclaration(class_name);
     if (!cls) {
         THROW_CompilerError("First file '" + first_file + "' does not have class '" + class_name + "'");
     }
@@ -75,144 +87,530 @@ int Compiler::finishWith(ReturnCode code) {
     return code;
 }
 
+void Compiler::reportPassTimings() {
+    if ( !timer.isEnabled() ) { return; }
+
+    if ( time_passes_json_file.empty() ) {
+        timer.printTable(cerr);
+    } else {
+        std::ofstream json_file {time_passes_json_file};
+        timer.writeJson(json_file);
+    }
+}
+
 struct Destructor {
+    Compiler &compiler;
+
     ~Destructor() {
-        AddLocation::deleteFileNames();
+        compiler.reportPassTimings();
     }
 };
 
-int Compiler::run() {
-    Destructor destruct;
-    Driver drv;
-    AstWeeder weeder;
-    vector<AstNodeVariant> asts;
-    Util::linked_asts = &asts;
-    
-    // Lexing and parsing
+// Removes the packages and types a program declares in an analysed library's root package, once it is compiled
+struct RootPackageCheckpoint {
+    PackageDeclarationObject &root;
+    int sub_packages;
+    int classes;
+    int interfaces;
+
+    explicit RootPackageCheckpoint(PackageDeclarationObject &root) :
+        root{root},
+        sub_packages{root.sub_packages->getSize()},
+        classes{root.classes->getSize()},
+        interfaces{root.interfaces->getSize()} {}
+    RootPackageCheckpoint(const RootPackageCheckpoint&) = delete;
+    RootPackageCheckpoint &operator=(const RootPackageCheckpoint&) = delete;
+
+    ~RootPackageCheckpoint() {
+        root.sub_packages->removeSymbolsFrom(sub_packages);
+        root.classes->removeSymbolsFrom(classes);
+        root.interfaces->removeSymbolsFrom(interfaces);
+    }
+};
+
+// First identifier of the unit's package, or "" if it is in the default package
+static std::string topLevelPackage(AstNodeVariant &ast) {
+    auto &unit = std::get<CompilationUnit>(ast);
+    return unit.package_declaration ? unit.package_declaration->identifiers.front().name : "";
+}
+
+void Compiler::analyse(
+    util::ThreadPool &pool,
+    PackageDeclarationObject &root_package,
+    std::vector<AstNodeVariant*> &declared_asts,
+    const std::vector<std::string> &declared_unit_names,
+    std::vector<AstNodeVariant*> &asts,
+    const std::vector<std::string> &unit_names
+) {
+    // Environment building
+    timer.timeUnits("Environment building", declared_asts, declared_unit_names, [&](AstNodeVariant *ast) {
+        EnvironmentBuilder(root_package).visit(*ast);
+    });
+
+    // Type linking
+    timer.timeUnits("Type linking", declared_asts, declared_unit_names, [&](AstNodeVariant *ast) {
+        TypeLinker(root_package).visit(*ast);
+    });
+
+    // Hierarchy checking
+    timer.timeUnits("Hierarchy checking", declared_asts, declared_unit_names, [&](AstNodeVariant *ast) {
+        HierarchyCheckingVisitor(root_package).visit(*ast);
+    });
+
+    // The remaining analysis passes only annotate their own AST, so ASTs are checked concurrently
+
+    // Disambiguation of names
+    timer.timeUnits("Disambiguation", pool, asts, unit_names, [&](AstNodeVariant *ast) {
+        DisambiguationVisitor(root_package).visit(*ast);
+    });
+
+    // Disambiguation of names (forward decl)
+    timer.timeUnits("Forward declaration checking", pool, asts, unit_names, [&](AstNodeVariant *ast) {
+        ForwardDeclarationVisitor(root_package).visit(*ast);
+    });
+
+    // Check for unclassified identifiers (optional)
+    timer.timeUnits("Unclassified identifier search", pool, asts, unit_names, [&](AstNodeVariant *ast) {
+        SearchUnclassifiedVisitor().visit(*ast);
+    });
+
+    // Type checking
+    timer.timeUnits("Type checking", pool, asts, unit_names, [&](AstNodeVariant *ast) {
+        TypeChecker(root_package).visit(*ast);
+    });
+
+    // CfgBuilder
+    timer.timeUnits("CFG building", pool, asts, unit_names, [&](AstNodeVariant *ast) {
+        CfgBuilderVisitor().visit(*ast);
+    });
+
+    // Reachability testing
+    // Statements reached in each AST; every AST's set is made up front, so they are filled in concurrently
+    std::unordered_map<AstNodeVariant*, std::unordered_set<Statement*>> reached;
+    for ( auto ast : asts ) { reached[ast]; }
+    timer.timeUnits("Reachability analysis", pool, asts, unit_names, [&](AstNodeVariant *ast) {
+        CfgReachabilityVisitor(reached.at(ast)).visit(*ast);
+    });
+
+    // Reachability testing
+    timer.timeUnits("Reached statement checking", pool, asts, unit_names, [&](AstNodeVariant *ast) {
+        StatementVisitor(reached.at(ast)).visit(*ast);
+    });
+
+    // Local variable checking
+    timer.timeUnits("Local variable checking", pool, asts, unit_names, [&](AstNodeVariant *ast) {
+        LocalVariableVisitor(root_package).visit(*ast);
+    });
+}
+
+std::unique_ptr<AnalysedLibrary> Compiler::analyseLibrary() {
+    auto library = std::make_unique<AnalysedLibrary>();
+    auto &context = library->context;
+
     try {
-        drv.trace_scanning = trace_scanning;
-        drv.trace_parsing = trace_parsing;
+        auto &arena = context.ast_arenas.emplace_back();
+        auto snapshot = stdlib_snapshot_contents
+            ? AstSnapshotReader::readContents(*stdlib_snapshot_contents, stdlib_snapshot_file, context.filenames, arena)
+            : AstSnapshotReader::readFile(stdlib_snapshot_file, context.filenames, arena);
+        library->units = std::move(snapshot.units);
+
+        std::vector<AstNodeVariant*> units;
+        std::vector<std::string> unit_names;
+        for ( size_t i = 0; i < library->units.size(); i++ ) {
+            auto &unit = library->units[i];
+            library->unit_by_path.emplace(unit.path, i);
+            library->top_level_packages.insert(topLevelPackage(unit.ast));
+            units.push_back(&unit.ast);
+            unit_names.push_back(unit.filename);
+        }
 
-        std::list<std::string> files = infiles;
+        std::vector<AstNodeVariant*> declared_asts;
+        std::vector<std::string> declared_unit_names;
+        if ( snapshot.environment ) {
+            readEnvironment(*snapshot.environment, units, *context.root_package);
+        } else {
+            declared_asts = units;
+            declared_unit_names = unit_names;
+        }
 
-        for ( auto it = strfiles.rbegin(); it != strfiles.rend(); it++ ) {
-            std::string &strfile = *it;
+        util::ThreadPool pool {num_threads};
+        analyse(pool, *context.root_package, declared_asts, declared_unit_names, units, unit_names);
 
-            // Add in reverse to both list's front
-            drv.strfiles.push_front(strfile);
-            files.push_front("Foo.java");   // dummy filename for strfile
+        // Each program adds its own methods and colours the graph
+        for ( auto ast : units ) {
+            context.dispatch_vectors.visit(*ast);
         }
+    } catch (const std::exception &e) {
+        cerr << "Cannot analyse the standard library snapshot: " << e.what() << endl;
+        return nullptr;
+    }
 
-        for (auto file : files) {
-            bool is_strfile = !drv.strfiles.empty();
-            std::string strfile = is_strfile ? drv.strfiles.front() : "";
-            int rc = drv.parse(file);
+    return library;
+}
 
-            if (rc != 0) {
-                cerr << "Parsing failed" << endl;
-                return finishWith(ReturnCode::INVALID_PROGRAM);
+int Compiler::run() {
+    // All state of this compilation; nothing is kept in globals, so compilations can run concurrently
+    CompilationContext context;
+    Destructor destruct {*this};
+    // Debug traces from several threads would be interleaved
+    util::ThreadPool pool {(trace_parsing || trace_scanning) ? 1 : num_threads};
+    auto &asts = context.asts; // The ASTs of the program's own units
+    auto &unit_names = context.unit_names; // File each unit was parsed from
+
+    // Every unit of the program in input order, including those of an analysed library, and the program's own
+    // units, which the analysis passes run over
+    std::vector<AstNodeVariant*> units;
+    std::vector<AstNodeVariant*> program_asts;
+    std::vector<std::string> program_unit_names;
+    bool use_library = false;
+
+    // Units taken from the snapshot, by their index in units, and the environment written for them
+    std::vector<size_t> snapshot_sources;
+    std::optional<std::string> snapshot_environment;
+    
+    // Lexing and parsing
+    try {
+        struct SourceFile {
+            std::string name;
+            bool is_strfile = false;
+            const SourceBuffer *buffer = nullptr; // Contents of the file, once loaded
+            AstArena *arena = nullptr; // Where the file's AST is made, if it is parsed
+            std::optional<AstNodeVariant> ast;
+            std::optional<size_t> library_unit; // The analysed library's unit used instead, if any
+            std::ostringstream diagnostics;
+            bool failed = false;
+            std::exception_ptr exception;
+        };
+
+        std::vector<SourceFile> sources(strfiles.size() + infiles.size());
+        auto source_it = sources.begin();
+        for ( auto &strfile : strfiles ) {
+            source_it->name = "Foo.java";   // dummy filename for strfile
+            source_it->is_strfile = true;
+            source_it->buffer = &context.sources.addString(std::move(strfile), source_it->name);
+            source_it++;
+        }
+        for ( auto &file : infiles ) {
+            source_it->name = file;
+            source_it++;
+        }
+
+        // Read the snapshot into an arena of its own; false, after printing why, if it cannot be read
+        auto read_snapshot = [&](AstSnapshot &snapshot) {
+            try {
+                timer.timePass("Snapshot loading", [&]() {
+                    auto &arena = context.ast_arenas.emplace_back();
+                    snapshot = stdlib_snapshot_contents
+                        ? AstSnapshotReader::readContents(*stdlib_snapshot_contents, stdlib_snapshot_file, context.filenames, arena)
+                        : AstSnapshotReader::readFile(stdlib_snapshot_file, context.filenames, arena);
+                });
+            } catch (const CompilerError &e) {
+                cerr << e.what() << endl;
+                return false;
+            }
+            return true;
+        };
+
+        // With an analysed library, input files that are unchanged library files are left to it, and its other
+        // files are added after the input files. The library is not used if one of its files was changed.
+        use_library = library && write_snapshot_file.empty();
+        if ( use_library ) {
+            std::vector<bool> claimed(library->units.size());
+            for ( auto &source : sources ) {
+                if ( source.is_strfile ) { continue; }
+                auto unit = library->unit_by_path.find(snapshotPath(source.name));
+                if ( unit == library->unit_by_path.end() ) { continue; }
+
+                if ( claimed[unit->second] || !library->units[unit->second].matchesFile() ) {
+                    use_library = false;
+                    break;
+                }
+                claimed[unit->second] = true;
+                source.library_unit = unit->second;
             }
 
-            AstNodeVariant ast = std::move(*drv.root);            
+            if ( use_library ) {
+                for ( size_t i = 0; i < library->units.size(); i++ ) {
+                    if ( !claimed[i] ) {
+                        SourceFile &added = sources.emplace_back();
+                        added.name = library->units[i].filename;
+                        added.library_unit = i;
+                    }
+                }
+            } else {
+                for ( auto &source : sources ) { source.library_unit.reset(); }
+            }
+        }
 
-            rc = weeder.weed(ast, file, strfile);
+        // Input files that are unchanged since the snapshot was written are taken from it;
+        // files in the snapshot that were not given as input are added after the input files
+        if ( !use_library && !stdlib_snapshot_file.empty() ) {
+            AstSnapshot snapshot;
+            if ( !read_snapshot(snapshot) ) {
+                return finishWith(ReturnCode::USAGE_ERROR);
+            }
 
-            if (rc != 0) {
-                cerr << "Weeding failed" << endl;
-                return finishWith(ReturnCode::INVALID_PROGRAM);
+            std::unordered_map<std::string, size_t> source_by_path;
+            for ( size_t i = 0; i < sources.size(); i++ ) {
+                if ( !sources[i].is_strfile ) {
+                    source_by_path.emplace(snapshotPath(sources[i].name), i);
+                }
             }
 
-            asts.emplace_back(std::move(ast));
+            // The environment is only restored if every unit it was written for is used as it was
+            bool all_units_used = true;
+            for ( auto &unit : snapshot.units ) {
+                auto source = source_by_path.find(unit.path);
+                if ( source == source_by_path.end() ) {
+                    SourceFile &added = sources.emplace_back();
+                    added.name = unit.filename;
+                    added.ast.emplace(std::move(unit.ast));
+                    snapshot_sources.push_back(sources.size() - 1);
+                } else if ( unit.matchesFile() && !sources[source->second].ast ) {
+                    sources[source->second].ast.emplace(std::move(unit.ast));
+                    snapshot_sources.push_back(source->second);
+                } else {
+                    all_units_used = false;
+                }
+            }
+            if ( all_units_used ) {
+                snapshot_environment = std::move(snapshot.environment);
+            }
         }
 
-    } catch ( ... ) {
-        cerr << "Unknown exception occured in syntactic analysis" << endl;
-        return finishWith(ReturnCode::INVALID_PROGRAM);
-    }
+        // Files not loaded from the snapshot or left to the library
+        std::vector<SourceFile*> unparsed;
+        for ( auto &source : sources ) {
+            if ( !source.ast && !source.library_unit ) {
+                source.arena = &context.ast_arenas.emplace_back();
+                unparsed.push_back(&source);
+            }
+        }
 
-    PackageDeclarationObject default_package;
-    Util::root_package = &default_package;
+        // Each file is parsed and weeded independently, with its own scanner and parser
+        auto parse_pass = timer.startPass("Parsing and weeding");
+        parse_pass.reserveUnits(unparsed.size());
+        pool.parallelFor(unparsed.size(), [&](size_t i) {
+            SourceFile &source = *unparsed[i];
 
-    try {
-        #ifdef GRAPHVIZ
-            GraphVisitor gv(asts); // runs on return/destruct
-        #endif
+            parse_pass.timeUnitAt(i, source.name, [&]() {
+                try {
+                    if ( !source.buffer ) {
+                        try {
+                            source.buffer = &context.sources.addFile(source.name);
+                        } catch (const CompilerError &e) {
+                            source.diagnostics << e.what() << endl;
+                            source.failed = true;
+                            return;
+                        }
+                    }
 
-        // Environment building
-        for (auto &ast : asts) {
-            EnvironmentBuilder(default_package).visit(ast);
-        }
+                    Driver drv;
+                    drv.trace_scanning = trace_scanning;
+                    drv.trace_parsing = trace_parsing;
+                    drv.diagnostics = &source.diagnostics;
+                    drv.arena = source.arena;
 
-        // Type linking
-        for (auto& ast : asts) {
-            TypeLinker(default_package).visit(ast);
-        } 
+                    int rc = drv.parse(*source.buffer);
 
-        // Hierarchy checking
-        for ( auto& ast : asts ) {
-            HierarchyCheckingVisitor(default_package).visit(ast);
-        }
+                    if (rc != 0) {
+                        source.diagnostics << "Parsing failed" << endl;
+                        source.failed = true;
+                        return;
+                    }
 
-        // Disambiguation of names
-        for (auto &ast: asts ) {
-            DisambiguationVisitor(default_package).visit(ast);
-        }
+                    AstNodeVariant ast = std::move(*drv.root);
+
+                    rc = AstWeeder(source.diagnostics).weed(ast, source.name, source.buffer->contents());
 
-        // Disambiguation of names (forward decl)
-        for (auto &ast: asts ) {
-            ForwardDeclarationVisitor(default_package).visit(ast);
+                    if (rc != 0) {
+                        source.diagnostics << "Weeding failed" << endl;
+                        source.failed = true;
+                        return;
+                    }
+
+                    source.ast.emplace(std::move(ast));
+                } catch ( ... ) {
+                    source.exception = std::current_exception();
+                }
+            });
+        });
+
+        // Report the first failure in input order, as if the files were handled one at a time
+        for (auto &source : sources) {
+            cerr << source.diagnostics.str();
+
+            if (source.exception) {
+                std::rethrow_exception(source.exception);
+            }
+            if (source.failed) {
+                return finishWith(ReturnCode::INVALID_PROGRAM);
+            }
         }
 
-        // Check for unclassified identifiers (optional)
-        for (auto &ast: asts ) {
-            SearchUnclassifiedVisitor().visit(ast);
+        // The library's analysis only holds if the program declares nothing in its packages; otherwise the
+        // library's files are taken from the snapshot and analysed with the program
+        if ( use_library ) {
+            for ( auto &source : sources ) {
+                if ( source.ast
+                    && (library->top_level_packages.count("") || library->top_level_packages.count(topLevelPackage(*source.ast)))
+                ) {
+                    use_library = false;
+                    break;
+                }
+            }
+
+            if ( !use_library ) {
+                AstSnapshot snapshot;
+                if ( !read_snapshot(snapshot) ) {
+                    return finishWith(ReturnCode::USAGE_ERROR);
+                }
+                for ( auto &source : sources ) {
+                    if ( source.library_unit ) {
+                        source.ast.emplace(std::move(snapshot.units.at(*source.library_unit).ast));
+                        source.library_unit.reset();
+                    }
+                }
+            }
         }
 
-        // Type checking
-        for (auto &ast: asts ) {
-            TypeChecker(default_package).visit(ast);
+        // units points into asts, so it is not resized after this
+        asts.reserve(sources.size());
+        for (auto &source : sources) {
+            if (source.library_unit) {
+                units.push_back(&library->units[*source.library_unit].ast);
+            } else {
+                units.push_back(&asts.emplace_back(std::move(*source.ast)));
+                program_asts.push_back(units.back());
+                program_unit_names.push_back(source.name);
+            }
+            unit_names.emplace_back(source.name);
         }
 
-        // CfgBuilder
-        for (auto &ast: asts) {
-            CfgBuilderVisitor().visit(ast);
-        } 
+        if ( !write_snapshot_file.empty() ) {
+            try {
+                AstSnapshotWriter writer;
+                std::vector<AstNodeVariant*> snapshot_asts;
+                for ( size_t i = 0; i < units.size(); i++ ) {
+                    if ( !sources[i].is_strfile ) {
+                        writer.addUnit(unit_names[i], *units[i]);
+                        snapshot_asts.push_back(units[i]);
+                    }
+                }
+
+                // Store the environment of the units too, if they can be analysed on their own
+                std::optional<std::string> environment;
+                try {
+                    for ( auto ast : snapshot_asts ) { EnvironmentBuilder(*context.root_package).visit(*ast); }
+                    for ( auto ast : snapshot_asts ) { TypeLinker(*context.root_package).visit(*ast); }
+                    for ( auto ast : snapshot_asts ) { HierarchyCheckingVisitor(*context.root_package).visit(*ast); }
+                    environment = writeEnvironment(snapshot_asts, *context.root_package);
+                } catch (const std::exception &e) {
+                    cerr << "Snapshot written without an environment: " << e.what() << endl;
+                }
+                if ( environment ) {
+                    writer.setEnvironment(std::move(*environment));
+                }
 
-        // Reachability testing
-        for (auto &ast : asts) {
-            CfgReachabilityVisitor().visit(ast);
+                writer.writeToFile(write_snapshot_file);
+            } catch (const CompilerError &e) {
+                cerr << e.what() << endl;
+                return finishWith(ReturnCode::USAGE_ERROR);
+            }
+            return finishWith(ReturnCode::VALID_PROGRAM);
         }
 
-        // Reachability testing
-        for (auto &ast : asts) {
-            StatementVisitor().visit(ast);
+    } catch ( ... ) {
+        cerr << "Unknown exception occured in syntactic analysis" << endl;
+        return finishWith(ReturnCode::INVALID_PROGRAM);
+    }
+
+    // With a library, the program is declared in the library's root package, and removed from it afterwards
+    std::optional<RootPackageCheckpoint> library_checkpoint;
+    if ( use_library ) {
+        context.root_package = library->context.root_package;
+        library_checkpoint.emplace(*context.root_package);
+    }
+    auto &default_package = *context.root_package;
+
+    // Units environment building, type linking and hierarchy checking run over; units whose environment is
+    // restored from the snapshot are left out
+    std::vector<AstNodeVariant*> declared_asts;
+    std::vector<std::string> declared_unit_names;
+
+    // The snapshot's environment was worked out without the other units, so it is only restored if no other unit
+    // declares anything in its packages
+    std::unordered_set<size_t> snapshot_indices(snapshot_sources.begin(), snapshot_sources.end());
+    if ( snapshot_environment ) {
+        std::unordered_set<std::string> snapshot_packages;
+        for ( auto i : snapshot_sources ) { snapshot_packages.insert(topLevelPackage(*units[i])); }
+
+        for ( size_t i = 0; i < units.size(); i++ ) {
+            if ( !snapshot_indices.count(i)
+                && (snapshot_packages.count("") || snapshot_packages.count(topLevelPackage(*units[i])))
+            ) {
+                snapshot_environment.reset();
+                break;
+            }
         }
+    }
 
-        // Local variable checking
-        for (auto &ast: asts) {
-            LocalVariableVisitor().visit(ast);
+    if ( snapshot_environment ) {
+        std::vector<AstNodeVariant*> snapshot_asts;
+        for ( auto i : snapshot_sources ) { snapshot_asts.push_back(units[i]); }
+
+        try {
+            timer.timePass("Environment loading", [&]() {
+                readEnvironment(*snapshot_environment, snapshot_asts, default_package);
+            });
+        } catch (const CompilerError &e) {
+            cerr << e.what() << endl;
+            return finishWith(ReturnCode::USAGE_ERROR);
+        }
+    } else {
+        snapshot_indices.clear();
+    }
+    // Without a library, the program's units are all the units, so the snapshot's indices are theirs too
+    for ( size_t i = 0; i < program_asts.size(); i++ ) {
+        if ( !snapshot_indices.count(i) ) {
+            declared_asts.push_back(program_asts[i]);
+            declared_unit_names.push_back(program_unit_names[i]);
         }
+    }
+
+    try {
+        #ifdef GRAPHVIZ
+            GraphVisitor gv(asts); // runs on return/destruct
+        #endif
+
+        analyse(pool, default_package, declared_asts, declared_unit_names, program_asts, program_unit_names);
 
         // Dispatch vector creation
-        for (auto &ast: asts) {
-            DVBuilder().visit(ast);
-        }
-        DVBuilder::assignColours();
-        DVBuilder::assertColoured();
+        timer.timePass("Dispatch vector building", [&]() {
+            // The library's methods were added when it was analysed
+            if ( use_library ) {
+                context.dispatch_vectors.copyGraph(library->context.dispatch_vectors);
+            }
+            for (auto ast: program_asts) {
+                context.dispatch_vectors.visit(*ast);
+            }
+            context.dispatch_vectors.assignColours();
+            context.dispatch_vectors.assertColoured();
+        });
 
         for (auto &ast: asts) {
-            // PrintDVS().visit(ast);
+            // PrintDVS(context.dispatch_vectors).visit(ast);
         }
 
         // Code generation
         if (emit_code) {
-            auto entrypoint_method = getEntryPointMethod();
+            auto entrypoint_method = getEntryPointMethod(default_package);
 
             // Convert to IR
             std::vector<IR> IR_asts;
-            for (auto &ast: asts) {
-                IR_asts.emplace_back(IRBuilderVisitor().visit(ast));
-            }
+            timer.timeUnits("IR building", units, unit_names, [&](AstNodeVariant *ast) {
+                IR_asts.emplace_back(IRBuilderVisitor(context).visit(*ast));
+            });
 
             #ifdef GRAPHVIZ
                 // Graph IR
@@ -246,12 +644,12 @@ int Compiler::run() {
             }
 
              // Canonicalize IR
-            for (auto &ir_ast: IR_asts) {
+            timer.timeUnits("IR canonicalization", IR_asts, unit_names, [&](IR &ir_ast) {
                 IRCanonicalizer().convert(ir_ast);
                 if (!CanonicalChecker().check(ir_ast, true)) {
                     THROW_CompilerError("IR is not canonical after canonicalizing");
                 }
-            }
+            });
 
             #ifndef LIBFUZZER
                 if (run_java_ir) {
@@ -275,18 +673,64 @@ int Compiler::run() {
                 }
             #endif
 
-            if (optimization == OptimizationType::UNOPTIMIZED) {
-                AssemblyGenerator().generateCode(IR_asts, entrypoint_method, "brainless");
-            } else if (optimization == OptimizationType::REGISTER_ALLOCATION) {
-                AssemblyGenerator().generateCode(IR_asts, entrypoint_method, "linear-scan");
-            } else {
-                THROW_CompilerError("Unknown optimization type");
+            std::optional<BuildCache> cache;
+            if (!build_cache_directory.empty()) {
+                cache.emplace(build_cache_directory);
+            }
+
+            {
+                auto codegen_pass = timer.startPass("Code generation");
+                if (emit_c) {
+                    CSourceGenerator(pool, output_directory, annotate_assembly).generateCode(IR_asts, entrypoint_method);
+                } else {
+                    auto generator = AssemblyGenerator(
+                        pool, output_directory, cache ? &*cache : nullptr, annotate_assembly, emit_objects, target
+                    );
+
+                    std::string allocator_choice;
+                    if (optimization == OptimizationType::UNOPTIMIZED) {
+                        allocator_choice = "brainless";
+                    } else if (optimization == OptimizationType::REGISTER_ALLOCATION) {
+                        allocator_choice = "linear-scan";
+                    } else if (optimization == OptimizationType::GRAPH_COLOURING) {
+                        allocator_choice = "graph-colouring";
+                    } else {
+                        THROW_CompilerError("Unknown optimization type");
+                    }
+
+                    // Each unit's tiling and allocation is recorded under the pass
+                    std::vector<double> unit_milliseconds;
+                    generator.generateCode(
+                        IR_asts, entrypoint_method, allocator_choice, timer.isEnabled() ? &unit_milliseconds : nullptr
+                    );
+                    for (size_t i = 0; i < unit_milliseconds.size(); i++) {
+                        codegen_pass.addUnit(unit_names.at(i), unit_milliseconds[i]);
+                    }
+                }
+            }
+
+            if (!executable_file.empty()) {
+                timer.timePass("Linking", [&]() {
+                    if (emit_c) {
+                        Linker(pool, cache ? &*cache : nullptr).linkC(output_directory, executable_file);
+                        return;
+                    }
+
+                    std::string runtime = runtime_file;
+                    if (runtime.empty()) {
+                        runtime = target == Assembly::Target::X86_64 ? "tests/stdlib/runtime64.s" : "tests/stdlib/runtime.s";
+                    }
+                    Linker(pool, cache ? &*cache : nullptr, target).link(output_directory, runtime, executable_file);
+                });
             }
         }
 
     } catch (const CompilerError &e ) {
         cerr << e.what() << "\n";
         return finishWith(ReturnCode::COMPILER_DEVELOPMENT_ERROR);
+    } catch (const LinkError &e ) {
+        cerr << e.what() << "\n";
+        return finishWith(ReturnCode::LINK_ERROR);
     } catch (const std::exception &e) {
         cerr << e.what() << "\n";
         return finishWith(ReturnCode::INVALID_PROGRAM);
@@ -1,7 +1,17 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include "pass-timer.h"
+#include "utillities/thread_pool.h"
+#include "IR-tiling/assembly/target.h"
+#include "variant-ast/astnode.h"
+
+struct PackageDeclarationObject;
+struct AnalysedLibrary;
 
 class Compiler {
 public:
@@ -11,11 +21,13 @@ public:
         WARN_PROGRAM = 43,
         COMPILER_DEVELOPMENT_ERROR = 1,
         USAGE_ERROR = 2,
+        LINK_ERROR = 3,
     };
 
     enum OptimizationType {
         UNOPTIMIZED,
         REGISTER_ALLOCATION,
+        GRAPH_COLOURING,
     };
 private:
     bool trace_parsing = false;
@@ -25,23 +37,83 @@ private:
     bool run_ir = false;
     bool run_java_ir = false;
     OptimizationType optimization = REGISTER_ALLOCATION;
+    bool annotate_assembly = false; // Write an annotated listing, with comments explaining the generated code
+    bool emit_objects = false; // Write ELF object files instead of assembly
+    Assembly::Target target = Assembly::Target::X86; // Machine the assembly is generated for
+    bool emit_c = false; // Write C source, built with gcc, instead of assembly
+    size_t num_threads = util::ThreadPool::defaultThreadCount();
+
+    PassTimer timer;
+    std::string time_passes_json_file; // Write the timing report as JSON here instead of stderr
+    std::string stdlib_snapshot_file; // Load parsed files from this snapshot instead of parsing them
+    const std::string *stdlib_snapshot_contents = nullptr; // The snapshot file's contents, if already in memory
+    AnalysedLibrary *library = nullptr; // Already analysed standard library, used instead of the snapshot if possible
+    std::string write_snapshot_file; // Save the parsed input files as a snapshot here, then stop
+    std::string build_cache_directory; // Reuse the assembly of unchanged compilation units from here
+    std::string output_directory = "output"; // Assembly files are written here
+    std::string executable_file; // Assemble and link the output into this executable
+    std::string runtime_file; // Linked into the executable; the target's runtime in tests/stdlib if not set
 
-    std::list<std::string> strfiles; // Strings inputted as files
+    std::list<std::string> strfiles; // Strings inputted as files; their contents are handed to the compilation by run
     std::list<std::string> infiles; // File input
 
     // Return the label of the entry point method
-    std::string getEntryPointMethod();
+    std::string getEntryPointMethod(PackageDeclarationObject &root_package);
+
+    // Run the analysis passes, from environment building to local variable checking, over asts. Environment
+    // building, type linking and hierarchy checking only run over declared_asts; the others are already declared.
+    void analyse(
+        util::ThreadPool &pool,
+        PackageDeclarationObject &root_package,
+        std::vector<AstNodeVariant*> &declared_asts,
+        const std::vector<std::string> &declared_unit_names,
+        std::vector<AstNodeVariant*> &asts,
+        const std::vector<std::string> &unit_names
+    );
 public:
     Compiler() {};
     void setTraceParsing(bool value) { trace_parsing = value; }
     void setTraceScanning(bool value) { trace_scanning = value; }
     void setOutputRC(bool value) { output_rc = value; }
     void setEmitCode(bool value) { emit_code = value; }
+    // Whether a successful run writes assembly to output/
+    bool emitsCode() { return emit_code && write_snapshot_file.empty(); }
     void setRunIR(bool value) { run_ir = value; }
     void setRunJavaIR(bool value) { run_java_ir = value; }
+    void setAnnotateAssembly(bool value) { annotate_assembly = value; }
+    void setEmitObjects(bool value) { emit_objects = value; }
+    bool emitsObjects() { return emit_objects; }
+    void setTarget(Assembly::Target value) { target = value; }
+    Assembly::Target getTarget() { return target; }
+    void setEmitC(bool value) { emit_c = value; }
+    bool emitsC() { return emit_c; }
+    void setExecutable(std::string filename) { executable_file = filename; }
+    void setRuntime(std::string filename) { runtime_file = filename; }
     void setOptimizationType(OptimizationType optype) {
         optimization = optype;
     }
+    void setThreads(size_t value) { num_threads = value; }
+    void setTimePasses(bool value) { timer.setEnabled(value); }
+    void setTimePassesJson(std::string filename) {
+        timer.setEnabled(true);
+        time_passes_json_file = filename;
+    }
+
+    void setStdlibSnapshot(std::string filename) {
+        stdlib_snapshot_file = filename;
+        stdlib_snapshot_contents = nullptr;
+    }
+    void setStdlibSnapshot(std::string filename, const std::string *contents) {
+        stdlib_snapshot_file = filename;
+        stdlib_snapshot_contents = contents;
+    }
+    std::string getStdlibSnapshot() { return stdlib_snapshot_file; }
+    // Compile against a library analysed by analyseLibrary from the same snapshot
+    void setLibrary(AnalysedLibrary *value) { library = value; }
+    void setWriteSnapshot(std::string filename) { write_snapshot_file = filename; }
+    void setBuildCache(std::string directory) { build_cache_directory = directory; }
+    void setOutputDirectory(std::string directory) { output_directory = directory; }
+    std::string getOutputDirectory() { return output_directory; }
 
     // File names
     void addInFile(std::string filename) { infiles.push_back(filename); }
@@ -49,9 +121,15 @@ public:
     bool inFilesEmpty() { return infiles.empty(); }
 
     // String files
-    void addStringFile(std::string strfile) { strfiles.push_back(strfile); }
+    void addStringFile(std::string strfile) { strfiles.push_back(std::move(strfile)); }
     void setStringFiles(std::list<std::string> files) { strfiles = files; }
 
     int finishWith(ReturnCode code);
+    // Print the report of time and memory used by each pass, if enabled
+    void reportPassTimings();
     int run();
+
+    // Load and analyse the standard library snapshot on its own, for compiles to share;
+    // returns nullptr, after printing why, if it cannot be analysed
+    std::unique_ptr<AnalysedLibrary> analyseLibrary();
 };
@@ -0,0 +1,125 @@
+#include "pass-timer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sys/resource.h>
+#include <unistd.h>
+
+double PassTimer::millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+long PassTimer::peakRSS() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss; // Reported in kilobytes on Linux
+}
+
+long PassTimer::currentRSS() {
+    std::ifstream statm {"/proc/self/statm"};
+    long total_pages = 0, resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) return 0;
+    return resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+PassTimer::Pass::Pass(PassTimer *timer, std::string name) : timer{timer} {
+    if (!timer) return;
+    timing.name = std::move(name);
+    start_rss_kb = currentRSS();
+    start = Clock::now();
+}
+
+PassTimer::Pass::~Pass() {
+    if (!timer) return;
+    timing.milliseconds = millisecondsSince(start);
+    timing.peak_rss_kb = peakRSS();
+    timing.rss_growth_kb = currentRSS() - start_rss_kb;
+    timer->passes.push_back(std::move(timing));
+}
+
+void PassTimer::printTable(std::ostream &out, size_t units_per_pass) {
+    double total_ms = 0;
+    for (auto &pass : passes) total_ms += pass.milliseconds;
+
+    auto old_flags = out.flags();
+    auto old_precision = out.precision();
+    out << std::fixed << std::setprecision(2);
+
+    out << "===== Pass timing report =====\n";
+    out << std::left << std::setw(36) << "Pass"
+        << std::right << std::setw(12) << "Time (ms)"
+        << std::setw(8) << "%"
+        << std::setw(14) << "Peak RSS (MB)"
+        << std::setw(14) << "RSS +/- (MB)" << "\n";
+
+    for (auto &pass : passes) {
+        double percent = total_ms > 0 ? 100.0 * pass.milliseconds / total_ms : 0;
+        out << std::left << std::setw(36) << pass.name
+            << std::right << std::setw(12) << pass.milliseconds
+            << std::setw(8) << percent
+            << std::setw(14) << pass.peak_rss_kb / 1024.0
+            << std::setw(14) << pass.rss_growth_kb / 1024.0 << "\n";
+
+        // Show the compilation units that took the longest in this pass
+        std::vector<UnitTiming> slowest = pass.units;
+        std::sort(slowest.begin(), slowest.end(), [](const UnitTiming &a, const UnitTiming &b) {
+            return a.milliseconds > b.milliseconds;
+        });
+        if (slowest.size() > units_per_pass) slowest.resize(units_per_pass);
+
+        for (auto &unit : slowest) {
+            // Keep the end of long paths, which names the file
+            std::string name = unit.unit;
+            if (name.size() > 32) name = "..." + name.substr(name.size() - 29);
+
+            out << "    " << std::left << std::setw(32) << name
+                << std::right << std::setw(12) << unit.milliseconds << "\n";
+        }
+    }
+
+    out << std::left << std::setw(36) << "Total"
+        << std::right << std::setw(12) << total_ms
+        << std::setw(8) << 100.0
+        << std::setw(14) << peakRSS() / 1024.0 << "\n";
+
+    out.flags(old_flags);
+    out.precision(old_precision);
+}
+
+static std::string escapeJson(const std::string &text) {
+    std::string escaped;
+    for (char c : text) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default: escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void PassTimer::writeJson(std::ostream &out) {
+    out << "{\n  \"peak_rss_kb\": " << peakRSS() << ",\n  \"passes\": [";
+
+    for (size_t i = 0; i < passes.size(); i++) {
+        auto &pass = passes[i];
+        out << (i ? "," : "") << "\n    {"
+            << "\"name\": \"" << escapeJson(pass.name) << "\", "
+            << "\"ms\": " << pass.milliseconds << ", "
+            << "\"peak_rss_kb\": " << pass.peak_rss_kb << ", "
+            << "\"rss_growth_kb\": " << pass.rss_growth_kb << ", "
+            << "\"units\": [";
+
+        for (size_t j = 0; j < pass.units.size(); j++) {
+            auto &unit = pass.units[j];
+            out << (j ? ", " : "")
+                << "{\"unit\": \"" << escapeJson(unit.unit) << "\", \"ms\": " << unit.milliseconds << "}";
+        }
+        out << "]}";
+    }
+
+    out << "\n  ]\n}\n";
+}
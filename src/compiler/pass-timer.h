@@ -0,0 +1,147 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "utillities/thread_pool.h"
+
+// Records the wall-clock time and memory usage of each pass in the compiler pipeline.
+//
+// Passes that run once per compilation unit also record the time spent on each unit.
+// When disabled, passes are run without any measurement.
+class PassTimer {
+  public:
+    struct UnitTiming {
+        std::string unit;
+        double milliseconds;
+    };
+
+    struct PassTiming {
+        std::string name;
+        double milliseconds = 0;
+        long peak_rss_kb = 0;       // Peak resident set size of the process when the pass finished
+        long rss_growth_kb = 0;     // Change in resident set size over the pass
+        std::vector<UnitTiming> units;
+    };
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    bool enabled = false;
+    std::vector<PassTiming> passes;
+
+    static double millisecondsSince(Clock::time_point start);
+
+  public:
+    // Peak resident set size of the process, in kilobytes
+    static long peakRSS();
+    // Current resident set size of the process, in kilobytes
+    static long currentRSS();
+
+    // A pass being timed; the pass is recorded when this goes out of scope, even if the pass threw
+    class Pass {
+        PassTimer *timer;
+        PassTiming timing;
+        Clock::time_point start;
+        long start_rss_kb;
+
+      public:
+        Pass(PassTimer *timer, std::string name);
+        Pass(Pass&&) = delete;
+        ~Pass();
+
+        // Run function for a single compilation unit of the pass, recording the time taken
+        template <typename Function>
+        void timeUnit(const std::string &unit, Function &&function) {
+            if (!timer) { function(); return; }
+
+            auto unit_start = Clock::now();
+            try {
+                function();
+            } catch (...) {
+                timing.units.push_back({unit, millisecondsSince(unit_start)});
+                throw;
+            }
+            timing.units.push_back({unit, millisecondsSince(unit_start)});
+        }
+
+        // Record a compilation unit timed elsewhere, e.g. one whose work was spread across a pool
+        void addUnit(const std::string &unit, double milliseconds) {
+            if (timer) timing.units.push_back({unit, milliseconds});
+        }
+
+        // Make room for count compilation units to be timed with timeUnitAt
+        void reserveUnits(size_t count) {
+            if (timer) timing.units.resize(count);
+        }
+
+        // Like timeUnit, but records the unit in slot index; units in different slots may be
+        // timed from different threads at once
+        template <typename Function>
+        void timeUnitAt(size_t index, const std::string &unit, Function &&function) {
+            if (!timer) { function(); return; }
+
+            auto unit_start = Clock::now();
+            try {
+                function();
+            } catch (...) {
+                timing.units.at(index) = {unit, millisecondsSince(unit_start)};
+                throw;
+            }
+            timing.units.at(index) = {unit, millisecondsSince(unit_start)};
+        }
+    };
+
+    void setEnabled(bool value) { enabled = value; }
+    bool isEnabled() { return enabled; }
+
+    // Begin timing a pass
+    Pass startPass(const std::string &name) { return Pass(enabled ? this : nullptr, name); }
+
+    // Time a pass that runs once over the whole program
+    template <typename Function>
+    void timePass(const std::string &name, Function &&function) {
+        Pass pass = startPass(name);
+        function();
+    }
+
+    // Time a pass that runs once for each compilation unit, in order
+    template <typename Unit, typename Function>
+    void timeUnits(
+        const std::string &name,
+        std::vector<Unit> &units,
+        const std::vector<std::string> &unit_names,
+        Function &&function
+    ) {
+        Pass pass = startPass(name);
+        for (size_t i = 0; i < units.size(); i++) {
+            pass.timeUnit(unit_names.at(i), [&]() { function(units[i]); });
+        }
+    }
+
+    // Time a pass that runs once for each compilation unit, with the units spread across a pool
+    template <typename Unit, typename Function>
+    void timeUnits(
+        const std::string &name,
+        util::ThreadPool &pool,
+        std::vector<Unit> &units,
+        const std::vector<std::string> &unit_names,
+        Function &&function
+    ) {
+        Pass pass = startPass(name);
+        pass.reserveUnits(units.size());
+        pool.parallelFor(units.size(), [&](size_t i) {
+            pass.timeUnitAt(i, unit_names.at(i), [&]() { function(units[i]); });
+        });
+    }
+
+    const std::vector<PassTiming>& getPasses() { return passes; }
+
+    // Human readable report, with the slowest compilation units of each pass
+    void printTable(std::ostream &out, size_t units_per_pass = 5);
+
+    // Machine readable report, with every compilation unit of each pass
+    void writeJson(std::ostream &out);
+};
@@ -11,7 +11,7 @@ void EnvironmentBuilder::operator()(CompilationUnit &node) {
     if (node.package_declaration) {
         // Not in default package, iterate over package subnames to get to the package for this compilation unit
         for (auto& identifier : node.package_declaration->identifiers) {
-            std::string package_subname = identifier.name;
+            util::Symbol package_subname = identifier.name;
 
             if (!current_package->is_default_package) {
                 // Enclosing package is not the default package; classes must not conflict with package
@@ -39,7 +39,7 @@ void EnvironmentBuilder::operator()(CompilationUnit &node) {
 }
 
 void EnvironmentBuilder::operator()(ClassDeclaration &node) {
-    std::string class_name = node.class_name->name;
+    util::Symbol class_name = node.class_name->name;
 
     // Check for any conflicts in package
     if (!current_package->is_default_package) {
@@ -56,9 +56,10 @@ void EnvironmentBuilder::operator()(ClassDeclaration &node) {
     auto class_env = current_package->classes->addSymbol<ClassDeclarationObject>(class_name);
     class_env->package_contained_in = current_package;
     if ( !current_package->full_qualified_name.empty() ) {
-        class_env->full_qualified_name = current_package->full_qualified_name + ".";
+        class_env->full_qualified_name = current_package->full_qualified_name + "." + class_env->identifier;
+    } else {
+        class_env->full_qualified_name = class_env->identifier;
     }
-    class_env->full_qualified_name += class_env->identifier;
     this->current_type = class_env;
 
     linkDeclaration(node, *class_env);
@@ -66,7 +67,7 @@ void EnvironmentBuilder::operator()(ClassDeclaration &node) {
 }
 
 void EnvironmentBuilder::operator()(InterfaceDeclaration &node) {
-    std::string interface_name = node.interface_name->name;
+    util::Symbol interface_name = node.interface_name->name;
 
     // Check for any conflicts in package
     if (!current_package->is_default_package) {
@@ -85,9 +86,10 @@ void EnvironmentBuilder::operator()(InterfaceDeclaration &node) {
     auto int_env = current_package->interfaces->addSymbol<InterfaceDeclarationObject>(interface_name);
     int_env->package_contained_in = current_package;
     if ( !current_package->full_qualified_name.empty() ) {
-        int_env->full_qualified_name = current_package->full_qualified_name + ".";
+        int_env->full_qualified_name = current_package->full_qualified_name + "." + int_env->identifier;
+    } else {
+        int_env->full_qualified_name = int_env->identifier;
     }
-    int_env->full_qualified_name += int_env->identifier;
     this->current_type = int_env;
     
     linkDeclaration(node, *int_env);
@@ -95,7 +97,7 @@ void EnvironmentBuilder::operator()(InterfaceDeclaration &node) {
 }
 
 void EnvironmentBuilder::operator()(FieldDeclaration &node) {
-    std::string field_name = node.variable_declarator->variable_name->name;
+    util::Symbol field_name = node.variable_declarator->variable_name->name;
     
     // Field declarations only appear in classes
     if (auto current_class_ptr = std::get_if<ClassDeclarationObject*>(&current_type)) {
@@ -120,7 +122,7 @@ void EnvironmentBuilder::operator()(FieldDeclaration &node) {
 }
 
 void EnvironmentBuilder::operator()(MethodDeclaration &node) {
-    std::string method_name = node.function_name->name;
+    util::Symbol method_name = node.function_name->name;
 
     // Skip looking for method name conflicts for now, as must be checked in later compiler stage
     // due to overloading meaning we need to check parameter types.
@@ -155,7 +157,7 @@ void EnvironmentBuilder::operator()(ForStatement &node) {
 }
 
 void EnvironmentBuilder::operator()(FormalParameter &node) {
-    std::string parameter_name = node.parameter_name->name;
+    util::Symbol parameter_name = node.parameter_name->name;
 
     // Local variables and parameters must not conflict with each other
     if (current_method->parameters->lookupSymbol(parameter_name) || 
@@ -173,7 +175,7 @@ void EnvironmentBuilder::operator()(FormalParameter &node) {
 }
 
 void EnvironmentBuilder::operator()(LocalVariableDeclaration &node) {
-    std::string local_variable_name = node.variable_declarator->variable_name->name;
+    util::Symbol local_variable_name = node.variable_declarator->variable_name->name;
 
     // Local variables and parameters must not conflict with each other
     if (current_method->parameters->lookupSymbol(local_variable_name) || 
@@ -2,21 +2,23 @@
 #include <unordered_map>
 #include <vector>
 #include <type_traits>
+#include <algorithm>
 #include "symboltableentry.h"
 #include "symboltable.h"
 #include "variant-ast/names.h"
 
-std::list<SymbolTableEntry>* SymbolTable::lookupSymbol(const std::string& name) {
-    auto& matches = hashmap[name];
+std::list<SymbolTableEntry>* SymbolTable::lookupSymbol(util::Symbol name) {
+    // Lookups must not insert, as tables are read from several threads at once
+    auto matches = hashmap.find(name);
 
-    if (matches.size() == 0) {
+    if (matches == hashmap.end() || matches->second.size() == 0) {
         return nullptr;
     } else {
-        return &matches;
+        return &matches->second;
     }
 }
 
-SymbolTableEntry* SymbolTable::lookupUniqueSymbol(const std::string& name) {
+SymbolTableEntry* SymbolTable::lookupUniqueSymbol(util::Symbol name) {
     auto matches = lookupSymbol(name);
 
     if (matches) {
@@ -26,13 +28,25 @@ SymbolTableEntry* SymbolTable::lookupUniqueSymbol(const std::string& name) {
     }
 }
 
-int SymbolTable::getInsertPosition(const std::string &name) {
-    auto &matches = hashmap[name];
+int SymbolTable::getInsertPosition(util::Symbol name) {
+    auto position = insert_position.find(name);
 
-    if(matches.size() == 0) {
+    if(position == insert_position.end()) {
         return -1;
     } else {
-        return insert_position[name];
+        return position->second;
     }
 }
 
+
+void SymbolTable::removeSymbolsFrom(int position) {
+    for (auto it = insert_position.begin(); it != insert_position.end();) {
+        if (it->second >= position) {
+            hashmap.erase(it->first);
+            it = insert_position.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    current_insert_position = std::min(current_insert_position, position);
+}
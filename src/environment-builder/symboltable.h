@@ -8,9 +8,9 @@
 #include "variant-ast/names.h"
 
 class SymbolTable {
-    std::unordered_map<std::string, std::list<SymbolTableEntry>> hashmap;
+    std::unordered_map<util::Symbol, std::list<SymbolTableEntry>> hashmap;
 
-    std::unordered_map<std::string, int> insert_position;
+    std::unordered_map<util::Symbol, int> insert_position;
     int current_insert_position = 0;
     
     // Compile time asserts that T is a member of SymbolTableEntry variant
@@ -24,23 +24,26 @@ class SymbolTable {
 
     // Lookup a symbol in the environment and return pointer to list of all matches if found
     // Return nullptr if no symbol found
-    std::list<SymbolTableEntry>* lookupSymbol(const std::string& name);
+    std::list<SymbolTableEntry>* lookupSymbol(util::Symbol name);
 
     // Lookup a symbol in the environment and return pointer to just one match if found
     // If more than one match, the most recent match is returned
     // Return nullptr if no symbol found
-    SymbolTableEntry* lookupUniqueSymbol(const std::string& name);
+    SymbolTableEntry* lookupUniqueSymbol(util::Symbol name);
 
     // Get the insert order of a specific symbol table entry
-    int getInsertPosition(const std::string &name);
-    int getSize() { return hashmap.size(); };
+    int getInsertPosition(util::Symbol name);
+    int getSize() { return insert_position.size(); };
+
+    // Remove every symbol first inserted at or after position, along with all its entries
+    void removeSymbolsFrom(int position);
 
     // Add new SymbolTableEntry corresponding to name
     // Returns pointer to SymbolTableEntry that was added
     //
     // T must be a member of SymbolTableEntry variant
     template <typename T>
-    T* addSymbol(const std::string& name) {
+    T* addSymbol(util::Symbol name) {
         assertTypeIsSymbolTableEntry<T>();
 
         auto& matches = hashmap[name];
@@ -59,7 +62,7 @@ class SymbolTable {
 
     // Call lookupUniqueSymbol<SymbolTableEntry*> and return a subtype
     template <typename T>
-    T* lookupUniqueSymbol(const std::string& name) {
+    T* lookupUniqueSymbol(util::Symbol name) {
         assertTypeIsSymbolTableEntry<T>();
         SymbolTableEntry* result = lookupUniqueSymbol(name);
         if (result) {
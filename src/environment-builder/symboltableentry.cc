@@ -9,7 +9,7 @@ std::unique_ptr<SymbolTable> init_table() {
     return std::make_unique<SymbolTable>();
 }
 
-std::optional<TypeDeclaration> PackageDeclarationObject::tryFindTypeInPackage(std::string &identifier) {
+std::optional<TypeDeclaration> PackageDeclarationObject::tryFindTypeInPackage(util::Symbol identifier) {
     auto possible_classes = this->classes->lookupSymbol(identifier);
     auto possible_interfaces = this->interfaces->lookupSymbol(identifier);
 
@@ -40,7 +40,7 @@ std::optional<PackageDeclarationObject*> PackageDeclarationObject::tryFindPackag
     return temp_package;
 }
 
-PackageDeclarationObject::PackageDeclarationObject(const std::string &identifier) : 
+PackageDeclarationObject::PackageDeclarationObject(util::Symbol identifier) : 
     identifier{identifier},
     is_default_package{false},
     sub_packages{init_table()},
@@ -71,7 +71,7 @@ ClassDeclarationObject* PackageDeclarationObject::findClassDeclaration(std::vect
     if ( identifiers.size() == 0 ) { return nullptr; }
     auto current = this;
     
-    std::string class_name = identifiers.back().name;
+    util::Symbol class_name = identifiers.back().name;
 
     auto prefix = identifiers; // copy
     prefix.pop_back();
@@ -91,7 +91,7 @@ InterfaceDeclarationObject* PackageDeclarationObject::findInterfaceDeclaration(s
     if ( identifiers.size() == 0 ) { return nullptr; }
     auto current = this;
     
-    std::string interface_name = identifiers.back().name;
+    util::Symbol interface_name = identifiers.back().name;
 
     auto prefix = identifiers; // copy
     prefix.pop_back();
@@ -131,22 +131,22 @@ InterfaceDeclarationObject* PackageDeclarationObject::findInterfaceDeclaration(s
 
 TypeDeclarationObject::TypeDeclarationObject() : methods{init_table()} {}
 
-ClassDeclarationObject::ClassDeclarationObject(const std::string &identifier) :
+ClassDeclarationObject::ClassDeclarationObject(util::Symbol identifier) :
     TypeDeclarationObject(), identifier{identifier}, fields{init_table()} {}
 
-InterfaceDeclarationObject::InterfaceDeclarationObject(const std::string &identifier) :
+InterfaceDeclarationObject::InterfaceDeclarationObject(util::Symbol identifier) :
     TypeDeclarationObject(), identifier{identifier} {}
 
-FieldDeclarationObject::FieldDeclarationObject(const std::string &identifier) :
+FieldDeclarationObject::FieldDeclarationObject(util::Symbol identifier) :
     identifier{identifier} {}
 
-MethodDeclarationObject::MethodDeclarationObject(const std::string &identifier) :
+MethodDeclarationObject::MethodDeclarationObject(util::Symbol identifier) :
     identifier{identifier}, parameters{init_table()} {}
 
-FormalParameterDeclarationObject::FormalParameterDeclarationObject(const std::string &identifier) :
+FormalParameterDeclarationObject::FormalParameterDeclarationObject(util::Symbol identifier) :
     identifier{identifier} {}
 
-LocalVariableDeclarationObject::LocalVariableDeclarationObject(const std::string &identifier) :
+LocalVariableDeclarationObject::LocalVariableDeclarationObject(util::Symbol identifier) :
     identifier{identifier} {}
 
 // Helpers
@@ -225,7 +225,8 @@ bool ClassDeclarationObject::isSubType(TypeDeclaration type_decl) {
 bool ClassDeclarationObject::isSubClassOf(ClassDeclarationObject *other) {
     if ( other == nullptr ) { return false; }
     if ( this == other ) { return true; }
-    if ( other == Util::root_package->getJavaLangObject() ) { return true; }
+    // Fully qualified names are unique within a program
+    if ( other->full_qualified_name == "java.lang.Object" ) { return true; }
 
     if ( this->extended ) {
         return ( this->extended->isSubClassOf(other) );
@@ -10,6 +10,7 @@
 #include "scope.h"
 #include "type-decl/linkedtype.h"
 #include "type-decl/type_declaration.h"
+#include "utillities/symbol.h"
 #include <iostream>
 #include <list>
 
@@ -28,18 +29,18 @@ using SymbolTableEntry = std::variant<
 >;
 
 struct PackageDeclarationObject {
-    std::string identifier;
-    std::string full_qualified_name = "";
+    util::Symbol identifier;
+    util::Symbol full_qualified_name;
     bool is_default_package;
 
     std::unique_ptr<SymbolTable> sub_packages;
     std::unique_ptr<SymbolTable> classes;
     std::unique_ptr<SymbolTable> interfaces;
 
-    std::optional<TypeDeclaration> tryFindTypeInPackage(std::string &identifier);
+    std::optional<TypeDeclaration> tryFindTypeInPackage(util::Symbol identifier);
     std::optional<PackageDeclarationObject*> tryFindPackageInPackage(QualifiedIdentifier &qualified_identifier);
 
-    PackageDeclarationObject(const std::string &identifier);
+    PackageDeclarationObject(util::Symbol identifier);
     PackageDeclarationObject();
 
     // Helpers
@@ -57,7 +58,7 @@ struct PackageDeclarationObject {
 
 // Common fields for class and interface
 struct TypeDeclarationObject {
-    std::string full_qualified_name = "";
+    util::Symbol full_qualified_name;
 
     std::unordered_map<std::string, MethodDeclarationObject*> all_methods; // declared and inherited methods
     std::unordered_map<std::string, std::list<MethodDeclarationObject*>> overloaded_methods; // declared and inherited methods
@@ -74,7 +75,7 @@ struct TypeDeclarationObject {
 };
 
 struct ClassDeclarationObject : public TypeDeclarationObject {
-    std::string identifier;
+    util::Symbol identifier;
     class ClassDeclaration* ast_reference = nullptr;
 
     std::unique_ptr<SymbolTable> fields; // SymbolTable mapping to FieldDeclarationObjects
@@ -99,11 +100,11 @@ struct ClassDeclarationObject : public TypeDeclarationObject {
     bool isSuperClassOf(ClassDeclarationObject *other);
     bool isRelativeTo(ClassDeclarationObject *other);
 
-    ClassDeclarationObject(const std::string &identifier);
+    ClassDeclarationObject(util::Symbol identifier);
 };
 
 struct InterfaceDeclarationObject : public TypeDeclarationObject {
-    std::string identifier;
+    util::Symbol identifier;
     class InterfaceDeclaration* ast_reference = nullptr;
 
     // Fields resolved at type linking stage
@@ -112,12 +113,12 @@ struct InterfaceDeclarationObject : public TypeDeclarationObject {
     // Determine if this is a subtype of another class/interface
     bool isSubType(TypeDeclaration);
 
-    InterfaceDeclarationObject(const std::string &identifier);
+    InterfaceDeclarationObject(util::Symbol identifier);
 };
 
 struct FieldDeclarationObject {
-    std::string identifier;
-    std::string full_qualified_name = "";
+    util::Symbol identifier;
+    util::Symbol full_qualified_name;
     class FieldDeclaration* ast_reference = nullptr;
 
     ClassDeclarationObject* containing_class;
@@ -125,12 +126,12 @@ struct FieldDeclarationObject {
     // Fields resolved at type linking stage
     LinkedType type;
 
-    FieldDeclarationObject(const std::string &identifier);
+    FieldDeclarationObject(util::Symbol identifier);
 };
 
 struct MethodDeclarationObject {
-    std::string identifier;
-    std::string full_qualified_name = "";
+    util::Symbol identifier;
+    util::Symbol full_qualified_name;
     class MethodDeclaration* ast_reference = nullptr;
 
     std::unique_ptr<SymbolTable> parameters; // SymbolTable mapping to FormalParameterDeclarationObject
@@ -146,25 +147,25 @@ struct MethodDeclarationObject {
 
     TypeDeclarationObject* containing_type; // Back-link to the type that contains this method
 
-    MethodDeclarationObject(const std::string &identifier);
+    MethodDeclarationObject(util::Symbol identifier);
 };
 
 struct FormalParameterDeclarationObject {
-    std::string identifier;
+    util::Symbol identifier;
     class FormalParameter* ast_reference = nullptr;
 
     // Fields resolved at type linking stage
     LinkedType type;
 
-    FormalParameterDeclarationObject(const std::string &identifier);
+    FormalParameterDeclarationObject(util::Symbol identifier);
 };
 
 struct LocalVariableDeclarationObject {
-    std::string identifier;
+    util::Symbol identifier;
     class LocalVariableDeclaration* ast_reference = nullptr;
 
     // Fields resolved at type linking stage
     LinkedType type;
 
-    LocalVariableDeclarationObject(const std::string &identifier);
+    LocalVariableDeclarationObject(util::Symbol identifier);
 };
@@ -19,6 +19,14 @@ public:
         : runtime_error(make_message("Compiler error", message, file, line)) {}
 };
 
+// The generated code could not be assembled or linked, e.g. because the assembler or linker is missing
+#define THROW_LinkError(message) throw LinkError(message, __FILE__, __LINE__)
+class LinkError : public std::runtime_error {
+public:
+    LinkError(std::string message, std::string file, int line)
+        : runtime_error(make_message("Link error", message, file, line)) {}
+};
+
 /************************************************
  *  ERRORS within the simulator
  ************************************************/
@@ -3,6 +3,7 @@
 
 // CompUnitIR
 void IRGraphVisitor::operator()(CompUnitIR &node) {
+    comp_unit = &node;
     addNode(&node, node.label());
     for ( auto &kv_pair : node.getFunctions() ) {
         addChild(&node, kv_pair.second);
@@ -54,7 +55,7 @@ void IRGraphVisitor::operator()(NameIR &node) {
     this->visit_children(node);
 }
 void IRGraphVisitor::operator()(TempIR &node) {
-    addNode(&node, node.label());
+    addNode(&node, comp_unit ? "TEMP(" + comp_unit->temps.name(node.getId()) + ")" : node.label());
     this->visit_children(node);
 }
 
@@ -70,12 +71,11 @@ void IRGraphVisitor::operator()(ExpIR &node) {
     this->visit_children(node);
 }
 void IRGraphVisitor::operator()(JumpIR &node) {
-    addNode(&node, node.label());
-    addChild(&node, getInnerAddr(node.getTarget()));
+    addNode(&node, comp_unit ? "JUMP " + comp_unit->labels.name(node.getTarget()) : node.label());
     this->visit_children(node);
 }
 void IRGraphVisitor::operator()(LabelIR &node) {
-    addNode(&node, node.label());
+    addNode(&node, comp_unit ? "LABEL(" + comp_unit->labels.name(node.getId()) + ")" : node.label());
     this->visit_children(node);
 }
 void IRGraphVisitor::operator()(MoveIR &node) {
@@ -7,6 +7,7 @@
 
 class IRGraphVisitor : public IRSkipVisitor {
     std::ostringstream buffer;
+    CompUnitIR *comp_unit = nullptr; // Names the temporaries and labels, once visited
 
     void* getInnerAddr(IR &node) {
         return std::visit(util::overload {
@@ -0,0 +1,138 @@
+#include "linker.h"
+
+#include <algorithm>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+
+#include "exceptions/exceptions.h"
+#include "utillities/process.h"
+
+namespace {
+
+// Describe how a tool run by the linker failed
+std::string failure(const std::string &tool, int status) {
+    if ( status == -1 ) {
+        return tool + " could not be run";
+    }
+    return tool + " exited with " + std::to_string(status);
+}
+
+std::optional<std::string> readFile(const std::filesystem::path &path) {
+    std::ifstream input {path, std::ios::binary};
+    if ( !input ) {
+        return std::nullopt;
+    }
+    std::ostringstream contents;
+    contents << input.rdbuf();
+    return contents.str();
+}
+
+// Write the file under a private name and rename it into place, so a failed write never leaves a partial file behind
+bool writeFile(const std::filesystem::path &path, const std::string &contents) {
+    auto temporary_path = path;
+    temporary_path += "." + std::to_string(getpid()) + ".tmp";
+    std::error_code error;
+    std::ofstream output {temporary_path, std::ios::binary};
+    output.write(contents.data(), contents.size());
+    output.close(); // Closing flushes, which can fail too
+    if ( !output ) {
+        std::filesystem::remove(temporary_path, error);
+        return false;
+    }
+    std::filesystem::rename(temporary_path, path, error);
+    if ( error ) {
+        std::filesystem::remove(temporary_path, error);
+        return false;
+    }
+    return true;
+}
+
+// Files in the directory with the extension, sorted so the link order is the same in every compile
+std::vector<std::filesystem::path> filesWithExtension(const std::filesystem::path &directory, const std::string &extension) {
+    std::vector<std::filesystem::path> files;
+    for ( auto &entry : std::filesystem::directory_iterator(directory) ) {
+        if ( entry.is_regular_file() && entry.path().extension() == extension ) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+} // namespace
+
+void Linker::buildObject(
+    const std::filesystem::path &source_file, const std::filesystem::path &object_file, const std::vector<std::string> &tool
+) const {
+    auto source = readFile(source_file);
+    if ( !source ) {
+        THROW_LinkError("Cannot read " + source_file.string());
+    }
+
+    BuildCache::Fingerprint key;
+    if ( cache ) {
+        std::string command;
+        for ( auto &argument : tool ) {
+            command += argument + " ";
+        }
+        key = BuildCache::fingerprint(*source, command);
+        // An object that cannot be written from the cache is built as if it were not cached
+        auto object = cache->load(key);
+        if ( object && writeFile(object_file, *object) ) {
+            return;
+        }
+    }
+
+    std::vector<std::string> arguments = tool;
+    arguments.insert(arguments.end(), {source_file.string(), "-o", object_file.string()});
+    int status = util::runProcess(arguments);
+    if ( status != 0 ) {
+        THROW_LinkError("Building " + source_file.string() + " failed: " + failure(tool.front(), status));
+    }
+
+    if ( cache ) {
+        if ( auto object = readFile(object_file) ) {
+            cache->store(key, *object);
+        }
+    }
+}
+
+void Linker::buildAndLink(
+    const std::filesystem::path &output_directory,
+    const std::vector<std::filesystem::path> &source_files,
+    const std::vector<std::string> &tool,
+    const std::vector<std::string> &linker,
+    const std::string &executable
+) const {
+    pool.parallelFor(source_files.size(), [&](size_t i) {
+        auto object_file = output_directory / source_files[i].filename().replace_extension(".o");
+        buildObject(source_files[i], object_file, tool);
+    });
+
+    std::vector<std::string> arguments = linker;
+    arguments.insert(arguments.end(), {"-o", executable});
+    for ( auto &object_file : filesWithExtension(output_directory, ".o") ) {
+        arguments.push_back(object_file.string());
+    }
+    int status = util::runProcess(arguments);
+    if ( status != 0 ) {
+        THROW_LinkError("Linking " + executable + " failed: " + failure(linker.front(), status));
+    }
+}
+
+void Linker::link(const std::filesystem::path &output_directory, const std::string &runtime_file, const std::string &executable) const {
+    // Code generation may have written object files already, which only need linking
+    auto assembly_files = filesWithExtension(output_directory, ".s");
+    assembly_files.push_back(runtime_file);
+
+    std::string format = target == Assembly::Target::X86_64 ? "elf64" : "elf";
+    std::string emulation = target == Assembly::Target::X86_64 ? "-melf_x86_64" : "-melf_i386";
+    buildAndLink(output_directory, assembly_files, {"nasm", "-O1", "-f", format, "-g", "-F", "dwarf"}, {"ld", emulation}, executable);
+}
+
+void Linker::linkC(const std::filesystem::path &output_directory, const std::string &executable) const {
+    buildAndLink(output_directory, filesWithExtension(output_directory, ".c"), {"gcc", "-std=c99", "-O2", "-w", "-c"}, {"gcc"}, executable);
+}
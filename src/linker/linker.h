@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "build-cache/build-cache.h"
+#include "IR-tiling/assembly/target.h"
+#include "utillities/thread_pool.h"
+
+// Turns the files written by code generation into an executable, as tests/src/integration/assemble.py would:
+// every assembly file in the output directory, and the runtime, is assembled with nasm, then every object file
+// there is linked with ld, as 32 bit or 64 bit ELF for the target. C source from CSourceGenerator is instead compiled
+// and linked with gcc -O2.
+//
+// Files are assembled (or compiled) in parallel on the thread pool. If a BuildCache is given, the object built from
+// a file is stored under a hash of the file's contents, so unchanged files (the runtime, and units whose assembly was
+// reused) are not built again.
+class Linker {
+    util::ThreadPool &pool;
+    const BuildCache *cache;
+    Assembly::Target target;
+
+    // Build the source file into the object file with the tool's command, or reuse the object cached for its contents
+    void buildObject(
+        const std::filesystem::path &source_file, const std::filesystem::path &object_file, const std::vector<std::string> &tool
+    ) const;
+
+    // Build every source file into an object file in the output directory, then link every object file there
+    void buildAndLink(
+        const std::filesystem::path &output_directory,
+        const std::vector<std::filesystem::path> &source_files,
+        const std::vector<std::string> &tool,
+        const std::vector<std::string> &linker,
+        const std::string &executable
+    ) const;
+
+  public:
+    explicit Linker(util::ThreadPool &pool, const BuildCache *cache = nullptr, Assembly::Target target = Assembly::Target::X86)
+        : pool{pool}, cache{cache}, target{target} {}
+
+    // Assemble the files in output_directory and the runtime, and link them into the executable
+    void link(const std::filesystem::path &output_directory, const std::string &runtime_file, const std::string &executable) const;
+
+    // Compile the C files in output_directory, which include their own runtime, and link them into the executable
+    void linkC(const std::filesystem::path &output_directory, const std::string &executable) const;
+};
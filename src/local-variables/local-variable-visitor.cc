@@ -60,7 +60,7 @@ LinkedType LocalVariableVisitor::getLink(Expression &node) {
                     return LinkedType(PrimitiveType::CHAR);
                 },
                 [&] (std::string& literal_type) -> LinkedType {
-                    NonArrayLinkedType string_type = Util::root_package->findClassDeclaration("java.lang.String");
+                    NonArrayLinkedType string_type = default_package->findClassDeclaration("java.lang.String");
                     return LinkedType(string_type);
                 },
                 [&] (std::nullptr_t literal_type) -> LinkedType {
@@ -85,7 +85,7 @@ void LocalVariableVisitor::operator()(LocalVariableDeclaration &node) {
     } else {
         checkExpressionForIdentifier(*expr, *node.variable_declarator->variable_name);
 
-        auto linked_expr_type = TypeChecker::getLink(*expr);
+        auto linked_expr_type = TypeChecker::getLink(*expr, default_package);
 
         if (node.type->link.isPrimitive() && linked_expr_type.isPrimitive()) {
             auto node_type_primitive = node.type->link.getIfIsPrimitive();
@@ -3,6 +3,7 @@
 #include "environment-builder/symboltableentry.h"
 
 class LocalVariableVisitor : public DefaultSkipVisitor<void> {
+    PackageDeclarationObject* default_package = nullptr;
     MethodDeclarationObject* current_method;
     void checkExpressionForIdentifier(Expression &expr, Identifier &identifier);
     LinkedType getLink(Expression &node);
@@ -11,6 +12,8 @@ public:
     void operator()(MethodDeclaration &node) override;
     void operator()(LocalVariableDeclaration &node) override;
 
+    LocalVariableVisitor(PackageDeclarationObject& default_package) : default_package{&default_package} {}
+
     void visit(AstNodeVariant &node) override {
         std::visit(*this, node);
     }
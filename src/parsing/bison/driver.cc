@@ -10,17 +10,24 @@
             static_cast<yy::parser::symbol_kind_type>((symbol))))
 
 Driver::Driver()
-: trace_parsing (false), trace_scanning (false) {}
+: trace_parsing (false), trace_scanning (false) {
+    scan_init();
+}
+
+Driver::~Driver() {
+    scan_destroy();
+}
 
-int Driver::parse(const std::string &f) {
-    file = f;
-    location.initialize(&file);
+int Driver::parse(const SourceBuffer &source) {
+    this->source = &source;
+    location.initialize(&source.name);
 
     scan_begin();
     yy::parser parser(*this, &root);
     parser.set_debug_level(trace_parsing);
     result = parser.parse();
     scan_end();
+    this->source = nullptr;
 
     // Exception on parser failure
     if ( result != 0 ) { throw std::runtime_error("Parser error."); }
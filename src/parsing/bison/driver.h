@@ -2,33 +2,47 @@
 # define DRIVER_HH
 # include <string>
 # include "parser.hh"
+# include "source-manager/source-manager.h"
 # include <memory>
+# include <cstdio>
+# include <iostream>
 
-// Define lexer prototype
+// Define lexer prototype; the scanner is reentrant, so its state is passed in
 # define YY_DECL \
-  yy::parser::symbol_type yylex(Driver& drv)
+  yy::parser::symbol_type yylex(Driver& drv, void* yyscanner)
 YY_DECL;
 
 // Class to drive parsing/u3/a23dhingra/cs444/cs444-compiler/src/parsing/bison and scanning
+// Each Driver owns its own scanner, so separate Drivers can parse on separate threads
 class Driver {
+  // Reentrant scanner state (yyscan_t)
+  void* scanner = nullptr;
+  // Source being scanned, in place
+  const SourceBuffer* source = nullptr;
+
+  void scan_init();
+  void scan_destroy();
 public:
   Driver();
+  ~Driver();
+  Driver(const Driver&) = delete;
+  Driver& operator=(const Driver&) = delete;
 
   // Return code from last parse; 0 if success and non-zero otherwise
   int result;
   // Parse tree from last parse
   // AstNodeVariant *root;
-  std::unique_ptr<CompilationUnit> root;
-  // Run the parser on file F. Return 0 on success
-  int parse(const std::string& f);
-  // The name of the file being parsed
-  std::string file;
-  // String buffer of a file to parse
-  std::list<std::string> strfiles;
+  AstPtr<CompilationUnit> root;
+  // Arena the parse tree is made in, which must outlive it
+  AstArena* arena = nullptr;
+  // Run the parser on the source, which must outlive the parse tree. Return 0 on success
+  int parse(const SourceBuffer& source);
   // Whether to generate parser debug traces
   bool trace_parsing;
   // Whether to generate scanner debug traces
   bool trace_scanning;
+  // Where syntax errors are reported
+  std::ostream* diagnostics = &std::cerr;
 
   // Handling the scanner
   void scan_begin();
@@ -36,5 +50,12 @@ public:
 
   // The token's location used by the scanner
   yy::location location;
+
+  friend yy::parser::symbol_type yylex(Driver& drv);
 };
+
+// Lexer entry point used by the parser
+inline yy::parser::symbol_type yylex(Driver& drv) {
+  return yylex(drv, drv.scanner);
+}
 #endif // ! DRIVER_HH
@@ -119,59 +119,59 @@
 // Comma macro used to avoid issue with # of args in other macros
 
 // Overall tree (in progress)
-%nterm <unique_ptr<CompilationUnit>> CompilationUnit
-    %nterm <unique_ptr<QualifiedIdentifier>> PackageDeclaration
+%nterm <AstPtr<CompilationUnit>> CompilationUnit
+    %nterm <AstPtr<QualifiedIdentifier>> PackageDeclaration
     %nterm <pair<vector<QualifiedIdentifier> COMMA vector<QualifiedIdentifier>>> ImportDeclarations
-        %nterm <pair<unique_ptr<QualifiedIdentifier> COMMA unique_ptr<QualifiedIdentifier>>> ImportDeclaration
-            %nterm <unique_ptr<QualifiedIdentifier>> SingleTypeImportDeclaration
-            %nterm <unique_ptr<QualifiedIdentifier>> TypeImportOnDemandDeclaration
+        %nterm <pair<AstPtr<QualifiedIdentifier> COMMA AstPtr<QualifiedIdentifier>>> ImportDeclaration
+            %nterm <AstPtr<QualifiedIdentifier>> SingleTypeImportDeclaration
+            %nterm <AstPtr<QualifiedIdentifier>> TypeImportOnDemandDeclaration
     %nterm <pair<vector<ClassDeclaration> COMMA vector<InterfaceDeclaration>>> TypeDeclarations
-        %nterm <pair<unique_ptr<ClassDeclaration> COMMA unique_ptr<InterfaceDeclaration>>> TypeDeclaration
+        %nterm <pair<AstPtr<ClassDeclaration> COMMA AstPtr<InterfaceDeclaration>>> TypeDeclaration
             // Class declaration
             // InterfaceDeclaration
 
 // Class declaration (done?)
-%nterm <unique_ptr<ClassDeclaration>> ClassDeclaration
+%nterm <AstPtr<ClassDeclaration>> ClassDeclaration
     // Modifiers
     // Identifier
-    %nterm <unique_ptr<QualifiedIdentifier>> ExtendsOpt
+    %nterm <AstPtr<QualifiedIdentifier>> ExtendsOpt
     %nterm <vector<QualifiedIdentifier>> InterfacesOpt
         %nterm <vector<QualifiedIdentifier>> Interfaces
             %nterm <vector<QualifiedIdentifier>> InterfaceTypeList
     %nterm <pair<vector<FieldDeclaration> COMMA vector<MethodDeclaration>>> ClassBody
         %nterm <pair<vector<FieldDeclaration> COMMA vector<MethodDeclaration>>> ClassBodyDeclarationsOpt
             %nterm <pair<vector<FieldDeclaration> COMMA vector<MethodDeclaration>>> ClassBodyDeclarations
-                %nterm <pair<unique_ptr<FieldDeclaration> COMMA unique_ptr<MethodDeclaration>>> ClassBodyDeclaration
-                    %nterm <pair<unique_ptr<FieldDeclaration> COMMA unique_ptr<MethodDeclaration>>> ClassMemberDeclaration
-                        %nterm <unique_ptr<FieldDeclaration>> FieldDeclaration
+                %nterm <pair<AstPtr<FieldDeclaration> COMMA AstPtr<MethodDeclaration>>> ClassBodyDeclaration
+                    %nterm <pair<AstPtr<FieldDeclaration> COMMA AstPtr<MethodDeclaration>>> ClassMemberDeclaration
+                        %nterm <AstPtr<FieldDeclaration>> FieldDeclaration
                             // Modifiers
                             // Type
                             // VariableDeclarator
-                        %nterm <unique_ptr<MethodDeclaration>> MethodDeclaration
+                        %nterm <AstPtr<MethodDeclaration>> MethodDeclaration
                             // MethodHeader
                             // MethodBody
 
 // Method Header/Body (done)
-%nterm <unique_ptr<MethodDeclaration>> MethodHeader
-    %nterm <pair<unique_ptr<Identifier> COMMA vector<FormalParameter>>> MethodDeclarator
+%nterm <AstPtr<MethodDeclaration>> MethodHeader
+    %nterm <pair<AstPtr<Identifier> COMMA vector<FormalParameter>>> MethodDeclarator
         %nterm <vector<FormalParameter>> FormalParameterListOpt
             %nterm <vector<FormalParameter>> FormalParameterList
-                %nterm <unique_ptr<FormalParameter>> FormalParameter
-%nterm <unique_ptr<Block>> MethodBody
+                %nterm <AstPtr<FormalParameter>> FormalParameter
+%nterm <AstPtr<Block>> MethodBody
     // (Block)
 
 // InterfaceDeclaration (done)
-%nterm <unique_ptr<InterfaceDeclaration>> InterfaceDeclaration
+%nterm <AstPtr<InterfaceDeclaration>> InterfaceDeclaration
     %nterm <vector<Modifier>> InterfaceModifiersOpt
     // Identifier
     %nterm <vector<QualifiedIdentifier>> ExtendsInterfacesOpt
         %nterm <vector<QualifiedIdentifier>> ExtendsInterfaces
-            %nterm <unique_ptr<QualifiedIdentifier>> InterfaceType
+            %nterm <AstPtr<QualifiedIdentifier>> InterfaceType
     %nterm <vector<MethodDeclaration>> InterfaceBody
         %nterm <vector<MethodDeclaration>> InterfaceMemberDeclarationsOpt
             %nterm <vector<MethodDeclaration>> InterfaceMemberDeclarations
-                %nterm <unique_ptr<MethodDeclaration>> InterfaceMemberDeclaration
-                    %nterm <unique_ptr<MethodDeclaration>> AbstractMethodDeclaration
+                %nterm <AstPtr<MethodDeclaration>> InterfaceMemberDeclaration
+                    %nterm <AstPtr<MethodDeclaration>> AbstractMethodDeclaration
                         %nterm <vector<Modifier>> AbstractMethodModifiersOpt
                             %nterm <vector<Modifier>> AbstractMethodModifiers
                                 %nterm <Modifier> AbstractMethodModifier
@@ -179,96 +179,96 @@
 
 
 // QualifiedIdentifier (done)
-%nterm <unique_ptr<QualifiedIdentifier>> QualifiedIdentifier
-    %nterm <unique_ptr<Identifier>> Identifier
+%nterm <AstPtr<QualifiedIdentifier>> QualifiedIdentifier
+    %nterm <AstPtr<Identifier>> Identifier
 
 // Modifiers (done)
 %nterm <vector<Modifier>> Modifiers
     %nterm <Modifier> Modifier
 
 // Type (done)
-%nterm <unique_ptr<Type>> Type
-    %nterm <unique_ptr<Type>> PrimitiveType
+%nterm <AstPtr<Type>> Type
+    %nterm <AstPtr<Type>> PrimitiveType
         %nterm <PrimitiveType> IntegralType
         %nterm <PrimitiveType> BooleanType
-    %nterm <unique_ptr<Type>> ReferenceType
-        %nterm <unique_ptr<QualifiedIdentifier>> ClassOrInterfaceType
+    %nterm <AstPtr<Type>> ReferenceType
+        %nterm <AstPtr<QualifiedIdentifier>> ClassOrInterfaceType
 
 // VariableDeclarator (done)
-%nterm <unique_ptr<VariableDeclarator>> VariableDeclarator
-    %nterm <unique_ptr<Identifier>> VariableDeclaratorId
-    %nterm <unique_ptr<Expression>> VariableInitializer
+%nterm <AstPtr<VariableDeclarator>> VariableDeclarator
+    %nterm <AstPtr<Identifier>> VariableDeclaratorId
+    %nterm <AstPtr<Expression>> VariableInitializer
 
 // Expression (done)
-%nterm <unique_ptr<Expression>> Expression
-    %nterm <unique_ptr<Expression>> AssignmentExpression
-        %nterm <unique_ptr<Expression>> Assignment
-            %nterm <unique_ptr<Expression>> LeftHandSide
-                %nterm <unique_ptr<Expression>> FieldAccess
+%nterm <AstPtr<Expression>> Expression
+    %nterm <AstPtr<Expression>> AssignmentExpression
+        %nterm <AstPtr<Expression>> Assignment
+            %nterm <AstPtr<Expression>> LeftHandSide
+                %nterm <AstPtr<Expression>> FieldAccess
                     // Primary
-                %nterm <unique_ptr<Expression>> ArrayAccess
+                %nterm <AstPtr<Expression>> ArrayAccess
 
     // ConditionalOrExpression (done)
-    %nterm <unique_ptr<Expression>> ConditionalOrExpression
-    %nterm <unique_ptr<Expression>> ConditionalAndExpression
-    %nterm <unique_ptr<Expression>> InclusiveOrExpression
-    %nterm <unique_ptr<Expression>> AndExpression
-    %nterm <unique_ptr<Expression>> EqualityExpression
-    %nterm <unique_ptr<Expression>> RelationalExpression
-    %nterm <unique_ptr<Expression>> AdditiveExpression
-    %nterm <unique_ptr<Expression>> MultiplicativeExpression
-    %nterm <unique_ptr<Expression>> UnaryExpression
-    %nterm <unique_ptr<Expression>> UnaryExpressionNotPlusMinus
-    %nterm <unique_ptr<Expression>> CastExpression
-    %nterm <unique_ptr<Expression>> PrimaryOrExpressionName
+    %nterm <AstPtr<Expression>> ConditionalOrExpression
+    %nterm <AstPtr<Expression>> ConditionalAndExpression
+    %nterm <AstPtr<Expression>> InclusiveOrExpression
+    %nterm <AstPtr<Expression>> AndExpression
+    %nterm <AstPtr<Expression>> EqualityExpression
+    %nterm <AstPtr<Expression>> RelationalExpression
+    %nterm <AstPtr<Expression>> AdditiveExpression
+    %nterm <AstPtr<Expression>> MultiplicativeExpression
+    %nterm <AstPtr<Expression>> UnaryExpression
+    %nterm <AstPtr<Expression>> UnaryExpressionNotPlusMinus
+    %nterm <AstPtr<Expression>> CastExpression
+    %nterm <AstPtr<Expression>> PrimaryOrExpressionName
 
     // Primary (done)
-    %nterm <unique_ptr<Expression>> Primary
-        %nterm <unique_ptr<Expression>> PrimaryNoNewArray
-            %nterm <unique_ptr<Literal>> Literal
-            %nterm <unique_ptr<Expression>> ClassInstanceCreationExpression
+    %nterm <AstPtr<Expression>> Primary
+        %nterm <AstPtr<Expression>> PrimaryNoNewArray
+            %nterm <AstPtr<Literal>> Literal
+            %nterm <AstPtr<Expression>> ClassInstanceCreationExpression
                 // Arguments
-            %nterm <unique_ptr<Expression>> MethodInvocation
-        %nterm <unique_ptr<Expression>> ArrayCreationExpression
+            %nterm <AstPtr<Expression>> MethodInvocation
+        %nterm <AstPtr<Expression>> ArrayCreationExpression
 
 // Statements (done)
-%nterm <unique_ptr<Statement>> Statement
-    %nterm <unique_ptr<Statement>> StatementWithoutTrailingSubstatement
+%nterm <AstPtr<Statement>> Statement
+    %nterm <AstPtr<Statement>> StatementWithoutTrailingSubstatement
         // Block
         %nterm <EmptyStatement> EmptyStatement
-        %nterm <unique_ptr<ExpressionStatement>> ExpressionStatement
-        %nterm <unique_ptr<Statement>> ReturnStatement
-    %nterm <unique_ptr<Statement>> IfThenStatement
+        %nterm <AstPtr<ExpressionStatement>> ExpressionStatement
+        %nterm <AstPtr<Statement>> ReturnStatement
+    %nterm <AstPtr<Statement>> IfThenStatement
         // ParExpr, Statement
-    %nterm <unique_ptr<Statement>> IfThenElseStatement
-        %nterm <unique_ptr<Statement>> IfThenElseStatementNoShortIf
+    %nterm <AstPtr<Statement>> IfThenElseStatement
+        %nterm <AstPtr<Statement>> IfThenElseStatementNoShortIf
         // ParExpr, StatementNoShortIf, Statement
-    %nterm <unique_ptr<Statement>> WhileStatement
-        %nterm <unique_ptr<Statement>> WhileStatementNoShortIf
+    %nterm <AstPtr<Statement>> WhileStatement
+        %nterm <AstPtr<Statement>> WhileStatementNoShortIf
         // ParExpr, Statement
-    %nterm <unique_ptr<Statement>> ForStatement
-        %nterm <unique_ptr<Statement>> ForStatementNoShortIf
-        %nterm <unique_ptr<Statement>> ForInitOpt
-            %nterm <unique_ptr<Statement>> ForInit
+    %nterm <AstPtr<Statement>> ForStatement
+        %nterm <AstPtr<Statement>> ForStatementNoShortIf
+        %nterm <AstPtr<Statement>> ForInitOpt
+            %nterm <AstPtr<Statement>> ForInit
                 // (StatementExpression, LocalVariableDeclaration)
-        %nterm <unique_ptr<Expression>> ExpressionOpt
+        %nterm <AstPtr<Expression>> ExpressionOpt
             // (Expression)
-        %nterm <unique_ptr<Statement>> ForUpdateOpt
+        %nterm <AstPtr<Statement>> ForUpdateOpt
             // (StatementExpression)
         // (Statement)
 
     // Common types for statements (done)
-    %nterm <unique_ptr<Expression>> ParExpression
-    %nterm <unique_ptr<Statement>> StatementNoShortIf
-    %nterm <unique_ptr<ExpressionStatement>> StatementExpression
+    %nterm <AstPtr<Expression>> ParExpression
+    %nterm <AstPtr<Statement>> StatementNoShortIf
+    %nterm <AstPtr<ExpressionStatement>> StatementExpression
 
     // Block (done)
-    %nterm <unique_ptr<Block>> Block
+    %nterm <AstPtr<Block>> Block
         %nterm <vector<Statement>> BlockStatementsOpt
         %nterm <vector<Statement>> BlockStatements
-        %nterm <unique_ptr<Statement>> BlockStatement
-            %nterm <unique_ptr<LocalVariableDeclaration>> LocalVariableDeclarationStatement
-                %nterm <unique_ptr<LocalVariableDeclaration>> LocalVariableDeclaration
+        %nterm <AstPtr<Statement>> BlockStatement
+            %nterm <AstPtr<LocalVariableDeclaration>> LocalVariableDeclarationStatement
+                %nterm <AstPtr<LocalVariableDeclaration>> LocalVariableDeclaration
                     // (Type, VariableDeclarator)
             // Statement
 
@@ -279,7 +279,7 @@
 
 /******************** END NONTERMINALS ********************/
 
-%parse-param {std::unique_ptr<CompilationUnit> *root}
+%parse-param {AstPtr<CompilationUnit> *root}
 
 %{
 #define SET_LOCATION(me, loc) \
@@ -289,20 +289,21 @@
 #define MAKE_STACK_OBJ(me, type, constructor...) \
     me = type(constructor)
 
+// Nodes are made in the arena of the compilation unit being parsed
 #define NEW_OBJ(type, constructor...) \
-    make_unique<type>(constructor)
+    driver.arena->make<type>(constructor)
 
 #define NEW_TYPE(type, isarray) \
     NEW_OBJ(Type, move(NEW_OBJ(NonArrayType, type)), isarray)
 
 #define NEW_VARIANT_OBJ(outer_type, inner_type, inner_constructor...) \
-    make_unique<outer_type>(in_place_type<inner_type>, inner_constructor)
+    driver.arena->make<outer_type>(in_place_type<inner_type>, inner_constructor)
 
 #define MAKE_OBJ(me, type, constructor...) \
-    me = make_unique<type>(constructor)
+    me = NEW_OBJ(type, constructor)
 
 #define MAKE_VARIANT_OBJ(me, outer_type, inner_type, inner_constructor...) \
-    me = make_unique<outer_type>(in_place_type<inner_type>, inner_constructor)
+    me = NEW_VARIANT_OBJ(outer_type, inner_type, inner_constructor)
 
 #define OBJ_TO_VARIANT(outer_type, obj) \
     NEW_OBJ(outer_type, move(obj))
@@ -339,7 +340,7 @@
     (nullptr)
 
 #define EMPTY_OBJ(type) \
-    make_unique<type>(nullptr)
+    NEW_OBJ(type, nullptr)
 
 #define EMPTY_VECTOR(type) \
     (vector<type>())
@@ -375,7 +376,7 @@ Start:
     }
 
 // root = AstNodeVariant**
-// $1 = unique_ptr<CompilationUnit>
+// $1 = AstPtr<CompilationUnit>
 
 CompilationUnit:
     PackageDeclaration ImportDeclarations TypeDeclarations
@@ -1087,5 +1088,5 @@ VariableDeclarator:
 %%
 
 void yy::parser::error (const location_type& l, const std::string& m) {
-  std::cerr << l << ": " << m << '\n';
+  *driver.diagnostics << l << ": " << m << '\n';
 }
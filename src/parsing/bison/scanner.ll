@@ -12,7 +12,7 @@
 // not conform to C89.  See Debian bug 333231
 // <http://bugs.debian.org/cgi-bin/bugreport.cgi?bug=333231>.
 # undef yywrap
-# define yywrap() 1
+# define yywrap(yyscanner) 1
 
 // Pacify warnings in yy_init_buffer (observed with Flex 2.6.4)
 // and GCC 7.3.0.
@@ -21,7 +21,7 @@
 #endif
 %}
 
-%option noyywrap nounput batch noinput stack
+%option noyywrap nounput batch noinput stack reentrant
 /* %option debug */
 
 Whitespace      [ \b\t\f\r]
@@ -112,7 +112,7 @@ null                return yy::parser::make_NULL_TOKEN(nullptr, loc);
 \"      BEGIN(IN_STRING); string_buf.clear();
 <IN_STRING>{
     \"      { BEGIN(INITIAL); return yy::parser::make_STRING_LITERAL(string_buf.str(), loc); }
-    \\      yy_push_state(IN_ESCAPE);
+    \\      yy_push_state(IN_ESCAPE, yyscanner);
     .       string_buf << yytext;
 }
 
@@ -127,21 +127,21 @@ null                return yy::parser::make_NULL_TOKEN(nullptr, loc);
             return yy::parser::make_CHAR_LITERAL(outstr[0], loc);
         }
     }
-    \\      yy_push_state(IN_ESCAPE);
+    \\      yy_push_state(IN_ESCAPE, yyscanner);
     .       string_buf << yytext;
 }
 
 <IN_ESCAPE>{
-    t               { string_buf << "\t"; yy_pop_state(); }
-    b               { string_buf << "\b"; yy_pop_state(); }
-    n               { string_buf << "\n"; yy_pop_state(); }
-    r               { string_buf << "\r"; yy_pop_state(); }
-    f               { string_buf << "\f"; yy_pop_state(); }
-    \\              { string_buf << "\\"; yy_pop_state(); }
-    \"              { string_buf << "\""; yy_pop_state(); }
-    \'              { string_buf << "'" ; yy_pop_state(); }
-    [0-7]{1,2}      { string_buf << (char) std::stoi( yytext, 0, 8 ); yy_pop_state(); }
-    [0-3][0-7]{2}   { string_buf << (char) std::stoi( yytext, 0, 8 ); yy_pop_state(); }
+    t               { string_buf << "\t"; yy_pop_state(yyscanner); }
+    b               { string_buf << "\b"; yy_pop_state(yyscanner); }
+    n               { string_buf << "\n"; yy_pop_state(yyscanner); }
+    r               { string_buf << "\r"; yy_pop_state(yyscanner); }
+    f               { string_buf << "\f"; yy_pop_state(yyscanner); }
+    \\              { string_buf << "\\"; yy_pop_state(yyscanner); }
+    \"              { string_buf << "\""; yy_pop_state(yyscanner); }
+    \'              { string_buf << "'" ; yy_pop_state(yyscanner); }
+    [0-7]{1,2}      { string_buf << (char) std::stoi( yytext, 0, 8 ); yy_pop_state(yyscanner); }
+    [0-3][0-7]{2}   { string_buf << (char) std::stoi( yytext, 0, 8 ); yy_pop_state(yyscanner); }
     .               { throw yy::parser::syntax_error(loc, "invalid escape:\\"+ std::string(yytext)); }
 }
 
@@ -189,28 +189,20 @@ instanceof      return yy::parser::make_INSTANCEOF(loc);
 [\n]+      loc.lines (yyleng); loc.step ();
 %%
 
+void Driver::scan_init() {
+    yylex_init(&scanner);
+}
+
+void Driver::scan_destroy() {
+    yylex_destroy(scanner);
+}
+
 void Driver::scan_begin() {
-    yy_flex_debug = trace_scanning;
-    if ( strfiles.empty() ) {
-        if (file.empty()|| file == "-")
-        yyin = stdin;
-        else if (!(yyin = fopen (file.c_str (), "r")))
-        {
-            std::cerr << "cannot open " << file << ": " << strerror(errno) << '\n';
-            exit (EXIT_FAILURE);
-        }
-        yy_switch_to_buffer( yy_create_buffer(yyin, YY_BUF_SIZE) );
-    } else {
-        yy_switch_to_buffer( yy_scan_string(strfiles.front().c_str()) );
-    }
+    yyset_debug(trace_scanning, scanner);
+    // Scan the source in place, rather than through a stdio buffer or a copy of it
+    yy_switch_to_buffer( yy_scan_buffer(source->scanBuffer(), source->scanBufferSize(), scanner), scanner );
 }
 
 void Driver::scan_end() {
-    if ( strfiles.empty() ) {
-        fclose(yyin);
-    } else {
-        strfiles.pop_front();
-    }
-    yy_delete_buffer( YY_CURRENT_BUFFER );
+    yypop_buffer_state(scanner);
 }
-
@@ -8,10 +8,10 @@
 #include <string>
 #include <variant>
 
-std::unordered_set<Statement*> CfgReachabilityVisitor::reached;
-
 bool isJavaLangString(LinkedType &link) {
-    return link.getIfNonArrayIsClass() == Util::root_package->findClassDeclaration("java.lang.String");
+    // Fully qualified names are unique within a program
+    auto cls = link.getIfNonArrayIsClass();
+    return cls && cls->full_qualified_name == "java.lang.String";
 }
 
 bool CfgReachabilityVisitor::isConstantExpression(Expression &node) {
@@ -3,8 +3,11 @@
 #include <unordered_set>
 
 class CfgReachabilityVisitor : public CfgVisitor {
+    // Statements found to be reachable; one set per AST, so ASTs can be checked concurrently
+    std::unordered_set<Statement*> &reached;
 public:
-    static std::unordered_set<Statement*> reached;
+    CfgReachabilityVisitor(std::unordered_set<Statement*> &reached) : reached{reached} {}
+
     static bool isConstantExpression(Expression &node);
     static Literal evalConstantExpression(Expression &node);
 public:
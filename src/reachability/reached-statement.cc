@@ -7,34 +7,34 @@
 #include "variant-ast/statements.h"
 #include <variant>
 
-void checkStatement(Statement &stmt) {
+void checkStatement(Statement &stmt, const std::unordered_set<Statement*> &reached) {
     std::visit(util::overload{
         [&](IfThenStatement &node) -> void {
             if ( node.then_clause ) {
-                checkStatement(*node.then_clause);
+                checkStatement(*node.then_clause, reached);
             }
         },
         [&](IfThenElseStatement &node) -> void {
             if ( node.then_clause ) {
-                checkStatement(*node.then_clause);
+                checkStatement(*node.then_clause, reached);
             }
             if ( node.else_clause ) {
-                checkStatement(*node.else_clause);
+                checkStatement(*node.else_clause, reached);
             }
         },
         [&](WhileStatement &node) -> void {
             if ( node.body_statement ) {
-                checkStatement(*node.body_statement);
+                checkStatement(*node.body_statement, reached);
             }
         },
         [&](ForStatement &node) -> void {
             if ( node.body_statement ) {
-                checkStatement(*node.body_statement);
+                checkStatement(*node.body_statement, reached);
             }
         },
         [&](Block &node) -> void {
             for ( auto& stmt : node.statements ) {
-                checkStatement(stmt);
+                checkStatement(stmt, reached);
             }
         },
         [&](auto &node) -> void {}
@@ -42,7 +42,7 @@ void checkStatement(Statement &stmt) {
 
     std::string location_str = Util::statementToLocationString(stmt);
     // std::cout << &stmt << std::endl;
-    if ( CfgReachabilityVisitor::reached.find(&stmt) == CfgReachabilityVisitor::reached.end() ) {
+    if ( reached.find(&stmt) == reached.end() ) {
         THROW_ReachabilityError("Statement not reached: " + location_str);
     }
 }
@@ -52,6 +52,6 @@ void StatementVisitor::operator()(MethodDeclaration &node) {
 
     if ( node.body.get() == nullptr ) { return; }
     for ( auto &stmt : node.body->statements ) {
-        checkStatement(stmt);
+        checkStatement(stmt, reached);
     }
 }
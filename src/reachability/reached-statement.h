@@ -1,9 +1,14 @@
 #pragma once
 #include "variant-ast/astvisitor/defaultskipvisitor.h"
 #include "variant-ast/classes.h"
+#include <unordered_set>
 
 class StatementVisitor : public DefaultSkipVisitor<void> {
+    // Statements found reachable by CfgReachabilityVisitor on the same AST
+    const std::unordered_set<Statement*> &reached;
 public:
+    StatementVisitor(const std::unordered_set<Statement*> &reached) : reached{reached} {}
+
     using DefaultSkipVisitor<void>::operator();
     void operator()(MethodDeclaration &node) override;
 
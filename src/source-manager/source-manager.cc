@@ -0,0 +1,71 @@
+#include "source-manager.h"
+#include "exceptions/exceptions.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+SourceBuffer::~SourceBuffer() {
+    if ( mapped_size ) {
+        munmap(data, mapped_size);
+    }
+}
+
+SourceBuffer &SourceManager::addBuffer(const std::string &name) {
+    std::lock_guard<std::mutex> lock {mutex};
+    return buffers.emplace_back(name);
+}
+
+const SourceBuffer &SourceManager::addFile(const std::string &filename) {
+    if ( filename.empty() || filename == "-" ) {
+        std::string contents {std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>()};
+        return addString(std::move(contents), filename);
+    }
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat file_stat;
+    if ( fd < 0 || fstat(fd, &file_stat) < 0 ) {
+        std::string error = std::strerror(errno);
+        if ( fd >= 0 ) { close(fd); }
+        THROW_CompilerError("Cannot open " + filename + ": " + error);
+    }
+    size_t size = file_stat.st_size;
+
+    // Reserve room for the contents and the two NUL bytes after them, then map the file over the
+    // start of it. The rest of the file's last page and the pages after it read as zeros.
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    size_t mapped_size = (size + 2 + page_size - 1) / page_size * page_size;
+    void *region = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ( region != MAP_FAILED && size > 0
+        && mmap(region, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED
+    ) {
+        munmap(region, mapped_size);
+        region = MAP_FAILED;
+    }
+    std::string error = std::strerror(errno);
+    close(fd);
+    if ( region == MAP_FAILED ) {
+        THROW_CompilerError("Cannot map " + filename + ": " + error);
+    }
+
+    SourceBuffer &buffer = addBuffer(filename);
+    buffer.data = static_cast<char*>(region);
+    buffer.size = size;
+    buffer.mapped_size = mapped_size;
+    return buffer;
+}
+
+const SourceBuffer &SourceManager::addString(std::string contents, const std::string &name) {
+    SourceBuffer &buffer = addBuffer(name);
+    buffer.owned_contents = std::move(contents);
+    buffer.size = buffer.owned_contents.size();
+    buffer.owned_contents.append(2, '\0');
+    buffer.data = buffer.owned_contents.data();
+    return buffer;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// The contents of one source file, which the scanner reads in place.
+//
+// The contents are followed by two NUL bytes, as flex requires of a buffer it scans directly,
+// and are writable since flex temporarily terminates each token within the buffer.
+class SourceBuffer {
+    char *data = nullptr;
+    size_t size = 0;
+    size_t mapped_size = 0; // Zero if the contents are held in owned_contents instead of mapped
+    std::string owned_contents;
+
+    friend class SourceManager;
+
+  public:
+    // File name as given on the command line; locations in the file's AST point to it
+    std::string name;
+
+    std::string_view contents() const { return {data, size}; }
+
+    // Start and length of the buffer to hand to the scanner, including both NUL bytes
+    char *scanBuffer() const { return data; }
+    size_t scanBufferSize() const { return size + 2; }
+
+    explicit SourceBuffer(std::string name) : name{std::move(name)} {}
+    ~SourceBuffer();
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+};
+
+// Owns the source of every file a compilation parses, for as long as its ASTs live.
+//
+// Files are memory-mapped once and never copied: the scanner runs over the mapping, and later checks
+// on the raw source (e.g. the weeder's ASCII check) reuse it instead of reading the file again.
+class SourceManager {
+    std::mutex mutex; // Files are loaded concurrently
+    std::deque<SourceBuffer> buffers; // Grows without moving the buffers already added
+
+    SourceBuffer &addBuffer(const std::string &name);
+
+  public:
+    // Map the file, or read standard input if the name is "-" or empty.
+    // Throws CompilerError if the file cannot be read.
+    const SourceBuffer &addFile(const std::string &filename);
+
+    // Take over source given as a string, scanned under the given file name
+    const SourceBuffer &addString(std::string contents, const std::string &name);
+};
@@ -6,7 +6,7 @@
 bool checkAssignability(LinkedType& linkedType1, LinkedType& linkedType2, PackageDeclarationObject* default_package);
 bool checkCastability(LinkedType& type, LinkedType& expression, PackageDeclarationObject* default_package);
 
-LinkedType TypeChecker::getLink(Expression &node) {
+LinkedType TypeChecker::getLink(Expression &node, PackageDeclarationObject *root_package) {
     return std::visit(util::overload {
         // Literal handled seperately as it is not a class
         [&] (Literal expr_type) -> LinkedType {
@@ -21,7 +21,7 @@ LinkedType TypeChecker::getLink(Expression &node) {
                     return LinkedType(PrimitiveType::CHAR);
                 },
                 [&] (std::string& literal_type) -> LinkedType {
-                    NonArrayLinkedType string_type = Util::root_package->findClassDeclaration("java.lang.String");
+                    NonArrayLinkedType string_type = root_package->findClassDeclaration("java.lang.String");
                     return LinkedType(string_type);
                 },
                 [&] (std::nullptr_t literal_type) -> LinkedType {
@@ -36,7 +36,7 @@ LinkedType TypeChecker::getLink(Expression &node) {
     }, node);
 }
 
-LinkedType TypeChecker::getLink(std::unique_ptr<Expression>& node_ptr) {
+LinkedType TypeChecker::getLink(AstPtr<Expression>& node_ptr) {
     return getLink(*node_ptr);
 }
 
@@ -44,7 +44,7 @@ bool TypeChecker::isVariable(Expression& node) {
     return std::visit([&](auto& expr){ return expr.is_variable; }, node);
 }
 
-bool TypeChecker::isVariable(std::unique_ptr<Expression>& node_ptr) {
+bool TypeChecker::isVariable(AstPtr<Expression>& node_ptr) {
     return isVariable(*node_ptr);
 }
 
@@ -101,7 +101,9 @@ void TypeChecker::operator()(MethodDeclaration &node) {
         ClassDeclarationObject* superclass = current_class->extended;
         bool superclass_default_constructor_exists = false;
 
-        std::list<MethodDeclarationObject*> constructors = superclass->overloaded_methods[superclass->identifier];
+        std::list<MethodDeclarationObject*> constructors;
+        auto constructors_it = superclass->overloaded_methods.find(superclass->identifier);
+        if (constructors_it != superclass->overloaded_methods.end()) { constructors = constructors_it->second; }
         for (auto constructor : constructors) {
             if (constructor->getParameters().size() == 0) {
                 superclass_default_constructor_exists = true;
@@ -179,12 +181,14 @@ void TypeChecker::operator()(FieldDeclaration &node) {
 FieldDeclarationObject* checkIfFieldIsAccessible(
     ClassDeclarationObject* current_class,
     ClassDeclarationObject* class_with_field,
-    std::string& field_simple_name,
+    util::Symbol field_simple_name,
     bool must_be_static = false
 ) {
     // First, see if the field even exists
     if (!class_with_field) { return nullptr; }
-    auto possible_field = class_with_field->accessible_fields[field_simple_name];
+    auto possible_field_it = class_with_field->accessible_fields.find(field_simple_name);
+    if (possible_field_it == class_with_field->accessible_fields.end()) { return nullptr; }
+    auto possible_field = possible_field_it->second;
     if (!possible_field) { return nullptr; }
 
     // Second, if the field access is static, ensure it is static; if the field access is non-static, ensure it is non static
@@ -273,7 +277,7 @@ void TypeChecker::operator()(QualifiedIdentifier &qid) {
     switch (qid.getClassification()) {
         case EXPRESSION_NAME: 
             if (qid.isSimple()) {
-                std::string& name = qid.identifiers.back().name;
+                util::Symbol name = qid.identifiers.back().name;
                 // 1. Look up in local vars scope
                 if (current_method) {
                     auto possible_var = current_method->scope_manager.lookupDeclaredVariable(name);
@@ -313,7 +317,7 @@ void TypeChecker::operator()(QualifiedIdentifier &qid) {
             } else {
                 // 6.5.6.2: Expression name is of the form Q.id
                 QualifiedIdentifier Q = qid.getQualifiedIdentifierWithoutLast();
-                std::string& id = qid.identifiers.back().name;
+                util::Symbol id = qid.identifiers.back().name;
                 switch (Q.getClassification()) {
                     case PACKAGE_NAME:
                         THROW_TypeCheckerError("PackageName precedes ExpressionName in " + qid.getQualifiedName());
@@ -514,7 +518,7 @@ void TypeChecker::operator()(InfixExpression &node) {
 
 // Finds applicable and accessible method_name within type_to_search with matching arguments
 // Throws if no method is applicable and accessible
-MethodDeclarationObject* TypeChecker::determineMethodSignature(LinkedType& type_to_search, std::string& method_name, std::vector<Expression>& arguments, bool is_constructor) {
+MethodDeclarationObject* TypeChecker::determineMethodSignature(LinkedType& type_to_search, util::Symbol method_name, std::vector<Expression>& arguments, bool is_constructor) {
     std::list<MethodDeclarationObject*> invoked_method_candidates = type_to_search.getAllMethods(method_name);
 
     // Find all applicable & accessible methods
@@ -577,7 +581,7 @@ MethodDeclarationObject* TypeChecker::determineMethodSignature(LinkedType& type_
 void TypeChecker::operator()(MethodInvocation &node) {
 
     /* JLS 15.12: Method Invocation Expressions */
-    std::string& method_name = node.method_name->name;
+    util::Symbol method_name = node.method_name->name;
     this->visit_children(node);
 
     // Whether the method call is in the form A(), which is implicitly this.A()
@@ -704,14 +708,14 @@ void TypeChecker::operator()(ClassInstanceCreationExpression &node) {
     }
 
     // Check constructor call is valid
-    std::string constructor_name = node.class_name->identifiers.back().name;
+    util::Symbol constructor_name = node.class_name->identifiers.back().name;
     node.called_constructor = determineMethodSignature(class_constructed, constructor_name, node.arguments, true);
 }
 
 void TypeChecker::operator()(FieldAccess &node) {
     this->visit_children(node);
 
-    std::string& field_name = node.identifier->name;
+    util::Symbol field_name = node.identifier->name;
     FieldDeclarationObject* resolved_field = nullptr;
 
     // Type that the field is being accessed on
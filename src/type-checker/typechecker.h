@@ -18,13 +18,14 @@ class TypeChecker: public DefaultSkipVisitor<void> {
     FieldDeclarationObject* current_field = nullptr;
 
     // Shorthand for getting linked type from any expression node
-    LinkedType getLink(std::unique_ptr<Expression>& node_ptr);
+    LinkedType getLink(AstPtr<Expression>& node_ptr);
+    LinkedType getLink(Expression &node) { return getLink(node, default_package); }
 
     ClassDeclarationObject* getStringClass(LinkedType &link);
 
     // Return true iff expression node is mutable
     bool isVariable(Expression& node);
-    bool isVariable(std::unique_ptr<Expression>& node_ptr);
+    bool isVariable(AstPtr<Expression>& node_ptr);
 
     // Helper methods
     bool checkifMethodIsAccessible(
@@ -36,12 +37,12 @@ class TypeChecker: public DefaultSkipVisitor<void> {
 
     // Finds applicable and accessible method_name within type_to_search with matching arguments
     // Throws if no method is applicable and accessible
-    MethodDeclarationObject* determineMethodSignature(LinkedType& type_to_search, std::string& method_name, std::vector<Expression>& arguments, bool is_constructor);
+    MethodDeclarationObject* determineMethodSignature(LinkedType& type_to_search, util::Symbol method_name, std::vector<Expression>& arguments, bool is_constructor);
 
   public:
     using DefaultSkipVisitor<void>::operator();
 
-    static LinkedType getLink(Expression &node);
+    static LinkedType getLink(Expression &node, PackageDeclarationObject *root_package);
     // Operations for finding the types of identifiers
     void operator()(CompilationUnit &node) override;
 
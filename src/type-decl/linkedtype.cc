@@ -76,16 +76,17 @@ bool LinkedType::isSubType(LinkedType other, PackageDeclarationObject* default_p
     return std::visit([&](auto type_dec){ return type_dec->isSubType(other_type); }, this_type);
 }
 
-std::list<struct MethodDeclarationObject*> LinkedType::getAllMethods(std::string& method_name) {
+std::list<struct MethodDeclarationObject*> LinkedType::getAllMethods(util::Symbol method_name) {
     // TODO : handle arrays specially
     if (getIfNonArrayIsPrimitive()) { return {}; }
 
-    if (auto cls = getIfNonArrayIsClass()) {
-        return cls->overloaded_methods[method_name];
-    } else {
-        auto ifc = getIfNonArrayIsInterface();
-        return ifc->overloaded_methods[method_name];
-    }
+    auto &overloaded_methods = getIfNonArrayIsClass()
+        ? getIfNonArrayIsClass()->overloaded_methods
+        : getIfNonArrayIsInterface()->overloaded_methods;
+
+    auto methods = overloaded_methods.find(method_name);
+    if (methods == overloaded_methods.end()) { return {}; }
+    return methods->second;
 }
 
 std::string LinkedType::toSimpleString() {
@@ -3,6 +3,7 @@
 #include <list>
 #include "type-decl/type_declaration.h"
 #include "variant-ast/primitivetype.h"
+#include "utillities/symbol.h"
 
 struct TypeDeclarationObject;
 using NonArrayLinkedType 
@@ -14,7 +15,7 @@ struct LinkedType {
     NonArrayLinkedType linked_type;
 
     // TODO : Remove one of the middle two constructors, requires some refactoring on code using them
-    LinkedType() : is_array{false}, linked_type{nullptr} {}
+    LinkedType() : not_expression{false}, is_array{false}, linked_type{nullptr} {}
 
     LinkedType(NonArrayLinkedType non_array_type, bool is_array=false, bool not_expression=false) 
         : is_array{is_array}, not_expression{not_expression}, linked_type{non_array_type} {}
@@ -52,7 +53,7 @@ struct LinkedType {
     PrimitiveType* getIfIsPrimitive() { return is_array ? nullptr : getIfNonArrayIsPrimitive(); };
 
     // Return all defined and inherited methods on the type this LinkedType represents with specified simple name
-    std::list<struct MethodDeclarationObject*> getAllMethods(std::string &);
+    std::list<struct MethodDeclarationObject*> getAllMethods(util::Symbol);
 
     friend bool operator==(const LinkedType &lhs, const LinkedType &rhs) {
         return (lhs.linked_type == rhs.linked_type) && (lhs.is_array == rhs.is_array);
@@ -20,7 +20,7 @@ CompilationUnitNamespace::CompilationUnitNamespace(
     star_imports{star_imports}
 {}
 
-TypeDeclaration resolveCandidates(std::vector<TypeDeclaration>& valid_candidates, std::string identifier) {
+TypeDeclaration resolveCandidates(std::vector<TypeDeclaration>& valid_candidates, util::Symbol identifier) {
     util::removeDuplicates(valid_candidates);
     if (valid_candidates.size() == 0) {
         THROW_TypeLinkerError("Type declaration for " + identifier + " not found");
@@ -46,7 +46,7 @@ TypeDeclaration CompilationUnitNamespace::lookupQualifiedType(QualifiedIdentifie
         *   3. id must be exactly one type that is a member of Q.
     */
     QualifiedIdentifier package_qid = qualified_identifier.getQualifiedIdentifierWithoutLast();
-    std::string canoncial_name = qualified_identifier.identifiers.back().name;
+    util::Symbol canoncial_name = qualified_identifier.identifiers.back().name;
 
     if (package_qid.identifiers.empty()) {
         auto valid_candidates = lookupSimpleType(canoncial_name);
@@ -54,7 +54,7 @@ TypeDeclaration CompilationUnitNamespace::lookupQualifiedType(QualifiedIdentifie
     }
 
     // Check each import-on-demand package in compilation units namespace
-    auto getValidCandidates = [&](QualifiedIdentifier &package_qid, std::string canoncial_name){
+    auto getValidCandidates = [&](QualifiedIdentifier &package_qid, util::Symbol canoncial_name){
         std::vector<TypeDeclaration> valid_candidates;
         
         auto all_packages = star_imports;
@@ -82,7 +82,7 @@ TypeDeclaration CompilationUnitNamespace::lookupQualifiedType(QualifiedIdentifie
     // Return true if any non-strict prefix of qid resolves to a type in the environment.
     std::function<bool(QualifiedIdentifier&)> somePrefixIsType = [&](QualifiedIdentifier &qid){
         auto prefix = qid.getQualifiedIdentifierWithoutLast();
-        std::string canoncial_name = qid.identifiers.back().name;
+        util::Symbol canoncial_name = qid.identifiers.back().name;
 
         if (prefix.identifiers.empty()) {
             // This is a simple type
@@ -106,7 +106,7 @@ TypeDeclaration CompilationUnitNamespace::lookupQualifiedType(QualifiedIdentifie
     return resolveCandidates(valid_candidates, canoncial_name);
 }
 
-std::vector<TypeDeclaration> CompilationUnitNamespace::lookupSimpleType(std::string &identifier) {
+std::vector<TypeDeclaration> CompilationUnitNamespace::lookupSimpleType(util::Symbol identifier) {
     /*
         * Typelinking:
         * - Unqualified names are handled by these rules: 
@@ -16,13 +16,15 @@ class CompilationUnitNamespace {
 
     // Look up identifier as a type in compilation unit's namespace.
     // Returns all valid candidates.
-    std::vector<TypeDeclaration> lookupSimpleType(std::string &identifier);
+    std::vector<TypeDeclaration> lookupSimpleType(util::Symbol identifier);
   public:
     // Look up qualifed_identifier as a type in compilation unit's namespace.
     // Throws semantic error if there are multiple candidates in the namespace.
     TypeDeclaration lookupQualifiedType(QualifiedIdentifier &qualified_identifier);
     TypeDeclaration getDeclaredType() { return declared_type; }
     PackageDeclarationObject* getCurrentPackage() { return current_package; }
+    std::vector<TypeDeclaration>& getSingleImports() { return single_imports; }
+    std::vector<PackageDeclarationObject*>& getStarImports() { return star_imports; }
 
     CompilationUnitNamespace() = default;
     CompilationUnitNamespace(
@@ -198,7 +198,7 @@ void TypeLinker::operator()(Type &node) {
 
 void TypeLinker::operator()(ClassDeclaration &node) {
 
-    std::string name = node.class_name->name;
+    util::Symbol name = node.class_name->name;
 
     // Check this class resolves unambiguously with imported classes
     auto qid = QualifiedIdentifier(std::vector{Identifier(name)});
@@ -229,7 +229,7 @@ void TypeLinker::operator()(ClassDeclaration &node) {
 
 void TypeLinker::operator()(InterfaceDeclaration &node) {
 
-    std::string name = node.interface_name->name;
+    util::Symbol name = node.interface_name->name;
 
     // Check this interface resolves unambiguously with imported classes
     auto qid = QualifiedIdentifier(std::vector{Identifier(name)});
@@ -265,7 +265,7 @@ void TypeLinker::operator()(MethodDeclaration &node) {
         node.environment->is_constructor = true;
 
         // Name must be the same as the class name
-        std::string& constructor_name = node.environment->identifier;
+        util::Symbol constructor_name = node.environment->identifier;
         std::visit(util::overload {
             [&](ClassDeclarationObject* cls){
                 if (cls->identifier != constructor_name) {
@@ -0,0 +1,35 @@
+#include "process.h"
+
+#include <cerrno>
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char **environ;
+
+namespace util {
+
+int runProcess(const std::vector<std::string> &arguments) {
+    std::vector<char*> argv;
+    for ( auto &argument : arguments ) {
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    pid_t pid;
+    if ( posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ) != 0 ) {
+        return -1;
+    }
+
+    int status;
+    pid_t waited;
+    do {
+        waited = waitpid(pid, &status, 0);
+    } while ( waited == -1 && errno == EINTR );
+
+    if ( waited == -1 || !WIFEXITED(status) ) {
+        return -1;
+    }
+    return WEXITSTATUS(status);
+}
+
+} // namespace util
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace util {
+
+// Run a program, found on the PATH, with the arguments (the first naming the program) and wait for it to finish.
+//
+// Returns the program's exit status, or -1 if it could not be started or did not exit normally.
+// Safe to call from several threads at once.
+int runProcess(const std::vector<std::string> &arguments);
+
+} // namespace util
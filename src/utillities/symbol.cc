@@ -0,0 +1,35 @@
+#include "symbol.h"
+
+#include <array>
+#include <mutex>
+#include <unordered_set>
+
+namespace util {
+
+namespace {
+
+// Split by hash, so threads interning different strings rarely wait on each other
+constexpr size_t NUM_SHARDS = 16;
+
+struct InternShard {
+    std::mutex mutex;
+    std::unordered_set<std::string> strings; // Elements never move, so handles stay valid
+};
+
+std::array<InternShard, NUM_SHARDS> &shards() {
+    // Never destroyed, so symbols held by other static objects stay valid during exit
+    static auto *shards = new std::array<InternShard, NUM_SHARDS>();
+    return *shards;
+}
+
+} // namespace
+
+const std::string *Symbol::intern(std::string_view string) {
+    size_t hash = std::hash<std::string_view>{}(string);
+    InternShard &shard = shards()[hash % NUM_SHARDS];
+
+    std::lock_guard<std::mutex> lock {shard.mutex};
+    return &*shard.strings.emplace(string).first;
+}
+
+} // namespace util
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace util {
+
+// Handle to an interned string, e.g. an identifier or a qualified name.
+//
+// Every distinct string is stored once for the life of the process, and equal strings share a handle,
+// so comparing and hashing symbols compares and hashes a pointer. Interning is thread-safe, so
+// separate compilations and parallel passes share one interner.
+class Symbol {
+    const std::string *string;
+
+    static const std::string *intern(std::string_view string);
+
+  public:
+    Symbol() : Symbol(std::string_view{}) {}
+    Symbol(std::string_view string) : string{intern(string)} {}
+    Symbol(const std::string &string) : Symbol(std::string_view{string}) {}
+    Symbol(const char *string) : Symbol(std::string_view{string}) {}
+
+    const std::string &str() const { return *string; }
+    operator const std::string&() const { return *string; }
+
+    bool empty() const { return string->empty(); }
+    size_t size() const { return string->size(); }
+    const char *c_str() const { return string->c_str(); }
+
+    bool operator==(Symbol other) const { return string == other.string; }
+    bool operator!=(Symbol other) const { return string != other.string; }
+    bool operator==(const std::string &other) const { return *string == other; }
+    bool operator!=(const std::string &other) const { return *string != other; }
+    bool operator==(const char *other) const { return *string == other; }
+    bool operator!=(const char *other) const { return *string != other; }
+
+    // Ordered by contents, so ordered containers do not depend on where strings were interned
+    bool operator<(Symbol other) const { return string != other.string && *string < *other.string; }
+
+    size_t hash() const { return std::hash<const std::string*>{}(string); }
+};
+
+inline bool operator==(const std::string &string, Symbol symbol) { return symbol == string; }
+inline bool operator!=(const std::string &string, Symbol symbol) { return symbol != string; }
+inline bool operator==(const char *string, Symbol symbol) { return symbol == string; }
+inline bool operator!=(const char *string, Symbol symbol) { return symbol != string; }
+
+inline std::string operator+(Symbol symbol, const std::string &string) { return symbol.str() + string; }
+inline std::string operator+(const std::string &string, Symbol symbol) { return string + symbol.str(); }
+inline std::string operator+(Symbol symbol, const char *string) { return symbol.str() + string; }
+inline std::string operator+(const char *string, Symbol symbol) { return string + symbol.str(); }
+inline std::string operator+(Symbol symbol, Symbol other) { return symbol.str() + other.str(); }
+
+inline std::ostream &operator<<(std::ostream &out, Symbol symbol) { return out << symbol.str(); }
+
+} // namespace util
+
+template <>
+struct std::hash<util::Symbol> {
+    size_t operator()(util::Symbol symbol) const { return symbol.hash(); }
+};
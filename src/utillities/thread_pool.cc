@@ -0,0 +1,119 @@
+#include "thread_pool.h"
+
+using namespace util;
+
+// Pool and queue of the worker running on this thread, if any
+static thread_local ThreadPool *current_pool = nullptr;
+static thread_local size_t current_queue = 0;
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    if (num_threads < 1) num_threads = 1;
+
+    for (size_t i = 0; i < num_threads; i++) {
+        queues.emplace_back(std::make_unique<WorkQueue>());
+    }
+
+    // The thread waiting on the pool makes up the last thread
+    for (size_t i = 1; i < num_threads; i++) {
+        workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock {mutex};
+        stopping = true;
+    }
+    task_available.notify_all();
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::defaultThreadCount() {
+    size_t hardware_threads = std::thread::hardware_concurrency();
+    return hardware_threads ? hardware_threads : 1;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    if (workers.empty()) {
+        task();
+        return;
+    }
+
+    size_t queue;
+    {
+        std::lock_guard<std::mutex> lock {mutex};
+        queue = (current_pool == this) ? current_queue : next_queue++ % queues.size();
+        queued_tasks++;
+        unfinished_tasks++;
+    }
+    {
+        std::lock_guard<std::mutex> lock {queues[queue]->mutex};
+        queues[queue]->tasks.push_back(std::move(task));
+    }
+    task_available.notify_one();
+}
+
+void ThreadPool::wait() {
+    while (runTask(0));
+
+    std::unique_lock<std::mutex> lock {mutex};
+    all_finished.wait(lock, [this]() { return unfinished_tasks == 0; });
+}
+
+bool ThreadPool::popTask(size_t queue, bool from_back, std::function<void()> &task) {
+    std::lock_guard<std::mutex> lock {queues[queue]->mutex};
+    auto &tasks = queues[queue]->tasks;
+    if (tasks.empty()) return false;
+
+    if (from_back) {
+        task = std::move(tasks.back());
+        tasks.pop_back();
+    } else {
+        task = std::move(tasks.front());
+        tasks.pop_front();
+    }
+    return true;
+}
+
+bool ThreadPool::runTask(size_t home_queue) {
+    std::function<void()> task;
+
+    bool found = popTask(home_queue, true, task);
+    for (size_t i = 1; !found && i < queues.size(); i++) {
+        found = popTask((home_queue + i) % queues.size(), false, task);
+    }
+    if (!found) return false;
+
+    {
+        std::lock_guard<std::mutex> lock {mutex};
+        queued_tasks--;
+    }
+
+    task();
+
+    bool finished;
+    {
+        std::lock_guard<std::mutex> lock {mutex};
+        unfinished_tasks--;
+        finished = (unfinished_tasks == 0);
+    }
+    if (finished) all_finished.notify_all();
+
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t queue) {
+    current_pool = this;
+    current_queue = queue;
+
+    while (true) {
+        if (runTask(queue)) continue;
+
+        std::unique_lock<std::mutex> lock {mutex};
+        task_available.wait(lock, [this]() { return stopping || queued_tasks > 0; });
+        if (stopping && queued_tasks == 0) return;
+    }
+}
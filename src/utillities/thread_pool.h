@@ -0,0 +1,84 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+// Work-stealing pool of worker threads.
+//
+// Every worker has its own task queue. Tasks submitted by a worker go to the back of its own queue,
+// and other tasks are spread across the queues; an idle worker takes from the back of its own
+// queue, then steals from the front of the others, so uneven tasks still keep every thread busy.
+// The thread calling wait() runs tasks too. A pool with a single thread runs each task as it is submitted.
+class ThreadPool {
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // Queue 0 belongs to threads outside the pool; queue i belongs to worker i
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    size_t next_queue = 0;
+
+    size_t queued_tasks = 0;
+    size_t unfinished_tasks = 0;
+    bool stopping = false;
+
+    std::mutex mutex;
+    std::condition_variable task_available;
+    std::condition_variable all_finished;
+
+    // Run one task, preferring the given queue; return false if there were none
+    bool runTask(size_t home_queue);
+    bool popTask(size_t queue, bool from_back, std::function<void()> &task);
+    void workerLoop(size_t queue);
+  public:
+    explicit ThreadPool(size_t num_threads = defaultThreadCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of hardware threads, or 1 if unknown
+    static size_t defaultThreadCount();
+
+    size_t size() const { return queues.size(); }
+
+    // Tasks must not throw; use parallelFor to propagate exceptions
+    void submit(std::function<void()> task);
+
+    // Block until every submitted task has finished, running tasks on this thread meanwhile
+    void wait();
+
+    // Run function(i) for every i in [0, count) and wait for all of them.
+    // If any calls throw, the exception from the lowest i is rethrown, so failures are deterministic.
+    template <typename Function>
+    void parallelFor(size_t count, Function &&function) {
+        std::vector<std::exception_ptr> exceptions(count);
+
+        for (size_t i = 0; i < count; i++) {
+            submit([&function, &exceptions, i]() {
+                try {
+                    function(i);
+                } catch (...) {
+                    exceptions[i] = std::current_exception();
+                }
+            });
+        }
+        wait();
+
+        for (auto &exception : exceptions) {
+            if (exception) { std::rethrow_exception(exception); }
+        }
+    }
+};
+
+};
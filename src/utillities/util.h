@@ -7,8 +7,6 @@
 #include "variant-ast/astnode.h"
 
 struct Util {
-    static PackageDeclarationObject* root_package;
-    static std::vector<AstNodeVariant>* linked_asts;
     static std::string locationToString(yy::location &loc);
     static std::string statementToLocationString(Statement &stmt);
     static std::string expressionToLocationString(Expression &expr);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Destroys an AST node in place; its memory belongs to the AstArena it was made in
+struct AstDeleter {
+    template <typename T>
+    void operator()(T *node) const { node->~T(); }
+};
+
+// Owning pointer to an AST node made by AstArena::make
+template <typename T>
+using AstPtr = std::unique_ptr<T, AstDeleter>;
+
+// Bump allocator for the AST nodes of one compilation unit.
+//
+// Nodes are laid out one after another in the order the parser builds them, and their memory is
+// released all at once when the arena is destroyed, which must be after every AstPtr made from it.
+class AstArena {
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::byte *next = nullptr;
+    size_t remaining = 0;
+
+    void *allocate(size_t size, size_t alignment) {
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(next) % alignment) % alignment;
+        if ( next == nullptr || padding + size > remaining ) {
+            // Nodes larger than a block get a block of their own
+            size_t block_size = std::max(BLOCK_SIZE, size + alignment);
+            blocks.emplace_back(new std::byte[block_size]);
+            next = blocks.back().get();
+            remaining = block_size;
+            padding = (alignment - reinterpret_cast<uintptr_t>(next) % alignment) % alignment;
+        }
+        void *node = next + padding;
+        next += padding + size;
+        remaining -= padding + size;
+        return node;
+    }
+
+  public:
+    AstArena() = default;
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    template <typename T, typename... Args>
+    AstPtr<T> make(Args&&... args) {
+        void *memory = allocate(sizeof(T), alignof(T));
+        return AstPtr<T>(new (memory) T(std::forward<Args>(args)...));
+    }
+};
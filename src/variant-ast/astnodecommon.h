@@ -1,7 +1,9 @@
 #pragma once
 // For putting common decorator information e.g. Type
 #include "parsing/bison/location.hh"
+#include "astarena.h"
+
+// Nodes are never deleted through this base, so it carries no vtable
 struct AstNodeCommon {
-    virtual ~AstNodeCommon() = default;
     yy::location location;
 };
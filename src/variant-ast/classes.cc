@@ -9,8 +9,8 @@
 
 ClassDeclaration::ClassDeclaration(
     std::vector<Modifier>& modifiers,
-    std::unique_ptr<Identifier>& class_name,
-    std::unique_ptr<QualifiedIdentifier>& extends_class,
+    AstPtr<Identifier>& class_name,
+    AstPtr<QualifiedIdentifier>& extends_class,
     std::vector<QualifiedIdentifier>& implements,
     std::vector<FieldDeclaration>& field_declarations,
     std::vector<MethodDeclaration>& method_declarations
@@ -25,7 +25,7 @@ ClassDeclaration::ClassDeclaration(
 
 InterfaceDeclaration::InterfaceDeclaration(
     std::vector<Modifier>& modifiers,
-    std::unique_ptr<Identifier>& interface_name,
+    AstPtr<Identifier>& interface_name,
     std::vector<QualifiedIdentifier>& extends_class,
     std::vector<MethodDeclaration>& method_declarations
 ) :
@@ -37,8 +37,8 @@ InterfaceDeclaration::InterfaceDeclaration(
 
 FieldDeclaration::FieldDeclaration(
         std::vector<Modifier>& modifiers,
-        std::unique_ptr<Type>& type,
-        std::unique_ptr<VariableDeclarator>& variable_declarator
+        AstPtr<Type>& type,
+        AstPtr<VariableDeclarator>& variable_declarator
 ) :
     modifiers(std::move(modifiers)),
     type(std::move(type)),
@@ -47,10 +47,10 @@ FieldDeclaration::FieldDeclaration(
 
 MethodDeclaration::MethodDeclaration(
     std::vector<Modifier>& modifiers,
-    std::unique_ptr<Type>& type,
-    std::unique_ptr<Identifier>& function_name,
+    AstPtr<Type>& type,
+    AstPtr<Identifier>& function_name,
     std::vector<FormalParameter>& parameters,
-    std::unique_ptr<Block>& body
+    AstPtr<Block>& body
 ) :
     modifiers{std::move(modifiers)}, 
     type{std::move(type)},
@@ -60,16 +60,16 @@ MethodDeclaration::MethodDeclaration(
 {}
 
 VariableDeclarator::VariableDeclarator(
-    std::unique_ptr<Identifier>& variable_name,
-    std::unique_ptr<Expression>& expression
+    AstPtr<Identifier>& variable_name,
+    AstPtr<Expression>& expression
 ) :
     variable_name{std::move(variable_name)}, 
     expression{std::move(expression)}
 {}
 
 FormalParameter::FormalParameter(
-    std::unique_ptr<Type>& type, 
-    std::unique_ptr<Identifier>& parameter_name
+    AstPtr<Type>& type, 
+    AstPtr<Identifier>& parameter_name
 ) :
     type{std::move(type)}, 
     parameter_name{std::move(parameter_name)} 
@@ -79,8 +79,8 @@ FormalParameter::FormalParameter(
 
 ClassDeclaration::ClassDeclaration(
     std::vector<Modifier>&& modifiers,
-    std::unique_ptr<Identifier>&& class_name,
-    std::unique_ptr<QualifiedIdentifier>&& extends_class,
+    AstPtr<Identifier>&& class_name,
+    AstPtr<QualifiedIdentifier>&& extends_class,
     std::vector<QualifiedIdentifier>&& implements,
     std::vector<FieldDeclaration>&& field_declarations,
     std::vector<MethodDeclaration>&& method_declarations
@@ -95,7 +95,7 @@ ClassDeclaration::ClassDeclaration(
 
 InterfaceDeclaration::InterfaceDeclaration(
     std::vector<Modifier>&& modifiers,
-    std::unique_ptr<Identifier>&& interface_name,
+    AstPtr<Identifier>&& interface_name,
     std::vector<QualifiedIdentifier>&& extends_class,
     std::vector<MethodDeclaration>&& method_declarations
 ) :
@@ -107,8 +107,8 @@ InterfaceDeclaration::InterfaceDeclaration(
 
 FieldDeclaration::FieldDeclaration(
         std::vector<Modifier>&& modifiers,
-        std::unique_ptr<Type>&& type,
-        std::unique_ptr<VariableDeclarator>&& variable_declarator
+        AstPtr<Type>&& type,
+        AstPtr<VariableDeclarator>&& variable_declarator
 ) :
     modifiers(std::move(modifiers)),
     type(std::move(type)),
@@ -117,10 +117,10 @@ FieldDeclaration::FieldDeclaration(
 
 MethodDeclaration::MethodDeclaration(
     std::vector<Modifier>&& modifiers,
-    std::unique_ptr<Type>&& type,
-    std::unique_ptr<Identifier>&& function_name,
+    AstPtr<Type>&& type,
+    AstPtr<Identifier>&& function_name,
     std::vector<FormalParameter>&& parameters,
-    std::unique_ptr<Block>&& body
+    AstPtr<Block>&& body
 ) :
     modifiers{std::move(modifiers)}, 
     type{std::move(type)},
@@ -130,16 +130,16 @@ MethodDeclaration::MethodDeclaration(
 {}
 
 VariableDeclarator::VariableDeclarator(
-    std::unique_ptr<Identifier>&& variable_name,
-    std::unique_ptr<Expression>&& expression
+    AstPtr<Identifier>&& variable_name,
+    AstPtr<Expression>&& expression
 ) :
     variable_name{std::move(variable_name)}, 
     expression{std::move(expression)}
 {}
 
 FormalParameter::FormalParameter(
-    std::unique_ptr<Type>&& type, 
-    std::unique_ptr<Identifier>&& parameter_name
+    AstPtr<Type>&& type, 
+    AstPtr<Identifier>&& parameter_name
 ) :
     type{std::move(type)}, 
     parameter_name{std::move(parameter_name)} 
@@ -22,23 +22,23 @@ enum class Modifier {
 };
 
 struct VariableDeclarator : public AstNodeCommon {
-    std::unique_ptr<Identifier> variable_name;
-    std::unique_ptr<Expression> expression;
+    AstPtr<Identifier> variable_name;
+    AstPtr<Expression> expression;
 
     VariableDeclarator(
-        std::unique_ptr<Identifier>& variable_name, 
-        std::unique_ptr<Expression>& expression
+        AstPtr<Identifier>& variable_name, 
+        AstPtr<Expression>& expression
     );
     VariableDeclarator(
-        std::unique_ptr<Identifier>&& variable_name, 
-        std::unique_ptr<Expression>&& expression
+        AstPtr<Identifier>&& variable_name, 
+        AstPtr<Expression>&& expression
     );
 };
 
 struct FieldDeclaration: public AstNodeCommon {
     std::vector<Modifier> modifiers;
-    std::unique_ptr<Type> type;
-    std::unique_ptr<VariableDeclarator> variable_declarator;
+    AstPtr<Type> type;
+    AstPtr<VariableDeclarator> variable_declarator;
 
     struct FieldDeclarationObject *environment = nullptr;
 
@@ -46,29 +46,29 @@ struct FieldDeclaration: public AstNodeCommon {
 
     FieldDeclaration(
         std::vector<Modifier>& modifiers,
-        std::unique_ptr<Type>& type,
-        std::unique_ptr<VariableDeclarator>& variable_declarator
+        AstPtr<Type>& type,
+        AstPtr<VariableDeclarator>& variable_declarator
     );
     FieldDeclaration(
         std::vector<Modifier>&& modifiers,
-        std::unique_ptr<Type>&& type,
-        std::unique_ptr<VariableDeclarator>&& variable_declarator
+        AstPtr<Type>&& type,
+        AstPtr<VariableDeclarator>&& variable_declarator
     );
 };
 
 struct FormalParameter : public AstNodeCommon {
-    std::unique_ptr<Type> type;
-    std::unique_ptr<Identifier> parameter_name;
+    AstPtr<Type> type;
+    AstPtr<Identifier> parameter_name;
 
     struct FormalParameterDeclarationObject *environment = nullptr;
 
     FormalParameter(
-        std::unique_ptr<Type>& type, 
-        std::unique_ptr<Identifier>& parameter_name
+        AstPtr<Type>& type, 
+        AstPtr<Identifier>& parameter_name
     );
     FormalParameter(
-        std::unique_ptr<Type>&& type, 
-        std::unique_ptr<Identifier>&& parameter_name
+        AstPtr<Type>&& type, 
+        AstPtr<Identifier>&& parameter_name
     );
 
     std::string toString() const;
@@ -76,10 +76,10 @@ struct FormalParameter : public AstNodeCommon {
 
 struct MethodDeclaration : public AstNodeCommon {
     std::vector<Modifier> modifiers;
-    std::unique_ptr<Type> type;
-    std::unique_ptr<Identifier> function_name;
+    AstPtr<Type> type;
+    AstPtr<Identifier> function_name;
     std::vector<FormalParameter> parameters;
-    std::unique_ptr<Block> body;
+    AstPtr<Block> body;
     CfgStatement* cfg_start = nullptr;
     CfgStatement* cfg_end = nullptr;
 
@@ -87,17 +87,17 @@ struct MethodDeclaration : public AstNodeCommon {
 
     MethodDeclaration(
         std::vector<Modifier>& modifiers,
-        std::unique_ptr<Type>& type,
-        std::unique_ptr<Identifier>& function_name,
+        AstPtr<Type>& type,
+        AstPtr<Identifier>& function_name,
         std::vector<FormalParameter>& parameters,
-        std::unique_ptr<Block>& body
+        AstPtr<Block>& body
     );
     MethodDeclaration(
         std::vector<Modifier>&& modifiers,
-        std::unique_ptr<Type>&& type,
-        std::unique_ptr<Identifier>&& function_name,
+        AstPtr<Type>&& type,
+        AstPtr<Identifier>&& function_name,
         std::vector<FormalParameter>&& parameters,
-        std::unique_ptr<Block>&& body
+        AstPtr<Block>&& body
     );
     MethodDeclaration(const MethodDeclaration &other) = default;
     MethodDeclaration(MethodDeclaration &&other) = default;
@@ -116,8 +116,8 @@ struct MethodDeclaration : public AstNodeCommon {
 
 struct ClassDeclaration: public AstNodeCommon {
     std::vector<Modifier> modifiers; // Vector of class modifiers
-    std::unique_ptr<Identifier> class_name; // Class name
-    std::unique_ptr<QualifiedIdentifier> extends_class; // Class that this class extends off of
+    AstPtr<Identifier> class_name; // Class name
+    AstPtr<QualifiedIdentifier> extends_class; // Class that this class extends off of
     std::vector<QualifiedIdentifier> implements; // Intefaces that this class implements
     std::vector<FieldDeclaration> field_declarations; // Class field declarations
     std::vector<MethodDeclaration> method_declarations; // Class method declarations
@@ -126,16 +126,16 @@ struct ClassDeclaration: public AstNodeCommon {
 
     ClassDeclaration(
         std::vector<Modifier>& modifiers,
-        std::unique_ptr<struct Identifier>& class_name,
-        std::unique_ptr<QualifiedIdentifier>& extends_class,
+        AstPtr<struct Identifier>& class_name,
+        AstPtr<QualifiedIdentifier>& extends_class,
         std::vector<QualifiedIdentifier>& implements,
         std::vector<FieldDeclaration>& field_declarations,
         std::vector<MethodDeclaration>& method_declarations
     );
     ClassDeclaration(
         std::vector<Modifier>&& modifiers,
-        std::unique_ptr<struct Identifier>&& class_name,
-        std::unique_ptr<QualifiedIdentifier>&& extends_class,
+        AstPtr<struct Identifier>&& class_name,
+        AstPtr<QualifiedIdentifier>&& extends_class,
         std::vector<QualifiedIdentifier>&& implements,
         std::vector<FieldDeclaration>&& field_declarations,
         std::vector<MethodDeclaration>&& method_declarations
@@ -147,7 +147,7 @@ struct ClassDeclaration: public AstNodeCommon {
 
 struct InterfaceDeclaration: public AstNodeCommon {
     std::vector<Modifier> modifiers; // vector of interface modifiers
-    std::unique_ptr<Identifier> interface_name; // interface name
+    AstPtr<Identifier> interface_name; // interface name
     std::vector<QualifiedIdentifier> extends_class; // classes that this interface extends off of
     std::vector<MethodDeclaration> method_declarations; // interface method declarations
 
@@ -155,13 +155,13 @@ struct InterfaceDeclaration: public AstNodeCommon {
 
     InterfaceDeclaration(
         std::vector<Modifier>& modifiers,
-        std::unique_ptr<Identifier>& interface_name,
+        AstPtr<Identifier>& interface_name,
         std::vector<QualifiedIdentifier>& extends_class,
         std::vector<MethodDeclaration>& method_declarations
     );
     InterfaceDeclaration(
         std::vector<Modifier>&& modifiers,
-        std::unique_ptr<Identifier>&& interface_name,
+        AstPtr<Identifier>&& interface_name,
         std::vector<QualifiedIdentifier>&& extends_class,
         std::vector<MethodDeclaration>&& method_declarations
     );
@@ -3,29 +3,29 @@
 #include "types.h"
 
 Assignment::Assignment(
-    std::unique_ptr<Expression>& assigned_to,
-    std::unique_ptr<Expression>& assigned_from
+    AstPtr<Expression>& assigned_to,
+    AstPtr<Expression>& assigned_from
 ) :
     assigned_to{std::move(assigned_to)},
     assigned_from{std::move(assigned_from)}
 {}
 
 QualifiedThis::QualifiedThis(
-    std::unique_ptr<QualifiedIdentifier>& qt
+    AstPtr<QualifiedIdentifier>& qt
 ) : 
     qualified_this{std::move(qt)} 
 {}
 
 ArrayCreationExpression::ArrayCreationExpression(
-    std::unique_ptr<Type>& type,
-    std::unique_ptr<Expression>& expr
+    AstPtr<Type>& type,
+    AstPtr<Expression>& expr
 ) : 
     type{std::move(type)},
     expression{std::move(expr)} 
 {}
 
 ClassInstanceCreationExpression::ClassInstanceCreationExpression(
-    std::unique_ptr<QualifiedIdentifier>& class_name,
+    AstPtr<QualifiedIdentifier>& class_name,
     std::vector<Expression>& arguments
 ): 
     class_name{std::move(class_name)},
@@ -33,24 +33,24 @@ ClassInstanceCreationExpression::ClassInstanceCreationExpression(
 {}
 
 FieldAccess::FieldAccess(
-    std::unique_ptr<Expression>& expression,
-    std::unique_ptr<Identifier>& identifier
+    AstPtr<Expression>& expression,
+    AstPtr<Identifier>& identifier
 ): 
     expression{std::move(expression)},
     identifier{std::move(identifier)}
 {}
 
 ArrayAccess::ArrayAccess(
-    std::unique_ptr<Expression>& array,
-    std::unique_ptr<Expression>& selector  
+    AstPtr<Expression>& array,
+    AstPtr<Expression>& selector  
 ): 
     array{std::move(array)},
     selector{std::move(selector)}
 {}
 
 MethodInvocation::MethodInvocation(
-    std::unique_ptr<Expression>& parent_expr,
-    std::unique_ptr<Identifier>& method_name,
+    AstPtr<Expression>& parent_expr,
+    AstPtr<Identifier>& method_name,
     std::vector<Expression>& arguments
 ):
     parent_expr{std::move(parent_expr)},
@@ -59,8 +59,8 @@ MethodInvocation::MethodInvocation(
 {}
 
 InfixExpression::InfixExpression(
-    std::unique_ptr<Expression>& ex1,
-    std::unique_ptr<Expression>& ex2,
+    AstPtr<Expression>& ex1,
+    AstPtr<Expression>& ex2,
     InfixOperator op
 ) :
     expression1{std::move(ex1)},
@@ -69,7 +69,7 @@ InfixExpression::InfixExpression(
 {}
 
 PrefixExpression::PrefixExpression(
-    std::unique_ptr<Expression>& expression,
+    AstPtr<Expression>& expression,
     PrefixOperator op
 ): 
     expression{std::move(expression)},
@@ -77,23 +77,23 @@ PrefixExpression::PrefixExpression(
 {}
 
 CastExpression::CastExpression(
-    std::unique_ptr<Type>& type,
-    std::unique_ptr<Expression>& expression
+    AstPtr<Type>& type,
+    AstPtr<Expression>& expression
 ): 
     type{std::move(type)},
     expression{std::move(expression)}
 {}
 
 InstanceOfExpression::InstanceOfExpression(
-    std::unique_ptr<Expression>& expression,
-    std::unique_ptr<Type>& type
+    AstPtr<Expression>& expression,
+    AstPtr<Type>& type
 ): 
     expression{std::move(expression)},
     type{std::move(type)}
 {}
 
 ParenthesizedExpression::ParenthesizedExpression(
-    std::unique_ptr<Expression>& expression
+    AstPtr<Expression>& expression
 ):
     expression{std::move(expression)}
 {}
@@ -101,29 +101,29 @@ ParenthesizedExpression::ParenthesizedExpression(
 // ----------
 
 Assignment::Assignment(
-    std::unique_ptr<Expression>&& assigned_to,
-    std::unique_ptr<Expression>&& assigned_from
+    AstPtr<Expression>&& assigned_to,
+    AstPtr<Expression>&& assigned_from
 ) :
     assigned_to{std::move(assigned_to)},
     assigned_from{std::move(assigned_from)}
 {}
 
 QualifiedThis::QualifiedThis(
-    std::unique_ptr<QualifiedIdentifier>&& qt
+    AstPtr<QualifiedIdentifier>&& qt
 ) : 
     qualified_this{std::move(qt)} 
 {}
 
 ArrayCreationExpression::ArrayCreationExpression(
-    std::unique_ptr<Type>&& type,
-    std::unique_ptr<Expression>&& expr
+    AstPtr<Type>&& type,
+    AstPtr<Expression>&& expr
 ) : 
     type{std::move(type)},
     expression{std::move(expr)} 
 {}
 
 ClassInstanceCreationExpression::ClassInstanceCreationExpression(
-    std::unique_ptr<QualifiedIdentifier>&& class_name,
+    AstPtr<QualifiedIdentifier>&& class_name,
     std::vector<Expression>&& arguments
 ): 
     class_name{std::move(class_name)},
@@ -131,24 +131,24 @@ ClassInstanceCreationExpression::ClassInstanceCreationExpression(
 {}
 
 FieldAccess::FieldAccess(
-    std::unique_ptr<Expression>&& expression,
-    std::unique_ptr<Identifier>&& identifier
+    AstPtr<Expression>&& expression,
+    AstPtr<Identifier>&& identifier
 ): 
     expression{std::move(expression)},
     identifier{std::move(identifier)}
 {}
 
 ArrayAccess::ArrayAccess(
-    std::unique_ptr<Expression>&& array,
-    std::unique_ptr<Expression>&& selector  
+    AstPtr<Expression>&& array,
+    AstPtr<Expression>&& selector  
 ): 
     array{std::move(array)},
     selector{std::move(selector)}
 {}
 
 MethodInvocation::MethodInvocation(
-    std::unique_ptr<Expression>&& parent_expr,
-    std::unique_ptr<Identifier>&& method_name,
+    AstPtr<Expression>&& parent_expr,
+    AstPtr<Identifier>&& method_name,
     std::vector<Expression>&& arguments
 ):
     parent_expr{std::move(parent_expr)},
@@ -157,8 +157,8 @@ MethodInvocation::MethodInvocation(
 {}
 
 InfixExpression::InfixExpression(
-    std::unique_ptr<Expression>&& ex1,
-    std::unique_ptr<Expression>&& ex2,
+    AstPtr<Expression>&& ex1,
+    AstPtr<Expression>&& ex2,
     InfixOperator op
 ) :
     expression1{std::move(ex1)},
@@ -167,7 +167,7 @@ InfixExpression::InfixExpression(
 {}
 
 PrefixExpression::PrefixExpression(
-    std::unique_ptr<Expression>&& expression,
+    AstPtr<Expression>&& expression,
     PrefixOperator op
 ): 
     expression{std::move(expression)},
@@ -175,23 +175,23 @@ PrefixExpression::PrefixExpression(
 {}
 
 CastExpression::CastExpression(
-    std::unique_ptr<Type>&& type,
-    std::unique_ptr<Expression>&& expression
+    AstPtr<Type>&& type,
+    AstPtr<Expression>&& expression
 ): 
     type{std::move(type)},
     expression{std::move(expression)}
 {}
 
 InstanceOfExpression::InstanceOfExpression(
-    std::unique_ptr<Expression>&& expression,
-    std::unique_ptr<Type>&& type
+    AstPtr<Expression>&& expression,
+    AstPtr<Type>&& type
 ): 
     expression{std::move(expression)},
     type{std::move(type)}
 {}
 
 ParenthesizedExpression::ParenthesizedExpression(
-    std::unique_ptr<Expression>&& expression
+    AstPtr<Expression>&& expression
 ):
     expression{std::move(expression)}
 {}
@@ -71,54 +71,54 @@ struct Literal : public LiteralVariant, public ExpressionCommon {
 
 struct Assignment: public ExpressionCommon {
     // Represents assigned_to = assigned_from
-    std::unique_ptr<Expression> assigned_to;
-    std::unique_ptr<Expression> assigned_from;
+    AstPtr<Expression> assigned_to;
+    AstPtr<Expression> assigned_from;
 
     Assignment(
-        std::unique_ptr<Expression>& assigned_to,
-        std::unique_ptr<Expression>& assigned_from
+        AstPtr<Expression>& assigned_to,
+        AstPtr<Expression>& assigned_from
     );
     Assignment(
-        std::unique_ptr<Expression>&& assigned_to,
-        std::unique_ptr<Expression>&& assigned_from
+        AstPtr<Expression>&& assigned_to,
+        AstPtr<Expression>&& assigned_from
     );
 };
 
 struct QualifiedThis: public ExpressionCommon {
-    std::unique_ptr<QualifiedIdentifier> qualified_this;
+    AstPtr<QualifiedIdentifier> qualified_this;
 
     QualifiedThis(
-        std::unique_ptr<QualifiedIdentifier>& qt
+        AstPtr<QualifiedIdentifier>& qt
     );
     QualifiedThis(
-        std::unique_ptr<QualifiedIdentifier>&& qt
+        AstPtr<QualifiedIdentifier>&& qt
     );
 };
 
 struct ArrayCreationExpression: public ExpressionCommon {
-    std::unique_ptr<Type> type;
-    std::unique_ptr<Expression> expression;
+    AstPtr<Type> type;
+    AstPtr<Expression> expression;
 
     ArrayCreationExpression(
-        std::unique_ptr<Type>& type,
-        std::unique_ptr<Expression>& expr
+        AstPtr<Type>& type,
+        AstPtr<Expression>& expr
     );
     ArrayCreationExpression(
-        std::unique_ptr<Type>&& type,
-        std::unique_ptr<Expression>&& expr
+        AstPtr<Type>&& type,
+        AstPtr<Expression>&& expr
     );
 };
 
 struct ClassInstanceCreationExpression: public ExpressionCommon {
-    std::unique_ptr<QualifiedIdentifier> class_name;
+    AstPtr<QualifiedIdentifier> class_name;
     std::vector<Expression> arguments;
 
     ClassInstanceCreationExpression(
-        std::unique_ptr<QualifiedIdentifier>& class_name,
+        AstPtr<QualifiedIdentifier>& class_name,
         std::vector<Expression>& arguments
     );
     ClassInstanceCreationExpression(
-        std::unique_ptr<QualifiedIdentifier>&& class_name,
+        AstPtr<QualifiedIdentifier>&& class_name,
         std::vector<Expression>&& arguments
     );
 
@@ -132,16 +132,16 @@ struct ClassInstanceCreationExpression: public ExpressionCommon {
 };
 
 struct FieldAccess: public ExpressionCommon {
-    std::unique_ptr<Expression> expression;
-    std::unique_ptr<Identifier> identifier;
+    AstPtr<Expression> expression;
+    AstPtr<Identifier> identifier;
 
     FieldAccess(
-        std::unique_ptr<Expression>& expression,
-        std::unique_ptr<Identifier>& identifier
+        AstPtr<Expression>& expression,
+        AstPtr<Identifier>& identifier
     );
     FieldAccess(
-        std::unique_ptr<Expression>&& expression,
-        std::unique_ptr<Identifier>&& identifier
+        AstPtr<Expression>&& expression,
+        AstPtr<Identifier>&& identifier
     );
 
     // The type that the field access is on.
@@ -150,22 +150,22 @@ struct FieldAccess: public ExpressionCommon {
 };
 
 struct ArrayAccess: public ExpressionCommon {
-    std::unique_ptr<Expression> array;
-    std::unique_ptr<Expression> selector;
+    AstPtr<Expression> array;
+    AstPtr<Expression> selector;
 
     ArrayAccess(
-        std::unique_ptr<Expression>& array,
-        std::unique_ptr<Expression>& selector  
+        AstPtr<Expression>& array,
+        AstPtr<Expression>& selector  
     );
     ArrayAccess(
-        std::unique_ptr<Expression>&& array,
-        std::unique_ptr<Expression>&& selector  
+        AstPtr<Expression>&& array,
+        AstPtr<Expression>&& selector  
     );
 };
 
 struct MethodInvocation: public ExpressionCommon {
-    std::unique_ptr<Expression> parent_expr;    // CAN BE NULL
-    std::unique_ptr<Identifier> method_name;
+    AstPtr<Expression> parent_expr;    // CAN BE NULL
+    AstPtr<Identifier> method_name;
     std::vector<Expression> arguments;
 
     // The method declaration that is called.
@@ -173,83 +173,83 @@ struct MethodInvocation: public ExpressionCommon {
     MethodDeclarationObject* called_method = nullptr;
 
     MethodInvocation(
-        std::unique_ptr<Expression>& parent_expr,
-        std::unique_ptr<Identifier>& method_name,
+        AstPtr<Expression>& parent_expr,
+        AstPtr<Identifier>& method_name,
         std::vector<Expression>& arguments
     );
     MethodInvocation(
-        std::unique_ptr<Expression>&& parent_expr,
-        std::unique_ptr<Identifier>&& method_name,
+        AstPtr<Expression>&& parent_expr,
+        AstPtr<Identifier>&& method_name,
         std::vector<Expression>&& arguments
     );
 };
 
 struct InfixExpression : public ExpressionCommon {
-    std::unique_ptr<Expression> expression1;
-    std::unique_ptr<Expression> expression2;
+    AstPtr<Expression> expression1;
+    AstPtr<Expression> expression2;
     InfixOperator op;
 
     InfixExpression(
-        std::unique_ptr<Expression>& ex1,
-        std::unique_ptr<Expression>& ex2,
+        AstPtr<Expression>& ex1,
+        AstPtr<Expression>& ex2,
         InfixOperator op
     );
     InfixExpression(
-        std::unique_ptr<Expression>&& ex1,
-        std::unique_ptr<Expression>&& ex2,
+        AstPtr<Expression>&& ex1,
+        AstPtr<Expression>&& ex2,
         InfixOperator op
     );
 };
 
 struct PrefixExpression : public ExpressionCommon {
-    std::unique_ptr<Expression> expression;
+    AstPtr<Expression> expression;
     PrefixOperator op;
 
     PrefixExpression(
-        std::unique_ptr<Expression>& expression,
+        AstPtr<Expression>& expression,
         PrefixOperator op
     );
     PrefixExpression(
-        std::unique_ptr<Expression>&& expression,
+        AstPtr<Expression>&& expression,
         PrefixOperator op
     );
 };
 
 struct CastExpression : public ExpressionCommon {
-    std::unique_ptr<Type> type;
-    std::unique_ptr<Expression> expression;
+    AstPtr<Type> type;
+    AstPtr<Expression> expression;
 
     CastExpression(
-        std::unique_ptr<Type>& type,
-        std::unique_ptr<Expression>& expression
+        AstPtr<Type>& type,
+        AstPtr<Expression>& expression
     );
     CastExpression(
-        std::unique_ptr<Type>&& type,
-        std::unique_ptr<Expression>&& expression
+        AstPtr<Type>&& type,
+        AstPtr<Expression>&& expression
     );
 };
 
 struct InstanceOfExpression : public ExpressionCommon {
-    std::unique_ptr<Expression> expression;
-    std::unique_ptr<Type> type;
+    AstPtr<Expression> expression;
+    AstPtr<Type> type;
 
     InstanceOfExpression(
-        std::unique_ptr<Expression>& expression,
-        std::unique_ptr<Type>& type
+        AstPtr<Expression>& expression,
+        AstPtr<Type>& type
     );
     InstanceOfExpression(
-        std::unique_ptr<Expression>&& expression,
-        std::unique_ptr<Type>&& type
+        AstPtr<Expression>&& expression,
+        AstPtr<Type>&& type
     );
 };
 
 struct ParenthesizedExpression : public ExpressionCommon {
-    std::unique_ptr<Expression> expression;
+    AstPtr<Expression> expression;
     
     ParenthesizedExpression(
-        std::unique_ptr<Expression>& expression
+        AstPtr<Expression>& expression
     );
     ParenthesizedExpression(
-        std::unique_ptr<Expression>&& expression
+        AstPtr<Expression>&& expression
     );
 };
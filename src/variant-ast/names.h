@@ -4,6 +4,7 @@
 #include <vector>
 #include "astnodecommon.h"
 #include "astnode.h"
+#include "utillities/symbol.h"
 #include <unordered_map>
 
 enum Classification {
@@ -26,7 +27,7 @@ std::string inline classificationToString(Classification classification) {
 }
 
 struct Identifier: public AstNodeCommon {
-    std::string name; // Identifier name
+    util::Symbol name; // Identifier name
 
     // If this identifier is classified as an PACKAGE_NAME, points to the package it refers to, and nullptr otherwise.
     //
@@ -59,8 +60,9 @@ struct Identifier: public AstNodeCommon {
 
     Classification classification = UNCLASSIFIED;
 
-    Identifier(std::string& name) : name(std::move(name)) {}
-    Identifier(std::string&& name) : name(std::move(name)) {}
+    Identifier(util::Symbol name) : name(name) {}
+    Identifier(const std::string& name) : name(name) {}
+    Identifier(const char *name) : name(name) {}
 };
 
 struct QualifiedIdentifier: public ExpressionCommon {
@@ -6,7 +6,7 @@
 #include "names.h"
 
 CompilationUnit::CompilationUnit(
-    std::unique_ptr<QualifiedIdentifier>& package_declaration, 
+    AstPtr<QualifiedIdentifier>& package_declaration, 
     std::vector<QualifiedIdentifier>& single_imports, 
     std::vector<QualifiedIdentifier>& asterisk_imports, 
     std::vector<ClassDeclaration>& class_decs, 
@@ -22,7 +22,7 @@ CompilationUnit::CompilationUnit(
 // --------
 
 CompilationUnit::CompilationUnit(
-    std::unique_ptr<QualifiedIdentifier>&& package_declaration, 
+    AstPtr<QualifiedIdentifier>&& package_declaration, 
     std::vector<QualifiedIdentifier>&& single_imports, 
     std::vector<QualifiedIdentifier>&& asterisk_imports, 
     std::vector<ClassDeclaration>&& class_decs, 
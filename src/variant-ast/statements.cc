@@ -5,17 +5,17 @@
 #include "names.h"
 
 IfThenStatement::IfThenStatement(
-    std::unique_ptr<Expression>& if_clause,
-    std::unique_ptr<Statement>& then_clause
+    AstPtr<Expression>& if_clause,
+    AstPtr<Statement>& then_clause
 ) : 
     if_clause{std::move(if_clause)},
     then_clause{std::move(then_clause)} 
 {}
 
 IfThenElseStatement::IfThenElseStatement(
-    std::unique_ptr<Expression>& if_clause,
-    std::unique_ptr<Statement>& then_clause,
-    std::unique_ptr<Statement>& else_clause
+    AstPtr<Expression>& if_clause,
+    AstPtr<Statement>& then_clause,
+    AstPtr<Statement>& else_clause
 ) : 
     if_clause{std::move(if_clause)},
     then_clause{std::move(then_clause)},
@@ -23,18 +23,18 @@ IfThenElseStatement::IfThenElseStatement(
 {}
 
 WhileStatement::WhileStatement(
-    std::unique_ptr<Expression>& condition_expression,
-    std::unique_ptr<Statement>& body_statement
+    AstPtr<Expression>& condition_expression,
+    AstPtr<Statement>& body_statement
 ) : 
     condition_expression{std::move(condition_expression)},
     body_statement{std::move(body_statement)}
 {}
 
 ForStatement::ForStatement(
-    std::unique_ptr<Statement>& init_statement,
-    std::unique_ptr<Expression>& condition_expression,
-    std::unique_ptr<Statement>& update_statement,
-    std::unique_ptr<Statement>& body_statement
+    AstPtr<Statement>& init_statement,
+    AstPtr<Expression>& condition_expression,
+    AstPtr<Statement>& update_statement,
+    AstPtr<Statement>& body_statement
 ) : 
     init_statement{std::move(init_statement)},
     condition_expression{std::move(condition_expression)},
@@ -49,14 +49,14 @@ Block::Block(
 {}
 
 ReturnStatement::ReturnStatement(
-    std::unique_ptr<Expression>& return_expression
+    AstPtr<Expression>& return_expression
 ) : 
     return_expression{std::move(return_expression)}
 {}
 
 LocalVariableDeclaration::LocalVariableDeclaration(
-    std::unique_ptr<Type>& type,
-    std::unique_ptr<VariableDeclarator>& variable_declarator
+    AstPtr<Type>& type,
+    AstPtr<VariableDeclarator>& variable_declarator
 ) : 
     type(std::move(type)),
     variable_declarator(std::move(variable_declarator))
@@ -65,17 +65,17 @@ LocalVariableDeclaration::LocalVariableDeclaration(
 // -------------
 
 IfThenStatement::IfThenStatement(
-    std::unique_ptr<Expression>&& if_clause,
-    std::unique_ptr<Statement>&& then_clause
+    AstPtr<Expression>&& if_clause,
+    AstPtr<Statement>&& then_clause
 ) : 
     if_clause{std::move(if_clause)},
     then_clause{std::move(then_clause)} 
 {}
 
 IfThenElseStatement::IfThenElseStatement(
-    std::unique_ptr<Expression>&& if_clause,
-    std::unique_ptr<Statement>&& then_clause,
-    std::unique_ptr<Statement>&& else_clause
+    AstPtr<Expression>&& if_clause,
+    AstPtr<Statement>&& then_clause,
+    AstPtr<Statement>&& else_clause
 ) : 
     if_clause{std::move(if_clause)},
     then_clause{std::move(then_clause)},
@@ -83,18 +83,18 @@ IfThenElseStatement::IfThenElseStatement(
 {}
 
 WhileStatement::WhileStatement(
-    std::unique_ptr<Expression>&& condition_expression,
-    std::unique_ptr<Statement>&& body_statement
+    AstPtr<Expression>&& condition_expression,
+    AstPtr<Statement>&& body_statement
 ) : 
     condition_expression{std::move(condition_expression)},
     body_statement{std::move(body_statement)}
 {}
 
 ForStatement::ForStatement(
-    std::unique_ptr<Statement>&& init_statement,
-    std::unique_ptr<Expression>&& condition_expression,
-    std::unique_ptr<Statement>&& update_statement,
-    std::unique_ptr<Statement>&& body_statement
+    AstPtr<Statement>&& init_statement,
+    AstPtr<Expression>&& condition_expression,
+    AstPtr<Statement>&& update_statement,
+    AstPtr<Statement>&& body_statement
 ) : 
     init_statement{std::move(init_statement)},
     condition_expression{std::move(condition_expression)},
@@ -110,14 +110,14 @@ Block::Block(
 {}
 
 ReturnStatement::ReturnStatement(
-    std::unique_ptr<Expression>&& return_expression
+    AstPtr<Expression>&& return_expression
 ) : 
     return_expression{std::move(return_expression)}
 {}
 
 LocalVariableDeclaration::LocalVariableDeclaration(
-    std::unique_ptr<Type>&& type,
-    std::unique_ptr<VariableDeclarator>&& variable_declarator
+    AstPtr<Type>&& type,
+    AstPtr<VariableDeclarator>&& variable_declarator
 ) : 
     type(std::move(type)),
     variable_declarator(std::move(variable_declarator))
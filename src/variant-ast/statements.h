@@ -30,69 +30,69 @@ typedef std::variant<
 > Statement;
 
 struct IfThenStatement: public AstNodeCommon {
-    std::unique_ptr<Expression> if_clause;
-    std::unique_ptr<Statement> then_clause;
+    AstPtr<Expression> if_clause;
+    AstPtr<Statement> then_clause;
 
     IfThenStatement(
-        std::unique_ptr<Expression>& if_clause,
-        std::unique_ptr<Statement>& then_clause
+        AstPtr<Expression>& if_clause,
+        AstPtr<Statement>& then_clause
     );
     IfThenStatement(
-        std::unique_ptr<Expression>&& if_clause,
-        std::unique_ptr<Statement>&& then_clause
+        AstPtr<Expression>&& if_clause,
+        AstPtr<Statement>&& then_clause
     );
 };
 
 struct IfThenElseStatement: public AstNodeCommon {
-    std::unique_ptr<Expression> if_clause;
-    std::unique_ptr<Statement> then_clause;
-    std::unique_ptr<Statement> else_clause;
+    AstPtr<Expression> if_clause;
+    AstPtr<Statement> then_clause;
+    AstPtr<Statement> else_clause;
 
     IfThenElseStatement(
-        std::unique_ptr<Expression>& if_clause,
-        std::unique_ptr<Statement>& then_clause,
-        std::unique_ptr<Statement>& else_clause
+        AstPtr<Expression>& if_clause,
+        AstPtr<Statement>& then_clause,
+        AstPtr<Statement>& else_clause
     );
     IfThenElseStatement(
-        std::unique_ptr<Expression>&& if_clause,
-        std::unique_ptr<Statement>&& then_clause,
-        std::unique_ptr<Statement>&& else_clause
+        AstPtr<Expression>&& if_clause,
+        AstPtr<Statement>&& then_clause,
+        AstPtr<Statement>&& else_clause
     );
 };
 
 struct WhileStatement: public AstNodeCommon {
-    std::unique_ptr<Expression> condition_expression;
-    std::unique_ptr<Statement> body_statement;
+    AstPtr<Expression> condition_expression;
+    AstPtr<Statement> body_statement;
 
     WhileStatement(
-        std::unique_ptr<Expression>& condition_expression,
-        std::unique_ptr<Statement>& body_statement
+        AstPtr<Expression>& condition_expression,
+        AstPtr<Statement>& body_statement
     );
     WhileStatement(
-        std::unique_ptr<Expression>&& condition_expression,
-        std::unique_ptr<Statement>&& body_statement
+        AstPtr<Expression>&& condition_expression,
+        AstPtr<Statement>&& body_statement
     );
 };
 
 struct ForStatement: public AstNodeCommon {
-    std::unique_ptr<Statement> init_statement;
-    std::unique_ptr<Expression> condition_expression;
-    std::unique_ptr<Statement> update_statement;
-    std::unique_ptr<Statement> body_statement;
+    AstPtr<Statement> init_statement;
+    AstPtr<Expression> condition_expression;
+    AstPtr<Statement> update_statement;
+    AstPtr<Statement> body_statement;
 
     size_t scope_id;
 
     ForStatement(
-        std::unique_ptr<Statement>& init_statement,
-        std::unique_ptr<Expression>& condition_expression,
-        std::unique_ptr<Statement>& update_statement,
-        std::unique_ptr<Statement>& body_statement
+        AstPtr<Statement>& init_statement,
+        AstPtr<Expression>& condition_expression,
+        AstPtr<Statement>& update_statement,
+        AstPtr<Statement>& body_statement
     );
     ForStatement(
-        std::unique_ptr<Statement>&& init_statement,
-        std::unique_ptr<Expression>&& condition_expression,
-        std::unique_ptr<Statement>&& update_statement,
-        std::unique_ptr<Statement>&& body_statement
+        AstPtr<Statement>&& init_statement,
+        AstPtr<Expression>&& condition_expression,
+        AstPtr<Statement>&& update_statement,
+        AstPtr<Statement>&& body_statement
     );
 };
 
@@ -112,28 +112,28 @@ struct Block: public AstNodeCommon {
 };
 
 struct ReturnStatement: public AstNodeCommon {
-    std::unique_ptr<Expression> return_expression;
+    AstPtr<Expression> return_expression;
 
     ReturnStatement(
-        std::unique_ptr<Expression>& return_expression
+        AstPtr<Expression>& return_expression
     );
     ReturnStatement(
-        std::unique_ptr<Expression>&& return_expression
+        AstPtr<Expression>&& return_expression
     );
 };
 
 struct LocalVariableDeclaration: public AstNodeCommon {
-    std::unique_ptr<Type> type;
-    std::unique_ptr<VariableDeclarator> variable_declarator;
+    AstPtr<Type> type;
+    AstPtr<VariableDeclarator> variable_declarator;
 
     struct LocalVariableDeclarationObject *environment = nullptr;
 
     LocalVariableDeclaration(
-        std::unique_ptr<Type>& type,
-        std::unique_ptr<VariableDeclarator>& variable_declarator
+        AstPtr<Type>& type,
+        AstPtr<VariableDeclarator>& variable_declarator
     );
     LocalVariableDeclaration(
-        std::unique_ptr<Type>&& type,
-        std::unique_ptr<VariableDeclarator>&& variable_declarator
+        AstPtr<Type>&& type,
+        AstPtr<VariableDeclarator>&& variable_declarator
     );
 };
@@ -1,13 +1,13 @@
 #include "types.h"
 #include "names.h"
 
-Type::Type(std::unique_ptr<NonArrayType>& non_array_type, bool is_array) :
+Type::Type(AstPtr<NonArrayType>& non_array_type, bool is_array) :
     non_array_type{std::move(non_array_type)}, is_array{is_array}, link{}
 {}
 
 // -------
 
-Type::Type(std::unique_ptr<NonArrayType>&& non_array_type, bool is_array) :
+Type::Type(AstPtr<NonArrayType>&& non_array_type, bool is_array) :
     non_array_type{std::move(non_array_type)}, is_array{is_array}, link{}
 {}
 
@@ -10,13 +10,13 @@
 typedef std::variant<PrimitiveType, struct QualifiedIdentifier> NonArrayType;
 
 struct Type : public AstNodeCommon {
-    std::unique_ptr<NonArrayType> non_array_type;
+    AstPtr<NonArrayType> non_array_type;
     bool is_array;
 
     LinkedType link;
 
-    Type(std::unique_ptr<NonArrayType>& non_array_type, bool is_array);
-    Type(std::unique_ptr<NonArrayType>&& non_array_type, bool is_array);
+    Type(AstPtr<NonArrayType>& non_array_type, bool is_array);
+    Type(AstPtr<NonArrayType>&& non_array_type, bool is_array);
 
     // Operators
     friend bool operator==(const Type & lhs, const Type & rhs);
@@ -25,24 +25,7 @@ string getFileName(string& filename) {
     }
 }
 
-
-string readFileToString(const string& filePath) {
-    ifstream file(filePath);
-    if (!file.is_open()) {
-        throw runtime_error("Unable to open file: " + filePath);
-    }
-
-    string content;
-    string line;
-    while (getline(file, line)) {
-        content += line + "\n";
-    }
-
-    return content;
-}
-
-
-void AstWeeder::checkAsciiRange(const string& source) {
+void AstWeeder::checkAsciiRange(string_view source) {
     for (char c : source) {
         if (c < 0 || c > 127) {
             addViolation("Character outside 7-bit ASCII range detected: " + c);
@@ -56,13 +39,13 @@ void AstWeeder::addViolation(const std::string& vio) {
 }
 
 void AstWeeder::printViolations() {
-    std::cerr << "Weeder detected the following violations:\n";
+    diagnostics << "Weeder detected the following violations:\n";
     for (const auto& violation : violations) {
-        std::cerr << "  - " << violation << '\n';
+        diagnostics << "  - " << violation << '\n';
     }
 }
 
-int AstWeeder::weed(AstNodeVariant& root, string fileName, string &strfile) {
+int AstWeeder::weed(AstNodeVariant& root, string fileName, string_view source) {
     if(holds_alternative<CompilationUnit>(root)) {
         auto &cu = get<CompilationUnit>(root);
         string file = getFileName(fileName);
@@ -71,7 +54,7 @@ int AstWeeder::weed(AstNodeVariant& root, string fileName, string &strfile) {
         checkOneTypePerFile(cu);
         
         // check program ascii range
-        checkAsciiRange(strfile == "" ? readFileToString(fileName) : strfile);
+        checkAsciiRange(source);
 
         // check programm interfaces
         checkInterfaces(cu.interface_declarations, file);
@@ -7,6 +7,7 @@
 #include <stdexcept>
 #include <optional>
 #include <variant>
+#include <string_view>
 #include <fstream>
 #include "variant-ast/astnode.h"
 #include "variant-ast/astvisitor/graballvisitor.h"
@@ -14,16 +15,18 @@
 using namespace std;
 class AstWeeder {
 public: 
-    int weed(AstNodeVariant& root, string fileName, string &strfile);
+    // source is the file's contents, as scanned
+    int weed(AstNodeVariant& root, string fileName, string_view source);
 
-    AstWeeder() {}
+    AstWeeder(ostream &diagnostics = cerr) : diagnostics{diagnostics} {}
 
 private:
     vector<string> violations;
+    ostream &diagnostics; // Where violations are reported
 
     void checkOneTypePerFile(const CompilationUnit& cu);
 
-    void checkAsciiRange(const string& source);
+    void checkAsciiRange(string_view source);
 
     void checkClassModifiersAndConstructors(vector<ClassDeclaration> &classes, string &filename);
 
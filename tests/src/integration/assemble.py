@@ -3,7 +3,8 @@ from helpers.helpers import *
 
 def assemble_all_files(binary_name="main", output_path="../../../output"):
     """
-    Emit the binary produced by assembling and linking all the assembly files in output_path.
+    Emit the binary produced by assembling and linking all the assembly files in output_path,
+    along with any object files joosc wrote there directly (--emit-objects).
 
     Return True if success, False if fail
     """
@@ -1,6 +1,5 @@
 import os, subprocess, sys
 from helpers.helpers import *
-from assemble import assemble_all_files
 from typing import List
 
 def single_correct_output_test(program_path, compiler_args: List[str]) -> bool:
@@ -19,16 +18,15 @@ def single_correct_output_test(program_path, compiler_args: List[str]) -> bool:
     # if program is a directory, get all files from the direcory and add to a list
     files = get_all_files(program_path, ".java") if os.path.isdir(program_path) else [program_path]
 
-    result = subprocess.run([joosc_executable, *compiler_args, *files, *stdlib_files])
+    # joosc assembles and links the program into ./main itself
+    result = run_joosc([joosc_executable, *compiler_args, "-o", "main", *files, *stdlib_files])
+
+    if result.returncode == LINK_ERROR:
+        print(f"{colors.FAIL}FAIL: joosc failed to assemble {program}, so it couldn't be run.{colors.ENDC}\n")
+        return False
 
     if result.returncode in (0, 43):
         # Program compiled, check output is correct
-
-        successful_assemble = assemble_all_files()
-        if not successful_assemble:
-            print(f"{colors.FAIL}FAIL: joosc failed to assemble {program}, so it couldn't be run.{colors.ENDC}\n")
-            return False
-        
         program_result = subprocess.run(["./main"], cwd=root_dir)
 
         # with open(resolve_path(root_dir, "ir_result.tmp"), "r") as file:
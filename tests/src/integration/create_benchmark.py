@@ -1,6 +1,5 @@
 import os, subprocess, sys
 from helpers.helpers import *
-from assemble import assemble_all_files
 from typing import List
 import time
 import csv
@@ -16,13 +15,12 @@ def compile_file(program_path, compiler_args: List[str]):
     joosc_executable = resolve_path(root_dir, "./joosc")
     files = get_all_files(program_path, ".java") if os.path.isdir(program_path) else [program_path]
 
-    result = subprocess.run([joosc_executable, *compiler_args, *files, *stdlib_files])
+    # joosc assembles and links the program into ./main itself
+    result = run_joosc([joosc_executable, *compiler_args, "-o", "main", *files, *stdlib_files])
 
-    if result.returncode in (0, 43):
-        assembled = assemble_all_files()
-        if not assembled:
-            print(f"{colors.FAIL}FAIL: joosc failed to assemble {program}, so it couldn't be run.{colors.ENDC}\n")
-            return False
+    if result.returncode == LINK_ERROR:
+        print(f"{colors.FAIL}FAIL: joosc failed to assemble {program}, so it couldn't be run.{colors.ENDC}\n")
+        return False
 
 def add_to_csv(optimization:str, benchmark_name: str, optimized_time: float, unoptimized_time: float):
     root_dir = resolve_path(os.path.dirname(__file__), "../../../")
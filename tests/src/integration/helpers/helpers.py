@@ -1,5 +1,5 @@
 from pathlib import Path
-import os
+import os, socket, subprocess, sys
 
 # Imported from Blender
 class colors:
@@ -14,6 +14,9 @@ class colors:
     UNDERLINE = '\033[4m'
     HEADER_BOLD_UNDERLINE = HEADER + BOLD + UNDERLINE
 
+# joosc return code when the program compiled, but could not be assembled or linked (with -o)
+LINK_ERROR = 3
+
 # Function to load environment variables from .env file
 def load_env_file(filename=".env"):
     with open(filename, "r") as f:
@@ -37,6 +40,29 @@ def get_all_files(directory, ext):
                 file_list.append(os.path.join(root, file))
     return file_list
 
+def run_joosc(command, stderr=None):
+    """
+    Run the joosc command line (executable followed by arguments).
+    If JOOSC_SERVER is set to the socket of a running `joosc --server`, the compile is sent there
+    instead of starting a new process. Diagnostics are written to stderr, or printed if it is None.
+    """
+    server_socket = os.getenv('JOOSC_SERVER')
+    if not server_socket:
+        return subprocess.run(command, stderr=stderr)
+
+    request = b"\0".join(field.encode() for field in ["compile", os.getcwd(), *command[1:]]) + b"\0\0"
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as connection:
+        connection.connect(server_socket)
+        connection.sendall(request)
+        response = b""
+        while chunk := connection.recv(65536):
+            response += chunk
+
+    header, _, diagnostics = response.partition(b"diagnostics\n")
+    returncode = int(header.split(b"\n", 1)[0])
+    (stderr or sys.stdout).write(diagnostics.decode(errors="replace"))
+    return subprocess.CompletedProcess(command, returncode)
+
 def print_file_contents(file):
     with open(file, "r") as outfile: 
         print(outfile.read())
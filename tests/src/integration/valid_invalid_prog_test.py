@@ -30,7 +30,7 @@ def single_valid_invalid_prog_test(program_path, print_pass_cases=True, expected
         files = get_all_files(program_path, ".java")
 
     with open(integration_log_file, "w") as outfile:
-        result = subprocess.run([joosc_executable, *compiler_args, *files, *stdlib_files], stderr=outfile)
+        result = run_joosc([joosc_executable, *compiler_args, *files, *stdlib_files], stderr=outfile)
 
     if result.returncode == expected_code:
         # Test passed, display output if -f is not set
@@ -0,0 +1,21 @@
+#include <filesystem>
+#include <gtest/gtest.h>
+
+#include "build-cache/build-cache.h"
+
+// Test that an entry is only reused for the fingerprint it was stored for, even if another's hash is the same
+
+TEST(BuildCache, collidingfingerprintsmiss) {
+    auto directory = std::filesystem::temp_directory_path() / "joosc-build-cache-test";
+    std::filesystem::remove_all(directory);
+    BuildCache cache {directory.string()};
+
+    BuildCache::Fingerprint stored {42, "mov eax, 1"};
+    BuildCache::Fingerprint colliding {42, "mov eax, 2"};
+    cache.store(stored, "first unit");
+
+    EXPECT_EQ(cache.load(stored), std::optional<std::string>("first unit"));
+    EXPECT_EQ(cache.load(colliding), std::nullopt) << "A different fingerprint with the same hash should miss";
+
+    std::filesystem::remove_all(directory);
+}
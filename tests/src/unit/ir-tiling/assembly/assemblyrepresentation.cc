@@ -2,6 +2,7 @@
 
 #include "IR-tiling/assembly/assembly.h"
 #include "IR-tiling/assembly/assembly-instruction.h"
+#include "IR-tiling/assembly/assembly-writer.h"
 
 #include "IR-tiling/register-allocation/brainless-allocator.h"
 #include "IR-tiling/register-allocation/linear-scanning-allocator.h"
@@ -11,49 +12,83 @@
 TEST(Mov, StringifiesCorrectly) {
     using namespace Assembly;
 
-    Operand a = "a";
-    AssemblyInstruction move_basic = Mov("a", "b");
+    Register a = Register::abstract(0);
+    Register b = Register::abstract(1);
+    AssemblyInstruction move_basic = Mov(a, b);
 
-    EXPECT_EQ(move_basic.toString(), "mov a, b") << "Basic move did not stringify correctly";
+    EXPECT_EQ(move_basic.toString(), "mov %_ABSTRACT_REG0%, %_ABSTRACT_REG1%") << "Basic move did not stringify correctly";
 
-    AssemblyInstruction move_effective_address1 = Mov("a", EffectiveAddress("eax", 2));
+    AssemblyInstruction move_effective_address1 = Mov(a, EffectiveAddress(REG32_ACCUM, 2));
 
-    EXPECT_EQ(move_effective_address1.toString(), "mov a, [eax + 2]") << "Advanced move 1 did not stringify correctly";
+    EXPECT_EQ(move_effective_address1.toString(), "mov %_ABSTRACT_REG0%, [eax + 2]") << "Advanced move 1 did not stringify correctly";
+
+    AssemblyInstruction move_static_field = Mov(REG32_ACCUM, EffectiveAddress(LabelUse("field")));
+
+    EXPECT_EQ(move_static_field.toString(), "mov eax, [field]") << "Static field move did not stringify correctly";
 }
 
 TEST(Lea, registerusagecorrect) {
     using namespace Assembly;
 
-    AssemblyInstruction lea = Lea("eax", EffectiveAddress("%REGABS1%"));
+    Register abs1 = Register::abstract(1);
+    AssemblyInstruction lea = Lea(REG32_ACCUM, EffectiveAddress(abs1));
 
-    EXPECT_EQ(lea.toString(), "lea eax, [%REGABS1%]") << "Basic lea did not stringify correctly";
+    EXPECT_EQ(lea.toString(), "lea eax, [%_ABSTRACT_REG1%]") << "Basic lea did not stringify correctly";
 
     auto used = lea.getUsedRegisters();
 
-    EXPECT_TRUE(used.count("eax") == 1) << "used does not contain eax";
-    EXPECT_TRUE(used.count("%REGABS1%") == 1) << "used does not contain %REGABS1%";
+    EXPECT_TRUE(used.count(REG32_ACCUM) == 1) << "used does not contain eax";
+    EXPECT_TRUE(used.count(abs1) == 1) << "used does not contain %_ABSTRACT_REG1%";
 
     auto read = lea.getReadRegisters();
 
     std::string readstr;
 
-    for (auto reg : read) readstr += " " + reg;
+    for (auto reg : read) readstr += " " + reg.toString();
 
-    EXPECT_TRUE(read.count("eax") == 0) << "read contains eax; specifically it contains" << readstr;
-    EXPECT_TRUE(read.count("%REGABS1%") == 1) << "read does not contain %REGABS1%";
+    EXPECT_TRUE(read.count(REG32_ACCUM) == 0) << "read contains eax; specifically it contains" << readstr;
+    EXPECT_TRUE(read.count(abs1) == 1) << "read does not contain %_ABSTRACT_REG1%";
 
     auto write = lea.getWriteRegisters();
 
-    EXPECT_TRUE(write.count("eax") == 1) << "write does not contain eax";
-    EXPECT_TRUE(write.count("%REGABS1%") == 0) << "write contains %REGABS1%";
+    EXPECT_TRUE(write.count(REG32_ACCUM) == 1) << "write does not contain eax";
+    EXPECT_TRUE(write.count(abs1) == 0) << "write contains %_ABSTRACT_REG1%";
 
     EXPECT_TRUE(used.size() == 2) << "used amount incorrect";
 
-    lea.replaceRegister("eax", "a");
-    EXPECT_EQ(lea.toString(), "lea a, [%REGABS1%]") << "replaced lea did not stringify correctly";
+    lea.replaceRegister(REG32_ACCUM, REG32_BASE);
+    EXPECT_EQ(lea.toString(), "lea ebx, [%_ABSTRACT_REG1%]") << "replaced lea did not stringify correctly";
+
+    lea.replaceRegister(abs1, REG32_DATA);
+    EXPECT_EQ(lea.toString(), "lea ebx, [edx]") << "replaced lea did not stringify correctly";
+    EXPECT_TRUE(lea.getReadRegisters().count(REG32_DATA) == 1) << "read does not contain replaced register";
+    EXPECT_TRUE(lea.getUsedAbstractRegisters().empty()) << "abstract register still used after replacement";
+}
+
+TEST(SetL, partialregisterusagecorrect) {
+    using namespace Assembly;
+
+    AssemblyInstruction setl = SetL(REG8L_ACCUM);
+
+    EXPECT_EQ(setl.toString(), "setl al") << "SetL did not stringify correctly";
+    EXPECT_TRUE(setl.getWriteRegisters().count(REG32_ACCUM) == 1) << "writing al does not write eax";
+}
+
+TEST(AssemblyWriter, widensstackandaddressregistersforx86_64) {
+    using namespace Assembly;
+
+    auto render = [](AssemblyInstruction instruction, Target target) {
+        AssemblyWriter out {false, nullptr, target};
+        out.text(instruction);
+        return out.take();
+    };
 
-    lea.replaceRegister("%REGABS1%", "b");
-    EXPECT_EQ(lea.toString(), "lea a, [b]") << "replaced lea did not stringify correctly";
+    EXPECT_EQ(render(Push(REG32_STACKBASEPTR), Target::X86), "push ebp");
+    EXPECT_EQ(render(Push(REG32_STACKBASEPTR), Target::X86_64), "push rbp");
+    EXPECT_EQ(render(Call(REG32_ACCUM), Target::X86_64), "call rax");
+    EXPECT_EQ(render(Sub(REG32_STACKPTR, 8), Target::X86_64), "sub rsp, 8");
+    EXPECT_EQ(render(Mov(REG32_R8, EffectiveAddress(REG32_BASE, REG32_DATA, 4, 8)), Target::X86_64), "mov r8d, [rbx + (rdx * 4) + 8]");
+    EXPECT_EQ(render(Mov(REG32_ACCUM, EffectiveAddress(REG32_STACKBASEPTR, 16)), Target::X86_64), "mov eax, [rbp + 16]");
 }
 
 TEST(BrainlessRegisterAllocator, allocatescorrectly) {
@@ -62,8 +97,8 @@ TEST(BrainlessRegisterAllocator, allocatescorrectly) {
     BrainlessRegisterAllocator allocator;
 
     std::list<AssemblyInstruction> instrs = {
-        Mov("%REGABS1%", 123),
-        Lea("eax", EffectiveAddress("%REGABS1%"))
+        Mov(Register::abstract(1), 123),
+        Lea(REG32_ACCUM, EffectiveAddress(Register::abstract(1)))
     };
 
     allocator.allocateRegisters(instrs);
@@ -81,8 +116,8 @@ TEST(LinearScanningRegisterAllocator, allocatescorrectly) {
 
     std::list<AssemblyInstruction> instrs = {
         SetL(REG8L_ACCUM),
-        Mov("a", 2),
-        Mov(REG32_ACCUM, "a"),
+        Mov(Register::abstract(0), 2),
+        Mov(REG32_ACCUM, Register::abstract(0)),
         Mov(REG32_COUNTER, REG32_ACCUM)
     };
 
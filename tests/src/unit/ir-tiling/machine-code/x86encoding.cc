@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "IR-tiling/assembly/assembly.h"
+#include "IR-tiling/assembly/assembly-instruction.h"
+#include "IR-tiling/machine-code/x86-encoder.h"
+
+// Test that instructions are encoded as an assembler would encode them
+
+static std::vector<uint8_t> encode(std::list<AssemblyInstruction> instructions) {
+    return X86Encoder().encode(instructions).bytes;
+}
+
+TEST(X86Encoder, EncodesAddressingModes) {
+    using namespace Assembly;
+
+    EXPECT_EQ(encode({Mov(REG32_BASE, REG32_COUNTER)}), (std::vector<uint8_t>{0x89, 0xcb}));
+    EXPECT_EQ(encode({Mov(REG32_COUNTER, EffectiveAddress(REG32_STACKBASEPTR, -8))}), (std::vector<uint8_t>{0x8b, 0x4d, 0xf8}));
+    EXPECT_EQ(encode({Mov(REG32_COUNTER, EffectiveAddress(REG32_STACKBASEPTR))}), (std::vector<uint8_t>{0x8b, 0x4d, 0x00}));
+    EXPECT_EQ(encode({Mov(EffectiveAddress(REG32_STACKPTR, 4), REG32_ACCUM)}), (std::vector<uint8_t>{0x89, 0x44, 0x24, 0x04}));
+    EXPECT_EQ(encode({Lea(REG32_SOURCE, EffectiveAddress(REG32_COUNTER, REG32_BASE, 4, 300))}),
+        (std::vector<uint8_t>{0x8d, 0xb4, 0x99, 0x2c, 0x01, 0x00, 0x00}));
+}
+
+TEST(X86Encoder, UsesShortImmediates) {
+    using namespace Assembly;
+
+    EXPECT_EQ(encode({Sub(REG32_STACKPTR, 8)}), (std::vector<uint8_t>{0x83, 0xec, 0x08}));
+    EXPECT_EQ(encode({Add(REG32_ACCUM, 1000)}), (std::vector<uint8_t>{0x05, 0xe8, 0x03, 0x00, 0x00}));
+    EXPECT_EQ(encode({Cmp(REG32_DATA, 1000)}), (std::vector<uint8_t>{0x81, 0xfa, 0xe8, 0x03, 0x00, 0x00}));
+    EXPECT_EQ(encode({Push(-1)}), (std::vector<uint8_t>{0x6a, 0xff}));
+}
+
+TEST(X86Encoder, RelaxesJumps) {
+    using namespace Assembly;
+
+    // A backwards jump that fits in a byte stays short
+    EXPECT_EQ(encode({Label("loop"), Cdq(), Jump(LabelUse("loop"))}), (std::vector<uint8_t>{0x99, 0xeb, 0xfd}));
+
+    // A jump over more than 127 bytes is widened
+    std::list<AssemblyInstruction> far_jump = {Je(LabelUse("end"))};
+    for (int i = 0; i < 128; ++i) far_jump.push_back(Cdq());
+    far_jump.push_back(Label("end"));
+    auto bytes = encode(far_jump);
+    ASSERT_EQ(bytes.size(), 6 + 128);
+    EXPECT_EQ(std::vector<uint8_t>(bytes.begin(), bytes.begin() + 6), (std::vector<uint8_t>{0x0f, 0x84, 0x80, 0x00, 0x00, 0x00}));
+}
+
+TEST(X86Encoder, ReferencesOtherSymbols) {
+    using namespace Assembly;
+
+    std::list<AssemblyInstruction> instructions = {Jump(LabelUse("start")), Call(LabelUse("__malloc")), Label("start")};
+    auto code = X86Encoder().encode(instructions);
+
+    EXPECT_EQ(code.bytes, (std::vector<uint8_t>{0xeb, 0x05, 0xe8, 0xfc, 0xff, 0xff, 0xff}));
+    ASSERT_EQ(code.references.size(), 1);
+    EXPECT_EQ(code.references[0].offset, 3);
+    EXPECT_EQ(code.references[0].symbol, "__malloc");
+    EXPECT_EQ(code.references[0].kind, MachineCode::ReferenceKind::RELATIVE);
+    ASSERT_EQ(code.labels.size(), 1);
+    EXPECT_EQ(code.labels[0].offset, 7);
+}
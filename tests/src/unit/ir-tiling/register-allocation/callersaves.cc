@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "IR-tiling/assembly/assembly.h"
+#include "IR-tiling/assembly/assembly-instruction.h"
+
+#include "IR-tiling/register-allocation/linear-scanning-allocator.h"
+#include "IR-tiling/register-allocation/graph-colouring-allocator.h"
+#include "render.h"
+
+// Test that calls only save the registers holding values live across them
+
+TEST(CallerSaves, nothingsavedwhennothinglive) {
+    using namespace Assembly;
+
+    Register size = Register::abstract(0);
+    Register object = Register::abstract(1);
+
+    std::list<AssemblyInstruction> body = {
+        Mov(size, 8),
+        Mov(REG32_ACCUM, size),
+        Call(LabelUse("__malloc")),
+        Mov(object, REG32_ACCUM),
+        Mov(REG32_ACCUM, object),
+        Ret()
+    };
+
+    int32_t stack_size = LinearScanningRegisterAllocator().allocateRegisters(body);
+    EXPECT_EQ(stack_size, 0) << "Nothing should be saved on the stack";
+
+    for (auto& instruction : render(body)) {
+        EXPECT_EQ(instruction.find("ebp"), std::string::npos) << "Unexpected save or restore: " << instruction;
+    }
+}
+
+TEST(CallerSaves, keepslivevaluesoutofclobberedregisters) {
+    using namespace Assembly;
+
+    for (bool graph_colouring : {false, true}) {
+        Register kept = Register::abstract(0);
+
+        std::list<AssemblyInstruction> body = {
+            Mov(kept, 5),
+            Mov(REG32_ACCUM, 8),
+            Call(LabelUse("__malloc")),
+            Add(kept, REG32_ACCUM),
+            Mov(REG32_ACCUM, kept),
+            Ret()
+        };
+
+        int32_t stack_size = graph_colouring
+            ? GraphColouringRegisterAllocator().allocateRegisters(body)
+            : LinearScanningRegisterAllocator().allocateRegisters(body);
+        EXPECT_EQ(stack_size, 0) << "The value live across __malloc should not be saved on the stack";
+
+        auto instructions = render(body);
+        EXPECT_EQ(instructions[0].find("ebx"), std::string::npos) << "__malloc clobbers ebx: " << instructions[0];
+        for (auto& instruction : instructions) {
+            EXPECT_EQ(instruction.find("ebp"), std::string::npos) << "Unexpected save or restore: " << instruction;
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include "IR-tiling/assembly/assembly.h"
+#include "IR-tiling/assembly/assembly-instruction.h"
+
+#include "IR-tiling/register-allocation/control-flow-graph.h"
+
+// Test that the blocks of nested loops are given the number of loops they are in
+
+TEST(ControlFlowGraph, findsnestedloopdepths) {
+    using namespace Assembly;
+
+    Register i = Register::abstract(0);
+    Register j = Register::abstract(1);
+
+    std::list<AssemblyInstruction> body = {
+        Mov(i, 0),                 // 0
+        Label("outer"),            // 1
+        Cmp(i, 10),                // 2
+        Je(LabelUse("outer_end")), // 3
+        Mov(j, 0),                 // 4
+        Label("inner"),            // 5
+        Cmp(j, 10),                // 6
+        Je(LabelUse("inner_end")), // 7
+        Add(j, 1),                 // 8
+        Jump(LabelUse("inner")),   // 9
+        Label("inner_end"),        // 10
+        Add(i, 1),                 // 11
+        Jump(LabelUse("outer")),   // 12
+        Label("outer_end"),        // 13
+        Mov(REG32_ACCUM, i),       // 14
+        Ret()                      // 15
+    };
+
+    ControlFlowGraph cfg {body};
+
+    std::vector<double> frequencies;
+    for (size_t instruction : {0, 2, 4, 6, 8, 11, 14}) frequencies.push_back(cfg.frequency(instruction));
+
+    EXPECT_EQ(frequencies, (std::vector<double>{1, 10, 10, 100, 100, 10, 1}))
+        << "Each loop an instruction is in should count 10 times";
+}
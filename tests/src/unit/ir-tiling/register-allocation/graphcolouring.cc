@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include "IR-tiling/assembly/assembly.h"
+#include "IR-tiling/assembly/assembly-instruction.h"
+
+#include "IR-tiling/register-allocation/graph-colouring-allocator.h"
+#include "render.h"
+
+// Test that the graph colouring allocator coalesces copies between temporaries
+
+TEST(GraphColouring, coalescescopies) {
+    using namespace Assembly;
+
+    Register a = Register::abstract(0);
+    Register b = Register::abstract(1);
+    Register difference = Register::abstract(2);
+
+    std::list<AssemblyInstruction> body = {
+        Mov(a, 7),
+        Mov(b, 3),
+        Sub(a, b),
+        Mov(difference, a),
+        Mov(REG32_ACCUM, difference),
+        Ret()
+    };
+
+    int32_t stack_size = GraphColouringRegisterAllocator().allocateRegisters(body);
+    EXPECT_EQ(stack_size, 0) << "Three temporaries should not spill";
+
+    EXPECT_EQ(render(body), (std::vector<std::string>{"mov eax, 7", "mov ecx, 3", "sub eax, ecx", "ret"}))
+        << "Copies into and out of the difference should be coalesced away";
+}
+
+// Test that a temporary live across a call is given a callee saved register, so the call site saves nothing
+
+TEST(GraphColouring, keepsvaluesacrosscallsincalleesaved) {
+    using namespace Assembly;
+
+    Register kept = Register::abstract(0);
+
+    std::list<AssemblyInstruction> body = {
+        Mov(kept, 5),
+        Call(LabelUse("f")),
+        Mov(REG32_ACCUM, kept),
+        Ret()
+    };
+
+    int32_t stack_size = GraphColouringRegisterAllocator().allocateRegisters(body);
+    EXPECT_EQ(stack_size, 0) << "No caller saved register should need a stack space";
+
+    EXPECT_EQ(render(body), (std::vector<std::string>{"mov ebx, 5", "call f", "mov eax, ebx", "ret"}))
+        << "The temporary should be kept in ebx across the call";
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include "IR-tiling/assembly/assembly.h"
+#include "IR-tiling/assembly/assembly-instruction.h"
+
+#include "IR-tiling/register-allocation/control-flow-graph.h"
+#include "IR-tiling/register-allocation/liveness.h"
+
+// Test that liveness follows the jumps of a function body
+
+TEST(Liveness, extendsacrossloopbackedge) {
+    using namespace Assembly;
+
+    Register base = Register::abstract(0);
+    Register i = Register::abstract(1);
+    Register scratch = Register::abstract(2);
+
+    std::list<AssemblyInstruction> body = {
+        Mov(base, 100),                          // 0
+        Mov(i, 0),                               // 1
+        Label("loop"),                           // 2
+        Mov(scratch, EffectiveAddress(base, i)), // 3
+        Add(i, scratch),                         // 4
+        Cmp(i, 10),                              // 5
+        Je(LabelUse("done")),                    // 6
+        Jump(LabelUse("loop")),                  // 7
+        Label("done"),                           // 8
+        Mov(REG32_ACCUM, i),                     // 9
+        Ret()                                    // 10
+    };
+
+    ControlFlowGraph cfg {body};
+    ASSERT_EQ(cfg.blocks.size(), 4) << "Expected blocks for the entry, the loop, the back edge and the exit";
+
+    auto ranges = Liveness(cfg).liveRanges();
+
+    using Ranges = std::vector<Liveness::Range>;
+    EXPECT_EQ(ranges[base], (Ranges{{0, 7}})) << "Value read in the loop should be live across the back edge";
+    EXPECT_EQ(ranges[i], (Ranges{{1, 9}})) << "Induction variable should be live until its last read";
+    EXPECT_EQ(ranges[scratch], (Ranges{{3, 4}})) << "Value written in the loop should be dead across the back edge";
+    EXPECT_EQ(ranges[REG32_ACCUM], (Ranges{{9, 10}})) << "Return value should be live until the return";
+}
+
+TEST(Liveness, leavesholesbetweenvalues) {
+    using namespace Assembly;
+
+    Register a = Register::abstract(0);
+    Register b = Register::abstract(1);
+
+    std::list<AssemblyInstruction> body = {
+        Mov(a, 1),           // 0
+        Mov(b, a),           // 1
+        Add(b, 5),           // 2
+        Mov(a, 2),           // 3
+        Add(b, a),           // 4
+        Mov(REG32_ACCUM, b), // 5
+        Ret()                // 6
+    };
+
+    ControlFlowGraph cfg {body};
+    auto ranges = Liveness(cfg).liveRanges();
+
+    using Ranges = std::vector<Liveness::Range>;
+    EXPECT_EQ(ranges[a], (Ranges{{0, 1}, {3, 4}})) << "Register should be dead between its last read and next write";
+    EXPECT_EQ(ranges[b], (Ranges{{1, 5}}));
+}
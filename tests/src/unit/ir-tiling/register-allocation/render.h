@@ -0,0 +1,14 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "IR-tiling/assembly/assembly-instruction.h"
+
+// The text of each instruction of an allocated function body, for comparing against the expected listing
+inline std::vector<std::string> render(std::list<AssemblyInstruction>& body) {
+    std::vector<std::string> instructions;
+    for (auto& instruction : body) instructions.push_back(instruction.toString());
+    return instructions;
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include "IR/ir.h"
+#include "IR/flat-ir.h"
+
+// Test that a function body is flattened in post-order, with children referred to by id
+
+TEST(FlatIR, storesnodesinpostorder) {
+    std::vector<std::unique_ptr<ExpressionIR>> args;
+    args.push_back(ConstIR::makeExpr(4));
+    args.push_back(TempIR::makeExpr(1));
+
+    std::vector<std::unique_ptr<StatementIR>> stmts;
+    stmts.push_back(LabelIR::makeStmt(0));
+    stmts.push_back(MoveIR::makeStmt(
+        TempIR::makeExpr(0),
+        BinOpIR::makeExpr(BinOpIR::ADD, TempIR::makeExpr(1), ConstIR::makeOne())
+    ));
+    stmts.push_back(std::make_unique<StatementIR>(
+        std::in_place_type<CallIR>, NameIR::makeExpr("f"), std::move(args)
+    ));
+    stmts.push_back(ReturnIR::makeStmt(TempIR::makeExpr(0)));
+    auto body = SeqIR::makeStmt(std::move(stmts));
+
+    FlatIR flat {*body};
+
+    std::vector<FlatIR::Kind> kinds;
+    for (IRNodeId id = 0; id < flat.size(); id++) {
+        kinds.push_back(flat[id].kind);
+    }
+    std::vector<FlatIR::Kind> expected = {
+        FlatIR::Kind::LABEL,
+        FlatIR::Kind::TEMP, FlatIR::Kind::TEMP, FlatIR::Kind::CONST, FlatIR::Kind::BIN_OP, FlatIR::Kind::MOVE,
+        FlatIR::Kind::NAME, FlatIR::Kind::CONST, FlatIR::Kind::TEMP, FlatIR::Kind::CALL,
+        FlatIR::Kind::TEMP, FlatIR::Kind::RETURN,
+        FlatIR::Kind::SEQ
+    };
+    ASSERT_EQ(kinds, expected);
+
+    auto &seq = flat[flat.root()];
+    EXPECT_EQ(flat.root(), 12u);
+    ASSERT_EQ(flat.list(seq).size(), 4u);
+    EXPECT_EQ(flat.list(seq)[0], 0u);
+    EXPECT_EQ(flat.list(seq)[1], 5u);
+    EXPECT_EQ(flat.list(seq)[2], 9u);
+    EXPECT_EQ(flat.list(seq)[3], 11u);
+
+    auto &move = flat[5];
+    EXPECT_EQ(move.first, 1u);
+    EXPECT_EQ(move.second, 4u);
+    EXPECT_EQ(flat[move.second].op, BinOpIR::ADD);
+    EXPECT_EQ(flat[3].value, 1);
+
+    auto &call = flat[9];
+    EXPECT_EQ(flat.text(flat[call.first]), "f");
+    ASSERT_EQ(flat.list(call).size(), 2u);
+    EXPECT_EQ(flat[flat.list(call)[0]].value, 4);
+    EXPECT_EQ(flat[flat.list(call)[1]].id, 1u);
+
+    EXPECT_EQ(flat[11].first, 10u);
+    EXPECT_EQ(flat.label(4), "ADD");
+}
@@ -8,12 +8,13 @@
 
 
 TEST(GrabAllVisitor, GetsCorrectAmountFromCompilationUnit) {
+    AstArena arena;
     std::string name1 = "hello";
     std::string name2 = "hello";
     auto id1 = Identifier(name1);
     auto id2 = Identifier(name2);
     auto identifiers = std::vector<Identifier>{name1, name2};
-    auto package_declaration = std::make_unique<QualifiedIdentifier>(
+    auto package_declaration = arena.make<QualifiedIdentifier>(
         identifiers
     );
     auto single_imports = std::vector<QualifiedIdentifier>();
@@ -5,8 +5,9 @@
 #include "variant-ast/astnode.h"
 
 TEST(AstNodeVariant, LValueConstructorCompiles) {
+    AstArena arena;
     auto identifiers = std::vector<Identifier>();
-    auto package_declaration = std::make_unique<QualifiedIdentifier>(
+    auto package_declaration = arena.make<QualifiedIdentifier>(
         identifiers
     );
     auto single_imports = std::vector<QualifiedIdentifier>();
@@ -24,8 +25,9 @@ TEST(AstNodeVariant, LValueConstructorCompiles) {
 }
 
 TEST(AstNodeVariant, RValueConstructorCompiles) {
+    AstArena arena;
     AstNodeVariant root = CompilationUnit(
-        std::make_unique<QualifiedIdentifier>(
+        arena.make<QualifiedIdentifier>(
             std::vector<Identifier>()
         ),
         std::vector<QualifiedIdentifier>(), 
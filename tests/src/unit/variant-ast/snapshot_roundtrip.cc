@@ -0,0 +1,214 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "variant-ast/astnode.h"
+#include "variant-ast/astvisitor/graballvisitor.h"
+#include "ast-snapshot/ast-snapshot.h"
+#include "ast-snapshot/environment-snapshot.h"
+#include "environment-builder/environmentbuilder.h"
+#include "environment-builder/symboltable.h"
+#include "type-linking/typelinker.h"
+#include "hierarchy-checking/hierarchy-checking.h"
+#include "parsing/bison/driver.h"
+#include "source-manager/source-manager.h"
+#include "weeder/astweeder.h"
+
+static std::string readFile(const std::string &filename) {
+    std::ifstream input {filename, std::ios::binary};
+    std::stringstream contents;
+    contents << input.rdbuf();
+    return contents.str();
+}
+
+// Parse and weed a file as the compiler does before writing a snapshot
+static AstNodeVariant parseFile(const std::string &filename, SourceManager &sources, AstArena &arena) {
+    auto &buffer = sources.addFile(filename);
+
+    Driver driver;
+    driver.trace_parsing = false;
+    driver.trace_scanning = false;
+    driver.arena = &arena;
+    EXPECT_EQ(driver.parse(buffer), 0) << filename << " should parse";
+
+    AstNodeVariant parsed = std::move(*driver.root);
+    std::stringstream diagnostics;
+    EXPECT_EQ(AstWeeder(diagnostics).weed(parsed, filename, buffer.contents()), 0) << diagnostics.str();
+    return parsed;
+}
+
+// Test that a snapshot written with --write-snapshot loads back as the same AST with --stdlib-snapshot
+
+TEST(AstSnapshot, RoundTripReproducesAst) {
+    auto directory = std::filesystem::temp_directory_path() / "joosc-snapshot-roundtrip";
+    std::filesystem::create_directories(directory);
+    std::string source_file = (directory / "Counter.java").string();
+    std::string snapshot_file = (directory / "first.snapshot").string();
+    std::string rewritten_file = (directory / "second.snapshot").string();
+
+    std::ofstream {source_file} <<
+        "package counting;\n"
+        "import java.util.*;\n"
+        "public class Counter extends Object {\n"
+        "    protected int count = 0;\n"
+        "    public Counter() {}\n"
+        "    public int add(int[] values, String label) {\n"
+        "        for (int i = 0; i < values.length; i = i + 1) {\n"
+        "            if (values[i] != -1 && !(label instanceof Object)) count = count + (char) values[i];\n"
+        "            else { ; }\n"
+        "        }\n"
+        "        while (count > 100) count = count / 2;\n"
+        "        Object copy = new Counter();\n"
+        "        return this.count + label.length() + \"done\".length();\n"
+        "    }\n"
+        "}\n";
+
+    // Parse and weed the file as the compiler does before writing a snapshot
+    SourceManager sources;
+    AstArena parsed_arena;
+    auto &buffer = sources.addFile(source_file);
+
+    Driver driver;
+    driver.trace_parsing = false;
+    driver.trace_scanning = false;
+    driver.arena = &parsed_arena;
+    ASSERT_EQ(driver.parse(buffer), 0) << "Test source should parse";
+
+    AstNodeVariant parsed = std::move(*driver.root);
+    std::stringstream diagnostics;
+    ASSERT_EQ(AstWeeder(diagnostics).weed(parsed, source_file, buffer.contents()), 0) << diagnostics.str();
+
+    AstSnapshotWriter writer;
+    writer.addUnit(source_file, parsed);
+    writer.writeToFile(snapshot_file);
+
+    // Load it back
+    LocationFileNames filenames;
+    AstArena loaded_arena;
+    auto units = AstSnapshotReader::readFile(snapshot_file, filenames, loaded_arena).units;
+    ASSERT_EQ(units.size(), 1);
+    EXPECT_EQ(units[0].filename, source_file);
+    EXPECT_TRUE(units[0].matchesFile()) << "Unchanged file should match its snapshot";
+
+    // Every identifier should come back with its name and location
+    auto parsed_identifiers = GrabAllVisitor<Identifier>().visit(parsed);
+    auto loaded_identifiers = GrabAllVisitor<Identifier>().visit(units[0].ast);
+    ASSERT_EQ(parsed_identifiers.size(), loaded_identifiers.size());
+    for (size_t i = 0; i < parsed_identifiers.size(); i++) {
+        EXPECT_EQ(parsed_identifiers[i]->name.str(), loaded_identifiers[i]->name.str());
+        EXPECT_EQ(parsed_identifiers[i]->location.begin.line, loaded_identifiers[i]->location.begin.line);
+        EXPECT_EQ(parsed_identifiers[i]->location.begin.column, loaded_identifiers[i]->location.begin.column);
+        EXPECT_EQ(*loaded_identifiers[i]->location.begin.filename, source_file);
+    }
+
+    // Writing the loaded AST should give the same snapshot, so nothing was lost or changed
+    AstSnapshotWriter rewriter;
+    rewriter.addUnit(units[0].filename, units[0].ast);
+    rewriter.writeToFile(rewritten_file);
+    EXPECT_EQ(readFile(snapshot_file), readFile(rewritten_file)) << "Snapshot of the loaded AST should be identical";
+
+    std::filesystem::remove_all(directory);
+}
+
+// Test that the environment stored in a snapshot restores what environment building, type linking and
+// hierarchy checking work out
+
+TEST(AstSnapshot, EnvironmentRoundTrip) {
+    auto directory = std::filesystem::temp_directory_path() / "joosc-snapshot-environment";
+    std::filesystem::create_directories(directory);
+    std::string object_file = (directory / "Object.java").string();
+    std::string counter_file = (directory / "Counter.java").string();
+    std::string countable_file = (directory / "Countable.java").string();
+    std::string snapshot_file = (directory / "environment.snapshot").string();
+
+    std::ofstream {object_file} <<
+        "package java.lang;\n"
+        "public class Object {\n"
+        "    public Object() {}\n"
+        "    public boolean equals(Object other) { return this == other; }\n"
+        "}\n";
+    std::ofstream {countable_file} <<
+        "package counting;\n"
+        "public interface Countable { public int count(); }\n";
+    std::ofstream {counter_file} <<
+        "package counting;\n"
+        "public class Counter extends Object implements Countable {\n"
+        "    protected int total = 0;\n"
+        "    public Counter() {}\n"
+        "    public int count() { Object copy = new Counter(); return total; }\n"
+        "}\n";
+
+    // Analyse the units on their own, as --write-snapshot does
+    SourceManager sources;
+    AstArena parsed_arena;
+    std::vector<std::string> files {object_file, countable_file, counter_file};
+    std::vector<AstNodeVariant> parsed;
+    for ( auto &file : files ) { parsed.push_back(parseFile(file, sources, parsed_arena)); }
+
+    std::vector<AstNodeVariant*> parsed_units;
+    for ( auto &unit : parsed ) { parsed_units.push_back(&unit); }
+
+    PackageDeclarationObject analysed_root;
+    for ( auto unit : parsed_units ) { EnvironmentBuilder(analysed_root).visit(*unit); }
+    for ( auto unit : parsed_units ) { TypeLinker(analysed_root).visit(*unit); }
+    for ( auto unit : parsed_units ) { HierarchyCheckingVisitor(analysed_root).visit(*unit); }
+
+    AstSnapshotWriter writer;
+    for ( size_t i = 0; i < files.size(); i++ ) { writer.addUnit(files[i], parsed[i]); }
+    writer.setEnvironment(writeEnvironment(parsed_units, analysed_root));
+    writer.writeToFile(snapshot_file);
+
+    // Load the units back and restore their environment instead of analysing them again
+    LocationFileNames filenames;
+    AstArena loaded_arena;
+    auto snapshot = AstSnapshotReader::readFile(snapshot_file, filenames, loaded_arena);
+    ASSERT_TRUE(snapshot.environment.has_value());
+
+    std::vector<AstNodeVariant*> loaded_units;
+    for ( auto &unit : snapshot.units ) { loaded_units.push_back(&unit.ast); }
+
+    PackageDeclarationObject restored_root;
+    readEnvironment(*snapshot.environment, loaded_units, restored_root);
+
+    auto object = restored_root.getJavaLangObject();
+    auto counter = restored_root.findClassDeclaration("counting.Counter");
+    auto countable = restored_root.findInterfaceDeclaration("counting.Countable");
+    ASSERT_NE(counter, nullptr);
+    ASSERT_NE(countable, nullptr);
+    EXPECT_EQ(counter->full_qualified_name, "counting.Counter");
+    EXPECT_EQ(counter->package_contained_in, restored_root.findPackageDeclaration("counting"));
+
+    // Type links
+    EXPECT_EQ(counter->extended, object);
+    EXPECT_EQ(counter->implemented, std::vector<InterfaceDeclarationObject*>{countable});
+    EXPECT_EQ(std::get<CompilationUnit>(*loaded_units[2]).cu_namespace.getDeclaredType(), TypeDeclaration{counter});
+    auto total = counter->fields->lookupUniqueSymbol<FieldDeclarationObject>("total");
+    ASSERT_NE(total, nullptr);
+    EXPECT_TRUE(total->type.isNumeric());
+
+    auto constructor = counter->methods->lookupUniqueSymbol<MethodDeclarationObject>("Counter");
+    ASSERT_NE(constructor, nullptr);
+    EXPECT_TRUE(constructor->is_constructor);
+
+    auto count = counter->methods->lookupUniqueSymbol<MethodDeclarationObject>("count");
+    ASSERT_NE(count, nullptr);
+    auto locals = GrabAllVisitor<LocalVariableDeclaration>().visit(*loaded_units[2]);
+    ASSERT_EQ(locals.size(), 1);
+    ASSERT_NE(locals[0]->environment, nullptr);
+    EXPECT_EQ(locals[0]->environment->type.getIfIsClass(), object);
+    auto creations = GrabAllVisitor<ClassInstanceCreationExpression>().visit(*loaded_units[2]);
+    ASSERT_EQ(creations.size(), 1);
+    EXPECT_EQ(creations[0]->link.getIfIsClass(), counter);
+
+    // Hierarchy
+    EXPECT_EQ(counter->all_methods.at("equals"), object->all_methods.at("equals"));
+    EXPECT_EQ(counter->all_methods.at("count"), count);
+    EXPECT_EQ(counter->method_list.size(), 4);
+    EXPECT_EQ(countable->all_methods.at("equals"), object->all_methods.at("equals"));
+    EXPECT_EQ(counter->accessible_fields.at("total"), total);
+
+    std::filesystem::remove_all(directory);
+}
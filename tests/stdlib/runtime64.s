@@ -0,0 +1,57 @@
+section .text
+
+; Runtime for the x86-64 target. Joos values are still 32 bits, and the
+; program lies in the low 4GB, so addresses fit in the 32 bit registers.
+
+; Allocates eax bytes of memory. Pointer to allocated memory returned in eax.
+    global __malloc
+__malloc:
+    mov esi, eax ; number of bytes requested
+    mov eax, 12  ; sys_brk system call
+    mov edi, 0   ; 0 bytes - query current brk
+    syscall
+    mov rdx, rax ; start of the allocated memory
+    lea rdi, [rax + rsi] ; move brk ahead by number of bytes requested
+    mov eax, 12  ; sys_brk system call
+    syscall
+    cmp rax, rdi ; on error, brk is not moved; exit with code 22
+    jae ok
+    mov eax, 22
+    call __debexit
+ok:
+    mov eax, edx
+    ret
+
+; Debugging exit: ends the process, returning the value of
+; eax as the exit code.
+    global __debexit
+__debexit:
+    mov edi, eax
+    mov eax, 60  ; sys_exit system call
+    syscall
+
+; Exceptional exit: ends the process with exit code 13.
+; Call this in cases where the Joos code would throw an exception.
+    global __exception
+__exception:
+    mov eax, 60  ; sys_exit system call
+    mov edi, 13
+    syscall
+
+; Implementation of java.io.OutputStream.nativeWrite method.
+; Outputs the low-order byte of eax to standard output.
+    global NATIVEjava.io.OutputStream.nativeWrite
+NATIVEjava.io.OutputStream.nativeWrite:
+    mov [char], al ; save the low order byte in memory
+    mov eax, 1     ; sys_write system call
+    mov edi, 1     ; stdout
+    mov esi, char  ; address of bytes to write
+    mov edx, 1     ; number of bytes to write
+    syscall
+    mov eax, 0     ; return 0
+    ret
+
+section .data
+
+char:
+    dd 0